@@ -42,7 +42,7 @@ std::unique_ptr<WatchDog> juli(new WatchDog());
 ////////////////////////////////////////////////////////////////////////////////////
 WatchDog::WatchDog()
 {
-    setVersion(0, 3);
+    setVersion(0, 4);
     setDriverInterface(AUX_INTERFACE);
 
     watchdogClient = new WatchDogClient();
@@ -93,6 +93,9 @@ bool WatchDog::Connect()
     IDSnoopDevice(ActiveDeviceT[ACTIVE_TELESCOPE].text, "TELESCOPE_PARK");
     IDSnoopDevice(ActiveDeviceT[ACTIVE_DOME].text, "DOME_PARK");
 
+    // Open the client session now so that a shutdown does not wait for the connection
+    startClient();
+
     return true;
 }
 
@@ -112,6 +115,9 @@ bool WatchDog::Disconnect()
         m_WeatherAlertTimer = -1;
     }
 
+    if (watchdogClient->isServerConnected())
+        watchdogClient->disconnectServer();
+
     LOG_INFO("Watchdog is disabled.");
     m_ShutdownStage = WATCHDOG_IDLE;
 
@@ -168,6 +174,12 @@ bool WatchDog::initProperties()
     IUFillTextVector(&ActiveDeviceTP, ActiveDeviceT, 3, getDeviceName(), "ACTIVE_DEVICES", "Active devices",
                      OPTIONS_TAB, IP_RW, 60, IPS_IDLE);
 
+    // Shutdown Latency
+    IUFillNumber(&LatencyN[LATENCY_COMMANDS], "LATENCY_COMMANDS", "Commands (ms)", "%.f", 0, 1e6, 0, 0);
+    IUFillNumber(&LatencyN[LATENCY_COMPLETE], "LATENCY_COMPLETE", "Complete (ms)", "%.f", 0, 1e9, 0, 0);
+    IUFillNumberVector(&LatencyNP, LatencyN, 2, getDeviceName(), "WATCHDOG_LATENCY", "Latency",
+                       MAIN_CONTROL_TAB, IP_RO, 60, IPS_IDLE);
+
     addDebugControl();
 
     return true;
@@ -187,6 +199,7 @@ void WatchDog::ISGetProperties(const char *dev)
     defineProperty(&ShutdownProcedureSP);
     defineProperty(&MountPolicySP);
     defineProperty(&ActiveDeviceTP);
+    defineProperty(&LatencyNP);
 }
 
 ////////////////////////////////////////////////////////////////////////////////////
@@ -214,6 +227,7 @@ bool WatchDog::ISNewText(const char *dev, const char *name, char *texts[], char
             }
 
             IDSetText(&SettingsTP, nullptr);
+            restartClient();
             return true;
         }
 
@@ -235,6 +249,7 @@ bool WatchDog::ISNewText(const char *dev, const char *name, char *texts[], char
             IUUpdateText(&ActiveDeviceTP, texts, names, n);
             ActiveDeviceTP.s = IPS_OK;
             IDSetText(&ActiveDeviceTP, nullptr);
+            restartClient();
             return true;
         }
     }
@@ -298,6 +313,9 @@ bool WatchDog::ISNewNumber(const char *dev, const char *name, double values[], c
 
                 LOG_DEBUG("Received heart beat from client.");
 
+                // Reopen the client session if INDI server dropped it
+                startClient();
+
                 if (m_WatchDogTimer > 0)
                 {
                     RemoveTimer(m_WatchDogTimer);
@@ -337,6 +355,8 @@ bool WatchDog::ISNewSwitch(const char *dev, const char *name, ISState *states, c
             else
                 ShutdownProcedureSP.s = IPS_OK;
             IDSetSwitch(&ShutdownProcedureSP, nullptr);
+            if (isConnected())
+                restartClient();
             return true;
         }
         // Mount Lock Policy
@@ -584,6 +604,11 @@ void WatchDog::TimerHit()
         // Connect to server
         case WATCHDOG_IDLE:
 
+            m_ShutdownStart = std::chrono::steady_clock::now();
+            LatencyN[LATENCY_COMMANDS].value = LatencyN[LATENCY_COMPLETE].value = 0;
+            LatencyNP.s = IPS_BUSY;
+            IDSetNumber(&LatencyNP, nullptr);
+
             ShutdownProcedureSP.s = IPS_BUSY;
             IDSetSwitch(&ShutdownProcedureSP, nullptr);
 
@@ -600,20 +625,14 @@ void WatchDog::TimerHit()
                 break;
             }
 
-            // Watch mount if requied
-            if (ShutdownProcedureS[PARK_MOUNT].s == ISS_ON)
-                watchdogClient->setMount(ActiveDeviceT[ACTIVE_TELESCOPE].text);
-            // Watch dome
-            if (ShutdownProcedureS[PARK_DOME].s == ISS_ON)
-                watchdogClient->setDome(ActiveDeviceT[ACTIVE_DOME].text);
-
-            // Set indiserver host and port
-            watchdogClient->setServer(SettingsT[INDISERVER_HOST].text, m_INDIServerPort);
-
-            LOG_DEBUG("Connecting to INDI server...");
-
-            watchdogClient->connectServer();
+            // The session opened on connection is normally ready, park right away
+            if (watchdogClient->isConnected())
+            {
+                startParking();
+                break;
+            }
 
+            startClient();
             m_ShutdownStage = WATCHDOG_CLIENT_STARTED;
 
             break;
@@ -624,13 +643,7 @@ void WatchDog::TimerHit()
             {
                 LOGF_DEBUG("Connected to INDI server %s @ %s", SettingsT[0].text,
                            SettingsT[1].text);
-
-                if (ShutdownProcedureS[PARK_MOUNT].s == ISS_ON)
-                    parkMount();
-                else if (ShutdownProcedureS[PARK_DOME].s == ISS_ON)
-                    parkDome();
-                else if (ShutdownProcedureS[EXECUTE_SCRIPT].s == ISS_ON)
-                    executeScript();
+                startParking();
             }
             else
                 LOG_DEBUG("Waiting for INDI server connection...");
@@ -660,6 +673,14 @@ void WatchDog::TimerHit()
             // check if dome is parked
             IPState domeState = watchdogClient->getDomeParkState();
 
+            // When the mount is ignored it parks along with the dome, wait for both
+            if (ShutdownProcedureS[PARK_MOUNT].s == ISS_ON && MountPolicyS[MOUNT_IGNORED].s == ISS_ON)
+            {
+                IPState mountState = watchdogClient->getMountParkState();
+                if (mountState != IPS_OK && mountState != IPS_IDLE)
+                    break;
+            }
+
             if (domeState == IPS_OK || domeState == IPS_IDLE)
             {
                 LOG_INFO("Dome parked.");
@@ -676,23 +697,98 @@ void WatchDog::TimerHit()
             LOG_INFO("Shutdown procedure complete.");
             ShutdownProcedureSP.s = IPS_OK;
             IDSetSwitch(&ShutdownProcedureSP, nullptr);
-            // If watch dog client still connected, keep it as such
-            if (watchdogClient->isConnected())
-                m_ShutdownStage = WATCHDOG_CLIENT_STARTED;
-            // If server is shutdown, then we reset to IDLE
-            else
-                m_ShutdownStage = WATCHDOG_IDLE;
+            updateLatency(LATENCY_COMPLETE);
+            LatencyNP.s = IPS_OK;
+            IDSetNumber(&LatencyNP, nullptr);
+            // The next shutdown reuses the client session if it is still open
+            m_ShutdownStage = WATCHDOG_IDLE;
             return;
 
         case WATCHDOG_ERROR:
             ShutdownProcedureSP.s = IPS_ALERT;
             IDSetSwitch(&ShutdownProcedureSP, nullptr);
+            LatencyNP.s = IPS_ALERT;
+            IDSetNumber(&LatencyNP, nullptr);
             return;
     }
 
     SetTimer(getCurrentPollingPeriod());
 }
 
+////////////////////////////////////////////////////////////////////////////////////
+/// Connect the client to INDI server ahead of any shutdown, watching only the park
+/// properties of the selected devices.
+////////////////////////////////////////////////////////////////////////////////////
+void WatchDog::startClient()
+{
+    if (ShutdownProcedureS[PARK_MOUNT].s == ISS_OFF && ShutdownProcedureS[PARK_DOME].s == ISS_OFF)
+        return;
+
+    if (watchdogClient->isServerConnected())
+        return;
+
+    // Watch mount if requied
+    if (ShutdownProcedureS[PARK_MOUNT].s == ISS_ON)
+        watchdogClient->setMount(ActiveDeviceT[ACTIVE_TELESCOPE].text);
+    // Watch dome
+    if (ShutdownProcedureS[PARK_DOME].s == ISS_ON)
+        watchdogClient->setDome(ActiveDeviceT[ACTIVE_DOME].text);
+
+    // Set indiserver host and port
+    watchdogClient->setServer(SettingsT[INDISERVER_HOST].text, m_INDIServerPort);
+
+    LOG_DEBUG("Connecting to INDI server...");
+
+    if (watchdogClient->connectServer() == false)
+        LOGF_WARN("Unable to connect to INDI server %s @ %s, retrying on shutdown.", SettingsT[INDISERVER_HOST].text,
+                  SettingsT[INDISERVER_PORT].text);
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+/// Settings or devices changed, reopen the session with the new ones. A new client
+/// starts with an empty watch list so devices no longer active are not requested.
+////////////////////////////////////////////////////////////////////////////////////
+void WatchDog::restartClient()
+{
+    if (!isConnected() || m_ShutdownStage != WATCHDOG_IDLE)
+        return;
+
+    // Deleting the client disconnects it and waits for its listener thread
+    delete (watchdogClient);
+    watchdogClient = new WatchDogClient();
+
+    startClient();
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+///
+////////////////////////////////////////////////////////////////////////////////////
+void WatchDog::startParking()
+{
+    if (ShutdownProcedureS[PARK_MOUNT].s == ISS_ON)
+        parkMount();
+    else if (ShutdownProcedureS[PARK_DOME].s == ISS_ON)
+        parkDome();
+    else if (ShutdownProcedureS[EXECUTE_SCRIPT].s == ISS_ON)
+        executeScript();
+
+    if (m_ShutdownStage == WATCHDOG_ERROR)
+        return;
+
+    updateLatency(LATENCY_COMMANDS);
+    IDSetNumber(&LatencyNP, nullptr);
+    LOGF_DEBUG("Shutdown commands sent %.f ms after the trigger.", LatencyN[LATENCY_COMMANDS].value);
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+///
+////////////////////////////////////////////////////////////////////////////////////
+void WatchDog::updateLatency(int index)
+{
+    LatencyN[index].value = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() -
+                            m_ShutdownStart).count();
+}
+
 void WatchDog::parkDome()
 {
     if (watchdogClient->parkDome() == false)
@@ -29,6 +29,8 @@
 
 #include "defaultdevice.h"
 
+#include <chrono>
+
 class WatchDogClient;
 
 class WatchDog : public INDI::DefaultDevice
@@ -67,9 +69,13 @@ class WatchDog : public INDI::DefaultDevice
         virtual bool saveConfigItems(FILE *fp) override;
 
     private:
+        void startClient();
+        void restartClient();
+        void startParking();
         void parkDome();
         void parkMount();
         void executeScript();
+        void updateLatency(int index);
 
         // Heart Beat to check if client is alive
         INumberVectorProperty HeartBeatNP;
@@ -102,6 +108,11 @@ class WatchDog : public INDI::DefaultDevice
         IText ActiveDeviceT[3] {};
         enum { ACTIVE_TELESCOPE, ACTIVE_DOME, ACTIVE_WEATHER };
 
+        // Time from the shutdown trigger until the park commands are sent, and until the procedure completes
+        INumberVectorProperty LatencyNP;
+        INumber LatencyN[2];
+        enum { LATENCY_COMMANDS, LATENCY_COMPLETE };
+
         // Pointer to client to issue commands to the respective mount and/or dome drivers.
         WatchDogClient *watchdogClient {nullptr};
         // Watchdog timer to ensure heart beat is there
@@ -118,4 +129,6 @@ class WatchDog : public INDI::DefaultDevice
         bool m_IsDomeParked { false };
         // State machine to store where in the shutdown procedure we currently stand
         ShutdownStages m_ShutdownStage;
+        // When the shutdown procedure was triggered
+        std::chrono::steady_clock::time_point m_ShutdownStart;
 };
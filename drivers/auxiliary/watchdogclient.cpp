@@ -53,6 +53,8 @@ void WatchDogClient::newDevice(INDI::BaseDevice *dp)
 {
     IDLog("Receiving new device: %s\n", dp->getDeviceName());
 
+    std::lock_guard<std::mutex> lock(propertyLock);
+
     if (dome.empty() || std::string(dp->getDeviceName()) == dome)
         domeOnline = true;
     if (mount.empty() || std::string(dp->getDeviceName()) == mount)
@@ -66,19 +68,69 @@ void WatchDogClient::newDevice(INDI::BaseDevice *dp)
 *************************************************************************************/
 void WatchDogClient::newProperty(INDI::Property *property)
 {
+    std::lock_guard<std::mutex> lock(propertyLock);
+
     if (!strcmp(property->getName(), "TELESCOPE_PARK"))
         mountParkSP = property->getSwitch();
     else if (!strcmp(property->getName(), "DOME_PARK"))
         domeParkSP = property->getSwitch();
 }
 
+/**************************************************************************************
+** The mount or dome driver went away, its properties are about to be freed.
+***************************************************************************************/
+void WatchDogClient::removeDevice(INDI::BaseDevice *dp)
+{
+    IDLog("Removing device: %s\n", dp->getDeviceName());
+
+    std::lock_guard<std::mutex> lock(propertyLock);
+
+    if (!mount.empty() && std::string(dp->getDeviceName()) == mount)
+    {
+        mountOnline = false;
+        mountParkSP = nullptr;
+    }
+    if (!dome.empty() && std::string(dp->getDeviceName()) == dome)
+    {
+        domeOnline = false;
+        domeParkSP = nullptr;
+    }
+
+    isReady = (domeOnline && mountOnline);
+}
+
 /**************************************************************************************
 **
 ***************************************************************************************/
+void WatchDogClient::removeProperty(INDI::Property *property)
+{
+    std::lock_guard<std::mutex> lock(propertyLock);
+
+    if (mountParkSP != nullptr && property->getSwitch() == mountParkSP)
+        mountParkSP = nullptr;
+    else if (domeParkSP != nullptr && property->getSwitch() == domeParkSP)
+        domeParkSP = nullptr;
+}
+
+/**************************************************************************************
+** Devices and properties go away with the connection, a new session defines them again.
+***************************************************************************************/
+void WatchDogClient::serverDisconnected(int exit_code)
+{
+    IDLog("Disconnected from INDI server (%d)\n", exit_code);
+
+    std::lock_guard<std::mutex> lock(propertyLock);
+    isReady = mountOnline = domeOnline = false;
+    mountParkSP = domeParkSP = nullptr;
+}
+
+/**************************************************************************************
+** Only the park property is requested so the session stays cheap while it is kept open.
+***************************************************************************************/
 void WatchDogClient::setMount(const std::string &value)
 {
     mount = value;
-    watchDevice(mount.c_str());
+    watchProperty(mount.c_str(), "TELESCOPE_PARK");
 }
 
 /**************************************************************************************
@@ -87,7 +139,7 @@ void WatchDogClient::setMount(const std::string &value)
 void WatchDogClient::setDome(const std::string &value)
 {
     dome = value;
-    watchDevice(dome.c_str());
+    watchProperty(dome.c_str(), "DOME_PARK");
 }
 
 /**************************************************************************************
@@ -95,6 +147,8 @@ void WatchDogClient::setDome(const std::string &value)
 ***************************************************************************************/
 bool WatchDogClient::parkDome()
 {
+    std::lock_guard<std::mutex> lock(propertyLock);
+
     if (domeParkSP == nullptr)
         return false;
 
@@ -118,6 +172,8 @@ bool WatchDogClient::parkDome()
 ***************************************************************************************/
 bool WatchDogClient::parkMount()
 {
+    std::lock_guard<std::mutex> lock(propertyLock);
+
     if (mountParkSP == nullptr)
         return false;
 
@@ -141,6 +197,11 @@ bool WatchDogClient::parkMount()
 ***************************************************************************************/
 IPState WatchDogClient::getDomeParkState()
 {
+    std::lock_guard<std::mutex> lock(propertyLock);
+
+    if (domeParkSP == nullptr)
+        return IPS_ALERT;
+
     return domeParkSP->s;
 }
 
@@ -149,5 +210,10 @@ IPState WatchDogClient::getDomeParkState()
 ***************************************************************************************/
 IPState WatchDogClient::getMountParkState()
 {
+    std::lock_guard<std::mutex> lock(propertyLock);
+
+    if (mountParkSP == nullptr)
+        return IPS_ALERT;
+
     return mountParkSP->s;
 }
@@ -30,6 +30,7 @@
 #include "basedevice.h"
 
 #include <cstring>
+#include <mutex>
 
 class WatchDogClient : public INDI::BaseClient
 {
@@ -50,9 +51,9 @@ class WatchDogClient : public INDI::BaseClient
 
   protected:
     virtual void newDevice(INDI::BaseDevice *dp);
-    virtual void removeDevice(INDI::BaseDevice */*dp*/) {}
+    virtual void removeDevice(INDI::BaseDevice *dp);
     virtual void newProperty(INDI::Property *property);
-    virtual void removeProperty(INDI::Property */*property*/) {}
+    virtual void removeProperty(INDI::Property *property);
     virtual void newBLOB(IBLOB */*bp*/) {}
     virtual void newSwitch(ISwitchVectorProperty */*svp*/) {}
     virtual void newNumber(INumberVectorProperty */*nvp*/) {}
@@ -60,11 +61,13 @@ class WatchDogClient : public INDI::BaseClient
     virtual void newText(ITextVectorProperty */*tvp*/) {}
     virtual void newLight(ILightVectorProperty */*lvp*/) {}
     virtual void serverConnected() {}
-    virtual void serverDisconnected(int /*exit_code*/) {}
+    virtual void serverDisconnected(int exit_code);
 
   private:
     std::string dome, mount;
     bool isReady, isRunning, domeOnline, mountOnline;
 
     ISwitchVectorProperty *mountParkSP, *domeParkSP;
+    // Properties are defined and deleted from the listener thread while the driver uses them
+    std::mutex propertyLock;
 };
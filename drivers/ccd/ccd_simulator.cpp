@@ -37,6 +37,14 @@ static pthread_mutex_t condMutex = PTHREAD_MUTEX_INITIALIZER;
 
 static std::unique_ptr<CCDSim> ccdsim(new CCDSim());
 
+// Julian day of the timers clock, so the sky follows an accelerated or stepped clock like the exposures do
+static double clockJulianDay()
+{
+    struct timeval now { 0, 0 };
+    IEGetClockTime(&now);
+    return 2440587.5 + (now.tv_sec + now.tv_usec / 1e6) / 86400.0;
+}
+
 CCDSim::CCDSim() : INDI::FilterInterface(this)
 {
     currentRA  = RA;
@@ -48,7 +56,9 @@ CCDSim::CCDSim() : INDI::FilterInterface(this)
     primaryFocalLength = 900;
     guiderFocalLength  = 300;
 
-    time(&RunStart);
+    struct timeval runStart { 0, 0 };
+    IEGetClockTime(&runStart);
+    RunStart = runStart.tv_sec;
 
     // Filter stuff
     FilterSlotN[0].min = 1;
@@ -339,7 +349,7 @@ bool CCDSim::StartExposure(float duration)
     ExposureRequest   = duration;
 
     PrimaryCCD.setExposureDuration(duration);
-    gettimeofday(&ExpStart, nullptr);
+    IEGetClockTime(&ExpStart);
     //  Leave the proper time showing for the draw routines
     if (DirectoryS[INDI_ENABLED].s == ISS_ON)
     {
@@ -361,7 +371,7 @@ bool CCDSim::StartGuideExposure(float n)
     AbortGuideFrame      = false;
     GuideCCD.setExposureDuration(n);
     DrawCcdFrame(&GuideCCD);
-    gettimeofday(&GuideExpStart, nullptr);
+    IEGetClockTime(&GuideExpStart);
     InGuideExposure = true;
     return true;
 }
@@ -393,7 +403,7 @@ float CCDSim::CalcTimeLeft(timeval start, float req)
     {
         0, 0
     };
-    gettimeofday(&now, nullptr);
+    IEGetClockTime(&now);
 
     timesince =
         (double)(now.tv_sec * 1000.0 + now.tv_usec / 1000) - (double)(start.tv_sec * 1000.0 + start.tv_usec / 1000);
@@ -563,11 +573,11 @@ int CCDSim::DrawCcdFrame(INDI::CCDChip * targetChip)
         if (m_PEPeriod > 0)
         {
             double timesince;
-            time_t now;
-            time(&now);
+            struct timeval now { 0, 0 };
+            IEGetClockTime(&now);
 
             //  Lets figure out where we are on the pe curve
-            timesince = difftime(now, RunStart);
+            timesince = difftime(now.tv_sec, RunStart);
             //  This is our spot in the curve
             double PESpot = timesince / m_PEPeriod;
             //  Now convert to radians
@@ -645,7 +655,7 @@ int CCDSim::DrawCcdFrame(INDI::CCDChip * targetChip)
 
             INDI::IEquatorialCoordinates epochPos { 0, 0 }, J2000Pos { 0, 0 };
 
-            double jd = ln_get_julian_from_sys();
+            double jd = clockJulianDay();
 
             epochPos.rightascension  = currentRA;
             epochPos.declination = currentDE;
@@ -1120,7 +1130,7 @@ bool CCDSim::ISNewNumber(const char * dev, const char * name, double values[], c
             RA = EqPEN[AXIS_RA].value;
             Dec = EqPEN[AXIS_DE].value;
 
-            INDI::ObservedToJ2000(&epochPos, ln_get_julian_from_sys(), &J2000Pos);
+            INDI::ObservedToJ2000(&epochPos, clockJulianDay(), &J2000Pos);
             currentRA  = J2000Pos.rightascension;
             currentDE = J2000Pos.declination;
             usePE = true;
@@ -1328,7 +1338,7 @@ bool CCDSim::ISSnoopDevice(XMLEle * root)
             INDI::IEquatorialCoordinates epochPos { 0, 0 }, J2000Pos { 0, 0 };
             epochPos.ra  = newra * 15.0;
             epochPos.dec = newdec;
-            ln_get_equ_prec2(&epochPos, ln_get_julian_from_sys(), JD2000, &J2000Pos);
+            ln_get_equ_prec2(&epochPos, clockJulianDay(), JD2000, &J2000Pos);
             raPE  = J2000Pos.ra / 15.0;
             decPE = J2000Pos.dec;
             usePE = true;
@@ -1453,7 +1463,9 @@ void * CCDSim::streamVideoHelper(void * context)
 
 void * CCDSim::streamVideo()
 {
-    auto start = std::chrono::high_resolution_clock::now();
+    // Frames are paced on the timers clock, like the exposures
+    struct timeval start { 0, 0 };
+    IEGetClockTime(&start);
 
     while (true)
     {
@@ -1477,16 +1489,17 @@ void * CCDSim::streamVideo()
 
         PrimaryCCD.binFrame();
 
-        auto finish = std::chrono::high_resolution_clock::now();
-        std::chrono::duration<double> elapsed = finish - start;
+        struct timeval finish { 0, 0 };
+        IEGetClockTime(&finish);
+        double elapsed = finish.tv_sec - start.tv_sec + (finish.tv_usec - start.tv_usec) / 1e6;
 
-        if (elapsed.count() < ExposureRequest)
-            usleep(fabs(ExposureRequest - elapsed.count()) * 1e6);
+        if (elapsed < ExposureRequest)
+            IEClockSleep(static_cast<int>((ExposureRequest - elapsed) * 1000));
 
         uint32_t size = PrimaryCCD.getFrameBufferSize() / (PrimaryCCD.getBinX() * PrimaryCCD.getBinY());
         Streamer->newFrame(PrimaryCCD.getFrameBuffer(), size);
 
-        start = std::chrono::high_resolution_clock::now();
+        IEGetClockTime(&start);
     }
 
     pthread_mutex_unlock(&condMutex);
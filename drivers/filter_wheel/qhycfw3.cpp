@@ -24,6 +24,7 @@
 
 #include <cstring>
 #include <memory>
+#include <termios.h>
 
 // We declare an auto pointer to QHYCFW3.
 static std::unique_ptr<QHYCFW3> qhycfw(new QHYCFW3());
@@ -32,6 +33,9 @@ QHYCFW3::QHYCFW3()
 {
     setVersion(1, 1);
     setFilterConnection(CONNECTION_SERIAL | CONNECTION_TCP);
+
+    // The end of a move is reported by the wheel
+    m_FilterMotion.setEventDriven(true);
 }
 
 const char *QHYCFW3::getDefaultName()
@@ -158,47 +162,111 @@ bool QHYCFW3::Handshake()
     return true;
 }
 
+bool QHYCFW3::Disconnect()
+{
+    cancelMove();
+    return INDI::FilterWheel::Disconnect();
+}
+
 bool QHYCFW3::SelectFilter(int f)
 {
+    cancelMove();
+
     TargetFilter = f;
-    char cmd[8] = {0}, res[8] = {0};
-    int rc = -1, nbytes_written = 0, nbytes_read = 0;
+    char cmd[8] = {0};
+    int rc = -1, nbytes_written = 0;
 
     LOGF_DEBUG("CMD <%d>", TargetFilter - 1);
 
     snprintf(cmd, 2, "%d", TargetFilter - 1);
 
     if (isSimulation())
-        snprintf(res, 8, "%d", TargetFilter - 1);
-    else
     {
-        if ((rc = tty_write_string(PortFD, cmd, &nbytes_written)) != TTY_OK)
-        {
-            char error_message[ERRMSG_SIZE];
-            tty_error_msg(rc, error_message, ERRMSG_SIZE);
+        CurrentFilter = TargetFilter;
+        SelectFilterDone(CurrentFilter);
+        return true;
+    }
+
+    tcflush(PortFD, TCIFLUSH);
+
+    if ((rc = tty_write_string(PortFD, cmd, &nbytes_written)) != TTY_OK)
+    {
+        char error_message[ERRMSG_SIZE];
+        tty_error_msg(rc, error_message, ERRMSG_SIZE);
+
+        LOGF_ERROR("Sending command select filter failed: %s", error_message);
+        return false;
+    }
 
-            LOGF_ERROR("Sending command select filter failed: %s", error_message);
-            return false;
-        }
+    moveCallbackID = IEAddCallback(PortFD, &QHYCFW3::moveResponseHelper, this);
+    moveTimerID    = IEAddTimer(MOVE_TIMEOUT, &QHYCFW3::moveTimeoutHelper, this);
 
-        if ((rc = tty_read(PortFD, res, 1, 30, &nbytes_read)) != TTY_OK)
-        {
-            char error_message[ERRMSG_SIZE];
-            tty_error_msg(rc, error_message, ERRMSG_SIZE);
+    return true;
+}
 
-            LOGF_ERROR("Reading select filter response failed: %s", error_message);
-            return false;
-        }
+void QHYCFW3::moveResponseHelper(int fd, void *context)
+{
+    INDI_UNUSED(fd);
+    static_cast<QHYCFW3 *>(context)->moveResponse();
+}
 
-        LOGF_DEBUG("RES <%s>", res);
+void QHYCFW3::moveTimeoutHelper(void *context)
+{
+    static_cast<QHYCFW3 *>(context)->moveTimeout();
+}
+
+void QHYCFW3::moveResponse()
+{
+    char res[8] = {0};
+    int rc = -1, nbytes_read = 0;
+
+    cancelMove();
+
+    if ((rc = tty_read(PortFD, res, 1, 1, &nbytes_read)) != TTY_OK)
+    {
+        char error_message[ERRMSG_SIZE];
+        tty_error_msg(rc, error_message, ERRMSG_SIZE);
+
+        LOGF_ERROR("Reading select filter response failed: %s", error_message);
+        FilterSlotNP.s = IPS_ALERT;
+        IDSetNumber(&FilterSlotNP, nullptr);
+        return;
     }
 
+    LOGF_DEBUG("RES <%s>", res);
+
     if (atoi(res) + 1 == TargetFilter)
     {
         CurrentFilter = TargetFilter;
         SelectFilterDone(CurrentFilter);
-        return true;
+        return;
     }
 
-    return false;
+    LOGF_ERROR("Wheel reported slot %d instead of %d.", atoi(res) + 1, TargetFilter);
+    FilterSlotNP.s = IPS_ALERT;
+    IDSetNumber(&FilterSlotNP, nullptr);
+}
+
+void QHYCFW3::moveTimeout()
+{
+    moveTimerID = -1;
+    cancelMove();
+
+    LOG_ERROR("Timed out waiting for the wheel to reach the filter.");
+    FilterSlotNP.s = IPS_ALERT;
+    IDSetNumber(&FilterSlotNP, nullptr);
+}
+
+void QHYCFW3::cancelMove()
+{
+    if (moveCallbackID != -1)
+    {
+        IERmCallback(moveCallbackID);
+        moveCallbackID = -1;
+    }
+    if (moveTimerID != -1)
+    {
+        IERmTimer(moveTimerID);
+        moveTimerID = -1;
+    }
 }
@@ -32,5 +32,18 @@ class QHYCFW3 : public INDI::FilterWheel
     bool initProperties() override;
 
     bool Handshake() override;
+    bool Disconnect() override;
     bool SelectFilter(int) override;
+
+  private:
+    static void moveResponseHelper(int fd, void *context);
+    static void moveTimeoutHelper(void *context);
+    void moveResponse();
+    void moveTimeout();
+    void cancelMove();
+
+    // The wheel answers a move once it reaches the slot, the answer is read from the event loop
+    int moveCallbackID { -1 };
+    int moveTimerID { -1 };
+    static constexpr const int MOVE_TIMEOUT { 30000 };
 };
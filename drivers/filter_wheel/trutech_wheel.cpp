@@ -211,5 +211,5 @@ void TruTech::TimerHit()
         }
     }
 
-    SetTimer(getCurrentPollingPeriod());
+    SetTimer(getFilterPollingPeriod());
 }
@@ -817,7 +817,7 @@ void DMFC::TimerHit()
         }
     }
 
-    SetTimer(getCurrentPollingPeriod());
+    SetTimer(getFocusPollingPeriod());
 }
 
 bool DMFC::AbortFocuser()
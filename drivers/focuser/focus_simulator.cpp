@@ -34,7 +34,11 @@ static std::unique_ptr<FocusSim> focusSim(new FocusSim());
 ************************************************************************************/
 FocusSim::FocusSim()
 {
-    FI::SetCapability(FOCUSER_CAN_ABS_MOVE | FOCUSER_CAN_REL_MOVE | FOCUSER_HAS_VARIABLE_SPEED | FOCUSER_HAS_BACKLASH);
+    FI::SetCapability(FOCUSER_CAN_ABS_MOVE | FOCUSER_CAN_REL_MOVE | FOCUSER_CAN_ABORT | FOCUSER_HAS_VARIABLE_SPEED |
+                      FOCUSER_HAS_BACKLASH);
+
+    // Absolute moves complete on their own, like focusers reporting their status without being polled
+    m_FocusMotion.setEventDriven(true);
 }
 
 /************************************************************************************
@@ -51,6 +55,11 @@ bool FocusSim::Connect()
 ************************************************************************************/
 bool FocusSim::Disconnect()
 {
+    if (motionTimerID != -1)
+    {
+        IERmTimer(motionTimerID);
+        motionTimerID = -1;
+    }
     return true;
 }
 
@@ -155,15 +164,15 @@ bool FocusSim::ISNewSwitch(const char *dev, const char *name, ISState *states, c
             switch (index)
             {
                 case MODE_ALL:
-                    cap = FOCUSER_CAN_ABS_MOVE | FOCUSER_CAN_REL_MOVE | FOCUSER_HAS_VARIABLE_SPEED;
+                    cap = FOCUSER_CAN_ABS_MOVE | FOCUSER_CAN_REL_MOVE | FOCUSER_CAN_ABORT | FOCUSER_HAS_VARIABLE_SPEED;
                     break;
 
                 case MODE_ABSOLUTE:
-                    cap = FOCUSER_CAN_ABS_MOVE;
+                    cap = FOCUSER_CAN_ABS_MOVE | FOCUSER_CAN_ABORT;
                     break;
 
                 case MODE_RELATIVE:
-                    cap = FOCUSER_CAN_REL_MOVE;
+                    cap = FOCUSER_CAN_REL_MOVE | FOCUSER_CAN_ABORT;
                     break;
 
                 case MODE_TIMER:
@@ -238,7 +247,7 @@ IPState FocusSim::MoveFocuser(FocusDirection dir, int speed, uint16_t duration)
     }
 
     // simulate delay in motion as the focuser moves to the new position
-    usleep(duration * 1000);
+    IEClockSleep(duration);
 
     double ticks = initTicks + (internalTicks - mid) / 5000.0;
 
@@ -266,17 +275,55 @@ IPState FocusSim::MoveFocuser(FocusDirection dir, int speed, uint16_t duration)
 ************************************************************************************/
 IPState FocusSim::MoveAbsFocuser(uint32_t targetTicks)
 {
-    double mid = (FocusAbsPosN[0].max - FocusAbsPosN[0].min) / 2;
+    // A new target replaces the move in progress
+    if (motionTimerID != -1)
+        IERmTimer(motionTimerID);
 
     internalTicks = targetTicks;
+    motionTarget  = targetTicks;
 
-    // Limit to +/- 10 from initTicks
-    double ticks = initTicks + (targetTicks - mid) / 5000.0;
+    // simulate delay in motion as the focuser moves to the new position, the end of the move is reported from the event loop
+    int duration = std::abs((int)(targetTicks - FocusAbsPosN[0].value) * FOCUS_MOTION_DELAY) / 1000;
+    motionTimerID = IEAddTimer(duration, &FocusSim::motionDoneHelper, this);
 
-    // simulate delay in motion as the focuser moves to the new position
-    usleep(std::abs((int)(targetTicks - FocusAbsPosN[0].value) * FOCUS_MOTION_DELAY));
+    return IPS_BUSY;
+}
+
+/************************************************************************************
+ *
+************************************************************************************/
+bool FocusSim::AbortFocuser()
+{
+    // The focuser stays where it was, the move in progress never completes
+    if (motionTimerID != -1)
+    {
+        IERmTimer(motionTimerID);
+        motionTimerID = -1;
+    }
+    internalTicks = FocusAbsPosN[0].value;
+    m_FocusMotion.finish();
+    return true;
+}
+
+/************************************************************************************
+ *
+************************************************************************************/
+void FocusSim::motionDoneHelper(void *context)
+{
+    static_cast<FocusSim *>(context)->motionDone();
+}
+
+/************************************************************************************
+ *
+************************************************************************************/
+void FocusSim::motionDone()
+{
+    motionTimerID = -1;
 
-    FocusAbsPosN[0].value = targetTicks;
+    double mid = (FocusAbsPosN[0].max - FocusAbsPosN[0].min) / 2;
+
+    // Limit to +/- 10 from initTicks
+    double ticks = initTicks + (motionTarget - mid) / 5000.0;
 
     FWHMN[0].value = 0.5625 * ticks * ticks + SeeingN[0].value;
 
@@ -288,7 +335,7 @@ IPState FocusSim::MoveAbsFocuser(uint32_t targetTicks)
 
     IDSetNumber(&FWHMNP, nullptr);
 
-    return IPS_OK;
+    MoveFocuserDone(motionTarget);
 }
 
 /************************************************************************************
@@ -54,13 +54,19 @@ class FocusSim : public INDI::Focuser
         virtual IPState MoveFocuser(FocusDirection dir, int speed, uint16_t duration) override;
         virtual IPState MoveAbsFocuser(uint32_t targetTicks) override;
         virtual IPState MoveRelFocuser(FocusDirection dir, uint32_t ticks) override;
+        virtual bool AbortFocuser() override;
         virtual bool SetFocuserSpeed(int speed) override;
 
         virtual bool SetFocuserBacklash(int32_t steps) override;
         virtual bool SetFocuserBacklashEnabled(bool enabled) override;
 
     private:
+        static void motionDoneHelper(void *context);
+        void motionDone();
+
         double internalTicks { 0 };
+        uint32_t motionTarget { 0 };
+        int motionTimerID { -1 };
         double initTicks { 0 };
 
         // Seeing in arcseconds
@@ -538,7 +538,7 @@ void MoonLite::TimerHit()
         }
     }
 
-    SetTimer(getCurrentPollingPeriod());
+    SetTimer(getFocusPollingPeriod());
 }
 
 bool MoonLite::AbortFocuser()
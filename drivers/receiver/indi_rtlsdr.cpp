@@ -288,7 +288,7 @@ bool RTLSDR::ISNewNumber(const char *dev, const char *name, double values[], cha
         IUUpdateNumber(&ReceiverSettingsNP, values, names, n);
         IDSetNumber(&ReceiverSettingsNP, nullptr);
     }
-    return processNumber(dev, name, values, names, n) & !r;
+    return INDI::Receiver::ISNewNumber(dev, name, values, names, n) & !r;
 }
 
 /**************************************************************************************
@@ -379,7 +379,9 @@ void RTLSDR::grabData()
         continuum = getBuffer();
         if (n_read > 0)
         {
-            memcpy(continuum + b_read, buffer, n_read);
+            // The spectrometer integrates the 8 bits I/Q samples as they come, the buffer is only filled for raw uploads
+            if (streamPredicate || !addSamples(buffer, n_read, 8))
+                memcpy(continuum + b_read, buffer, n_read);
             b_read += n_read;
             to_read -= n_read;
         }
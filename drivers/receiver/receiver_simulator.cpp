@@ -18,13 +18,16 @@
 */
 
 #include "receiver_simulator.h"
+#include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <unistd.h>
 #include <indilogger.h>
 #include <memory>
 
 #define SPECTRUM_SIZE (256)
+#define SIMULATOR_BLOCK_SIZE (16384)
 #define min(a,b) \
   ({ __typeof__ (a) _a = (a); \
       __typeof__ (b) _b = (b); \
@@ -163,7 +166,7 @@ bool RadioSim::ISNewNumber(const char *dev, const char *name, double values[], c
         }
         IDSetNumber(&ReceiverSettingsNP, nullptr);
     }
-    return processNumber(dev, name, values, names, n) & !r;
+    return INDI::Receiver::ISNewNumber(dev, name, values, names, n) & !r;
 }
 
 /**************************************************************************************
@@ -262,10 +265,27 @@ void RadioSim::grabData()
         uint8_t* continuum;
         int size = getBufferSize();
 
-        //Fill the continuum
+        // 16 bits I/Q noise with the hydrogen line as a faint tone when it is within the band
+        const double hydrogenLine = 1420405751.768;
+        double offset = hydrogenLine - getFrequency();
+        double amplitude = fabs(offset) < getSampleRate() / 2 ? 1000 : 0;
+        double step = 2 * M_PI * offset / getSampleRate();
+
+        //Fill the continuum, the spectrometer integrates it block by block
         continuum = getBuffer();
-        for(int i = 0; i < size; i++)
-            continuum[i] = rand() % 255;
+        int16_t block[2 * SIMULATOR_BLOCK_SIZE];
+        int samples = size / static_cast<int>(sizeof(int16_t) * 2);
+        for(int first = 0; first < samples; first += SIMULATOR_BLOCK_SIZE) {
+            int count = min(SIMULATOR_BLOCK_SIZE, samples - first);
+            for(int i = 0; i < count; i++) {
+                double phase = step * (first + i);
+                block[2 * i]     = amplitude * cos(phase) + (rand() % 8192) - 4096;
+                block[2 * i + 1] = amplitude * sin(phase) + (rand() % 8192) - 4096;
+            }
+            int len = count * sizeof(int16_t) * 2;
+            if(streamPredicate || !addSamples(reinterpret_cast<uint8_t*>(block), len))
+                memcpy(continuum + first * sizeof(int16_t) * 2, block, len);
+        }
 
         LOG_INFO("Download complete.");
         IntegrationComplete();
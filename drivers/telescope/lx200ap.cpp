@@ -1236,6 +1236,27 @@ bool LX200AstroPhysics::updateAPSlewRate(int index)
 // AP mounts handle guide commands differently enough from the "generic" LX200 we need to override some
 // functions related to the GuiderInterface
 
+bool LX200AstroPhysics::Abort()
+{
+    if (LX200Generic::Abort() == false)
+        return false;
+
+    // Guide pulses are timed with event loop timers here, not with the pulse scheduler
+    if (GuideNSTID)
+    {
+        IERmTimer(GuideNSTID);
+        GuideNSTID = 0;
+    }
+
+    if (GuideWETID)
+    {
+        IERmTimer(GuideWETID);
+        GuideWETID = 0;
+    }
+
+    return true;
+}
+
 IPState LX200AstroPhysics::GuideNorth(uint32_t ms)
 {
     // If we're using pulse command, then MovementXXX should NOT be active at all.
@@ -1153,6 +1153,27 @@ bool LX200AstroPhysicsV2::updateAPSlewRate(int index)
 // AP mounts handle guide commands differently enough from the "generic" LX200 we need to override some
 // functions related to the GuiderInterface
 
+bool LX200AstroPhysicsV2::Abort()
+{
+    if (LX200Generic::Abort() == false)
+        return false;
+
+    // Guide pulses are timed with event loop timers here, not with the pulse scheduler
+    if (GuideNSTID)
+    {
+        IERmTimer(GuideNSTID);
+        GuideNSTID = 0;
+    }
+
+    if (GuideWETID)
+    {
+        IERmTimer(GuideWETID);
+        GuideWETID = 0;
+    }
+
+    return true;
+}
+
 IPState LX200AstroPhysicsV2::GuideNorth(uint32_t ms)
 {
     if (!isAPReady())
@@ -75,6 +75,8 @@ class LX200AstroPhysicsV2 : public LX200Generic
         virtual bool SetSlewRate(int index) override;
         bool updateAPSlewRate(int index);
 
+        virtual bool Abort() override;
+
         // Guide Commands
         virtual IPState GuideNorth(uint32_t ms) override;
         virtual IPState GuideSouth(uint32_t ms) override;
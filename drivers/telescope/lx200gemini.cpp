@@ -133,6 +133,14 @@ bool LX200Gemini::initProperties()
     IUFillSwitch(&TrackModeS[GEMINI_TRACK_LUNAR], "TRACK_LUNAR", "Lunar", ISS_OFF);
     IUFillSwitch(&TrackModeS[GEMINI_TRACK_SOLAR], "TRACK_SOLAR", "Solar", ISS_OFF);
 
+    // Side of pier only changes on a slew, no need to query it on every status read
+    m_PollScheduler.addQuantity(PIER_SIDE_QUANTITY, [this]()
+    {
+        if (!isSimulation() && !m_isSleeping)
+            syncSideOfPier();
+        return true;
+    }, 5);
+
     return true;
 }
 
@@ -452,6 +460,9 @@ bool LX200Gemini::ReadScopeStatus()
             IDSetNumber(&EqNP, NULL);
 
             LOG_INFO("Slew is complete. Tracking...");
+
+            // Pick up a meridian flip right away
+            m_PollScheduler.invalidate(PIER_SIDE_QUANTITY);
         }
     }
     else if (TrackState == SCOPE_PARKING)
@@ -479,8 +490,6 @@ bool LX200Gemini::ReadScopeStatus()
 
     NewRaDec(currentRA, currentDEC);
 
-    syncSideOfPier();
-
     return true;
 }
 
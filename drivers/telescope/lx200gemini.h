@@ -130,6 +130,7 @@ class LX200Gemini : public LX200Generic
         };
 
         const uint8_t GEMINI_TIMEOUT = 3;
+        static constexpr const char *PIER_SIDE_QUANTITY {"PIER_SIDE"};
 
         void setTrackState(INDI::Telescope::TelescopeStatus state);
         void updateParkingState();
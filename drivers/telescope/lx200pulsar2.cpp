@@ -2495,6 +2495,16 @@ bool LX200Pulsar2::Abort()
 }
 
 
+void LX200Pulsar2::guideTimeoutHelperNS(void *p)
+{
+    static_cast<LX200Pulsar2 *>(p)->guideTimeoutNS();
+}
+
+void LX200Pulsar2::guideTimeoutHelperWE(void *p)
+{
+    static_cast<LX200Pulsar2 *>(p)->guideTimeoutWE();
+}
+
 IPState LX200Pulsar2::GuideNorth(uint32_t ms)
 {
     if (!usePulseCommand && (MovementNSSP.s == IPS_BUSY || MovementWESP.s == IPS_BUSY))
@@ -59,6 +59,8 @@ class LX200Pulsar2 : public LX200Generic
     virtual IPState GuideSouth(uint32_t ms) override;
     virtual IPState GuideEast(uint32_t ms) override;
     virtual IPState GuideWest(uint32_t ms) override;
+    static void guideTimeoutHelperNS(void *p);
+    static void guideTimeoutHelperWE(void *p);
 
     virtual bool updateTime(ln_date *utc, double utc_offset) override;
     virtual bool updateLocation(double latitude, double longitude, double elevation) override;
@@ -220,6 +220,7 @@ bool LX200Telescope::updateProperties()
 
         defineProperty(&GuideNSNP);
         defineProperty(&GuideWENP);
+        defineProperty(&GuidePulseErrorNP);
 
         if (genericCapability & LX200_HAS_FOCUS)
         {
@@ -248,6 +249,7 @@ bool LX200Telescope::updateProperties()
 
         deleteProperty(GuideNSNP.name);
         deleteProperty(GuideWENP.name);
+        deleteProperty(GuidePulseErrorNP.name);
 
         if (genericCapability & LX200_HAS_FOCUS)
         {
@@ -402,6 +404,9 @@ bool LX200Telescope::Goto(double ra, double dec)
     TrackState = SCOPE_SLEWING;
     //EqNP.s     = IPS_BUSY;
 
+    // Do not wait for a possibly long idle period to notice the slew
+    boostPolling(getCurrentPollingPeriod());
+
     LOGF_INFO("Slewing to RA: %s - DEC: %s", RAStr, DecStr);
 
     return true;
@@ -483,6 +488,8 @@ bool LX200Telescope::Park()
 
     TrackState = SCOPE_PARKING;
     LOG_INFO("Parking telescope in progress...");
+
+    boostPolling(getCurrentPollingPeriod());
     return true;
 }
 
@@ -501,6 +508,7 @@ bool LX200Telescope::MoveNS(INDI_DIR_NS dir, TelescopeMotionCommand command)
             else
                 LOGF_DEBUG("Moving toward %s.",
                            (current_move == LX200_NORTH) ? "North" : "South");
+            boostPolling(getCurrentPollingPeriod());
             break;
 
         case MOTION_STOP:
@@ -532,6 +540,7 @@ bool LX200Telescope::MoveWE(INDI_DIR_WE dir, TelescopeMotionCommand command)
             }
             else
                 LOGF_DEBUG("Moving toward %s.", (current_move == LX200_WEST) ? "West" : "East");
+            boostPolling(getCurrentPollingPeriod());
             break;
 
         case MOTION_STOP:
@@ -563,17 +572,7 @@ bool LX200Telescope::Abort()
         GuideNSN[0].value = GuideNSN[1].value = 0.0;
         GuideWEN[0].value = GuideWEN[1].value = 0.0;
 
-        if (GuideNSTID)
-        {
-            IERmTimer(GuideNSTID);
-            GuideNSTID = 0;
-        }
-
-        if (GuideWETID)
-        {
-            IERmTimer(GuideWETID);
-            GuideNSTID = 0;
-        }
+        abortPulses();
 
         LOG_INFO("Guide aborted.");
         IDSetNumber(&GuideNSNP, nullptr);
@@ -1447,12 +1446,6 @@ IPState LX200Telescope::GuideNorth(uint32_t ms)
         return IPS_ALERT;
     }
 
-    if (GuideNSTID)
-    {
-        IERmTimer(GuideNSTID);
-        GuideNSTID = 0;
-    }
-
     if (usePulseCommand)
     {
         SendPulseCmd(LX200_NORTH, ms);
@@ -1467,7 +1460,7 @@ IPState LX200Telescope::GuideNorth(uint32_t ms)
     }
 
     guide_direction_ns = LX200_NORTH;
-    GuideNSTID      = IEAddTimer(static_cast<int>(ms), guideTimeoutHelperNS, this);
+    schedulePulse(AXIS_DE, ms, guideStop(LX200_NORTH));
     return IPS_BUSY;
 }
 
@@ -1486,12 +1479,6 @@ IPState LX200Telescope::GuideSouth(uint32_t ms)
         return IPS_ALERT;
     }
 
-    if (GuideNSTID)
-    {
-        IERmTimer(GuideNSTID);
-        GuideNSTID = 0;
-    }
-
     if (usePulseCommand)
     {
         SendPulseCmd(LX200_SOUTH, ms);
@@ -1506,7 +1493,7 @@ IPState LX200Telescope::GuideSouth(uint32_t ms)
     }
 
     guide_direction_ns = LX200_SOUTH;
-    GuideNSTID      = IEAddTimer(static_cast<int>(ms), guideTimeoutHelperNS, this);
+    schedulePulse(AXIS_DE, ms, guideStop(LX200_SOUTH));
     return IPS_BUSY;
 }
 
@@ -1525,12 +1512,6 @@ IPState LX200Telescope::GuideEast(uint32_t ms)
         return IPS_ALERT;
     }
 
-    if (GuideWETID)
-    {
-        IERmTimer(GuideWETID);
-        GuideWETID = 0;
-    }
-
     if (usePulseCommand)
     {
         SendPulseCmd(LX200_EAST, ms);
@@ -1545,7 +1526,7 @@ IPState LX200Telescope::GuideEast(uint32_t ms)
     }
 
     guide_direction_we = LX200_EAST;
-    GuideWETID      = IEAddTimer(static_cast<int>(ms), guideTimeoutHelperWE, this);
+    schedulePulse(AXIS_RA, ms, guideStop(LX200_EAST));
     return IPS_BUSY;
 }
 
@@ -1564,12 +1545,6 @@ IPState LX200Telescope::GuideWest(uint32_t ms)
         return IPS_ALERT;
     }
 
-    if (GuideWETID)
-    {
-        IERmTimer(GuideWETID);
-        GuideWETID = 0;
-    }
-
     if (usePulseCommand)
     {
         SendPulseCmd(LX200_WEST, ms);
@@ -1584,23 +1559,36 @@ IPState LX200Telescope::GuideWest(uint32_t ms)
     }
 
     guide_direction_we = LX200_WEST;
-    GuideWETID      = IEAddTimer(static_cast<int>(ms), guideTimeoutHelperWE, this);
+    schedulePulse(AXIS_RA, ms, guideStop(LX200_WEST));
     return IPS_BUSY;
 }
 
-int LX200Telescope::SendPulseCmd(int8_t direction, uint32_t duration_msec)
+std::function<void()> LX200Telescope::guideStop(int8_t direction)
 {
-    return ::SendPulseCmd(PortFD, direction, duration_msec);
+    // Pulse commands are timed by the mount itself
+    if (usePulseCommand || isSimulation())
+        return nullptr;
+
+    // Halt right at the deadline from the pulse scheduler thread, the motion switches are reset from the event loop
+    // in GuideComplete() afterwards. lx200driver serializes the serial port access.
+    int fd = PortFD;
+    return [fd, direction]()
+    {
+        HaltMovement(fd, direction);
+    };
 }
 
-void LX200Telescope::guideTimeoutHelperNS(void * p)
+void LX200Telescope::GuideComplete(INDI_EQ_AXIS axis)
 {
-    static_cast<LX200Telescope *>(p)->guideTimeoutNS();
+    if (axis == AXIS_DE)
+        guideTimeoutNS();
+    else
+        guideTimeoutWE();
 }
 
-void LX200Telescope::guideTimeoutHelperWE(void * p)
+int LX200Telescope::SendPulseCmd(int8_t direction, uint32_t duration_msec)
 {
-    static_cast<LX200Telescope *>(p)->guideTimeoutWE();
+    return ::SendPulseCmd(PortFD, direction, duration_msec);
 }
 
 void LX200Telescope::guideTimeoutWE()
@@ -156,8 +156,9 @@ class LX200Telescope : public INDI::Telescope, public INDI::GuiderInterface, pub
         virtual IPState MoveFocuser(FocusDirection dir, int speed, uint16_t duration) override;
         virtual bool SetFocuserSpeed(int speed) override;
 
-        static void guideTimeoutHelperNS(void *p);
-        static void guideTimeoutHelperWE(void *p);
+        virtual void GuideComplete(INDI_EQ_AXIS axis) override;
+        std::function<void()> guideStop(int8_t direction);
+
         void guideTimeoutNS();
         void guideTimeoutWE();
 
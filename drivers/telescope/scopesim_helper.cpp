@@ -24,6 +24,10 @@
 #include "scopesim_helper.h"
 
 #include "indilogger.h"
+#include "indidevapi.h"
+
+#include <libnova/julian_day.h>
+#include <libnova/sidereal_time.h>
 
 /////////////////////////////////////////////////////////////////////
 
@@ -126,7 +130,7 @@ void Axis::update()         // called about once a second to update the position
     struct timeval currentTime { 0, 0 };
 
     /* update elapsed time since last poll, don't presume exactly POLLMS */
-    gettimeofday(&currentTime, nullptr);
+    IEGetClockTime(&currentTime);
 
     if (lastTime.tv_sec == 0 && lastTime.tv_usec == 0)
         lastTime = currentTime;
@@ -220,7 +224,11 @@ void Axis::update()         // called about once a second to update the position
 
 Angle Alignment::lst()
 {
-    return Angle(get_local_sidereal_time(longitude.Degrees360()) * 15.0);
+    // Sidereal time follows the event loop clock, like the axes, so that accelerated runs stay consistent
+    struct timeval now { 0, 0 };
+    IEGetClockTime(&now);
+    double jd = ln_get_julian_from_timet(&now.tv_sec) + now.tv_usec / 86400e6;
+    return Angle(range24(ln_get_apparent_sidereal_time(jd) + longitude.Degrees360() / 15.0) * 15.0);
 }
 
 void Alignment::mountToApparentHaDec(Angle primary, Angle secondary, Angle * apparentHa, Angle* apparentDec)
@@ -262,7 +262,7 @@ public:
 
     void Abort() {  target = position; mcRate = 0; guideDuration = 0; }
 
-    bool isSlewing;
+    bool isSlewing { false };
 
     bool isTracking() { return tracking; }
 
@@ -308,13 +308,13 @@ private:
 
     struct timeval lastTime { 0, 0 };
 
-    bool tracking;      // this allows the tracking state and rate to be set independently
+    bool tracking { false };      // this allows the tracking state and rate to be set independently
 
     AXIS_TRACK_RATE trackingRate { AXIS_TRACK_RATE::OFF };
 
     Angle rotateCentre { 90.0 };
 
-    double guideDuration;
+    double guideDuration { 0 };
     Angle guideRateDegSec;
 
     // rates are angles in degrees per second derived from the values in indicom.h
@@ -174,6 +174,7 @@ bool ScopeSim::updateProperties()
     {
         defineProperty(&GuideNSNP);
         defineProperty(&GuideWENP);
+        defineProperty(&GuidePulseErrorNP);
         defineProperty(&GuideRateNP);
         loadConfig(true, GuideRateNP.name);
 
@@ -210,6 +211,7 @@ bool ScopeSim::updateProperties()
     {
         deleteProperty(GuideNSNP.name);
         deleteProperty(GuideWENP.name);
+        deleteProperty(GuidePulseErrorNP.name);
         deleteProperty(GuideRateNP.name);
     }
 
@@ -280,22 +282,6 @@ bool ScopeSim::ReadScopeStatus()
             break;
     }
 
-    if (guidingEW && !axisPrimary.IsGuiding())
-    {
-        GuideWENP.np[0].value = 0;
-        GuideWENP.np[1].value = 0;
-        GuideComplete(INDI_EQ_AXIS::AXIS_RA);
-        guidingEW = false;
-    }
-
-    if (guidingNS && !axisSecondary.IsGuiding())
-    {
-        GuideNSNP.np[0].value = 0;
-        GuideNSNP.np[1].value = 0;
-        GuideComplete(INDI_EQ_AXIS::AXIS_DE);
-        guidingNS = false;
-    }
-
 #ifdef USE_SIM_TAB
     double axisRA = axisPrimary.position.Degrees();
     double axisDE = axisSecondary.position.Degrees();
@@ -533,7 +519,7 @@ IPState ScopeSim::GuideNorth(uint32_t ms)
 {
     double rate = GuideRateN[DEC_AXIS].value;
     axisSecondary.StartGuide(rate, ms);
-    guidingNS = true;
+    schedulePulse(AXIS_DE, ms);
     return IPS_BUSY;
 }
 
@@ -541,7 +527,7 @@ IPState ScopeSim::GuideSouth(uint32_t ms)
 {
     double rate = GuideRateN[DEC_AXIS].value;
     axisSecondary.StartGuide(-rate, ms);
-    guidingNS = true;
+    schedulePulse(AXIS_DE, ms);
     return IPS_BUSY;
 }
 
@@ -549,7 +535,7 @@ IPState ScopeSim::GuideEast(uint32_t ms)
 {
     double rate = GuideRateN[RA_AXIS].value;
     axisPrimary.StartGuide(-rate, ms);
-    guidingEW = true;
+    schedulePulse(AXIS_RA, ms);
     return IPS_BUSY;
 }
 
@@ -557,7 +543,7 @@ IPState ScopeSim::GuideWest(uint32_t ms)
 {
     double rate = GuideRateN[RA_AXIS].value;
     axisPrimary.StartGuide(rate, ms);
-    guidingEW = true;
+    schedulePulse(AXIS_RA, ms);
     return IPS_BUSY;
 }
 
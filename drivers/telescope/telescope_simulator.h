@@ -100,9 +100,6 @@ class ScopeSim : public INDI::Telescope, public INDI::GuiderInterface
         //    double guiderEWTarget[2];
         //    double guiderNSTarget[2];
 
-        bool guidingNS = false;
-        bool guidingEW = false;
-
         INumber GuideRateN[2];
         INumberVectorProperty GuideRateNP;
 
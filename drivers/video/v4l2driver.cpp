@@ -221,6 +221,12 @@ bool V4L2_Driver::initProperties()
     IUFillTextVector(&CaptureColorSpaceTP, CaptureColorSpaceT, NARRAY(CaptureColorSpaceT), getDeviceName(),
                      "V4L2_COLORSPACE", "ColorSpace", IMAGE_INFO_TAB, IP_RO, 0, IPS_IDLE);
 
+    /* Capture Statistics */
+    IUFillNumber(&CaptureStatsN[CAPTURE_DROPPED_FRAMES], "DROPPED_FRAMES", "Dropped frames", "%.f", 0, 0, 0, 0);
+    IUFillNumber(&CaptureStatsN[CAPTURE_SEQUENCE_GAPS], "SEQUENCE_GAPS", "Skipped by device", "%.f", 0, 0, 0, 0);
+    IUFillNumberVector(&CaptureStatsNP, CaptureStatsN, NARRAY(CaptureStatsN), getDeviceName(), "V4L2_CAPTURE_STATS",
+                       "Capture Stats", IMAGE_INFO_TAB, IP_RO, 0, IPS_IDLE);
+
     /* Color Processing */
     IUFillSwitch(&ColorProcessingS[0], "Quantization", "", ISS_ON);
     IUFillSwitch(&ColorProcessingS[1], "Color Conversion", "", ISS_OFF);
@@ -281,6 +287,7 @@ void V4L2_Driver::ISGetProperties(const char * dev)
             defineProperty(&FrameRateNP);
 
         defineProperty(&StackModeSP);
+        defineProperty(&CaptureStatsNP);
 
 #ifdef WITH_V4L2_EXPERIMENTS
         defineProperty(&ImageDepthSP);
@@ -312,6 +319,7 @@ bool V4L2_Driver::updateProperties()
             defineProperty(&FrameRateNP);
 
         defineProperty(&StackModeSP);
+        defineProperty(&CaptureStatsNP);
 
 #ifdef WITH_V4L2_EXPERIMENTS
         defineProperty(&ImageDepthSP);
@@ -399,6 +407,7 @@ bool V4L2_Driver::updateProperties()
         v4loptions = 0;
 
         deleteProperty(StackModeSP.name);
+        deleteProperty(CaptureStatsNP.name);
 
 #ifdef WITH_V4L2_EXPERIMENTS
         deleteProperty(ImageDepthSP.name);
@@ -1165,6 +1174,7 @@ bool V4L2_Driver::start_capturing(bool do_stream)
         {
             gettimeofday(&frame_received, nullptr);
             v4l_capture_started = true;
+            updateCaptureStats();
         }
     }
 
@@ -1198,6 +1208,11 @@ bool V4L2_Driver::stop_capturing()
         LOGF_WARN("V4L2 base failed stopping capture (%s)", errmsg);
     }
 
+    if (v4l_base->getDroppedFrames() > 0 || v4l_base->getSequenceGaps() > 0)
+        LOGF_DEBUG("Capture dropped %llu frames, device skipped %llu frames",
+                   (unsigned long long)v4l_base->getDroppedFrames(), (unsigned long long)v4l_base->getSequenceGaps());
+    updateCaptureStats();
+
     is_capturing = false;
     v4l_capture_started = false;
     return true;
@@ -1299,6 +1314,52 @@ void V4L2_Driver::newFrame(void * p)
     ((V4L2_Driver *)(p))->newFrame();
 }
 
+void V4L2_Driver::captureError(const char * errmsg, void * p)
+{
+    ((V4L2_Driver *)(p))->captureError(errmsg);
+}
+
+/** @internal The device failed while capturing, V4L2 base already stopped streaming.
+ *  Fail the running exposure or stop the stream so the client knows capture ended.
+ */
+void V4L2_Driver::captureError(const char * errmsg)
+{
+    LOGF_ERROR("Capture stopped on device error: %s", errmsg);
+
+    bool exposing = is_capturing && !Streamer->isBusy();
+    if (Streamer->isBusy())
+        Streamer->setStream(false);
+
+    if (-1 != stdtimer)
+    {
+        IERmTimer(stdtimer);
+        stdtimer = -1;
+    }
+    if (exposing)
+        PrimaryCCD.setExposureFailed();
+
+    updateCaptureStats();
+    is_capturing        = false;
+    v4l_capture_started = false;
+}
+
+/** @internal Publish the capture loss counters, only when they changed so streaming does not flood clients.
+ */
+void V4L2_Driver::updateCaptureStats()
+{
+    double dropped = v4l_base->getDroppedFrames();
+    double gaps    = v4l_base->getSequenceGaps();
+
+    if (CaptureStatsNP.s != IPS_IDLE && dropped == CaptureStatsN[CAPTURE_DROPPED_FRAMES].value &&
+            gaps == CaptureStatsN[CAPTURE_SEQUENCE_GAPS].value)
+        return;
+
+    CaptureStatsN[CAPTURE_DROPPED_FRAMES].value = dropped;
+    CaptureStatsN[CAPTURE_SEQUENCE_GAPS].value  = gaps;
+    CaptureStatsNP.s = IPS_OK;
+    IDSetNumber(&CaptureStatsNP, nullptr);
+}
+
 /** @internal Stack normalized luminance pixels coming from the camera in an accumulator frame.
  */
 void V4L2_Driver::stackFrame()
@@ -1351,6 +1412,7 @@ void V4L2_Driver::newFrame()
     gettimeofday(&frame_received, nullptr);
     timersub(&frame_received, &current_frame_duration, &current_frame_duration);
 
+    updateCaptureStats();
 
     if (Streamer->isBusy())
     {
@@ -1702,6 +1764,7 @@ bool V4L2_Driver::Connect()
             saveConfig(true, PortTP.name);
 
         v4l_base->registerCallback(newFrame, this);
+        v4l_base->registerErrorCallback(captureError, this);
         lx->setCamerafd(v4l_base->fd);
 
         if (!(strcmp((const char *)v4l_base->cap.driver, "pwc")))
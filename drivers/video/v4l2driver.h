@@ -66,6 +66,9 @@ public:
         void stackFrame();
         void newFrame();
 
+        static void captureError(const char *errmsg, void *p);
+        void captureError(const char *errmsg);
+
     protected:
         virtual bool Connect() override;
         virtual bool Disconnect() override;
@@ -128,6 +131,12 @@ public:
         //INumber *ExposeTimeN;
         INumber *FrameN;
         INumber FrameRateN[1];
+        INumber CaptureStatsN[2];
+        enum
+        {
+            CAPTURE_DROPPED_FRAMES,
+            CAPTURE_SEQUENCE_GAPS
+        };
 
         /* Switch vectors */
         ISwitchVectorProperty ImageDepthSP;     /* 8 bits or 16 bits switch */
@@ -148,6 +157,7 @@ public:
         INumberVectorProperty CaptureSizesNP; /* Select Capture size switch (Step/Continuous)*/
         INumberVectorProperty FrameRateNP;    /* Frame rate (Step/Continuous) */
         INumberVectorProperty ImageAdjustNP;  /* Image controls */
+        INumberVectorProperty CaptureStatsNP; /* Frames lost since capture started */
 
         /* Text vectors */
         ITextVectorProperty PortTP;
@@ -165,6 +175,7 @@ public:
         void allocateBuffers();
         void releaseBuffers();
         void updateFrameSize();
+        void updateCaptureStats();
 
         /* Shutter control */
         bool setShutter(double duration);
@@ -29,6 +29,9 @@
  * work procedures may be registered that are called when there is nothing
  *   else to do;
  *
+ * timers run on a clock that may be accelerated, or stepped from timer to
+ *   timer, so that simulators sharing it run faster than real time;
+ *
  #define MAIN_TEST for a stand-alone test program.
  */
 
@@ -93,6 +96,18 @@ static int nwproc;   /* n entries in wproc[] */
 static int nwpinuse; /* n entries in wproc[] marked in-use */
 static int lastwp;   /* wproc index of last workproc called*/
 
+/* virtual clock of the timers.
+ * it runs clockscale times faster than the wall clock, starting at the wall
+ * clock time. when stepping, it only moves when the loop has nothing to do
+ * but wait for the next timer, and then jumps straight to it.
+ * INDICLOCKSCALE and INDICLOCKSTEP set the initial scale and stepping mode.
+ */
+static double clockscale = 1.0; /* virtual ms per wall clock ms */
+static int clockstep;           /* flag set when stepping from timer to timer */
+static int clockinit;           /* flag set once the clock was initialized */
+static double clockbase;        /* virtual ms from epoch at wallbase */
+static double wallbase;         /* wall clock ms from epoch */
+
 static void runWorkProc(void);
 static void callCallback(fd_set *rfdp);
 static void checkTimer();
@@ -202,6 +217,96 @@ void rmCallback(int cid)
     ncbinuse--;
 }
 
+/* ms from epoch of the wall clock */
+static double wallMS()
+{
+    struct timeval t;
+    gettimeofday(&t, NULL);
+    return (EPOCHDT(&t));
+}
+
+/* start the virtual clock at the wall clock time, with the scale and
+ * stepping mode from the environment if any.
+ */
+static void initClock()
+{
+    const char *scale = getenv("INDICLOCKSCALE");
+    const char *step  = getenv("INDICLOCKSTEP");
+
+    clockinit = 1;
+    wallbase  = clockbase = wallMS();
+    if (scale && atof(scale) > 0)
+        clockscale = atof(scale);
+    if (step && atoi(step))
+        clockstep = 1;
+}
+
+/* ms from epoch of the virtual clock */
+static double clockMS()
+{
+    if (!clockinit)
+        initClock();
+    if (clockstep)
+        return (clockbase);
+    return (clockbase + (wallMS() - wallbase) * clockscale);
+}
+
+/* restart the virtual clock from its current time, before changing its pace */
+static void rebaseClock()
+{
+    clockbase = clockMS();
+    wallbase  = wallMS();
+}
+
+void setClockScale(double scale)
+{
+    if (scale <= 0)
+        return;
+    rebaseClock();
+    clockscale = scale;
+}
+
+double getClockScale()
+{
+    if (!clockinit)
+        initClock();
+    return (clockscale);
+}
+
+void setClockStepping(int on)
+{
+    rebaseClock();
+    clockstep = on ? 1 : 0;
+}
+
+int getClockStepping()
+{
+    if (!clockinit)
+        initClock();
+    return (clockstep);
+}
+
+void getClockTime(struct timeval *tv)
+{
+    double ms = clockMS();
+
+    tv->tv_sec  = (time_t)floor(ms / 1000.0);
+    tv->tv_usec = (suseconds_t)((ms - tv->tv_sec * 1000.0) * 1000.0);
+}
+
+/* block the caller for ms of virtual time, which is immediate when stepping */
+void clockSleep(int ms)
+{
+    if (ms <= 0)
+        return;
+    if (!clockinit)
+        initClock();
+    if (clockstep)
+        clockbase += ms;
+    else
+        usleep((useconds_t)(ms * 1000.0 / clockscale));
+}
+
 /* insert maintaining sort */
 static void insertTimer(TF *node)
 {
@@ -224,12 +329,8 @@ static void insertTimer(TF *node)
  */
 static int addTimerImpl(int delay, int interval, TCF *fp, void *ud)
 {
-    struct timeval t;
     TF *node;
 
-    /* get time now */
-    gettimeofday(&t, NULL);
-
     /* create entry */
     node = (TF*)malloc(sizeof(TF));
 
@@ -237,7 +338,7 @@ static int addTimerImpl(int delay, int interval, TCF *fp, void *ud)
     node->ud  = ud;
     node->fp  = fp;
     node->tid = ++tid; /* store new unique id */
-    node->tgo = EPOCHDT(&t) + delay;
+    node->tgo = clockMS() + delay;
     node->interval = interval;
 
     insertTimer(node);
@@ -300,9 +401,7 @@ void rmTimer(int timer_id)
 /* Returns the timer's remaining value in milliseconds left until the timeout. */
 static double remainingTimerNode(TF *node)
 {
-    struct timeval now;
-    gettimeofday(&now, NULL);
-    return (node->tgo - EPOCHDT(&now));
+    return (node->tgo - clockMS());
 }
 
 /* Returns the timer's remaining value in milliseconds left until the timeout.
@@ -475,9 +574,9 @@ static void oneLoop()
     else if (timefunc->next != NULL)
     {
         double late = remainingTimerNode(timefunc->next); /* ms late */
-        if (late < 0)
+        if (late < 0 || clockstep)
             late = 0;
-        late /= 1000.0; /* secs late */
+        late /= 1000.0 * clockscale; /* wall clock secs late */
         tvp          = &tv;
         tvp->tv_sec  = (long)floor(late);
         tvp->tv_usec = (long)floor((late - tvp->tv_sec) * 1000000.0);
@@ -493,6 +592,14 @@ static void oneLoop()
         return;
     }
 
+    /* when stepping and only waiting for the next timer, jump to it */
+    if (ns == 0 && clockstep && nwpinuse == 0 && timefunc->next != NULL)
+    {
+        double late = remainingTimerNode(timefunc->next);
+        if (late > 0)
+            clockbase += late;
+    }
+
     /* dispatch */
     checkTimer();
     if (ns == 0)
@@ -557,6 +664,36 @@ void IERmWorkProc(int workprocid)
     rmWorkProc(workprocid);
 }
 
+void IESetClockScale(double scale)
+{
+    setClockScale(scale);
+}
+
+double IEGetClockScale()
+{
+    return (getClockScale());
+}
+
+void IESetClockStepping(int on)
+{
+    setClockStepping(on);
+}
+
+int IEGetClockStepping()
+{
+    return (getClockStepping());
+}
+
+void IEGetClockTime(struct timeval *tv)
+{
+    getClockTime(tv);
+}
+
+void IEClockSleep(int millisecs)
+{
+    clockSleep(millisecs);
+}
+
 int IEDeferLoop(int maxms, int *flagp)
 {
     return (deferLoop(maxms, flagp));
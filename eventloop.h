@@ -46,6 +46,8 @@ typedef void(WPF)(void *);
 */
 typedef void(TCF)(void *);
 
+struct timeval;
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -122,6 +124,41 @@ extern int nsecRemainingTimer(int tid);
 */
 extern void rmTimer(int tid);
 
+/** Set the pace of the clock timers run on, e.g. 100 to fire timers 100 times faster than the wall clock.
+ * The clock starts at the wall clock time, and keeps its current time when the pace changes.
+ * The INDICLOCKSCALE environment variable sets the initial pace.
+ *
+ * \param scale virtual seconds per wall clock second, ignored unless positive.
+ */
+extern void setClockScale(double scale);
+
+/** \return The pace of the timers clock, 1 unless changed. */
+extern double getClockScale();
+
+/** Step the timers clock instead of running it.
+ * While stepping, the clock stands still while there is anything to do and jumps straight to the next timer
+ * when the loop would otherwise wait for it, so that sequences of timers run as fast as possible and in a
+ * deterministic order. The INDICLOCKSTEP environment variable enables stepping initially.
+ *
+ * \param on non-zero to step the clock, 0 to run it at its pace again.
+ */
+extern void setClockStepping(int on);
+
+/** \return Non-zero if the timers clock is stepping. */
+extern int getClockStepping();
+
+/** Get the current time of the timers clock, which simulators use in place of gettimeofday().
+ *
+ * \param tv time since epoch, the wall clock time unless the clock was accelerated or stepped.
+ */
+extern void getClockTime(struct timeval *tv);
+
+/** Block for \e ms of the timers clock, returns at once when stepping after moving the clock forward.
+ *
+ * \param ms duration in milliseconds.
+ */
+extern void clockSleep(int ms);
+
 /* utility functions */
 extern int deferLoop(int maxms, int *flagp);
 extern int deferLoop0(int maxms, int *flagp);
@@ -102,6 +102,8 @@ after all, the framework must know how to call the callback correctlty.</p>
 #include "indiapi.h"
 #include "lilxml.h"
 
+struct timeval;
+
 /*******************************************************************************
  *******************************************************************************
  *
@@ -377,6 +379,37 @@ extern int IEAddWorkProc(IE_WPF *fp, void *userpointer);
 */
 extern void IERmWorkProc(int workprocid);
 
+/** \brief Set the pace of the clock timers and simulators run on, see setClockScale().
+*
+* \param scale virtual seconds per wall clock second, e.g. 100 to run 100 times faster than real time.
+*/
+extern void IESetClockScale(double scale);
+
+/** \return The pace of the timers clock. */
+extern double IEGetClockScale();
+
+/** \brief Step the timers clock from timer to timer instead of running it, see setClockStepping().
+*
+* \param on non-zero to step the clock.
+*/
+extern void IESetClockStepping(int on);
+
+/** \return Non-zero if the timers clock is stepping. */
+extern int IEGetClockStepping();
+
+/** \brief Get the current time of the timers clock. Simulators use it instead of gettimeofday() so that they
+* follow an accelerated or stepped clock.
+*
+* \param tv time since epoch.
+*/
+extern void IEGetClockTime(struct timeval *tv);
+
+/** \brief Block for \e millisecs of the timers clock, instead of usleep().
+*
+* \param millisecs duration in milliseconds.
+*/
+extern void IEClockSleep(int millisecs);
+
 /* wait in-line for a flag to set, presumably by another event function */
 
 extern int IEDeferLoop(int maxms, int *flagp);
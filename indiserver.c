@@ -32,6 +32,9 @@
  * 2017-01-29 JM: Added option to drop stream blobs if client blob queue is
  * higher than maxstreamsiz bytes
  *
+ * 2022: Messages are queued on two lanes per client and driver, see lq.c, so
+ * small commands and property updates are sent ahead of queued BLOBs.
+ *
  * Implementation notes:
  *
  * We fork each driver and open a server socket listening for INDI clients.
@@ -41,6 +44,10 @@
  * one client or device, they are queued and only removed after the last
  * consumer is finished. XMLEle are converted to linear strings before being
  * sent to optimize write system calls and avoid blocking to slow clients.
+ * Large pcdata, i.e. BLOB data, is not copied into the string but written from
+ * the parsed XMLEle in place, which the message keeps, so each BLOB is held in
+ * memory once however many clients and snooping drivers it is queued to, each
+ * of them only keeping its own write offset.
  * Clients that get more than maxqsiz bytes behind are shut down.
  */
 
@@ -48,7 +55,7 @@
 
 #include "config.h"
 
-#include "fq.h"
+#include "lq.h"
 #include "indiapi.h"
 #include "indidevapi.h"
 #include "lilxml.h"
@@ -78,6 +85,7 @@
 #define MAXRBUF       49152 /* max read buffering here */
 #define MAXWSIZ       49152 /* max bytes/write */
 #define SHORTMSGSIZ   2048  /* buf size for most messages */
+#define SHAREDPCDATA  SHORTMSGSIZ /* pcdata this large is sent from the parsed message in place */
 #define DEFMAXQSIZ    128   /* default max q behind, MB */
 #define DEFMAXSSIZ    5     /* default max stream behind, MB */
 #define DEFMAXRESTART 10    /* default max restarts */
@@ -93,6 +101,9 @@ typedef struct
     int count;         /* number of consumers left */
     unsigned long cl;  /* content length */
     char *cp;          /* content: buf or malloced */
+    XMLEle *ep;        /* parsed message kept for its large pcdata, or NULL */
+    XMLSegment *segs;  /* if ep, malloced content pieces: text in cp and pcdata in ep */
+    int nsegs;         /* n entries in segs[], 0 when content is all in cp */
     char buf[SHORTMSGSIZ];    /* local buf for most messages */
 } Msg;
 
@@ -128,7 +139,7 @@ typedef struct
     BLOBHandling blob;  /* when to send setBLOBs */
     int s;              /* socket for this client */
     LilXML *lp;         /* XML parsing context */
-    FQ *msgq;           /* Msg queue */
+    LQ *msgq;           /* Msg queue */
     unsigned int nsent; /* bytes of current Msg sent so far */
 } ClInfo;
 static ClInfo *clinfo; /*  malloced pool of clients */
@@ -156,7 +167,7 @@ typedef struct
     int efd;            /* stderr from driver, if local */
     int restarts;       /* times process has been restarted */
     LilXML *lp;         /* XML parsing context */
-    FQ *msgq;           /* Msg queue */
+    LQ *msgq;           /* Msg queue */
     unsigned int nsent; /* bytes of current Msg sent so far */
 } DvrInfo;
 static DvrInfo *dvrinfo; /* malloced array of drivers */
@@ -201,11 +212,13 @@ static void addClDevice(ClInfo *cp, const char *dev, const char *name, int isblo
 static int findClDevice(ClInfo *cp, const char *dev, const char *name);
 static int readFromDriver(DvrInfo *dp);
 static int stderrFromDriver(DvrInfo *dp);
-static int msgQSize(FQ *q);
+static int msgQSize(LQ *q);
+static void logLatency(const char *who, LQ *q);
 static void setMsgXMLEle(Msg *mp, XMLEle *root);
 static void setMsgStr(Msg *mp, char *str);
 static void freeMsg(Msg *mp);
 static Msg *newMsg(void);
+static const char *msgChunk(Msg *mp, unsigned long off, unsigned long *lp);
 static int sendClientMsg(ClInfo *cp);
 static int sendDriverMsg(DvrInfo *cp);
 static void crackBLOB(const char *enableBLOB, BLOBHandling *bp);
@@ -589,7 +602,7 @@ static void startLocalDvr(DvrInfo *dp)
     dp->wfd     = wp[1];
     dp->efd     = ep[0];
     dp->lp      = newLilXML();
-    dp->msgq    = newFQ(1);
+    dp->msgq    = newLQ(1);
     dp->sprops  = (Property *)malloc(1); /* seed for realloc */
     dp->nsprops = 0;
     dp->nsent   = 0;
@@ -601,7 +614,7 @@ static void startLocalDvr(DvrInfo *dp)
      * if restarting
      */
     mp = newMsg();
-    pushFQ(dp->msgq, mp);
+    pushLQ(dp->msgq, mp, 0, "", "");
     snprintf(buf, sizeof(buf), "<getProperties version='%g'/>\n", INDIV);
     setMsgStr(mp, buf);
     mp->count++;
@@ -644,7 +657,7 @@ static void startRemoteDvr(DvrInfo *dp)
     dp->rfd     = sockfd;
     dp->wfd     = sockfd;
     dp->lp      = newLilXML();
-    dp->msgq    = newFQ(1);
+    dp->msgq    = newLQ(1);
     dp->sprops  = (Property *)malloc(1); /* seed for realloc */
     dp->nsprops = 0;
     dp->nsent   = 0;
@@ -663,7 +676,7 @@ static void startRemoteDvr(DvrInfo *dp)
      * outbound (and our inbound) traffic on this socket to this device.
      */
     mp = newMsg();
-    pushFQ(dp->msgq, mp);
+    pushLQ(dp->msgq, mp, 0, "", "");
     if (dev[0])
         sprintf(buf, "<getProperties device='%s' version='%g'/>\n", dp->dev[0], INDIV);
     else
@@ -814,7 +827,7 @@ static void indiRun(void)
         if (cp->active)
         {
             FD_SET(cp->s, &rs);
-            if (nFQ(cp->msgq) > 0)
+            if (nLQ(cp->msgq) > 0)
                 FD_SET(cp->s, &ws);
             if (cp->s > maxfd)
                 maxfd = cp->s;
@@ -836,7 +849,7 @@ static void indiRun(void)
                 if (dp->efd > maxfd)
                     maxfd = dp->efd;
             }
-            if (nFQ(dp->msgq) > 0)
+            if (nLQ(dp->msgq) > 0)
             {
                 FD_SET(dp->wfd, &ws);
                 if (dp->wfd > maxfd)
@@ -908,7 +921,7 @@ static void indiRun(void)
                     return; /* fds effected */
                 s--;
             }
-            if (s > 0 && FD_ISSET(dp->wfd, &ws) && nFQ(dp->msgq) > 0)
+            if (s > 0 && FD_ISSET(dp->wfd, &ws) && nLQ(dp->msgq) > 0)
             {
                 if (sendDriverMsg(dp) < 0)
                     return; /* fds effected */
@@ -1139,7 +1152,7 @@ static void newClient()
     cp->active = 1;
     cp->s      = s;
     cp->lp     = newLilXML();
-    cp->msgq   = newFQ(1);
+    cp->msgq   = newLQ(1);
     cp->props  = malloc(1);
     cp->nsent  = 0;
 
@@ -1251,8 +1264,10 @@ static int readFromClient(ClInfo *cp)
             if (mp->count > 0)
                 setMsgXMLEle(mp, root);
             else
+            {
                 freeMsg(mp);
-            delXMLEle(root);
+                delXMLEle(root);
+            }
         }
         else if (err[0])
         {
@@ -1345,8 +1360,10 @@ static int readFromDriver(DvrInfo *dp)
             if (mp->count > 0)
                 setMsgXMLEle(mp, root);
             else
+            {
                 freeMsg(mp);
-            delXMLEle(root);
+                delXMLEle(root);
+            }
             inode++;
             root = nodes[inode];
             continue;
@@ -1400,8 +1417,10 @@ static int readFromDriver(DvrInfo *dp)
         if (mp->count > 0)
             setMsgXMLEle(mp, root);
         else
+        {
             freeMsg(mp);
-        delXMLEle(root);
+            delXMLEle(root);
+        }
         inode++;
         root = nodes[inode];
     }
@@ -1462,11 +1481,18 @@ static void shutdownClient(ClInfo *cp)
     delLilXML(cp->lp);
     free(cp->props);
 
+    if (verbose > 0)
+    {
+        char who[32];
+        snprintf(who, sizeof(who), "Client %d", cp->s);
+        logLatency(who, cp->msgq);
+    }
+
     /* decrement and possibly free any unsent messages for this client */
-    while ((mp = (Msg *)popFQ(cp->msgq)) != NULL)
+    while ((mp = (Msg *)popLQ(cp->msgq)) != NULL)
         if (--mp->count == 0)
             freeMsg(mp);
-    delFQ(cp->msgq);
+    delLQ(cp->msgq);
 
     /* ok now to recycle */
     cp->active = 0;
@@ -1503,8 +1529,10 @@ static void shutdownDvr(DvrInfo *dp, int restart)
         if (mp->count > 0)
             setMsgXMLEle(mp, root);
         else
+        {
             freeMsg(mp);
-        delXMLEle(root);
+            delXMLEle(root);
+        }
     }
 
     /* make sure it's dead, reclaim resources */
@@ -1537,11 +1565,18 @@ static void shutdownDvr(DvrInfo *dp, int restart)
     dp->active = 0;
     dp->ndev   = 0;
 
+    if (verbose > 0)
+    {
+        char who[MAXINDINAME + 8];
+        snprintf(who, sizeof(who), "Driver %s", dp->name);
+        logLatency(who, dp->msgq);
+    }
+
     /* decrement and possibly free any unsent messages for this client */
-    while ((mp = (Msg *)popFQ(dp->msgq)) != NULL)
+    while ((mp = (Msg *)popLQ(dp->msgq)) != NULL)
         if (--mp->count == 0)
             freeMsg(mp);
-    delFQ(dp->msgq);
+    delLQ(dp->msgq);
 
     if (restart)
     {
@@ -1568,7 +1603,9 @@ static void shutdownDvr(DvrInfo *dp, int restart)
 static void q2RDrivers(const char *dev, Msg *mp, XMLEle *root)
 {
     DvrInfo *dp;
-    char *roottag = tagXMLEle(root);
+    char *roottag    = tagXMLEle(root);
+    const char *name = findXMLAttValu(root, "name");
+    int isblob       = !strcmp(roottag, "newBLOBVector");
 
     char lastRemoteHost[MAXSBUF];
     int lastRemotePort = -1;
@@ -1607,7 +1644,7 @@ static void q2RDrivers(const char *dev, Msg *mp, XMLEle *root)
 
         /* ok: queue message to this driver */
         mp->count++;
-        pushFQ(dp->msgq, mp);
+        pushLQ(dp->msgq, mp, isblob, dev, name);
         if (verbose > 1)
         {
             fprintf(stderr, "%s: Driver %s: queuing responsible for <%s device='%s' name='%s'>\n", indi_tstamp(NULL),
@@ -1645,7 +1682,7 @@ static void q2SDrivers(DvrInfo *me, int isblob, const char *dev, const char *nam
 
         /* ok: queue message to this device */
         mp->count++;
-        pushFQ(dp->msgq, mp);
+        pushLQ(dp->msgq, mp, isblob, dev, name);
         if (verbose > 1)
         {
             fprintf(stderr, "%s: Driver %s: queuing snooped <%s device='%s' name='%s'>\n", indi_tstamp(NULL), dp->name,
@@ -1701,13 +1738,33 @@ static Property *findSDevice(DvrInfo *dp, const char *dev, const char *name)
     return (NULL);
 }
 
+/* return 1 if root holds a stream BLOB, which may be dropped for clients behind */
+static int isStreamBLOB(XMLEle *root)
+{
+    XMLEle *ep;
+
+    for (ep = nextXMLEle(root, 1); ep; ep = nextXMLEle(root, 0))
+    {
+        if (strcmp(tagXMLEle(ep), "oneBLOB") == 0)
+        {
+            XMLAtt *fa = findXMLAtt(ep, "format");
+
+            if (fa && strstr(valuXMLAtt(fa), "stream"))
+                return (1);
+        }
+    }
+
+    return (0);
+}
+
 /* put Msg mp on queue of each client interested in dev/name, except notme.
  * if BLOB always honor current mode.
  * return -1 if had to shut down any clients, else 0.
  */
 static int q2Clients(ClInfo *notme, int isblob, const char *dev, const char *name, Msg *mp, XMLEle *root)
 {
-    int shutany = 0;
+    int shutany  = 0;
+    int isstream = -1; /* root is a stream BLOB, not known yet */
     ClInfo *cp;
     int ql, i = 0;
 
@@ -1751,24 +1808,10 @@ static int q2Clients(ClInfo *notme, int isblob, const char *dev, const char *nam
         ql = msgQSize(cp->msgq);
         if (isblob && maxstreamsiz > 0 && ql > maxstreamsiz)
         {
-            // Drop frames for streaming blobs
-            /* pull out each name/BLOB pair, decode */
-            XMLEle *ep      = NULL;
-            int streamFound = 0;
-            for (ep = nextXMLEle(root, 1); ep; ep = nextXMLEle(root, 0))
-            {
-                if (strcmp(tagXMLEle(ep), "oneBLOB") == 0)
-                {
-                    XMLAtt *fa = findXMLAtt(ep, "format");
-
-                    if (fa && strstr(valuXMLAtt(fa), "stream"))
-                    {
-                        streamFound = 1;
-                        break;
-                    }
-                }
-            }
-            if (streamFound)
+            // Drop frames for streaming blobs, the same decision for every client
+            if (isstream < 0)
+                isstream = isStreamBLOB(root);
+            if (isstream)
             {
                 if (verbose > 1)
                     fprintf(stderr, "%s: Client %d: %d bytes behind. Dropping stream BLOB...\n", indi_tstamp(NULL),
@@ -1787,7 +1830,7 @@ static int q2Clients(ClInfo *notme, int isblob, const char *dev, const char *nam
 
         /* ok: queue message to this client */
         mp->count++;
-        pushFQ(cp->msgq, mp);
+        pushLQ(cp->msgq, mp, isblob, dev, name);
         if (verbose > 1)
             fprintf(stderr, "%s: Client %d: queuing <%s device='%s' name='%s'>\n", indi_tstamp(NULL), cp->s,
                     tagXMLEle(root), findXMLAttValu(root, "device"), findXMLAttValu(root, "name"));
@@ -1861,7 +1904,7 @@ static int q2Servers(DvrInfo *me, Msg *mp, XMLEle *root)
 
         /* ok: queue message to this client */
         mp->count++;
-        pushFQ(cp->msgq, mp);
+        pushLQ(cp->msgq, mp, 0, findXMLAttValu(root, "device"), findXMLAttValu(root, "name"));
         if (verbose > 1)
             fprintf(stderr, "%s: Client %d: queuing <%s device='%s' name='%s'>\n", indi_tstamp(NULL), cp->s,
                     tagXMLEle(root), findXMLAttValu(root, "device"), findXMLAttValu(root, "name"));
@@ -1871,32 +1914,67 @@ static int q2Servers(DvrInfo *me, Msg *mp, XMLEle *root)
 }
 
 /* return size of all Msqs on the given q */
-static int msgQSize(FQ *q)
+static int msgQSize(LQ *q)
 {
     int i, l = 0;
 
-    for (i = 0; i < nFQ(q); i++)
+    for (i = 0; i < nLQ(q); i++)
     {
-        Msg *mp = (Msg *)peekiFQ(q, i);
+        Msg *mp = (Msg *)peekiLQ(q, i);
         l += sizeof(Msg);
-        if (mp->cp != mp->buf)
+        if (mp->cp != mp->buf || mp->nsegs > 0)
             l += mp->cl;
     }
 
     return (l);
 }
 
-/* print root as content in Msg mp.
+/* report the queueing latency percentiles of each lane of q */
+static void logLatency(const char *who, LQ *q)
+{
+    static const char *lanes[LQ_NLANES] = { "control", "bulk" };
+    LQStats st;
+    int lane;
+
+    for (lane = 0; lane < LQ_NLANES; lane++)
+    {
+        statsLQ(q, lane, &st);
+        if (st.n == 0)
+            continue;
+        fprintf(stderr, "%s: %s: %s lane latency over %lu msgs: p50 %.1f ms p95 %.1f ms p99 %.1f ms max %.1f ms\n",
+                indi_tstamp(NULL), who, lanes[lane], st.n, st.p50, st.p95, st.p99, st.max);
+    }
+}
+
+/* print root as content in Msg mp, mp takes ownership of root.
+ * large pcdata is not copied: root is kept and the content is written as
+ * pieces of text printed in cp around the pcdata referenced in root.
  */
 static void setMsgXMLEle(Msg *mp, XMLEle *root)
 {
+    int i, nsegs;
+
     /* want cl to only count content, but need room for final \0 */
-    mp->cl = sprlXMLEle(root, 0);
-    if (mp->cl < sizeof(mp->buf))
+    unsigned long tl = sprslXMLEle(root, 0, SHAREDPCDATA, &nsegs);
+    if (tl < sizeof(mp->buf))
         mp->cp = mp->buf;
     else
-        mp->cp = malloc(mp->cl + 1);
-    sprXMLEle(mp->cp, root, 0);
+        mp->cp = malloc(tl + 1);
+
+    /* small message, print it all */
+    if (nsegs == 1)
+    {
+        mp->cl = sprXMLEle(mp->cp, root, 0);
+        delXMLEle(root);
+        return;
+    }
+
+    mp->ep    = root;
+    mp->segs  = (XMLSegment *)malloc(nsegs * sizeof(XMLSegment));
+    mp->nsegs = sprsXMLEle(mp->cp, root, 0, SHAREDPCDATA, mp->segs);
+    mp->cl    = 0;
+    for (i = 0; i < mp->nsegs; i++)
+        mp->cl += mp->segs[i].l;
 }
 
 /* save str as content in Msg mp.
@@ -1924,9 +2002,31 @@ static void freeMsg(Msg *mp)
 {
     if (mp->cp && mp->cp != mp->buf)
         free(mp->cp);
+    free(mp->segs);
+    delXMLEle(mp->ep);
     free(mp);
 }
 
+/* return the content of mp from offset off up to the end of its piece, set *lp
+ * to its length.
+ */
+static const char *msgChunk(Msg *mp, unsigned long off, unsigned long *lp)
+{
+    int i;
+
+    if (mp->nsegs == 0)
+    {
+        *lp = mp->cl - off;
+        return (&mp->cp[off]);
+    }
+
+    for (i = 0; i < mp->nsegs - 1 && off >= (unsigned long)mp->segs[i].l; i++)
+        off -= mp->segs[i].l;
+
+    *lp = mp->segs[i].l - off;
+    return (mp->segs[i].s + off);
+}
+
 /* write the next chunk of the current message in the queue to the given
  * client. pop message from queue when complete and free the message if we are
  * the last one to use it. shut down this client if trouble.
@@ -1936,16 +2036,19 @@ static void freeMsg(Msg *mp)
 static int sendClientMsg(ClInfo *cp)
 {
     ssize_t nsend, nw;
+    unsigned long nchunk;
+    const char *chunk;
     Msg *mp;
 
     /* get current message */
-    mp = (Msg *)peekFQ(cp->msgq);
+    mp = (Msg *)peekLQ(cp->msgq);
 
     /* send next chunk, never more than MAXWSIZ to reduce blocking */
-    nsend = mp->cl - cp->nsent;
+    chunk = msgChunk(mp, cp->nsent, &nchunk);
+    nsend = nchunk;
     if (nsend > MAXWSIZ)
         nsend = MAXWSIZ;
-    nw = write(cp->s, &mp->cp[cp->nsent], nsend);
+    nw = write(cp->s, chunk, nsend);
 
     /* shut down if trouble */
     if (nw <= 0)
@@ -1962,11 +2065,11 @@ static int sendClientMsg(ClInfo *cp)
     if (verbose > 2)
     {
         fprintf(stderr, "%s: Client %d: sending msg copy %d nq %d:\n%.*s\n", indi_tstamp(NULL), cp->s, mp->count,
-                nFQ(cp->msgq), (int)nw, &mp->cp[cp->nsent]);
+                nLQ(cp->msgq), (int)nw, chunk);
     }
     else if (verbose > 1)
     {
-        fprintf(stderr, "%s: Client %d: sending %.50s\n", indi_tstamp(NULL), cp->s, &mp->cp[cp->nsent]);
+        fprintf(stderr, "%s: Client %d: sending %.*s\n", indi_tstamp(NULL), cp->s, (int)(nw < 50 ? nw : 50), chunk);
     }
 
     /* update amount sent. when complete: free message if we are the last
@@ -1977,7 +2080,7 @@ static int sendClientMsg(ClInfo *cp)
     {
         if (--mp->count == 0)
             freeMsg(mp);
-        popFQ(cp->msgq);
+        popLQ(cp->msgq);
         cp->nsent = 0;
     }
 
@@ -1993,16 +2096,19 @@ static int sendClientMsg(ClInfo *cp)
 static int sendDriverMsg(DvrInfo *dp)
 {
     ssize_t nsend, nw;
+    unsigned long nchunk;
+    const char *chunk;
     Msg *mp;
 
     /* get current message */
-    mp = (Msg *)peekFQ(dp->msgq);
+    mp = (Msg *)peekLQ(dp->msgq);
 
     /* send next chunk, never more than MAXWSIZ to reduce blocking */
-    nsend = mp->cl - dp->nsent;
+    chunk = msgChunk(mp, dp->nsent, &nchunk);
+    nsend = nchunk;
     if (nsend > MAXWSIZ)
         nsend = MAXWSIZ;
-    nw = write(dp->wfd, &mp->cp[dp->nsent], nsend);
+    nw = write(dp->wfd, chunk, nsend);
 
     /* restart if trouble */
     if (nw <= 0)
@@ -2019,11 +2125,11 @@ static int sendDriverMsg(DvrInfo *dp)
     if (verbose > 2)
     {
         fprintf(stderr, "%s: Driver %s: sending msg copy %d nq %d:\n%.*s\n", indi_tstamp(NULL), dp->name, mp->count,
-                nFQ(dp->msgq), (int)nw, &mp->cp[dp->nsent]);
+                nLQ(dp->msgq), (int)nw, chunk);
     }
     else if (verbose > 1)
     {
-        fprintf(stderr, "%s: Driver %s: sending %.50s\n", indi_tstamp(NULL), dp->name, &mp->cp[dp->nsent]);
+        fprintf(stderr, "%s: Driver %s: sending %.*s\n", indi_tstamp(NULL), dp->name, (int)(nw < 50 ? nw : 50), chunk);
     }
 
     /* update amount sent. when complete: free message if we are the last
@@ -2034,7 +2140,7 @@ static int sendDriverMsg(DvrInfo *dp)
     {
         if (--mp->count == 0)
             freeMsg(mp);
-        popFQ(dp->msgq);
+        popLQ(dp->msgq);
         dp->nsent = 0;
     }
 
@@ -0,0 +1,686 @@
+/*
+*   DSP API - a digital signal processing library for astronomy usage
+*   Copyright © 2017-2022  Ilia Platone
+*
+*   This program is free software; you can redistribute it and/or
+*   modify it under the terms of the GNU Lesser General Public
+*   License as published by the Free Software Foundation; either
+*   version 3 of the License, or (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+*   Lesser General Public License for more details.
+*
+*   You should have received a copy of the GNU Lesser General Public License
+*   along with this program; if not, write to the Free Software Foundation,
+*   Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+
+#include "dsp.h"
+
+typedef struct dsp_star_candidate_t
+{
+    int x;
+    int y;
+    dsp_t peak;
+} dsp_star_candidate;
+
+static int dsp_qsort_candidate_peak_desc(const void *arg1, const void *arg2)
+{
+    const dsp_star_candidate* a = (const dsp_star_candidate*)arg1;
+    const dsp_star_candidate* b = (const dsp_star_candidate*)arg2;
+    if(a->peak < b->peak)
+        return 1;
+    if(a->peak > b->peak)
+        return -1;
+    return 0;
+}
+
+int dsp_qsort_double_asc(const void *arg1, const void *arg2)
+{
+    double a = *(const double*)arg1;
+    double b = *(const double*)arg2;
+    return (a > b) - (a < b);
+}
+
+int dsp_qsort_double_desc(const void *arg1, const void *arg2)
+{
+    return dsp_qsort_double_asc(arg2, arg1);
+}
+
+int dsp_qsort_star_diameter_asc(const void *arg1, const void *arg2)
+{
+    const dsp_star* a = (const dsp_star*)arg1;
+    const dsp_star* b = (const dsp_star*)arg2;
+    return (a->diameter > b->diameter) - (a->diameter < b->diameter);
+}
+
+int dsp_qsort_star_diameter_desc(const void *arg1, const void *arg2)
+{
+    return dsp_qsort_star_diameter_asc(arg2, arg1);
+}
+
+static void dsp_align_find_candidates_th(void* arg, int thread, int start, int end)
+{
+    struct {
+        int radius;
+        dsp_t threshold;
+        dsp_stream_p stream;
+        dsp_star_candidate *candidates;
+        int candidates_count;
+        int candidates_allocated;
+    } *arguments = arg;
+    arguments += thread;
+    dsp_stream_p stream = arguments->stream;
+    int width = stream->sizes[0];
+    int radius = arguments->radius;
+    dsp_t threshold = arguments->threshold;
+    int x, y;
+    for(y = radius + start; y < radius + end; y++) {
+        dsp_t *row = &stream->buf[y * width];
+        for(x = radius; x < width - radius; x++) {
+            dsp_t v = row[x];
+            if(v <= threshold)
+                continue;
+            dsp_t *up = row - width;
+            dsp_t *down = row + width;
+            // Strict comparison against already scanned neighbours resolves flat tops to a single pixel
+            if(v <= up[x-1] || v <= up[x] || v <= up[x+1] || v <= row[x-1])
+                continue;
+            if(v < row[x+1] || v < down[x-1] || v < down[x] || v < down[x+1])
+                continue;
+            // Reject isolated hot pixels: a real star spreads over at least two neighbours
+            int lit = (up[x] > threshold) + (down[x] > threshold) + (row[x-1] > threshold) + (row[x+1] > threshold);
+            if(lit < 2)
+                continue;
+            if(arguments->candidates_count == arguments->candidates_allocated) {
+                arguments->candidates_allocated = arguments->candidates_allocated * 2 + 64;
+                arguments->candidates = (dsp_star_candidate*)realloc(arguments->candidates, sizeof(dsp_star_candidate) * arguments->candidates_allocated);
+            }
+            arguments->candidates[arguments->candidates_count].x = x;
+            arguments->candidates[arguments->candidates_count].y = y;
+            arguments->candidates[arguments->candidates_count].peak = v;
+            arguments->candidates_count++;
+        }
+    }
+}
+
+static void dsp_align_measure_stars_th(void* arg, int thread, int start, int end)
+{
+    struct {
+        int radius;
+        dsp_t background;
+        dsp_t noise;
+        dsp_stream_p stream;
+        dsp_star_candidate *candidates;
+        dsp_star *stars;
+    } *arguments = arg;
+    dsp_stream_p stream = arguments->stream;
+    int width = stream->sizes[0];
+    int radius = arguments->radius;
+    int r2 = radius * radius;
+    int s, x, y;
+    (void)thread;
+    for(s = start; s < end; s++) {
+        dsp_star_candidate *c = &arguments->candidates[s];
+        dsp_star *star = &arguments->stars[s];
+        double flux = 0.0, cx = 0.0, cy = 0.0;
+        for(y = -radius; y <= radius; y++) {
+            dsp_t *row = &stream->buf[(c->y + y) * width + c->x];
+            for(x = -radius; x <= radius; x++) {
+                if(x * x + y * y > r2)
+                    continue;
+                double w = row[x] - arguments->background;
+                if(w <= arguments->noise)
+                    continue;
+                flux += w;
+                cx += w * x;
+                cy += w * y;
+            }
+        }
+        star->flux = flux;
+        star->peak = c->peak - arguments->background;
+        star->diameter = 0.0;
+        star->fwhm = 0.0;
+        star->center.location[0] = c->x;
+        star->center.location[1] = c->y;
+        if(flux <= 0.0)
+            continue;
+        cx /= flux;
+        cy /= flux;
+        // Second pass around the centroid: flux weighted mean radius (HFR) and second moment (FWHM)
+        double hfr = 0.0, m2 = 0.0;
+        flux = 0.0;
+        for(y = -radius; y <= radius; y++) {
+            dsp_t *row = &stream->buf[(c->y + y) * width + c->x];
+            double dy = y - cy;
+            for(x = -radius; x <= radius; x++) {
+                if(x * x + y * y > r2)
+                    continue;
+                double w = row[x] - arguments->background;
+                if(w <= arguments->noise)
+                    continue;
+                double dx = x - cx;
+                double d2 = dx * dx + dy * dy;
+                flux += w;
+                hfr += w * sqrt(d2);
+                m2 += w * d2;
+            }
+        }
+        star->flux = flux;
+        star->diameter = hfr * 2.0 / flux;
+        star->fwhm = 2.0 * sqrt(2.0 * log(2.0)) * sqrt(m2 / (2.0 * flux));
+        star->center.location[0] = c->x + cx;
+        star->center.location[1] = c->y + cy;
+    }
+}
+
+int dsp_align_find_stars(dsp_stream_p stream, double sigma, int radius, int max_stars)
+{
+    if(stream == NULL)
+        return 0;
+    double background, noise;
+    dsp_stats_background(stream, &background, &noise);
+    return dsp_align_find_stars_background(stream, background, noise, sigma, radius, max_stars);
+}
+
+int dsp_align_find_stars_background(dsp_stream_p stream, double background, double noise, double sigma, int radius, int max_stars)
+{
+    if(stream == NULL)
+        return 0;
+    if(stream->dims < 2)
+        return 0;
+    int width = stream->sizes[0];
+    int height = stream->sizes[1];
+    if(radius < 1 || width <= radius * 2 || height <= radius * 2)
+        return 0;
+    long unsigned int t;
+    int i, j;
+
+    while(stream->stars_count > 0)
+        free(stream->stars[--stream->stars_count].center.location);
+
+    struct {
+        int radius;
+        dsp_t threshold;
+        dsp_stream_p stream;
+        dsp_star_candidate *candidates;
+        int candidates_count;
+        int candidates_allocated;
+    } scan_arguments[dsp_max_threads(0)];
+    for(t = 0; t < dsp_max_threads(0); t++) {
+        scan_arguments[t].radius = radius;
+        scan_arguments[t].threshold = background + noise * sigma;
+        scan_arguments[t].stream = stream;
+        scan_arguments[t].candidates = NULL;
+        scan_arguments[t].candidates_count = 0;
+        scan_arguments[t].candidates_allocated = 0;
+    }
+    dsp_parallel_for(height - radius * 2, 0, dsp_align_find_candidates_th, scan_arguments);
+    int candidates_count = 0;
+    for(t = 0; t < dsp_max_threads(0); t++)
+        candidates_count += scan_arguments[t].candidates_count;
+    dsp_star_candidate *candidates = (dsp_star_candidate*)malloc(sizeof(dsp_star_candidate) * (candidates_count + 1));
+    candidates_count = 0;
+    for(t = 0; t < dsp_max_threads(0); t++) {
+        if(scan_arguments[t].candidates_count > 0)
+            memcpy(&candidates[candidates_count], scan_arguments[t].candidates, sizeof(dsp_star_candidate) * scan_arguments[t].candidates_count);
+        candidates_count += scan_arguments[t].candidates_count;
+        free(scan_arguments[t].candidates);
+    }
+    qsort(candidates, candidates_count, sizeof(dsp_star_candidate), dsp_qsort_candidate_peak_desc);
+
+    // Brightest first, drop peaks falling into the aperture of an already accepted star
+    int stars_count = 0;
+    int r2 = radius * radius;
+    for(i = 0; i < candidates_count && (max_stars <= 0 || stars_count < max_stars); i++) {
+        for(j = 0; j < stars_count; j++) {
+            int dx = candidates[i].x - candidates[j].x;
+            int dy = candidates[i].y - candidates[j].y;
+            if(dx * dx + dy * dy <= r2)
+                break;
+        }
+        if(j == stars_count)
+            candidates[stars_count++] = candidates[i];
+    }
+
+    dsp_star *stars = (dsp_star*)malloc(sizeof(dsp_star) * (stars_count + 1));
+    double *locations = (double*)malloc(sizeof(double) * 2 * (stars_count + 1));
+    for(i = 0; i < stars_count; i++) {
+        sprintf(stars[i].name, "%d", i);
+        stars[i].center.dims = 2;
+        stars[i].center.location = &locations[i * 2];
+    }
+    struct {
+        int radius;
+        dsp_t background;
+        dsp_t noise;
+        dsp_stream_p stream;
+        dsp_star_candidate *candidates;
+        dsp_star *stars;
+    } measure_arguments;
+    measure_arguments.radius = radius;
+    measure_arguments.background = background;
+    measure_arguments.noise = noise;
+    measure_arguments.stream = stream;
+    measure_arguments.candidates = candidates;
+    measure_arguments.stars = stars;
+    dsp_parallel_for(stars_count, 1, dsp_align_measure_stars_th, &measure_arguments);
+
+    for(i = 0; i < stars_count; i++) {
+        if(stars[i].flux > 0.0)
+            dsp_stream_add_star(stream, stars[i]);
+    }
+    free(locations);
+    free(stars);
+    free(candidates);
+    return stream->stars_count;
+}
+
+// Stars combined into triangles, the brightest first: 20 stars give 1140 triangles
+#define DSP_ALIGN_TRIANGLE_STARS 20
+
+typedef struct dsp_triangle_key_t
+{
+    double ratios[2];
+    int stars[3];
+} dsp_triangle_key;
+
+static int dsp_qsort_triangle_key_asc(const void *arg1, const void *arg2)
+{
+    const dsp_triangle_key* a = (const dsp_triangle_key*)arg1;
+    const dsp_triangle_key* b = (const dsp_triangle_key*)arg2;
+    if(a->ratios[0] < b->ratios[0])
+        return -1;
+    if(a->ratios[0] > b->ratios[0])
+        return 1;
+    return 0;
+}
+
+static int dsp_align_star_index(dsp_stream_p stream, dsp_star *star)
+{
+    int i;
+    for(i = 0; i < stream->stars_count; i++) {
+        if(stream->stars[i].center.location[0] == star->center.location[0] &&
+           stream->stars[i].center.location[1] == star->center.location[1])
+            return i;
+    }
+    return -1;
+}
+
+// Side ratios and star indices of the triangles, sorted by the first ratio
+static dsp_triangle_key *dsp_align_triangle_keys(dsp_stream_p stream, int *count)
+{
+    dsp_triangle_key *keys = (dsp_triangle_key*)malloc(sizeof(dsp_triangle_key) * (stream->triangles_count + 1));
+    int t, s;
+    *count = 0;
+    for(t = 0; t < stream->triangles_count; t++) {
+        dsp_triangle *triangle = &stream->triangles[t];
+        if(triangle->dims != 3)
+            continue;
+        dsp_triangle_key *key = &keys[*count];
+        key->ratios[0] = triangle->ratios[1];
+        key->ratios[1] = triangle->ratios[2];
+        for(s = 0; s < 3; s++) {
+            key->stars[s] = dsp_align_star_index(stream, &triangle->stars[s]);
+            if(key->stars[s] < 0)
+                break;
+        }
+        if(s == 3)
+            (*count)++;
+    }
+    qsort(keys, *count, sizeof(dsp_triangle_key), dsp_qsort_triangle_key_asc);
+    return keys;
+}
+
+void dsp_stream_calc_triangles(dsp_stream_p stream)
+{
+    if(stream == NULL)
+        return;
+    int t, s, i, j, k;
+    for(t = 0; t < stream->triangles_count; t++) {
+        for(s = 0; s < stream->triangles[t].dims; s++)
+            free(stream->triangles[t].stars[s].center.location);
+        free(stream->triangles[t].stars);
+        free(stream->triangles[t].sizes);
+        free(stream->triangles[t].ratios);
+    }
+    stream->triangles_count = 0;
+    int n = Min(stream->stars_count, DSP_ALIGN_TRIANGLE_STARS);
+    dsp_star stars[3];
+    double sizes[3];
+    dsp_triangle triangle;
+    triangle.dims = 3;
+    triangle.sizes = sizes;
+    triangle.stars = stars;
+    for(i = 0; i < n; i++) {
+        for(j = i + 1; j < n; j++) {
+            for(k = j + 1; k < n; k++) {
+                dsp_star *v[3] = { &stream->stars[i], &stream->stars[j], &stream->stars[k] };
+                // Side s is opposite to the star s, then both are sorted by decreasing side length
+                for(s = 0; s < 3; s++) {
+                    double dx = v[(s + 2) % 3]->center.location[0] - v[(s + 1) % 3]->center.location[0];
+                    double dy = v[(s + 2) % 3]->center.location[1] - v[(s + 1) % 3]->center.location[1];
+                    sizes[s] = sqrt(dx * dx + dy * dy);
+                }
+                int a, b;
+                for(a = 0; a < 2; a++) {
+                    for(b = a + 1; b < 3; b++) {
+                        if(sizes[b] > sizes[a]) {
+                            double size = sizes[a];
+                            dsp_star *star = v[a];
+                            sizes[a] = sizes[b];
+                            v[a] = v[b];
+                            sizes[b] = size;
+                            v[b] = star;
+                        }
+                    }
+                }
+                // Too small to give stable ratios
+                if(sizes[2] < 2.0)
+                    continue;
+                for(s = 0; s < 3; s++)
+                    stars[s] = *v[s];
+                triangle.index = stream->triangles_count;
+                triangle.theta = atan2(v[2]->center.location[1] - v[1]->center.location[1], v[2]->center.location[0] - v[1]->center.location[0]);
+                dsp_stream_add_triangle(stream, triangle);
+            }
+        }
+    }
+}
+
+// Least squares fit of q = [a -b; b a] p + t over the pairs flagged in inliers
+static int dsp_align_fit(double *p, double *q, int *inliers, int count, double *fit)
+{
+    double pcx = 0.0, pcy = 0.0, qcx = 0.0, qcy = 0.0;
+    int i, n = 0;
+    for(i = 0; i < count; i++) {
+        if(!inliers[i])
+            continue;
+        pcx += p[i * 2];
+        pcy += p[i * 2 + 1];
+        qcx += q[i * 2];
+        qcy += q[i * 2 + 1];
+        n++;
+    }
+    if(n < 2)
+        return 0;
+    pcx /= n;
+    pcy /= n;
+    qcx /= n;
+    qcy /= n;
+    double sa = 0.0, sb = 0.0, norm = 0.0;
+    for(i = 0; i < count; i++) {
+        if(!inliers[i])
+            continue;
+        double px = p[i * 2] - pcx;
+        double py = p[i * 2 + 1] - pcy;
+        double qx = q[i * 2] - qcx;
+        double qy = q[i * 2 + 1] - qcy;
+        sa += px * qx + py * qy;
+        sb += px * qy - py * qx;
+        norm += px * px + py * py;
+    }
+    if(norm <= 0.0)
+        return 0;
+    fit[0] = sa / norm;
+    fit[1] = sb / norm;
+    fit[2] = qcx - fit[0] * pcx + fit[1] * pcy;
+    fit[3] = qcy - fit[1] * pcx - fit[0] * pcy;
+    return n;
+}
+
+int dsp_align_get_offset(dsp_stream_p ref, dsp_stream_p to_align, double tolerance, double target_score)
+{
+    if(ref == NULL || to_align == NULL)
+        return DSP_ALIGN_NO_MATCH;
+    if(ref->dims < 2 || to_align->dims < 2)
+        return DSP_ALIGN_NO_MATCH;
+    to_align->align_info.err = DSP_ALIGN_NO_MATCH;
+    to_align->align_info.score = 0.0;
+    to_align->align_info.decimals = tolerance;
+    if(ref->triangles_count == 0)
+        dsp_stream_calc_triangles(ref);
+    if(to_align->triangles_count == 0)
+        dsp_stream_calc_triangles(to_align);
+    int nref = Min(ref->stars_count, DSP_ALIGN_TRIANGLE_STARS);
+    int nalign = Min(to_align->stars_count, DSP_ALIGN_TRIANGLE_STARS);
+    if(nref < 3 || nalign < 3)
+        return DSP_ALIGN_NO_MATCH;
+    double radius = pow(10.0, -tolerance);
+    int ref_count, align_count, i, j, s;
+    dsp_triangle_key *ref_keys = dsp_align_triangle_keys(ref, &ref_count);
+    dsp_triangle_key *align_keys = dsp_align_triangle_keys(to_align, &align_count);
+
+    // Every pair of similar triangles votes for the correspondence of its stars
+    int *votes = (int*)calloc(nref * nalign, sizeof(int));
+    for(j = 0; j < align_count; j++) {
+        dsp_triangle_key *key = &align_keys[j];
+        int lo = 0, hi = ref_count;
+        while(lo < hi) {
+            int mid = (lo + hi) / 2;
+            if(ref_keys[mid].ratios[0] < key->ratios[0] - radius)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        for(i = lo; i < ref_count && ref_keys[i].ratios[0] <= key->ratios[0] + radius; i++) {
+            if(fabs(ref_keys[i].ratios[1] - key->ratios[1]) > radius)
+                continue;
+            for(s = 0; s < 3; s++) {
+                if(ref_keys[i].stars[s] < nref && key->stars[s] < nalign)
+                    votes[ref_keys[i].stars[s] * nalign + key->stars[s]]++;
+            }
+        }
+    }
+    free(ref_keys);
+    free(align_keys);
+
+    // Keep the mutual best correspondences
+    double *p = (double*)malloc(sizeof(double) * 2 * nalign);
+    double *q = (double*)malloc(sizeof(double) * 2 * nalign);
+    int *inliers = (int*)malloc(sizeof(int) * nalign);
+    int pairs = 0;
+    for(j = 0; j < nalign; j++) {
+        int best = -1;
+        for(i = 0; i < nref; i++) {
+            if(votes[i * nalign + j] > 1 && (best < 0 || votes[i * nalign + j] > votes[best * nalign + j]))
+                best = i;
+        }
+        if(best < 0)
+            continue;
+        for(s = 0; s < nalign; s++) {
+            if(s != j && votes[best * nalign + s] >= votes[best * nalign + j])
+                break;
+        }
+        if(s < nalign)
+            continue;
+        p[pairs * 2] = ref->stars[best].center.location[0];
+        p[pairs * 2 + 1] = ref->stars[best].center.location[1];
+        q[pairs * 2] = to_align->stars[j].center.location[0];
+        q[pairs * 2 + 1] = to_align->stars[j].center.location[1];
+        inliers[pairs++] = 1;
+    }
+    free(votes);
+
+    // Refit without the pairs far from the model until the inliers settle
+    double fit[4];
+    int matches = 0, iteration, changed = 1;
+    for(iteration = 0; iteration < 8 && changed; iteration++) {
+        matches = dsp_align_fit(p, q, inliers, pairs, fit);
+        if(matches < 3)
+            break;
+        double *residuals = (double*)malloc(sizeof(double) * pairs);
+        double *sorted = (double*)malloc(sizeof(double) * pairs);
+        int n = 0;
+        for(i = 0; i < pairs; i++) {
+            double dx = fit[0] * p[i * 2] - fit[1] * p[i * 2 + 1] + fit[2] - q[i * 2];
+            double dy = fit[1] * p[i * 2] + fit[0] * p[i * 2 + 1] + fit[3] - q[i * 2 + 1];
+            residuals[i] = sqrt(dx * dx + dy * dy);
+            if(inliers[i])
+                sorted[n++] = residuals[i];
+        }
+        qsort(sorted, n, sizeof(double), dsp_qsort_double_asc);
+        double threshold = Max(1.0, sorted[n / 2] * 3.0);
+        changed = 0;
+        for(i = 0; i < pairs; i++) {
+            int inlier = residuals[i] <= threshold;
+            changed |= inlier != inliers[i];
+            inliers[i] = inlier;
+        }
+        free(sorted);
+        free(residuals);
+    }
+    free(p);
+    free(q);
+    free(inliers);
+    if(matches < 3)
+        return DSP_ALIGN_NO_MATCH;
+
+    to_align->align_info.score = (double)matches / Min(nref, nalign);
+    if(to_align->align_info.score < target_score)
+        return DSP_ALIGN_NO_MATCH;
+
+    dsp_align_info *info = &to_align->align_info;
+    int d;
+    for(d = 0; d < to_align->dims; d++) {
+        info->center[d] = ref->sizes[d] / 2.0;
+        info->offset[d] = 0.0;
+        info->factor[d] = 1.0;
+        if(d > 0)
+            info->radians[d - 1] = 0.0;
+    }
+    double factor = sqrt(fit[0] * fit[0] + fit[1] * fit[1]);
+    info->factor[0] = info->factor[1] = factor;
+    info->radians[0] = atan2(fit[1], fit[0]);
+    info->offset[0] = fit[2] + fit[0] * info->center[0] - fit[1] * info->center[1] - info->center[0];
+    info->offset[1] = fit[3] + fit[1] * info->center[0] + fit[0] * info->center[1] - info->center[1];
+    info->err = 0;
+
+    int mask = 0;
+    if(fabs(info->offset[0]) > radius || fabs(info->offset[1]) > radius)
+        mask |= DSP_ALIGN_TRANSLATED;
+    if(fabs(factor - 1.0) > radius)
+        mask |= DSP_ALIGN_SCALED;
+    if(fabs(info->radians[0]) > radius)
+        mask |= DSP_ALIGN_ROTATED;
+    return mask;
+}
+
+void dsp_align_get_matrix(dsp_stream_p stream, double *matrix)
+{
+    if(stream == NULL || matrix == NULL)
+        return;
+    if(stream->dims < 2)
+        return;
+    dsp_align_info *info = &stream->align_info;
+    double c = cos(info->radians[0]);
+    double s = sin(info->radians[0]);
+    matrix[0] = info->factor[0] * c;
+    matrix[1] = -info->factor[0] * s;
+    matrix[3] = info->factor[1] * s;
+    matrix[4] = info->factor[1] * c;
+    matrix[2] = info->center[0] + info->offset[0] - matrix[0] * info->center[0] - matrix[1] * info->center[1];
+    matrix[5] = info->center[1] + info->offset[1] - matrix[3] * info->center[0] - matrix[4] * info->center[1];
+}
+
+dsp_stack_p dsp_stack_new(int interpolation, double sigma, int radius, double tolerance, double target_score)
+{
+    dsp_stack_p stack = (dsp_stack_p)malloc(sizeof(dsp_stack));
+    stack->reference = NULL;
+    stack->sum = NULL;
+    stack->coverage = NULL;
+    stack->frames = 0;
+    stack->rejected = 0;
+    stack->interpolation = interpolation;
+    stack->sigma = sigma;
+    stack->radius = radius;
+    stack->tolerance = tolerance;
+    stack->target_score = target_score;
+    return stack;
+}
+
+void dsp_stack_reset(dsp_stack_p stack)
+{
+    if(stack == NULL)
+        return;
+    if(stack->reference != NULL) {
+        dsp_stream_free_buffer(stack->reference);
+        dsp_stream_free(stack->reference);
+    }
+    if(stack->sum != NULL) {
+        dsp_stream_free_buffer(stack->sum);
+        dsp_stream_free(stack->sum);
+    }
+    free(stack->coverage);
+    stack->reference = NULL;
+    stack->sum = NULL;
+    stack->coverage = NULL;
+    stack->frames = 0;
+    stack->rejected = 0;
+}
+
+void dsp_stack_free(dsp_stack_p stack)
+{
+    if(stack == NULL)
+        return;
+    dsp_stack_reset(stack);
+    free(stack);
+}
+
+int dsp_stack_add(dsp_stack_p stack, dsp_stream_p frame)
+{
+    if(stack == NULL || frame == NULL)
+        return DSP_ALIGN_NO_MATCH;
+    if(frame->dims < 2) {
+        stack->rejected++;
+        return DSP_ALIGN_NO_MATCH;
+    }
+    int d;
+    if(stack->reference != NULL) {
+        for(d = 0; d < frame->dims && frame->dims == stack->reference->dims; d++) {
+            if(frame->sizes[d] != stack->reference->sizes[d])
+                break;
+        }
+        if(d != stack->reference->dims) {
+            stack->rejected++;
+            return DSP_ALIGN_NO_MATCH;
+        }
+    }
+    dsp_align_find_stars(frame, stack->sigma, stack->radius, DSP_ALIGN_TRIANGLE_STARS);
+    dsp_stream_calc_triangles(frame);
+    double matrix[6] = { 1.0, 0.0, 0.0, 0.0, 1.0, 0.0 };
+    int mask = 0;
+    if(stack->reference == NULL) {
+        if(frame->triangles_count == 0) {
+            stack->rejected++;
+            return DSP_ALIGN_NO_MATCH;
+        }
+        stack->reference = dsp_stream_copy(frame);
+        stack->sum = dsp_stream_copy(frame);
+        dsp_buffer_set(stack->sum->buf, stack->sum->len, 0);
+        stack->coverage = (dsp_t*)calloc(frame->len, sizeof(dsp_t));
+    } else {
+        mask = dsp_align_get_offset(stack->reference, frame, stack->tolerance, stack->target_score);
+        if(mask & DSP_ALIGN_NO_MATCH) {
+            stack->rejected++;
+            return mask;
+        }
+        dsp_align_get_matrix(frame, matrix);
+    }
+    dsp_stream_warp_add(stack->sum, frame, matrix, stack->interpolation, stack->coverage);
+    stack->frames++;
+    return mask;
+}
+
+dsp_stream_p dsp_stack_get(dsp_stack_p stack)
+{
+    if(stack == NULL || stack->sum == NULL)
+        return NULL;
+    dsp_stream_p stream = dsp_stream_copy(stack->sum);
+    int i;
+    for(i = 0; i < stream->len; i++)
+        stream->buf[i] = stack->coverage[i] > 0 ? stack->sum->buf[i] / stack->coverage[i] : 0;
+    return stream;
+}
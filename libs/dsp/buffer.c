@@ -268,26 +268,23 @@ static int compare( const void* a, const void* b)
      else return 1;
 }
 
-static void* dsp_buffer_median_th(void* arg)
+static void dsp_buffer_median_th(void* arg, int thread, int start, int end)
 {
     struct {
-        int cur_th;
         int size;
         int median;
         dsp_stream_p stream;
         dsp_stream_p box;
+        dsp_t* sorted;
      } *arguments = arg;
+    arguments += thread;
     dsp_stream_p stream = arguments->stream;
     dsp_stream_p box = arguments->box;
     dsp_stream_p in = stream->parent;
-    int cur_th = arguments->cur_th;
     int size = arguments->size;
     int median = arguments->median;
-    int start = cur_th * stream->len / dsp_max_threads(0);
-    int end = start + stream->len / dsp_max_threads(0);
-    end = Min(stream->len, end);
     int x, y, dim, idx;
-    dsp_t* sorted = (dsp_t*)malloc(pow(size, stream->dims) * sizeof(dsp_t));
+    dsp_t* sorted = arguments->sorted;
     int len = pow(size, in->dims);
     for(x = start; x < end; x++) {
         dsp_t* buf = sorted;
@@ -307,10 +304,6 @@ static void* dsp_buffer_median_th(void* arg)
         qsort(sorted, len, sizeof(dsp_t), compare);
         stream->buf[x] = sorted[median*box->len/size];
     }
-    dsp_stream_free_buffer(box);
-    dsp_stream_free(box);
-    free(sorted);
-    return NULL;
 }
 
 void dsp_buffer_median(dsp_stream_p in, int size, int median)
@@ -322,17 +315,15 @@ void dsp_buffer_median(dsp_stream_p in, int size, int median)
     dsp_stream_p stream = dsp_stream_copy(in);
     dsp_buffer_set(stream->buf, stream->len, 0);
     stream->parent = in;
-    pthread_t *th = (pthread_t *)malloc(sizeof(pthread_t)*dsp_max_threads(0));
     struct {
-       int cur_th;
        int size;
        int median;
        dsp_stream_p stream;
        dsp_stream_p box;
+       dsp_t* sorted;
     } thread_arguments[dsp_max_threads(0)];
     for(y = 0; y < dsp_max_threads(0); y++)
     {
-        thread_arguments[y].cur_th = y;
         thread_arguments[y].size = size;
         thread_arguments[y].median = median;
         thread_arguments[y].stream = stream;
@@ -340,35 +331,36 @@ void dsp_buffer_median(dsp_stream_p in, int size, int median)
         for(d = 0; d < stream->dims; d++)
             dsp_stream_add_dim(thread_arguments[y].box, size);
         dsp_stream_alloc_buffer(thread_arguments[y].box, thread_arguments[y].box->len);
-        pthread_create(&th[y], NULL, dsp_buffer_median_th, &thread_arguments[y]);
+        thread_arguments[y].sorted = (dsp_t*)malloc(pow(size, stream->dims) * sizeof(dsp_t));
     }
+    dsp_parallel_for(stream->len, 0, dsp_buffer_median_th, thread_arguments);
     for(y = 0; y < dsp_max_threads(0); y++)
-        pthread_join(th[y], NULL);
-    free(th);
+    {
+        dsp_stream_free_buffer(thread_arguments[y].box);
+        dsp_stream_free(thread_arguments[y].box);
+        free(thread_arguments[y].sorted);
+    }
     stream->parent = NULL;
     dsp_buffer_copy(stream->buf, in->buf, stream->len);
     dsp_stream_free_buffer(stream);
     dsp_stream_free(stream);
 }
 
-static void* dsp_buffer_sigma_th(void* arg)
+static void dsp_buffer_sigma_th(void* arg, int thread, int start, int end)
 {
     struct {
-        int cur_th;
         int size;
         dsp_stream_p stream;
         dsp_stream_p box;
+        dsp_t* sigma;
      } *arguments = arg;
+    arguments += thread;
     dsp_stream_p stream = arguments->stream;
     dsp_stream_p in = stream->parent;
     dsp_stream_p box = arguments->box;
-    int cur_th = arguments->cur_th;
     int size = arguments->size;
-    int start = cur_th * stream->len / dsp_max_threads(0);
-    int end = start + stream->len / dsp_max_threads(0);
-    end = Min(stream->len, end);
     int x, y, dim, idx;
-    dsp_t* sigma = (dsp_t*)malloc(pow(size, stream->dims) * sizeof(dsp_t));
+    dsp_t* sigma = arguments->sigma;
     int len = pow(size, in->dims);
     for(x = start; x < end; x++) {
         dsp_t* buf = sigma;
@@ -387,10 +379,6 @@ static void* dsp_buffer_sigma_th(void* arg)
         }
         stream->buf[x] = dsp_stats_stddev(buf, len);
     }
-    dsp_stream_free_buffer(box);
-    dsp_stream_free(box);
-    free(sigma);
-    return NULL;
 }
 
 void dsp_buffer_sigma(dsp_stream_p in, int size)
@@ -402,26 +390,28 @@ void dsp_buffer_sigma(dsp_stream_p in, int size)
     dsp_stream_p stream = dsp_stream_copy(in);
     dsp_buffer_set(stream->buf, stream->len, 0);
     stream->parent = in;
-    pthread_t *th = (pthread_t *)malloc(sizeof(pthread_t)*dsp_max_threads(0));
     struct {
-       int cur_th;
        int size;
        dsp_stream_p stream;
        dsp_stream_p box;
+       dsp_t* sigma;
     } thread_arguments[dsp_max_threads(0)];
     for(y = 0; y < dsp_max_threads(0); y++)
     {
-        thread_arguments[y].cur_th = y;
         thread_arguments[y].size = size;
         thread_arguments[y].stream = stream;
         thread_arguments[y].box = dsp_stream_new();
         for(d = 0; d < stream->dims; d++)
             dsp_stream_add_dim(thread_arguments[y].box, size);
-        pthread_create(&th[y], NULL, dsp_buffer_sigma_th, &thread_arguments[y]);
+        thread_arguments[y].sigma = (dsp_t*)malloc(pow(size, stream->dims) * sizeof(dsp_t));
     }
+    dsp_parallel_for(stream->len, 0, dsp_buffer_sigma_th, thread_arguments);
     for(y = 0; y < dsp_max_threads(0); y++)
-        pthread_join(th[y], NULL);
-    free(th);
+    {
+        dsp_stream_free_buffer(thread_arguments[y].box);
+        dsp_stream_free(thread_arguments[y].box);
+        free(thread_arguments[y].sigma);
+    }
     stream->parent = NULL;
     dsp_buffer_copy(stream->buf, in->buf, stream->len);
     dsp_stream_free_buffer(stream);
@@ -77,6 +77,18 @@ extern "C" {
 */
 DLL_EXPORT unsigned long int dsp_max_threads(unsigned long value);
 
+/**
+* \brief Run func over the items [0, count) on the libdsp worker pool
+* The pool is started on first use with dsp_max_threads(0) - 1 workers and persists, the calling thread participates.
+* Items are split evenly, then claimed chunk by chunk; a participant running out of work steals half of another
+* participant's remaining items. Nested or concurrent calls run inline in the calling thread.
+* \param count Number of items
+* \param chunk Number of items claimed at once, 0 picks a default
+* \param func Function processing the items [start, end), thread is the participant index, lower than dsp_max_threads(0)
+* \param arg User argument passed to func
+*/
+DLL_EXPORT void dsp_parallel_for(int count, int chunk, void (*func)(void *arg, int thread, int start, int end), void *arg);
+
 #ifndef DSP_DEBUG
 #define DSP_DEBUG
 /**
@@ -201,6 +213,18 @@ dsp_print(x, str); \
 ///No matches were found during comparison
 #define DSP_ALIGN_NO_MATCH 8
 #endif
+#ifndef DSP_INTERPOLATION_NEAREST
+///Nearest neighbour sampling
+#define DSP_INTERPOLATION_NEAREST 0
+#endif
+#ifndef DSP_INTERPOLATION_BILINEAR
+///Bilinear interpolation of the four surrounding pixels
+#define DSP_INTERPOLATION_BILINEAR 1
+#endif
+#ifndef DSP_INTERPOLATION_LANCZOS
+///Three lobes Lanczos interpolation, bilinear near the borders
+#define DSP_INTERPOLATION_LANCZOS 2
+#endif
 /**\}*/
 /**
  * \defgroup DSP_Types DSP API types
@@ -239,6 +263,12 @@ typedef struct dsp_star_t
     dsp_point center;
     /// The diameter of the star
     double diameter;
+    /// The full width at half maximum of the star profile
+    double fwhm;
+    /// The background subtracted flux of the star
+    double flux;
+    /// The background subtracted peak value of the star
+    double peak;
     /// The name of the star
     char name[150];
 } dsp_star;
@@ -426,6 +456,36 @@ typedef struct dsp_stream_t
     int frame_number;
 } dsp_stream, *dsp_stream_p;
 
+/**
+* \brief Running aligned stack of frames
+* \sa dsp_stack_new
+* \sa dsp_stack_add
+* \sa dsp_stack_get
+*/
+typedef struct dsp_stack_t
+{
+    /// The reference frame, carrying the stars and triangles every frame is registered against
+    dsp_stream_p reference;
+    /// Sum of the aligned frames
+    dsp_stream_p sum;
+    /// Number of frames contributing to each pixel of sum
+    dsp_t *coverage;
+    /// Frames added to the stack
+    int frames;
+    /// Frames rejected because they could not be registered
+    int rejected;
+    /// Interpolation used to resample the frames (DSP_INTERPOLATION_*)
+    int interpolation;
+    /// Star detection threshold in units of background noise
+    double sigma;
+    /// Maximum star radius in pixels
+    int radius;
+    /// Decimals of the triangle side ratios that must match
+    double tolerance;
+    /// Minimum fraction of matching stars required to stack a frame
+    double target_score;
+} dsp_stack, *dsp_stack_p;
+
 /**\}*/
 /**
  * \defgroup dsp_FourierTransform DSP API Fourier transform related functions
@@ -457,6 +517,17 @@ DLL_EXPORT void dsp_fourier_2dsp(dsp_stream_p stream);
 */
 DLL_EXPORT void dsp_fourier_2fftw(dsp_stream_p stream);
 
+/**
+* \brief Serialize the creation and destruction of fftw plans, the fftw planner is not thread safe
+* Code creating its own plans next to libdsp must hold this lock while planning.
+*/
+DLL_EXPORT void dsp_fourier_plan_lock(void);
+
+/**
+* \brief Release the lock taken by dsp_fourier_plan_lock
+*/
+DLL_EXPORT void dsp_fourier_plan_unlock(void);
+
 /**
 * \brief Obtain a complex array from phase and magnitude arrays
 * \param mag the input magnitude array.
@@ -761,6 +832,14 @@ DLL_EXPORT void dsp_convolution_correlation(dsp_stream_p stream, dsp_stream_p ma
 */
 DLL_EXPORT double* dsp_stats_histogram(dsp_stream_p stream, int size);
 
+/**
+* \brief Estimate the background level and its noise with an iterative sigma clipping
+* \param stream the input stream.
+* \param background the estimated background level.
+* \param noise the standard deviation of the background.
+*/
+DLL_EXPORT void dsp_stats_background(dsp_stream_p stream, double *background, double *noise);
+
 /**\}*/
 /**
  * \defgroup dsp_Buffers DSP API Buffer editing functions
@@ -1167,6 +1246,8 @@ DLL_EXPORT void dsp_stream_del_triangle(dsp_stream_p stream, int index);
 
 /**
 * \brief Calculate the triangles in the stream struct
+* Triangles are built from every combination of the brightest stars, their sides are sorted by decreasing length
+* and each star is the vertex opposite the side with the same index. Previous triangles are removed.
 * \param stream the target DSP stream.
 * \sa dsp_stream_new
 * \sa dsp_stream_add_triangle
@@ -1269,6 +1350,38 @@ DLL_EXPORT void dsp_stream_translate(dsp_stream_p stream);
 */
 DLL_EXPORT void dsp_stream_scale(dsp_stream_p stream);
 
+/**
+* \brief Resample the first two dimensions of a stream through an affine transformation
+* The output pixel (x, y) samples the input at (matrix[0] * x + matrix[1] * y + matrix[2], matrix[3] * x + matrix[4] * y + matrix[5]).
+* Source coordinates are advanced incrementally along each row and every row is clipped once to the samples falling
+* inside the frame, so the inner loops carry no bounds checks. Rows are processed on the worker pool and further
+* dimensions are warped plane by plane. Pixels sampling outside the frame are set to zero.
+* \param stream The stream that will be warped in-place
+* \param matrix The six coefficients of the affine transformation
+* \param interpolation One of DSP_INTERPOLATION_NEAREST, DSP_INTERPOLATION_BILINEAR or DSP_INTERPOLATION_LANCZOS
+* \sa dsp_align_get_matrix
+*/
+DLL_EXPORT void dsp_stream_warp(dsp_stream_p stream, double *matrix, int interpolation);
+
+/**
+* \brief Warp a frame through an affine transformation and add it to an accumulator stream
+* \param stream The accumulator stream, it must have the same sizes as frame
+* \param frame The frame to warp, it is not modified
+* \param matrix The six coefficients of the affine transformation, see dsp_stream_warp
+* \param interpolation One of DSP_INTERPOLATION_NEAREST, DSP_INTERPOLATION_BILINEAR or DSP_INTERPOLATION_LANCZOS
+* \param coverage If not NULL, incremented for every pixel of stream receiving a sample of frame
+*/
+DLL_EXPORT void dsp_stream_warp_add(dsp_stream_p stream, dsp_stream_p frame, double *matrix, int interpolation, dsp_t *coverage);
+
+/**
+* \brief Translate, rotate and scale a stream in a single pass using its align_info
+* Replaces successive calls to dsp_stream_scale, dsp_stream_rotate and dsp_stream_translate.
+* \param stream The stream that will be aligned in-place
+* \param interpolation One of DSP_INTERPOLATION_NEAREST, DSP_INTERPOLATION_BILINEAR or DSP_INTERPOLATION_LANCZOS
+* \sa dsp_align_get_offset
+*/
+DLL_EXPORT void dsp_stream_align(dsp_stream_p stream, int interpolation);
+
 /**\}*/
 /**
  * \defgroup dsp_SignalGen DSP API Signal generation functions
@@ -1462,14 +1575,88 @@ DLL_EXPORT dsp_t* dsp_file_bayer_2_composite(dsp_t *src, int red, int width, int
 
 /**
 * \brief Calculate offsets, rotation and scaling of two streams giving reference alignment point
+* Triangles of both streams are matched by their side ratios, every match votes for the correspondence of its three
+* stars. The mutual best correspondences are fitted with a rotation, scale and translation, rejecting outliers.
+* The result is stored into the align_info of to_align: a point p of ref is found in to_align at
+* center + factor * rotation(radians) * (p - center) + offset. Streams without triangles get them calculated.
 * \param ref the reference stream
 * \param to_align the stream to be aligned
 * \param tolerance number of decimals allowed
-* \param target_score the minimum matching score to reach
-* \return The alignment mask (bit1: translated, bit2: scaled, bit3: rotated)
+* \param target_score the minimum matching score to reach, the fraction of stars matching
+* \return The alignment mask (bit1: translated, bit2: scaled, bit3: rotated), DSP_ALIGN_NO_MATCH if the streams do not match
 */
 DLL_EXPORT int dsp_align_get_offset(dsp_stream_p ref, dsp_stream_p to_align, double tolerance, double target_score);
 
+/**
+* \brief Detect the stars contained into the first two dimensions of a stream and fill its stars array
+* Every star gets its centroid, its diameter (twice the half-flux radius), FWHM, flux and peak above the background.
+* \param stream the input stream, previously found stars are removed.
+* \param sigma the detection threshold in units of background noise
+* \param radius the maximum radius of a star in pixels, also used as minimum separation between stars
+* \param max_stars the maximum number of stars to detect, brightest first, 0 for no limit
+* \return The number of stars found
+*/
+DLL_EXPORT int dsp_align_find_stars(dsp_stream_p stream, double sigma, int radius, int max_stars);
+
+/**
+* \brief Detect the stars of a stream whose background level and noise are already known
+* Same as dsp_align_find_stars, without computing the background statistics again.
+* \param stream the input stream, previously found stars are removed.
+* \param background the background level, as returned by dsp_stats_background
+* \param noise the background noise, as returned by dsp_stats_background
+* \param sigma the detection threshold in units of background noise
+* \param radius the maximum radius of a star in pixels, also used as minimum separation between stars
+* \param max_stars the maximum number of stars to detect, brightest first, 0 for no limit
+* \return The number of stars found
+*/
+DLL_EXPORT int dsp_align_find_stars_background(dsp_stream_p stream, double background, double noise, double sigma, int radius, int max_stars);
+
+/**
+* \brief Build the affine matrix warping a stream onto its reference from its align_info
+* \param stream the stream aligned by dsp_align_get_offset
+* \param matrix the six coefficients of the transformation, see dsp_stream_warp
+*/
+DLL_EXPORT void dsp_align_get_matrix(dsp_stream_p stream, double *matrix);
+
+/**
+* \brief Create a running aligned stack
+* \param interpolation the interpolation used to resample the frames (DSP_INTERPOLATION_*)
+* \param sigma the star detection threshold in units of background noise
+* \param radius the maximum radius of a star in pixels
+* \param tolerance number of decimals of the triangle side ratios that must match
+* \param target_score the minimum fraction of matching stars required to stack a frame
+* \return The new stack
+*/
+DLL_EXPORT dsp_stack_p dsp_stack_new(int interpolation, double sigma, int radius, double tolerance, double target_score);
+
+/**
+* \brief Register a frame against the first frame of the stack and add it
+* The stars of frame are detected and its triangles calculated. The first frame added becomes the reference.
+* \param stack the stack
+* \param frame the frame to add, with the same sizes as the reference
+* \return The alignment mask of the frame, DSP_ALIGN_NO_MATCH if it was rejected
+*/
+DLL_EXPORT int dsp_stack_add(dsp_stack_p stack, dsp_stream_p frame);
+
+/**
+* \brief Get the mean of the stacked frames, each pixel divided by the number of frames covering it
+* \param stack the stack
+* \return A new stream, NULL if no frame was stacked
+*/
+DLL_EXPORT dsp_stream_p dsp_stack_get(dsp_stack_p stack);
+
+/**
+* \brief Remove all the frames and the reference from a stack
+* \param stack the stack
+*/
+DLL_EXPORT void dsp_stack_reset(dsp_stack_p stack);
+
+/**
+* \brief Free a stack and its frames
+* \param stack the stack
+*/
+DLL_EXPORT void dsp_stack_free(dsp_stack_p stack);
+
 /**
 * \brief Callback function for qsort for double type ascending ordering
 * \param arg1 the first comparison element
@@ -20,20 +20,37 @@
 #include "dsp.h"
 #include <fftw3.h>
 
+// The fftw planner is not thread safe, plans are created and destroyed under this lock
+static pthread_mutex_t dsp_fourier_plan_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+void dsp_fourier_plan_lock(void)
+{
+    pthread_mutex_lock(&dsp_fourier_plan_mutex);
+}
+
+void dsp_fourier_plan_unlock(void)
+{
+    pthread_mutex_unlock(&dsp_fourier_plan_mutex);
+}
+
 static void dsp_fourier_dft_magnitude(dsp_stream_p stream)
 {
     if(stream == NULL)
         return;
-    if(stream->magnitude)
+    if(stream->magnitude) {
+        free(stream->magnitude->buf);
         stream->magnitude->buf = dsp_fourier_complex_array_get_magnitude(stream->dft, stream->len);
+    }
 }
 
 static void dsp_fourier_dft_phase(dsp_stream_p stream)
 {
     if(stream == NULL)
         return;
-    if(stream->phase)
+    if(stream->phase) {
+        free(stream->phase->buf);
         stream->phase->buf = dsp_fourier_complex_array_get_phase(stream->dft, stream->len);
+    }
 }
 
 void dsp_fourier_2dsp(dsp_stream_p stream)
@@ -134,14 +151,16 @@ dsp_complex dsp_fourier_phase_mag_array_get_complex(double* mag, double* phi, in
     return out;
 }
 
-static void* dsp_stream_dft_th(void* arg)
+static void dsp_stream_dft_th(void* arg, int thread, int start, int end)
 {
     struct {
         int exp;
        dsp_stream_p stream;
     } *arguments = arg;
-    dsp_fourier_dft(arguments->stream, arguments->exp);
-    return NULL;
+    int x;
+    (void)thread;
+    for(x = start; x < end; x++)
+        dsp_fourier_dft(arguments[x].stream, arguments[x].exp);
 }
 void dsp_fourier_dft(dsp_stream_p stream, int exp)
 {
@@ -158,27 +177,27 @@ void dsp_fourier_dft(dsp_stream_p stream, int exp)
     dsp_buffer_copy(stream->buf, buf, stream->len);
     int *sizes = (int*)malloc(sizeof(int)*stream->dims);
     dsp_buffer_reverse(sizes, stream->dims);
+    pthread_mutex_lock(&dsp_fourier_plan_mutex);
     fftw_plan plan = fftw_plan_dft_r2c(stream->dims, stream->sizes, buf, stream->dft.fftw, FFTW_ESTIMATE_PATIENT);
+    pthread_mutex_unlock(&dsp_fourier_plan_mutex);
     fftw_execute(plan);
-    fftw_free(plan);
+    pthread_mutex_lock(&dsp_fourier_plan_mutex);
+    fftw_destroy_plan(plan);
+    pthread_mutex_unlock(&dsp_fourier_plan_mutex);
     free(sizes);
     free(buf);
     dsp_fourier_2dsp(stream);
     if(exp > 1) {
         exp--;
-        pthread_t th[2];
         struct {
            int exp;
            dsp_stream_p stream;
         } thread_arguments[2];
         thread_arguments[0].exp = exp;
         thread_arguments[0].stream = stream->phase;
-        pthread_create(&th[0], NULL, dsp_stream_dft_th, &thread_arguments[0]);
         thread_arguments[1].exp = exp;
         thread_arguments[1].stream = stream->magnitude;
-        pthread_create(&th[1], NULL, dsp_stream_dft_th, &thread_arguments[1]);
-        pthread_join(th[0], NULL);
-        pthread_join(th[1], NULL);
+        dsp_parallel_for(2, 1, dsp_stream_dft_th, thread_arguments);
     }
 }
 
@@ -194,9 +213,13 @@ void dsp_fourier_idft(dsp_stream_p stream)
     dsp_fourier_2fftw(stream);
     int *sizes = (int*)malloc(sizeof(int)*stream->dims);
     dsp_buffer_reverse(sizes, stream->dims);
+    pthread_mutex_lock(&dsp_fourier_plan_mutex);
     fftw_plan plan = fftw_plan_dft_c2r(stream->dims, stream->sizes, stream->dft.fftw, buf, FFTW_ESTIMATE_PATIENT);
+    pthread_mutex_unlock(&dsp_fourier_plan_mutex);
     fftw_execute(plan);
-    fftw_free(plan);
+    pthread_mutex_lock(&dsp_fourier_plan_mutex);
+    fftw_destroy_plan(plan);
+    pthread_mutex_unlock(&dsp_fourier_plan_mutex);
     free(sizes);
     dsp_buffer_stretch(buf, stream->len, mn, mx);
     dsp_buffer_copy(buf, stream->buf, stream->len);
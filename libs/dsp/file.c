@@ -24,6 +24,94 @@
 #include <unistd.h>
 #include <jpeglib.h>
 
+/* Pixels converted at once when writing, the staging block stays in cache */
+#define DSP_FITS_BLOCK 4096
+
+/* Stretch a block of samples from [mn, mn + iratio] to [0, oratio] casting them to the output type in the same pass */
+#define dsp_file_stretch_block(in, out, len, mn, oratio, iratio) \
+    ({ \
+        int k; \
+        for(k = 0; k < len; k++) { \
+            out[k] = (__typeof(out[0]))((double)(in[k] - mn) * oratio / iratio); \
+        } \
+    })
+
+static int dsp_file_fits_types(int bpp, int *img_type, int *byte_type)
+{
+    switch (bpp)
+    {
+        case 8:
+            *byte_type = TBYTE;
+            *img_type  = BYTE_IMG;
+            return 1;
+        case 16:
+            *byte_type = TUSHORT;
+            *img_type  = USHORT_IMG;
+            return 1;
+        case 32:
+            *byte_type = TUINT;
+            *img_type  = ULONG_IMG;
+            return 1;
+        case 64:
+            *byte_type = TLONGLONG;
+            *img_type  = LONGLONG_IMG;
+            return 1;
+        case -32:
+            *byte_type = TFLOAT;
+            *img_type  = FLOAT_IMG;
+            return 1;
+        case -64:
+            *byte_type = TDOUBLE;
+            *img_type  = DOUBLE_IMG;
+            return 1;
+        default:
+            perr("Unsupported bits per sample value %d", bpp);
+            return 0;
+    }
+}
+
+/* Stretch the samples to [0, max] and write them from the given pixel on, one staging block at a time */
+static void dsp_file_write_fits_plane(fitsfile *fptr, int bpp, int byte_type, dsp_t *in, int len, long first, dsp_t max, int *status)
+{
+    int offset, n;
+    dsp_t mn = dsp_stats_min(in, len);
+    dsp_t mx = dsp_stats_max(in, len);
+    double oratio = max;
+    double iratio = mx - mn;
+    void *block = malloc((size_t)DSP_FITS_BLOCK * (size_t)abs(bpp) / 8);
+    if(block == NULL) {
+        *status = MEMORY_ALLOCATION;
+        return;
+    }
+    if(iratio == 0) iratio = 1;
+    for(offset = 0; offset < len && !*status; offset += DSP_FITS_BLOCK) {
+        n = Min(DSP_FITS_BLOCK, len - offset);
+        switch (bpp)
+        {
+            case 8:
+                dsp_file_stretch_block((&in[offset]), ((unsigned char*)block), n, mn, oratio, iratio);
+                break;
+            case 16:
+                dsp_file_stretch_block((&in[offset]), ((unsigned short*)block), n, mn, oratio, iratio);
+                break;
+            case 32:
+                dsp_file_stretch_block((&in[offset]), ((unsigned int*)block), n, mn, oratio, iratio);
+                break;
+            case 64:
+                dsp_file_stretch_block((&in[offset]), ((long long*)block), n, mn, oratio, iratio);
+                break;
+            case -32:
+                dsp_file_stretch_block((&in[offset]), ((float*)block), n, mn, oratio, iratio);
+                break;
+            case -64:
+                dsp_file_stretch_block((&in[offset]), ((double*)block), n, mn, oratio, iratio);
+                break;
+        }
+        fits_write_img(fptr, byte_type, first + offset, n, block, status);
+    }
+    free(block);
+}
+
 dsp_stream_p* dsp_file_read_fits(const char* filename, int *channels, int stretch)
 {
     fitsfile *fptr;
@@ -32,6 +120,8 @@ dsp_stream_p* dsp_file_read_fits(const char* filename, int *channels, int stretc
     char value[150];
     char comment[150];
     char error_status[64];
+    dsp_stream_p* stream = NULL;
+    int x, y;
 
     fits_open_file(&fptr, filename, READONLY, &status);
 
@@ -43,7 +133,7 @@ dsp_stream_p* dsp_file_read_fits(const char* filename, int *channels, int stretc
     fits_movabs_hdu(fptr, 1, IMAGE_HDU, &status);
     if(status)
     {
-        goto fail;
+        goto fail_fptr;
     }
 
     int dims;
@@ -51,68 +141,12 @@ dsp_stream_p* dsp_file_read_fits(const char* filename, int *channels, int stretc
     fits_get_img_param(fptr, 3, &bpp, &dims, naxes, &status);
     if(status)
     {
-        goto fail;
+        goto fail_fptr;
     }
-    bpp = fmax(16, bpp);
     int dim, nelements = 1;
     for(dim = 0; dim < dims; dim++) {
         nelements *= naxes[dim];
     }
-    void *array = malloc(((size_t)abs(bpp) * nelements / 8));
-    int anynul = 0;
-    dsp_t* buf = (dsp_t*)malloc(sizeof(dsp_t)*(size_t)(nelements+1));
-    switch(bpp) {
-    case BYTE_IMG:
-        fits_read_img(fptr, TBYTE, 1, (long)nelements, NULL, array, &anynul, &status);
-        dsp_buffer_stretch(((unsigned char*)(array)), (long)nelements, 0, dsp_t_max);
-        dsp_buffer_copy(((unsigned char*)array), buf, nelements);
-        break;
-    case SHORT_IMG:
-        fits_read_img(fptr, TUSHORT, 1, (long)nelements, NULL, array, &anynul, &status);
-        if((size_t)abs(bpp) > 8*sizeof(dsp_t))
-            dsp_buffer_stretch(((unsigned short*)(array)), (long)nelements, 0, dsp_t_max);
-        dsp_buffer_copy(((unsigned short*)array), buf, nelements);
-        break;
-    case USHORT_IMG:
-        fits_read_img(fptr, TUSHORT, 1, (long)nelements, NULL, array, &anynul, &status);
-        if((size_t)abs(bpp) > 8*sizeof(dsp_t))
-            dsp_buffer_stretch(((unsigned short*)(array)), (long)nelements, 0, dsp_t_max);
-        dsp_buffer_copy(((unsigned short*)array), buf, nelements);
-        break;
-    case LONG_IMG:
-        fits_read_img(fptr, TULONG, 1, (long)nelements, NULL, array, &anynul, &status);
-        if((size_t)abs(bpp) > 8*sizeof(dsp_t))
-            dsp_buffer_stretch(((int*)(array)), (long)nelements, 0, dsp_t_max);
-        dsp_buffer_copy(((int*)array), buf, nelements);
-        break;
-    case ULONG_IMG:
-        fits_read_img(fptr, TULONG, 1, (long)nelements, NULL, array, &anynul, &status);
-        if((size_t)abs(bpp) > 8*sizeof(dsp_t))
-            dsp_buffer_stretch(((unsigned int*)(array)), (long)nelements, 0, dsp_t_max);
-        dsp_buffer_copy(((unsigned int*)array), buf, nelements);
-        break;
-    case LONGLONG_IMG:
-        fits_read_img(fptr, TLONGLONG, 1, (long)nelements, NULL, array, &anynul, &status);
-        if((size_t)abs(bpp) > 8*sizeof(dsp_t))
-            dsp_buffer_stretch(((long*)(array)), (long)nelements, 0, dsp_t_max);
-        dsp_buffer_copy(((long*)array), buf, nelements);
-        break;
-    case FLOAT_IMG:
-        fits_read_img(fptr, TFLOAT, 1, (long)nelements, NULL, array, &anynul, &status);
-        if((size_t)abs(bpp) > 8*sizeof(dsp_t))
-            dsp_buffer_stretch(((float*)(array)), (long)nelements, 0, dsp_t_max);
-        dsp_buffer_copy(((float*)array), buf, nelements);
-        break;
-    case DOUBLE_IMG:
-        fits_read_img(fptr, TDOUBLE, 1, (long)nelements, NULL, array, &anynul, &status);
-        if((size_t)abs(bpp) > 8*sizeof(dsp_t))
-            dsp_buffer_stretch(((double*)(array)), (long)nelements, 0, dsp_t_max);
-        dsp_buffer_copy(((double*)array), buf, nelements);
-        break;
-    }
-    free(array);
-    if(status||anynul)
-        goto fail;
     int red = -1;
     ffgkey(fptr, "XBAYROFF", value, comment, &status);
     if (!status)
@@ -127,23 +161,51 @@ dsp_stream_p* dsp_file_read_fits(const char* filename, int *channels, int stretc
         red |= atoi(value)<<1;
     }
     status = 0;
-    fits_close_file(fptr, &status);
-    if(status)
-        goto fail;
-    dsp_stream_p* stream;
-    int x;
-    void* rgb = NULL;
+    int anynul = 0;
     int sizes[2] = { naxes[0], naxes[1] };
+    // cfitsio converts from the pixel type of the file straight into dsp_t, plane by plane
     if(red > -1) {
+        dsp_t* buf = (dsp_t*)malloc(sizeof(dsp_t)*(size_t)nelements);
+        fits_read_img(fptr, TDOUBLE, 1, (long)nelements, NULL, buf, &anynul, &status);
+        if(status||anynul) {
+            free(buf);
+            goto fail_fptr;
+        }
         *channels = 3;
-        rgb = dsp_file_bayer_2_rgb(buf, red, naxes[0], naxes[1]);
-        stream =  dsp_buffer_rgb_to_components(rgb, dims, sizes, *channels, 32, 0);
+        void* rgb = dsp_file_bayer_2_rgb(buf, red, naxes[0], naxes[1]);
+        free(buf);
+        // rgb is freed by dsp_buffer_rgb_to_components
+        stream = dsp_buffer_rgb_to_components(rgb, dims, sizes, *channels, -64, 0);
     } else {
         *channels = naxes[2];
         dims = 2;
-        stream = dsp_stream_from_components(buf, dims, sizes, *channels);
+        stream = (dsp_stream_p*)malloc(sizeof(dsp_stream_p)*(size_t)(*channels+1));
+        for(y = 0; y <= *channels; y++) {
+            stream[y] = dsp_stream_new();
+            for(dim = 0; dim < dims; dim++)
+                dsp_stream_add_dim(stream[y], sizes[dim]);
+            dsp_stream_alloc_buffer(stream[y], stream[y]->len);
+        }
+        for(y = 0; y < *channels && !status && !anynul; y++)
+            fits_read_img(fptr, TDOUBLE, 1 + (long)y * stream[y]->len, stream[y]->len, NULL, stream[y]->buf, &anynul, &status);
+        if(status||anynul) {
+            for(y = 0; y <= *channels; y++) {
+                dsp_stream_free_buffer(stream[y]);
+                dsp_stream_free(stream[y]);
+            }
+            free(stream);
+            stream = NULL;
+            goto fail_fptr;
+        }
+        for(x = 0; x < stream[*channels]->len; x++) {
+            double val = 0;
+            for(y = 0; y < *channels; y++) {
+                val += stream[y]->buf[x];
+            }
+            stream[*channels]->buf[x] = (dsp_t)val/(*channels);
+        }
     }
-    free(buf);
+    fits_close_file(fptr, &status);
     if(stream) {
         if(stretch) {
             for (x = 0; x < *channels; x++) {
@@ -159,72 +221,29 @@ fail:
         perr("FITS Error: %s\n", error_status);
     }
     return NULL;
+fail_fptr:
+    if(status) {
+        fits_get_errstatus(status, error_status);
+        perr("FITS Error: %s\n", error_status);
+    }
+    status = 0;
+    fits_close_file(fptr, &status);
+    return NULL;
 }
 
 void dsp_file_write_fits(const char* filename, int bpp, dsp_stream_p stream)
 {
-    dsp_stream_p tmp = dsp_stream_copy(stream);
     int img_type  = USHORT_IMG;
     int byte_type = TUSHORT;
-    char bit_depth[64] = "16 bits per sample";
-    void* buf = malloc((size_t)(tmp->len * (size_t)abs(bpp) / 8 + 512));
     int status    = 0;
-    int naxis    = tmp->dims;
-    long *naxes = (long*)malloc(sizeof(long) * (size_t)tmp->dims);
-    long nelements = tmp->len;
+    int naxis    = stream->dims;
+    long *naxes = (long*)malloc(sizeof(long) * (size_t)stream->dims);
     char error_status[64];
     int i;
-    dsp_buffer_stretch(tmp->buf, tmp->len, 0, dsp_t_max);
-    for (i = 0;  i < tmp->dims; i++)
-        naxes[i] = tmp->sizes[i];
-    switch (bpp)
-    {
-        case 8:
-            byte_type = TBYTE;
-            img_type  = BYTE_IMG;
-            dsp_buffer_copy(tmp->buf, ((unsigned char*)buf), tmp->len);
-            strcpy(bit_depth, "8 bits unsigned integer per sample");
-            break;
-
-        case 16:
-            byte_type = TUSHORT;
-            img_type  = USHORT_IMG;
-            dsp_buffer_copy(tmp->buf, ((unsigned short*)buf), tmp->len);
-            strcpy(bit_depth, "16 bits unsigned integer per sample");
-            break;
-
-        case 32:
-            byte_type = TULONG;
-            img_type  = ULONG_IMG;
-            dsp_buffer_copy(tmp->buf, ((unsigned int*)buf), tmp->len);
-            strcpy(bit_depth, "32 bits unsigned integer per sample");
-            break;
-
-        case 64:
-            byte_type = TLONGLONG;
-            img_type  = LONGLONG_IMG;
-            dsp_buffer_copy(tmp->buf, ((unsigned long*)buf), tmp->len);
-            strcpy(bit_depth, "64 bits unsigned integer per sample");
-            break;
-
-        case -32:
-            byte_type = TFLOAT;
-            img_type  = FLOAT_IMG;
-            dsp_buffer_copy(tmp->buf, ((float*)buf), tmp->len);
-            strcpy(bit_depth, "32 bits floating point per sample");
-            break;
-
-        case -64:
-            byte_type = TDOUBLE;
-            img_type  = DOUBLE_IMG;
-            dsp_buffer_copy(tmp->buf, ((double*)buf), tmp->len);
-            strcpy(bit_depth, "64 bits floating point per sample");
-            break;
-
-        default:
-            perr("Unsupported bits per sample value %d", bpp);
-            goto fail;
-    }
+    for (i = 0;  i < stream->dims; i++)
+        naxes[i] = stream->sizes[i];
+    if(!dsp_file_fits_types(bpp, &img_type, &byte_type))
+        goto fail;
 
     unlink(filename);
     fitsfile *fptr;
@@ -242,7 +261,7 @@ void dsp_file_write_fits(const char* filename, int bpp, dsp_stream_p stream)
         goto fail_fptr;
     }
 
-    fits_write_img(fptr, byte_type, 1, nelements, buf, &status);
+    dsp_file_write_fits_plane(fptr, bpp, byte_type, stream->buf, stream->len, 1, dsp_t_max, &status);
 
     if (status)
     {
@@ -257,10 +276,7 @@ fail_fptr:
         perr("FITS Error: %s\n", error_status);
     }
 fail:
-    dsp_stream_free_buffer(tmp);
-    dsp_stream_free(tmp);
     free(naxes);
-    free (buf);
 }
 
 void dsp_file_write_fits_composite(const char* filename, int components, int bpp, dsp_stream_p* stream)
@@ -269,72 +285,17 @@ void dsp_file_write_fits_composite(const char* filename, int components, int bpp
     dsp_stream_p tmp = stream[components];
     int img_type  = USHORT_IMG;
     int byte_type = TUSHORT;
-    char bit_depth[64] = "16 bits per sample";
-    void* buf = malloc((size_t)(tmp->len * components * (size_t)abs(bpp) / 8 + 512));
     int status    = 0;
     int naxis    = tmp->dims + 1;
     long *naxes = (long*)malloc(sizeof(long) * (size_t)(tmp->dims + 1));
-    long nelements = tmp->len * components;
     char error_status[64];
     int i;
     for (i = 0;  i < tmp->dims; i++)
         naxes[i] = tmp->sizes[i];
     naxes[i] = components;
     dsp_t max = (1<<(size_t)abs(bpp))/2-1;
-    for(x = 0; x < components; x++) {
-        tmp = dsp_stream_copy(stream[x]);
-        dsp_buffer_stretch(tmp->buf, tmp->len, 0, (dsp_t)max);
-        switch (bpp)
-        {
-            case 8:
-                byte_type = TBYTE;
-                img_type  = BYTE_IMG;
-                dsp_buffer_copy(tmp->buf, ((unsigned char*)&((unsigned char*)buf)[tmp->len*x]), tmp->len);
-                strcpy(bit_depth, "8 bits unsigned integer per sample");
-                break;
-
-            case 16:
-                byte_type = TUSHORT;
-                img_type  = USHORT_IMG;
-                dsp_buffer_copy(tmp->buf, ((unsigned short*)&((unsigned short*)buf)[tmp->len*x]), tmp->len);
-                strcpy(bit_depth, "16 bits unsigned integer per sample");
-                break;
-
-            case 32:
-                byte_type = TULONG;
-                img_type  = ULONG_IMG;
-                dsp_buffer_copy(tmp->buf, ((unsigned int*)&((unsigned int*)buf)[tmp->len*x]), tmp->len);
-                strcpy(bit_depth, "32 bits unsigned integer per sample");
-                break;
-
-            case 64:
-                byte_type = TLONGLONG;
-                img_type  = LONGLONG_IMG;
-                dsp_buffer_copy(tmp->buf, ((unsigned long*)&((unsigned long*)buf)[tmp->len*x]), tmp->len);
-                strcpy(bit_depth, "64 bits unsigned integer per sample");
-                break;
-
-            case -32:
-                byte_type = TFLOAT;
-                img_type  = FLOAT_IMG;
-                dsp_buffer_copy(tmp->buf, ((float*)&((float*)buf)[tmp->len*x]), tmp->len);
-                strcpy(bit_depth, "32 bits floating point per sample");
-                break;
-
-            case -64:
-                byte_type = TDOUBLE;
-                img_type  = DOUBLE_IMG;
-                dsp_buffer_copy(tmp->buf, ((double*)&((double*)buf)[tmp->len*x]), tmp->len);
-                strcpy(bit_depth, "64 bits floating point per sample");
-            break;
-
-            default:
-                perr("Unsupported bits per sample value %d", bpp);
-                break;
-        }
-        dsp_stream_free_buffer(tmp);
-        dsp_stream_free(tmp);
-    }
+    if(!dsp_file_fits_types(bpp, &img_type, &byte_type))
+        goto fail;
 
     unlink(filename);
     fitsfile *fptr;
@@ -352,7 +313,9 @@ void dsp_file_write_fits_composite(const char* filename, int components, int bpp
         goto fail_fptr;
     }
 
-    fits_write_img(fptr, byte_type, 1, nelements, buf, &status);
+    // Each component is a plane of the image
+    for(x = 0; x < components && !status; x++)
+        dsp_file_write_fits_plane(fptr, bpp, byte_type, stream[x]->buf, stream[x]->len, 1 + (long)tmp->len * x, max, &status);
 
     if (status)
     {
@@ -366,83 +329,28 @@ fail_fptr:
         fits_get_errstatus(status, error_status);
         perr("FITS Error: %s\n", error_status);
     }
+fail:
     free(naxes);
-    free (buf);
 }
 
 
 void dsp_file_write_fits_bayer(const char* filename, int components, int bpp, dsp_stream_p* stream)
 {
     int red = 0;
-    int x;
-    dsp_stream_p tmp = dsp_stream_copy(stream[components]);
+    dsp_stream_p tmp = stream[components];
     int img_type  = USHORT_IMG;
     int byte_type = TUSHORT;
-    char bit_depth[64] = "16 bits per sample";
-    int len = tmp->len;
-    void* data = malloc((size_t)(len * (size_t)abs(bpp) / 8 + 512));
     int status    = 0;
     int naxis    = tmp->dims;
     long *naxes = (long*)malloc(sizeof(long) * (size_t)(tmp->dims));
-    long nelements = tmp->len;
     char error_status[64];
     int i;
     for (i = 0;  i < tmp->dims; i++)
         naxes[i] = tmp->sizes[i];
-    dsp_t *buf = dsp_file_composite_2_bayer(stream, red, tmp->sizes[0], tmp->sizes[1]);
-    dsp_stream_free_buffer(tmp);
-    dsp_stream_free(tmp);
-    for(x = 0; x < components; x++) {
-        dsp_buffer_stretch(buf, stream[components]->len, 0, (dsp_t)(1<<(size_t)abs(bpp))-1);
-        switch (bpp)
-        {
-            case 8:
-                byte_type = TBYTE;
-                img_type  = BYTE_IMG;
-                dsp_buffer_copy(buf, ((unsigned char*)((unsigned char*)data)), stream[components]->len);
-                strcpy(bit_depth, "8 bits unsigned integer per sample");
-                break;
-
-            case 16:
-                byte_type = TUSHORT;
-                img_type  = USHORT_IMG;
-                dsp_buffer_copy(buf, ((unsigned short*)((unsigned short*)data)), stream[components]->len);
-                strcpy(bit_depth, "16 bits unsigned integer per sample");
-                break;
-
-            case 32:
-                byte_type = TULONG;
-                img_type  = ULONG_IMG;
-                dsp_buffer_copy(buf, ((unsigned int*)((unsigned int*)data)), stream[components]->len);
-                strcpy(bit_depth, "32 bits unsigned integer per sample");
-                break;
-
-            case 64:
-                byte_type = TLONGLONG;
-                img_type  = LONGLONG_IMG;
-                dsp_buffer_copy(buf, ((unsigned long*)((unsigned long*)data)), stream[components]->len);
-                strcpy(bit_depth, "64 bits unsigned integer per sample");
-                break;
-
-            case -32:
-                byte_type = TFLOAT;
-                img_type  = FLOAT_IMG;
-                dsp_buffer_copy(buf, ((float*)((float*)data)), stream[components]->len);
-                strcpy(bit_depth, "32 bits floating point per sample");
-                break;
-
-            case -64:
-                byte_type = TDOUBLE;
-                img_type  = DOUBLE_IMG;
-                dsp_buffer_copy(buf, ((double*)((double*)data)), stream[components]->len);
-                strcpy(bit_depth, "64 bits floating point per sample");
-            break;
-
-            default:
-                perr("Unsupported bits per sample value %d", bpp);
-                break;
-        }
-    }
+    dsp_t *buf = NULL;
+    if(!dsp_file_fits_types(bpp, &img_type, &byte_type))
+        goto fail;
+    buf = dsp_file_composite_2_bayer(stream, red, tmp->sizes[0], tmp->sizes[1]);
 
     unlink(filename);
     fitsfile *fptr;
@@ -494,7 +402,7 @@ void dsp_file_write_fits_bayer(const char* filename, int components, int bpp, ds
         goto fail_fptr;
     }
 
-    fits_write_img(fptr, byte_type, 1, nelements, data, &status);
+    dsp_file_write_fits_plane(fptr, bpp, byte_type, buf, tmp->len, 1, (dsp_t)(1<<(size_t)abs(bpp))-1, &status);
 
     if (status)
     {
@@ -508,8 +416,9 @@ fail_fptr:
         fits_get_errstatus(status, error_status);
         perr("FITS Error: %s\n", error_status);
     }
+fail:
     free(naxes);
-    free (data);
+    free(buf);
 }
 dsp_stream_p* dsp_file_read_jpeg(const char* filename, int *channels, int stretch)
 {
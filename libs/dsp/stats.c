@@ -42,3 +42,81 @@ double* dsp_stats_histogram(dsp_stream_p stream, int size)
         dsp_buffer_stretch(out, size, 0, size);
     return out;
 }
+
+static void dsp_stats_background_th(void* arg, int thread, int start, int end)
+{
+    struct {
+        double lo;
+        double hi;
+        double sum;
+        double sum2;
+        long count;
+        dsp_stream_p stream;
+    } *arguments = arg;
+    arguments += thread;
+    dsp_stream_p stream = arguments->stream;
+    double lo = arguments->lo;
+    double hi = arguments->hi;
+    double sum = 0.0, sum2 = 0.0;
+    long count = 0;
+    int x;
+    for(x = start; x < end; x++) {
+        double v = stream->buf[x];
+        if(v < lo || v > hi)
+            continue;
+        sum += v;
+        sum2 += v * v;
+        count++;
+    }
+    arguments->sum += sum;
+    arguments->sum2 += sum2;
+    arguments->count += count;
+}
+
+void dsp_stats_background(dsp_stream_p stream, double *background, double *noise)
+{
+    if(stream == NULL)
+        return;
+    long unsigned int y;
+    int iteration;
+    double mean = 0.0, sigma = 0.0;
+    double lo = -DBL_MAX, hi = DBL_MAX;
+    struct {
+        double lo;
+        double hi;
+        double sum;
+        double sum2;
+        long count;
+        dsp_stream_p stream;
+    } thread_arguments[dsp_max_threads(0)];
+    for(iteration = 0; iteration < 5; iteration++) {
+        for(y = 0; y < dsp_max_threads(0); y++) {
+            thread_arguments[y].lo = lo;
+            thread_arguments[y].hi = hi;
+            thread_arguments[y].sum = 0.0;
+            thread_arguments[y].sum2 = 0.0;
+            thread_arguments[y].count = 0;
+            thread_arguments[y].stream = stream;
+        }
+        dsp_parallel_for(stream->len, 0, dsp_stats_background_th, thread_arguments);
+        double sum = 0.0, sum2 = 0.0;
+        long count = 0;
+        for(y = 0; y < dsp_max_threads(0); y++) {
+            sum += thread_arguments[y].sum;
+            sum2 += thread_arguments[y].sum2;
+            count += thread_arguments[y].count;
+        }
+        if(count == 0)
+            break;
+        double last = sigma;
+        mean = sum / count;
+        sigma = sqrt(Max(0.0, sum2 / count - mean * mean));
+        // Clip stars and hot pixels away from the sky level, stop once the estimate settles
+        lo = mean - sigma * 3.0;
+        hi = mean + sigma * 3.0;
+        if(iteration > 0 && fabs(last - sigma) <= sigma * 0.01)
+            break;
+    }
+    *background = mean;
+    *noise = sigma;
+}
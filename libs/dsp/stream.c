@@ -360,6 +360,9 @@ void dsp_stream_add_star(dsp_stream_p stream, dsp_star star)
     stream->stars = (dsp_star*)realloc(stream->stars, sizeof(dsp_star)*(stream->stars_count+1));
     strcpy(stream->stars[stream->stars_count].name, star.name);
     stream->stars[stream->stars_count].diameter = star.diameter;
+    stream->stars[stream->stars_count].fwhm = star.fwhm;
+    stream->stars[stream->stars_count].flux = star.flux;
+    stream->stars[stream->stars_count].peak = star.peak;
     stream->stars[stream->stars_count].center.dims = star.center.dims;
     stream->stars[stream->stars_count].center.location = (double*)malloc(sizeof(double)*star.center.dims);
     for(d = 0; d < star.center.dims; d++)
@@ -557,20 +560,18 @@ void dsp_stream_translate(dsp_stream_p in)
 /**
  * @brief dsp_stream_scale_th
  * @param arg
- * @return
+ * @param thread
+ * @param start
+ * @param end
  */
-static void* dsp_stream_scale_th(void* arg)
+static void dsp_stream_scale_th(void* arg, int thread, int start, int end)
 {
     struct {
-        int cur_th;
         dsp_stream_p stream;
      } *arguments = arg;
+    (void)thread;
     dsp_stream_p stream = arguments->stream;
     dsp_stream_p in = stream->parent;
-    int cur_th = arguments->cur_th;
-    int start = cur_th * stream->len / dsp_max_threads(0);
-    int end = start + stream->len / dsp_max_threads(0);
-    end = Min(stream->len, end);
     int y, d;
     for(y = start; y < end; y++)
     {
@@ -588,31 +589,20 @@ static void* dsp_stream_scale_th(void* arg)
             stream->buf[y] += in->buf[x]/(factor*stream->dims);
         free(pos);
     }
-    return NULL;
 }
 
 void dsp_stream_scale(dsp_stream_p in)
 {
     if(in == NULL)
         return;
-    long unsigned int y;
     dsp_stream_p stream = dsp_stream_copy(in);
     dsp_buffer_set(stream->buf, stream->len, 0);
     stream->parent = in;
-    pthread_t *th = malloc(sizeof(pthread_t)*dsp_max_threads(0));
     struct {
-       int cur_th;
        dsp_stream_p stream;
-    } thread_arguments[dsp_max_threads(0)];
-    for(y = 0; y < dsp_max_threads(0); y++)
-    {
-        thread_arguments[y].cur_th = y;
-        thread_arguments[y].stream = stream;
-        pthread_create(&th[y], NULL, dsp_stream_scale_th, &thread_arguments[y]);
-    }
-    for(y = 0; y < dsp_max_threads(0); y++)
-        pthread_join(th[y], NULL);
-    free(th);
+    } thread_arguments;
+    thread_arguments.stream = stream;
+    dsp_parallel_for(stream->len, 0, dsp_stream_scale_th, &thread_arguments);
     stream->parent = NULL;
     dsp_buffer_copy(stream->buf, in->buf, stream->len);
     dsp_stream_free_buffer(stream);
@@ -620,18 +610,14 @@ void dsp_stream_scale(dsp_stream_p in)
 
 }
 
-static void* dsp_stream_rotate_th(void* arg)
+static void dsp_stream_rotate_th(void* arg, int thread, int start, int end)
 {
     struct {
-       int cur_th;
        dsp_stream_p stream;
     } *arguments = arg;
+    (void)thread;
     dsp_stream_p stream = arguments->stream;
     dsp_stream_p in = stream->parent;
-    int cur_th = arguments->cur_th;
-    int start = cur_th * stream->len / dsp_max_threads(0);
-    int end = start + stream->len / dsp_max_threads(0);
-    end = Min(stream->len, end);
     int y;
     for(y = start; y < end; y++)
     {
@@ -655,7 +641,6 @@ static void* dsp_stream_rotate_th(void* arg)
         if(x >= 0 && x < in->len)
             stream->buf[y] = in->buf[x];
     }
-    return NULL;
 }
 
 void dsp_stream_rotate(dsp_stream_p in)
@@ -665,22 +650,224 @@ void dsp_stream_rotate(dsp_stream_p in)
     dsp_stream_p stream = dsp_stream_copy(in);
     dsp_buffer_set(stream->buf, stream->len, 0);
     stream->parent = in;
-    long unsigned int y;
-    pthread_t *th = malloc(sizeof(pthread_t)*dsp_max_threads(0));
     struct {
-       int cur_th;
        dsp_stream_p stream;
-    } thread_arguments[dsp_max_threads(0)];
-    for(y = 0; y < dsp_max_threads(0); y++) {
-        thread_arguments[y].cur_th = y;
-        thread_arguments[y].stream = stream;
-        pthread_create(&th[y], NULL, dsp_stream_rotate_th, &thread_arguments[y]);
-    }
-    for(y = 0; y < dsp_max_threads(0); y++)
-        pthread_join(th[y], NULL);
-    free(th);
+    } thread_arguments;
+    thread_arguments.stream = stream;
+    dsp_parallel_for(stream->len, 0, dsp_stream_rotate_th, &thread_arguments);
     dsp_buffer_copy(stream->buf, in->buf, stream->len);
     dsp_stream_free_buffer(stream);
     dsp_stream_free(stream);
 
 }
+
+// Clip the samples start + step * x of a row to [lo, hi], narrowing [*first, *last)
+static void dsp_stream_warp_clip(double start, double step, double lo, double hi, int *first, int *last)
+{
+    if(step == 0.0) {
+        if(start < lo || start > hi)
+            *last = *first;
+        return;
+    }
+    double a = (lo - start) / step;
+    double b = (hi - start) / step;
+    if(a > b) {
+        double t = a;
+        a = b;
+        b = t;
+    }
+    if(a > *first)
+        *first = (int)Min(ceil(a), (double)*last);
+    if(b < *last - 1)
+        *last = (int)Max(floor(b) + 1, (double)*first);
+    // Rounding of the divisions above may leave a sample just outside on either end
+    while(*first < *last && (start + step * *first < lo || start + step * *first > hi))
+        (*first)++;
+    while(*last > *first && (start + step * (*last - 1) < lo || start + step * (*last - 1) > hi))
+        (*last)--;
+}
+
+static void dsp_stream_lanczos_weights(double f, double *w)
+{
+    // sin(pi * (f + 2 - k) / 3) from sin and cos of pi * f / 3 rotated by the tap offsets
+    static const double c[6] = { -0.5, 0.5, 1.0, 0.5, -0.5, -1.0 };
+    static const double s[6] = { 0.86602540378443865, 0.86602540378443865, 0.0, -0.86602540378443865, -0.86602540378443865, 0.0 };
+    int k;
+    if(f < 1E-9 || f > 1.0 - 1E-9) {
+        for(k = 0; k < 6; k++)
+            w[k] = (k == (f < 0.5 ? 2 : 3));
+        return;
+    }
+    double sf = sin(M_PI * f);
+    double s3 = sin(M_PI * f / 3.0);
+    double c3 = cos(M_PI * f / 3.0);
+    double sum = 0.0;
+    for(k = 0; k < 6; k++) {
+        double t = f + 2 - k;
+        w[k] = ((k & 1) ? -sf : sf) * (s3 * c[k] + c3 * s[k]) * 3.0 / (M_PI * M_PI * t * t);
+        sum += w[k];
+    }
+    for(k = 0; k < 6; k++)
+        w[k] /= sum;
+}
+
+static void dsp_stream_warp_th(void* arg, int thread, int start, int end)
+{
+    struct {
+        int width;
+        int height;
+        double *matrix;
+        int interpolation;
+        dsp_t *in;
+        dsp_t *out;
+        dsp_t *coverage;
+        int accumulate;
+    } *arguments = arg;
+    (void)thread;
+    int w = arguments->width;
+    int h = arguments->height;
+    double *m = arguments->matrix;
+    dsp_t *row = (dsp_t*)malloc(sizeof(dsp_t) * w);
+    int r, x, k, j;
+    for(r = start; r < end; r++) {
+        int y = r % h;
+        dsp_t *in = &arguments->in[(r / h) * w * h];
+        dsp_t *out = &arguments->out[r * w];
+        double sx0 = m[1] * y + m[2];
+        double sy0 = m[4] * y + m[5];
+        // Samples with all the four bilinear taps inside the frame
+        int first = 0, last = w;
+        dsp_stream_warp_clip(sx0, m[0], 0.0, w - 1, &first, &last);
+        dsp_stream_warp_clip(sy0, m[3], 0.0, h - 1, &first, &last);
+        // Samples with all the 6x6 Lanczos taps inside the frame
+        int lfirst = last, llast = last;
+        if(arguments->interpolation == DSP_INTERPOLATION_LANCZOS && w > 6 && h > 6) {
+            lfirst = first;
+            dsp_stream_warp_clip(sx0, m[0], 2.0, w - 4, &lfirst, &llast);
+            dsp_stream_warp_clip(sy0, m[3], 2.0, h - 4, &lfirst, &llast);
+            if(lfirst >= llast)
+                lfirst = llast = last;
+        }
+        if(arguments->interpolation == DSP_INTERPOLATION_NEAREST) {
+            for(x = first; x < last; x++) {
+                int ix = (int)(sx0 + m[0] * x + 0.5);
+                int iy = (int)(sy0 + m[3] * x + 0.5);
+                row[x] = in[iy * w + ix];
+            }
+        } else {
+            for(x = first; x < lfirst; x++) {
+                double sx = sx0 + m[0] * x;
+                double sy = sy0 + m[3] * x;
+                int ix = Min((int)sx, w - 2);
+                int iy = Min((int)sy, h - 2);
+                double fx = sx - ix;
+                double fy = sy - iy;
+                dsp_t *p = &in[iy * w + ix];
+                double top = p[0] + (p[1] - p[0]) * fx;
+                double bottom = p[w] + (p[w + 1] - p[w]) * fx;
+                row[x] = top + (bottom - top) * fy;
+            }
+            for(x = lfirst; x < llast; x++) {
+                double sx = sx0 + m[0] * x;
+                double sy = sy0 + m[3] * x;
+                int ix = Max(2, Min((int)sx, w - 4));
+                int iy = Max(2, Min((int)sy, h - 4));
+                double wx[6], wy[6];
+                dsp_stream_lanczos_weights(sx - ix, wx);
+                dsp_stream_lanczos_weights(sy - iy, wy);
+                dsp_t *p = &in[(iy - 2) * w + ix - 2];
+                double v = 0.0;
+                for(j = 0; j < 6; j++, p += w) {
+                    double t = 0.0;
+                    for(k = 0; k < 6; k++)
+                        t += p[k] * wx[k];
+                    v += t * wy[j];
+                }
+                row[x] = v;
+            }
+            for(x = llast; x < last; x++) {
+                double sx = sx0 + m[0] * x;
+                double sy = sy0 + m[3] * x;
+                int ix = Min((int)sx, w - 2);
+                int iy = Min((int)sy, h - 2);
+                double fx = sx - ix;
+                double fy = sy - iy;
+                dsp_t *p = &in[iy * w + ix];
+                double top = p[0] + (p[1] - p[0]) * fx;
+                double bottom = p[w] + (p[w + 1] - p[w]) * fx;
+                row[x] = top + (bottom - top) * fy;
+            }
+        }
+        if(arguments->accumulate) {
+            for(x = first; x < last; x++)
+                out[x] += row[x];
+            if(arguments->coverage != NULL) {
+                dsp_t *coverage = &arguments->coverage[r * w];
+                for(x = first; x < last; x++)
+                    coverage[x] += 1;
+            }
+        } else {
+            memset(out, 0, sizeof(dsp_t) * first);
+            memcpy(&out[first], &row[first], sizeof(dsp_t) * (last - first));
+            memset(&out[last], 0, sizeof(dsp_t) * (w - last));
+        }
+    }
+    free(row);
+}
+
+static void dsp_stream_warp_run(dsp_stream_p stream, dsp_t *in, double *matrix, int interpolation, dsp_t *coverage, int accumulate)
+{
+    struct {
+        int width;
+        int height;
+        double *matrix;
+        int interpolation;
+        dsp_t *in;
+        dsp_t *out;
+        dsp_t *coverage;
+        int accumulate;
+    } thread_arguments;
+    thread_arguments.width = stream->sizes[0];
+    thread_arguments.height = stream->sizes[1];
+    thread_arguments.matrix = matrix;
+    thread_arguments.interpolation = interpolation;
+    thread_arguments.in = in;
+    thread_arguments.out = stream->buf;
+    thread_arguments.coverage = coverage;
+    thread_arguments.accumulate = accumulate;
+    dsp_parallel_for(stream->len / stream->sizes[0], 0, dsp_stream_warp_th, &thread_arguments);
+}
+
+void dsp_stream_warp(dsp_stream_p stream, double *matrix, int interpolation)
+{
+    if(stream == NULL || matrix == NULL)
+        return;
+    if(stream->dims < 2 || stream->sizes[0] < 2 || stream->sizes[1] < 2)
+        return;
+    dsp_t *in = (dsp_t*)malloc(sizeof(dsp_t) * stream->len);
+    memcpy(in, stream->buf, sizeof(dsp_t) * stream->len);
+    dsp_stream_warp_run(stream, in, matrix, interpolation, NULL, 0);
+    free(in);
+}
+
+void dsp_stream_warp_add(dsp_stream_p stream, dsp_stream_p frame, double *matrix, int interpolation, dsp_t *coverage)
+{
+    if(stream == NULL || frame == NULL || matrix == NULL)
+        return;
+    if(stream->dims < 2 || stream->sizes[0] < 2 || stream->sizes[1] < 2 || stream->len != frame->len)
+        return;
+    if(frame->sizes[0] != stream->sizes[0] || frame->sizes[1] != stream->sizes[1])
+        return;
+    dsp_stream_warp_run(stream, frame->buf, matrix, interpolation, coverage, 1);
+}
+
+void dsp_stream_align(dsp_stream_p stream, int interpolation)
+{
+    if(stream == NULL)
+        return;
+    if(stream->dims < 2)
+        return;
+    double matrix[6];
+    dsp_align_get_matrix(stream, matrix);
+    dsp_stream_warp(stream, matrix, interpolation);
+}
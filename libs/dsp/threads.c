@@ -0,0 +1,179 @@
+/*
+*   DSP API - a digital signal processing library for astronomy usage
+*   Copyright © 2017-2022  Ilia Platone
+*
+*   This program is free software; you can redistribute it and/or
+*   modify it under the terms of the GNU Lesser General Public
+*   License as published by the Free Software Foundation; either
+*   version 3 of the License, or (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+*   Lesser General Public License for more details.
+*
+*   You should have received a copy of the GNU Lesser General Public License
+*   along with this program; if not, write to the Free Software Foundation,
+*   Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+
+#include "dsp.h"
+#include <stdint.h>
+
+// Remaining items of one participant, packed as (start << 32) | end so owner and thieves agree through a single CAS
+typedef struct dsp_pool_range_t
+{
+    uint64_t range;
+    char pad[64 - sizeof(uint64_t)];
+} dsp_pool_range;
+
+typedef struct dsp_pool_worker_t
+{
+    int id;
+    unsigned long generation;
+} dsp_pool_worker;
+
+static struct {
+    pthread_mutex_t job;
+    pthread_mutex_t mutex;
+    pthread_cond_t start;
+    pthread_cond_t done;
+    unsigned long workers;
+    unsigned long generation;
+    int participants;
+    int pending;
+    int chunk;
+    void (*func)(void *arg, int thread, int start, int end);
+    void *arg;
+    dsp_pool_range *ranges;
+} dsp_pool = { PTHREAD_MUTEX_INITIALIZER, PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, PTHREAD_COND_INITIALIZER, 0, 0, 0, 0, 0, NULL, NULL, NULL };
+
+// Set in pool workers and in the caller while it runs a job, nested parallel loops then run inline
+static __thread int dsp_pool_busy = 0;
+
+static int dsp_pool_take(dsp_pool_range *r, int chunk, int *start, int *end)
+{
+    uint64_t old = __atomic_load_n(&r->range, __ATOMIC_ACQUIRE);
+    for(;;) {
+        int lo = (int)(old >> 32);
+        int hi = (int)(old & 0xffffffff);
+        if(lo >= hi)
+            return 0;
+        int n = Min(chunk, hi - lo);
+        uint64_t new = ((uint64_t)(lo + n) << 32) | (uint32_t)hi;
+        if(__atomic_compare_exchange_n(&r->range, &old, new, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            *start = lo;
+            *end = lo + n;
+            return 1;
+        }
+    }
+}
+
+static int dsp_pool_steal(dsp_pool_range *victim, dsp_pool_range *own)
+{
+    uint64_t old = __atomic_load_n(&victim->range, __ATOMIC_ACQUIRE);
+    for(;;) {
+        int lo = (int)(old >> 32);
+        int hi = (int)(old & 0xffffffff);
+        if(lo >= hi)
+            return 0;
+        // Take the upper half, the victim keeps working on the lower end
+        int mid = hi - Max((hi - lo) / 2, 1);
+        uint64_t new = ((uint64_t)lo << 32) | (uint32_t)mid;
+        if(__atomic_compare_exchange_n(&victim->range, &old, new, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            __atomic_store_n(&own->range, ((uint64_t)mid << 32) | (uint32_t)hi, __ATOMIC_RELEASE);
+            return 1;
+        }
+    }
+}
+
+static void dsp_pool_run(int id)
+{
+    int start, end, v;
+    int participants = dsp_pool.participants;
+    for(;;) {
+        while(dsp_pool_take(&dsp_pool.ranges[id], dsp_pool.chunk, &start, &end))
+            dsp_pool.func(dsp_pool.arg, id, start, end);
+        for(v = 1; v < participants; v++) {
+            if(dsp_pool_steal(&dsp_pool.ranges[(id + v) % participants], &dsp_pool.ranges[id]))
+                break;
+        }
+        if(v == participants)
+            return;
+    }
+}
+
+static void* dsp_pool_worker_th(void* arg)
+{
+    dsp_pool_worker *worker = arg;
+    dsp_pool_busy = 1;
+    for(;;) {
+        pthread_mutex_lock(&dsp_pool.mutex);
+        while(worker->generation == dsp_pool.generation)
+            pthread_cond_wait(&dsp_pool.start, &dsp_pool.mutex);
+        worker->generation = dsp_pool.generation;
+        int participate = worker->id < dsp_pool.participants;
+        pthread_mutex_unlock(&dsp_pool.mutex);
+        if(!participate)
+            continue;
+        dsp_pool_run(worker->id);
+        pthread_mutex_lock(&dsp_pool.mutex);
+        if(--dsp_pool.pending == 0)
+            pthread_cond_signal(&dsp_pool.done);
+        pthread_mutex_unlock(&dsp_pool.mutex);
+    }
+    return NULL;
+}
+
+void dsp_parallel_for(int count, int chunk, void (*func)(void *arg, int thread, int start, int end), void *arg)
+{
+    if(count <= 0 || func == NULL)
+        return;
+    int threads = (int)Min((long)dsp_max_threads(0), (long)count);
+    if(threads < 2 || dsp_pool_busy || pthread_mutex_trylock(&dsp_pool.job)) {
+        func(arg, 0, 0, count);
+        return;
+    }
+    if(chunk < 1)
+        chunk = Max(1, count / (threads * 16));
+    // Start workers lazily, they persist for the process lifetime
+    if(dsp_pool.workers < (unsigned long)threads - 1) {
+        dsp_pool.ranges = (dsp_pool_range*)realloc(dsp_pool.ranges, sizeof(dsp_pool_range) * threads);
+        while(dsp_pool.workers < (unsigned long)threads - 1) {
+            pthread_t th;
+            dsp_pool_worker *worker = (dsp_pool_worker*)malloc(sizeof(dsp_pool_worker));
+            worker->id = ++dsp_pool.workers;
+            worker->generation = dsp_pool.generation;
+            if(pthread_create(&th, NULL, dsp_pool_worker_th, worker)) {
+                free(worker);
+                dsp_pool.workers--;
+                break;
+            }
+            pthread_detach(th);
+        }
+        threads = Min(threads, (int)dsp_pool.workers + 1);
+    }
+    int t;
+    for(t = 0; t < threads; t++) {
+        uint64_t lo = (uint64_t)t * count / threads;
+        uint64_t hi = (uint64_t)(t + 1) * count / threads;
+        dsp_pool.ranges[t].range = (lo << 32) | hi;
+    }
+    pthread_mutex_lock(&dsp_pool.mutex);
+    dsp_pool.func = func;
+    dsp_pool.arg = arg;
+    dsp_pool.chunk = chunk;
+    dsp_pool.participants = threads;
+    dsp_pool.pending = threads - 1;
+    dsp_pool.generation++;
+    pthread_cond_broadcast(&dsp_pool.start);
+    pthread_mutex_unlock(&dsp_pool.mutex);
+    dsp_pool_busy = 1;
+    dsp_pool_run(0);
+    dsp_pool_busy = 0;
+    pthread_mutex_lock(&dsp_pool.mutex);
+    while(dsp_pool.pending > 0)
+        pthread_cond_wait(&dsp_pool.done, &dsp_pool.mutex);
+    pthread_mutex_unlock(&dsp_pool.mutex);
+    pthread_mutex_unlock(&dsp_pool.job);
+}
@@ -32,6 +32,15 @@ BasicMathPlugin::BasicMathPlugin()
 
 BasicMathPlugin::~BasicMathPlugin()
 {
+    if (RebuildWorker.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> Lock(RebuildMutex);
+            RebuildQuit = true;
+        }
+        RebuildRequested.notify_one();
+        RebuildWorker.join();
+    }
     gsl_matrix_free(pActualToApparentTransform);
     gsl_matrix_free(pApparentToActualTransform);
 }
@@ -52,6 +61,9 @@ bool BasicMathPlugin::Initialise(InMemoryDatabase *pInMemoryDatabase)
     /// - If three compute a transform matrix.
     /// - If four or more compute a convex hull, then matrices for each
     /// triangular facet of the hull.
+    if (SyncPoints.size() < 4)
+        DiscardModel();
+
     switch (SyncPoints.size())
     {
         // JM 2021-07-04: No Transformation required.
@@ -224,140 +236,71 @@ bool BasicMathPlugin::Initialise(InMemoryDatabase *pInMemoryDatabase)
             if (!pInMemoryDatabase->GetDatabaseReferencePosition(Position))
                 return false;
 
-            // Compute Hulls etc.
-            ActualConvexHull.Reset();
-            ApparentConvexHull.Reset();
-            ActualDirectionCosines.clear();
-
-            // Add a dummy point at the nadir
-            ActualConvexHull.MakeNewVertex(0.0, 0.0, -1.0, 0);
-            ApparentConvexHull.MakeNewVertex(0.0, 0.0, -1.0, 0);
-
-            int VertexNumber = 1;
-            // Add the rest of the vertices
-            for (InMemoryDatabase::AlignmentDatabaseType::const_iterator Itr = SyncPoints.begin();
-                    Itr != SyncPoints.end(); Itr++)
+            ConvexHullModel *pModel = CurrentModel();
+            bool Pending;
             {
-                INDI::IEquatorialCoordinates RaDec;
-                TelescopeDirectionVector ActualDirectionCosine;
-                RaDec.declination = (*Itr).Declination;
-                RaDec.rightascension = (*Itr).RightAscension;
-                if (ApproximateMountAlignment == ZENITH)
-                {
-                    INDI::IHorizontalCoordinates ActualSyncPoint;
-                    EquatorialToHorizontal(&RaDec, &Position, (*Itr).ObservationJulianDate, &ActualSyncPoint);
-                    // Now express this coordinate as normalised direction vectors (a.k.a direction cosines)
-                    ActualDirectionCosine = TelescopeDirectionVectorFromAltitudeAzimuth(ActualSyncPoint);
-                }
-                else
-                {
-                    ActualDirectionCosine = TelescopeDirectionVectorFromEquatorialCoordinates(RaDec);
-                }
-                ActualDirectionCosines.push_back(ActualDirectionCosine);
-                ActualConvexHull.MakeNewVertex(ActualDirectionCosine.x, ActualDirectionCosine.y,
-                                               ActualDirectionCosine.z, VertexNumber);
-                ApparentConvexHull.MakeNewVertex((*Itr).TelescopeDirection.x, (*Itr).TelescopeDirection.y,
-                                                 (*Itr).TelescopeDirection.z, VertexNumber);
-                VertexNumber++;
+                std::lock_guard<std::mutex> Lock(RebuildMutex);
+                Pending = RebuildPending;
             }
-            // I should only need to do this once but it is easier to do it twice
-            ActualConvexHull.DoubleTriangle();
-            ActualConvexHull.ConstructHull();
-            ActualConvexHull.EdgeOrderOnFaces();
-            ApparentConvexHull.DoubleTriangle();
-            ApparentConvexHull.ConstructHull();
-            ApparentConvexHull.EdgeOrderOnFaces();
-
-            // Make the matrices
-            ConvexHull::tFace CurrentFace = ActualConvexHull.faces;
-#ifdef CONVEX_HULL_DEBUGGING
-            int ActualFaces = 0;
-#endif
-            if (nullptr != CurrentFace)
+
+            // New sync points appended to the ones the model was built from only need their own
+            // vertices added to the hulls and matrices for the new facets. This gives the same
+            // hulls as a full build since the vertices are processed in the same order.
+            if (!Pending && nullptr != pModel && IsPrefixOf(*pModel, SyncPoints, Position))
             {
-                do
+                for (size_t Index = pModel->SyncPoints.size(); Index < SyncPoints.size(); Index++)
                 {
-#ifdef CONVEX_HULL_DEBUGGING
-                    ActualFaces++;
-#endif
-                    if ((0 == CurrentFace->vertex[0]->vnum) || (0 == CurrentFace->vertex[1]->vnum) ||
-                            (0 == CurrentFace->vertex[2]->vnum))
-                    {
-#ifdef CONVEX_HULL_DEBUGGING
-                        ASSDEBUGF("Initialise - Ignoring actual face %d", ActualFaces);
-#endif
-                    }
-                    else
-                    {
-#ifdef CONVEX_HULL_DEBUGGING
-                        ASSDEBUGF("Initialise - Processing actual face %d v1 %d v2 %d v3 %d", ActualFaces,
-                                  CurrentFace->vertex[0]->vnum, CurrentFace->vertex[1]->vnum,
-                                  CurrentFace->vertex[2]->vnum);
-#endif
-                        CalculateTransformMatrices(ActualDirectionCosines[CurrentFace->vertex[0]->vnum - 1],
-                                                   ActualDirectionCosines[CurrentFace->vertex[1]->vnum - 1],
-                                                   ActualDirectionCosines[CurrentFace->vertex[2]->vnum - 1],
-                                                   SyncPoints[CurrentFace->vertex[0]->vnum - 1].TelescopeDirection,
-                                                   SyncPoints[CurrentFace->vertex[1]->vnum - 1].TelescopeDirection,
-                                                   SyncPoints[CurrentFace->vertex[2]->vnum - 1].TelescopeDirection,
-                                                   CurrentFace->pMatrix, nullptr);
-                    }
-                    CurrentFace = CurrentFace->next;
+                    pModel->SyncPoints.push_back(SyncPoints[Index]);
+                    AddSyncPoint(*pModel, SyncPoints[Index]);
                 }
-                while (CurrentFace != ActualConvexHull.faces);
+                ConstructHulls(*pModel, false);
+                UpdateMatrices(*pModel);
+                return true;
             }
 
-            // One of these days I will optimise this
-            CurrentFace = ApparentConvexHull.faces;
-#ifdef CONVEX_HULL_DEBUGGING
-            int ApparentFaces = 0;
-#endif
-            if (nullptr != CurrentFace)
+            // Anything else needs the hulls to be built again
+            if (SyncPoints.size() < BackgroundRebuildMinimum)
             {
-                do
-                {
-#ifdef CONVEX_HULL_DEBUGGING
-                    ApparentFaces++;
-#endif
-                    if ((0 == CurrentFace->vertex[0]->vnum) || (0 == CurrentFace->vertex[1]->vnum) ||
-                            (0 == CurrentFace->vertex[2]->vnum))
-                    {
-#ifdef CONVEX_HULL_DEBUGGING
-                        ASSDEBUGF("Initialise - Ignoring apparent face %d", ApparentFaces);
-#endif
-                    }
-                    else
-                    {
-#ifdef CONVEX_HULL_DEBUGGING
-                        ASSDEBUGF("Initialise - Processing apparent face %d v1 %d v2 %d v3 %d", ApparentFaces,
-                                  CurrentFace->vertex[0]->vnum, CurrentFace->vertex[1]->vnum,
-                                  CurrentFace->vertex[2]->vnum);
-#endif
-                        CalculateTransformMatrices(SyncPoints[CurrentFace->vertex[0]->vnum - 1].TelescopeDirection,
-                                                   SyncPoints[CurrentFace->vertex[1]->vnum - 1].TelescopeDirection,
-                                                   SyncPoints[CurrentFace->vertex[2]->vnum - 1].TelescopeDirection,
-                                                   ActualDirectionCosines[CurrentFace->vertex[0]->vnum - 1],
-                                                   ActualDirectionCosines[CurrentFace->vertex[1]->vnum - 1],
-                                                   ActualDirectionCosines[CurrentFace->vertex[2]->vnum - 1],
-                                                   CurrentFace->pMatrix, nullptr);
-                    }
-                    CurrentFace = CurrentFace->next;
-                }
-                while (CurrentFace != ApparentConvexHull.faces);
+                DiscardModel();
+                std::unique_ptr<ConvexHullModel> NewHulls = NewModel(ApproximateMountAlignment, Position);
+                NewHulls->SyncPoints = SyncPoints;
+                for (const auto &Entry : NewHulls->SyncPoints)
+                    AddSyncPoint(*NewHulls, Entry);
+                ConstructHulls(*NewHulls, true);
+                UpdateMatrices(*NewHulls);
+                ActiveModel = std::move(NewHulls);
+            }
+            else
+            {
+                // The old hulls no longer match the database, conversions wait for the rebuild instead
+                ActiveModel.reset();
+
+                std::lock_guard<std::mutex> Lock(RebuildMutex);
+                RebuildSyncPoints     = SyncPoints;
+                RebuildMountAlignment = ApproximateMountAlignment;
+                RebuildPosition       = Position;
+                RebuiltModel.reset();
+                RebuildGeneration++;
+                RebuildPending = true;
+                RebuildQueued  = true;
+                if (!RebuildWorker.joinable())
+                    RebuildWorker = std::thread(&BasicMathPlugin::RebuildThread, this);
+                RebuildRequested.notify_one();
             }
-
-#ifdef CONVEX_HULL_DEBUGGING
-            ASSDEBUGF("Initialise - ActualFaces %d ApparentFaces %d", ActualFaces, ApparentFaces);
-            ActualConvexHull.PrintObj("ActualHull.obj");
-            ActualConvexHull.PrintOut("ActualHull.log", ActualConvexHull.vertices);
-            ApparentConvexHull.PrintObj("ApparentHull.obj");
-            ActualConvexHull.PrintOut("ApparentHull.log", ApparentConvexHull.vertices);
-#endif
             return true;
         }
     }
 }
 
+void BasicMathPlugin::WaitForModel()
+{
+    {
+        std::unique_lock<std::mutex> Lock(RebuildMutex);
+        RebuildFinished.wait(Lock, [this] { return !RebuildPending; });
+    }
+    CurrentModel();
+}
+
 bool BasicMathPlugin::TransformCelestialToTelescope(const double RightAscension, const double Declination,
         double JulianOffset,
         TelescopeDirectionVector &ApparentTelescopeDirectionVector)
@@ -431,6 +374,16 @@ bool BasicMathPlugin::TransformCelestialToTelescope(const double RightAscension,
 
         default:
         {
+            ConvexHullModel *pModel = CurrentModel();
+            if (nullptr == pModel)
+            {
+                // The first model for this database is still being built
+                WaitForModel();
+                pModel = CurrentModel();
+                if (nullptr == pModel)
+                    return false;
+            }
+
             TelescopeDirectionVector ActualVector;
             if (ApproximateMountAlignment == ZENITH)
             {
@@ -449,7 +402,7 @@ bool BasicMathPlugin::TransformCelestialToTelescope(const double RightAscension,
             TelescopeDirectionVector ScaledActualVector = ActualVector * 2.0;
             // Shoot the scaled vector in the into the list of actual facets
             // and use the conversuion matrix from the one it intersects
-            ConvexHull::tFace CurrentFace = ActualConvexHull.faces;
+            ConvexHull::tFace CurrentFace = pModel->ActualConvexHull.faces;
 #ifdef CONVEX_HULL_DEBUGGING
             int ActualFaces = 0;
 #endif
@@ -476,82 +429,35 @@ bool BasicMathPlugin::TransformCelestialToTelescope(const double RightAscension,
                                   CurrentFace->vertex[2]->vnum);
 #endif
                         if (RayTriangleIntersection(ScaledActualVector,
-                                                    ActualDirectionCosines[CurrentFace->vertex[0]->vnum - 1],
-                                                    ActualDirectionCosines[CurrentFace->vertex[1]->vnum - 1],
-                                                    ActualDirectionCosines[CurrentFace->vertex[2]->vnum - 1]))
+                                                    pModel->ActualDirectionCosines[CurrentFace->vertex[0]->vnum - 1],
+                                                    pModel->ActualDirectionCosines[CurrentFace->vertex[1]->vnum - 1],
+                                                    pModel->ActualDirectionCosines[CurrentFace->vertex[2]->vnum - 1]))
                             break;
                     }
                     CurrentFace = CurrentFace->next;
                 }
-                while (CurrentFace != ActualConvexHull.faces);
-                if (CurrentFace == ActualConvexHull.faces)
+                while (CurrentFace != pModel->ActualConvexHull.faces);
+                if (CurrentFace == pModel->ActualConvexHull.faces)
                 {
                     // Find the three nearest points and build a transform
-                    std::map<double, const AlignmentDatabaseEntry *> NearestMap;
-                    for (InMemoryDatabase::AlignmentDatabaseType::const_iterator Itr = SyncPoints.begin();
-                            Itr != SyncPoints.end(); Itr++)
-                    {
-                        INDI::IEquatorialCoordinates RaDec;
-                        TelescopeDirectionVector ActualDirectionCosine;
-                        RaDec.rightascension  = (*Itr).RightAscension;
-                        RaDec.declination = (*Itr).Declination;
-                        if (ApproximateMountAlignment == ZENITH)
-                        {
-                            INDI::IHorizontalCoordinates ActualPoint;
-                            EquatorialToHorizontal(&RaDec, &Position, (*Itr).ObservationJulianDate, &ActualPoint);
-                            ActualDirectionCosine = TelescopeDirectionVectorFromAltitudeAzimuth(ActualPoint);
-                        }
-                        else
-                        {
-                            ActualDirectionCosine = TelescopeDirectionVectorFromEquatorialCoordinates(RaDec);
-                        }
-                        NearestMap[(ActualDirectionCosine - ActualVector).Length()] = &(*Itr);
-                    }
-                    // First compute local horizontal coordinates for the three sync points
-                    std::map<double, const AlignmentDatabaseEntry *>::const_iterator Nearest = NearestMap.begin();
-                    const AlignmentDatabaseEntry *pEntry1                                    = (*Nearest).second;
+                    std::map<double, size_t> NearestMap;
+                    for (size_t Index = 0; Index < pModel->ActualDirectionCosines.size(); Index++)
+                        NearestMap[(pModel->ActualDirectionCosines[Index] - ActualVector).Length()] = Index;
+                    std::map<double, size_t>::const_iterator Nearest = NearestMap.begin();
+                    size_t Index1                                    = (*Nearest).second;
                     Nearest++;
-                    const AlignmentDatabaseEntry *pEntry2 = (*Nearest).second;
+                    size_t Index2 = (*Nearest).second;
                     Nearest++;
-                    const AlignmentDatabaseEntry *pEntry3 = (*Nearest).second;
-                    INDI::IEquatorialCoordinates RaDec1;
-                    INDI::IEquatorialCoordinates RaDec2;
-                    INDI::IEquatorialCoordinates RaDec3;
-                    TelescopeDirectionVector ActualDirectionCosine1;
-                    TelescopeDirectionVector ActualDirectionCosine2;
-                    TelescopeDirectionVector ActualDirectionCosine3;
-                    RaDec1.declination = pEntry1->Declination;
-                    RaDec1.rightascension  = pEntry1->RightAscension;
-                    RaDec2.declination = pEntry2->Declination;
-                    RaDec2.rightascension  = pEntry2->RightAscension;
-                    RaDec3.declination = pEntry3->Declination;
-                    RaDec3.rightascension = pEntry3->RightAscension;
-
-                    if (ApproximateMountAlignment == ZENITH)
-                    {
-                        INDI::IHorizontalCoordinates ActualSyncPoint1;
-                        INDI::IHorizontalCoordinates ActualSyncPoint2;
-                        INDI::IHorizontalCoordinates ActualSyncPoint3;
-                        EquatorialToHorizontal(&RaDec1, &Position, pEntry1->ObservationJulianDate, &ActualSyncPoint1);
-                        EquatorialToHorizontal(&RaDec2, &Position, pEntry2->ObservationJulianDate, &ActualSyncPoint2);
-                        EquatorialToHorizontal(&RaDec3, &Position, pEntry3->ObservationJulianDate, &ActualSyncPoint3);
-
-                        // Now express these coordinates as normalised direction vectors (a.k.a direction cosines)
-                        ActualDirectionCosine1 = TelescopeDirectionVectorFromAltitudeAzimuth(ActualSyncPoint1);
-                        ActualDirectionCosine2 = TelescopeDirectionVectorFromAltitudeAzimuth(ActualSyncPoint2);
-                        ActualDirectionCosine3 = TelescopeDirectionVectorFromAltitudeAzimuth(ActualSyncPoint3);
-                    }
-                    else
-                    {
-                        ActualDirectionCosine1 = TelescopeDirectionVectorFromEquatorialCoordinates(RaDec1);
-                        ActualDirectionCosine2 = TelescopeDirectionVectorFromEquatorialCoordinates(RaDec2);
-                        ActualDirectionCosine3 = TelescopeDirectionVectorFromEquatorialCoordinates(RaDec3);
-                    }
+                    size_t Index3 = (*Nearest).second;
 
                     pComputedTransform = gsl_matrix_alloc(3, 3);
-                    CalculateTransformMatrices(ActualDirectionCosine1, ActualDirectionCosine2, ActualDirectionCosine3,
-                                               pEntry1->TelescopeDirection, pEntry2->TelescopeDirection,
-                                               pEntry3->TelescopeDirection, pComputedTransform, nullptr);
+                    CalculateTransformMatrices(pModel->ActualDirectionCosines[Index1],
+                                               pModel->ActualDirectionCosines[Index2],
+                                               pModel->ActualDirectionCosines[Index3],
+                                               pModel->SyncPoints[Index1].TelescopeDirection,
+                                               pModel->SyncPoints[Index2].TelescopeDirection,
+                                               pModel->SyncPoints[Index3].TelescopeDirection, pComputedTransform,
+                                               nullptr);
                     pTransform = pComputedTransform;
                 }
                 else
@@ -674,13 +580,23 @@ bool BasicMathPlugin::TransformTelescopeToCelestial(const TelescopeDirectionVect
 
         default:
         {
+            ConvexHullModel *pModel = CurrentModel();
+            if (nullptr == pModel)
+            {
+                // The first model for this database is still being built
+                WaitForModel();
+                pModel = CurrentModel();
+                if (nullptr == pModel)
+                    return false;
+            }
+
             gsl_matrix *pTransform;
             gsl_matrix *pComputedTransform = nullptr;
             // Scale the apparent telescope direction vector to make sure it traverses the unit sphere.
             TelescopeDirectionVector ScaledApparentVector = ApparentTelescopeDirectionVector * 2.0;
             // Shoot the scaled vector in the into the list of apparent facets
             // and use the conversuion matrix from the one it intersects
-            ConvexHull::tFace CurrentFace = ApparentConvexHull.faces;
+            ConvexHull::tFace CurrentFace = pModel->ApparentConvexHull.faces;
 #ifdef CONVEX_HULL_DEBUGGING
             int ApparentFaces = 0;
 #endif
@@ -707,68 +623,35 @@ bool BasicMathPlugin::TransformTelescopeToCelestial(const TelescopeDirectionVect
                                   CurrentFace->vertex[2]->vnum);
 #endif
                         if (RayTriangleIntersection(ScaledApparentVector,
-                                                    SyncPoints[CurrentFace->vertex[0]->vnum - 1].TelescopeDirection,
-                                                    SyncPoints[CurrentFace->vertex[1]->vnum - 1].TelescopeDirection,
-                                                    SyncPoints[CurrentFace->vertex[2]->vnum - 1].TelescopeDirection))
+                                                    pModel->SyncPoints[CurrentFace->vertex[0]->vnum - 1].TelescopeDirection,
+                                                    pModel->SyncPoints[CurrentFace->vertex[1]->vnum - 1].TelescopeDirection,
+                                                    pModel->SyncPoints[CurrentFace->vertex[2]->vnum - 1].TelescopeDirection))
                             break;
                     }
                     CurrentFace = CurrentFace->next;
                 }
-                while (CurrentFace != ApparentConvexHull.faces);
-                if (CurrentFace == ApparentConvexHull.faces)
+                while (CurrentFace != pModel->ApparentConvexHull.faces);
+                if (CurrentFace == pModel->ApparentConvexHull.faces)
                 {
                     // Find the three nearest points and build a transform
-                    std::map<double, const AlignmentDatabaseEntry *> NearestMap;
-                    for (InMemoryDatabase::AlignmentDatabaseType::const_iterator Itr = SyncPoints.begin();
-                            Itr != SyncPoints.end(); Itr++)
-                    {
-                        NearestMap[((*Itr).TelescopeDirection - ApparentTelescopeDirectionVector).Length()] = &(*Itr);
-                    }
-                    // First compute local horizontal coordinates for the three sync points
-                    std::map<double, const AlignmentDatabaseEntry *>::const_iterator Nearest = NearestMap.begin();
-                    const AlignmentDatabaseEntry *pEntry1                                    = (*Nearest).second;
+                    std::map<double, size_t> NearestMap;
+                    for (size_t Index = 0; Index < pModel->SyncPoints.size(); Index++)
+                        NearestMap[(pModel->SyncPoints[Index].TelescopeDirection - ApparentTelescopeDirectionVector)
+                                   .Length()] = Index;
+                    std::map<double, size_t>::const_iterator Nearest = NearestMap.begin();
+                    size_t Index1                                    = (*Nearest).second;
                     Nearest++;
-                    const AlignmentDatabaseEntry *pEntry2 = (*Nearest).second;
+                    size_t Index2 = (*Nearest).second;
                     Nearest++;
-                    const AlignmentDatabaseEntry *pEntry3 = (*Nearest).second;
-                    INDI::IEquatorialCoordinates RaDec1;
-                    INDI::IEquatorialCoordinates RaDec2;
-                    INDI::IEquatorialCoordinates RaDec3;
-                    TelescopeDirectionVector ActualDirectionCosine1;
-                    TelescopeDirectionVector ActualDirectionCosine2;
-                    TelescopeDirectionVector ActualDirectionCosine3;
-                    RaDec1.declination = pEntry1->Declination;
-                    RaDec1.rightascension  = pEntry1->RightAscension;
-                    RaDec2.declination = pEntry2->Declination;
-                    RaDec2.rightascension  = pEntry2->RightAscension;
-                    RaDec3.declination = pEntry3->Declination;
-                    RaDec3.rightascension = pEntry3->RightAscension;
-
-                    if (ApproximateMountAlignment == ZENITH)
-                    {
-                        INDI::IHorizontalCoordinates ActualSyncPoint1;
-                        INDI::IHorizontalCoordinates ActualSyncPoint2;
-                        INDI::IHorizontalCoordinates ActualSyncPoint3;
-                        EquatorialToHorizontal(&RaDec1, &Position, pEntry1->ObservationJulianDate, &ActualSyncPoint1);
-                        EquatorialToHorizontal(&RaDec2, &Position, pEntry2->ObservationJulianDate, &ActualSyncPoint2);
-                        EquatorialToHorizontal(&RaDec3, &Position, pEntry3->ObservationJulianDate, &ActualSyncPoint3);
-
-                        // Now express these coordinates as normalised direction vectors (a.k.a direction cosines)
-                        ActualDirectionCosine1 = TelescopeDirectionVectorFromAltitudeAzimuth(ActualSyncPoint1);
-                        ActualDirectionCosine2 = TelescopeDirectionVectorFromAltitudeAzimuth(ActualSyncPoint2);
-                        ActualDirectionCosine3 = TelescopeDirectionVectorFromAltitudeAzimuth(ActualSyncPoint3);
-                    }
-                    else
-                    {
-                        ActualDirectionCosine1 = TelescopeDirectionVectorFromEquatorialCoordinates(RaDec1);
-                        ActualDirectionCosine2 = TelescopeDirectionVectorFromEquatorialCoordinates(RaDec2);
-                        ActualDirectionCosine3 = TelescopeDirectionVectorFromEquatorialCoordinates(RaDec3);
-                    }
+                    size_t Index3 = (*Nearest).second;
+
                     pComputedTransform = gsl_matrix_alloc(3, 3);
-                    CalculateTransformMatrices(pEntry1->TelescopeDirection, pEntry2->TelescopeDirection,
-                                               pEntry3->TelescopeDirection, ActualDirectionCosine1,
-                                               ActualDirectionCosine2, ActualDirectionCosine3, pComputedTransform,
-                                               nullptr);
+                    CalculateTransformMatrices(pModel->SyncPoints[Index1].TelescopeDirection,
+                                               pModel->SyncPoints[Index2].TelescopeDirection,
+                                               pModel->SyncPoints[Index3].TelescopeDirection,
+                                               pModel->ActualDirectionCosines[Index1],
+                                               pModel->ActualDirectionCosines[Index2],
+                                               pModel->ActualDirectionCosines[Index3], pComputedTransform, nullptr);
                     pTransform = pComputedTransform;
                 }
                 else
@@ -814,6 +697,243 @@ bool BasicMathPlugin::TransformTelescopeToCelestial(const TelescopeDirectionVect
 
 // Private methods
 
+BasicMathPlugin::ConvexHullModel::~ConvexHullModel()
+{
+    ActualConvexHull.Reset();
+    ApparentConvexHull.Reset();
+}
+
+BasicMathPlugin::ConvexHullModel *BasicMathPlugin::CurrentModel()
+{
+    std::unique_ptr<ConvexHullModel> Rebuilt;
+    {
+        std::lock_guard<std::mutex> Lock(RebuildMutex);
+        Rebuilt = std::move(RebuiltModel);
+    }
+
+    // The matrices come from the derived class so they are calculated here rather than on the rebuild thread
+    if (Rebuilt)
+    {
+        UpdateMatrices(*Rebuilt);
+        ActiveModel = std::move(Rebuilt);
+    }
+    return ActiveModel.get();
+}
+
+std::unique_ptr<BasicMathPlugin::ConvexHullModel> BasicMathPlugin::NewModel(MountAlignment_t Alignment,
+        const IGeographicCoordinates &Position)
+{
+    std::unique_ptr<ConvexHullModel> NewHulls(new ConvexHullModel);
+    NewHulls->ApproximateMountAlignment = Alignment;
+    NewHulls->Position                  = Position;
+
+    // Add a dummy point at the nadir
+    NewHulls->ActualConvexHull.MakeNewVertex(0.0, 0.0, -1.0, 0);
+    NewHulls->ApparentConvexHull.MakeNewVertex(0.0, 0.0, -1.0, 0);
+    return NewHulls;
+}
+
+void BasicMathPlugin::AddSyncPoint(ConvexHullModel &Model, const AlignmentDatabaseEntry &Entry)
+{
+    INDI::IEquatorialCoordinates RaDec;
+    TelescopeDirectionVector ActualDirectionCosine;
+    RaDec.declination    = Entry.Declination;
+    RaDec.rightascension = Entry.RightAscension;
+    if (Model.ApproximateMountAlignment == ZENITH)
+    {
+        INDI::IHorizontalCoordinates ActualSyncPoint;
+        EquatorialToHorizontal(&RaDec, &Model.Position, Entry.ObservationJulianDate, &ActualSyncPoint);
+        // Now express this coordinate as normalised direction vectors (a.k.a direction cosines)
+        ActualDirectionCosine = TelescopeDirectionVectorFromAltitudeAzimuth(ActualSyncPoint);
+    }
+    else
+    {
+        ActualDirectionCosine = TelescopeDirectionVectorFromEquatorialCoordinates(RaDec);
+    }
+    Model.ActualDirectionCosines.push_back(ActualDirectionCosine);
+
+    int VertexNumber = Model.ActualDirectionCosines.size();
+    Model.ActualConvexHull.MakeNewVertex(ActualDirectionCosine.x, ActualDirectionCosine.y, ActualDirectionCosine.z,
+                                         VertexNumber);
+    Model.ApparentConvexHull.MakeNewVertex(Entry.TelescopeDirection.x, Entry.TelescopeDirection.y,
+                                           Entry.TelescopeDirection.z, VertexNumber);
+}
+
+void BasicMathPlugin::ConstructHulls(ConvexHullModel &Model, bool Initial)
+{
+    // ConstructHull only adds the vertices that have not been processed yet
+    if (Initial)
+        Model.ActualConvexHull.DoubleTriangle();
+    Model.ActualConvexHull.ConstructHull();
+    Model.ActualConvexHull.EdgeOrderOnFaces();
+    if (Initial)
+        Model.ApparentConvexHull.DoubleTriangle();
+    Model.ApparentConvexHull.ConstructHull();
+    Model.ApparentConvexHull.EdgeOrderOnFaces();
+}
+
+void BasicMathPlugin::UpdateMatrices(ConvexHullModel &Model)
+{
+    const InMemoryDatabase::AlignmentDatabaseType &SyncPoints = Model.SyncPoints;
+    const std::vector<TelescopeDirectionVector> &ActualDirectionCosines = Model.ActualDirectionCosines;
+
+    // Facets kept from before an incremental update still have their matrix
+    ConvexHull::tFace CurrentFace = Model.ActualConvexHull.faces;
+#ifdef CONVEX_HULL_DEBUGGING
+    int ActualFaces = 0;
+#endif
+    if (nullptr != CurrentFace)
+    {
+        do
+        {
+#ifdef CONVEX_HULL_DEBUGGING
+            ActualFaces++;
+#endif
+            if ((0 == CurrentFace->vertex[0]->vnum) || (0 == CurrentFace->vertex[1]->vnum) ||
+                    (0 == CurrentFace->vertex[2]->vnum))
+            {
+#ifdef CONVEX_HULL_DEBUGGING
+                ASSDEBUGF("Initialise - Ignoring actual face %d", ActualFaces);
+#endif
+            }
+            else if (!CurrentFace->matrixValid)
+            {
+#ifdef CONVEX_HULL_DEBUGGING
+                ASSDEBUGF("Initialise - Processing actual face %d v1 %d v2 %d v3 %d", ActualFaces,
+                          CurrentFace->vertex[0]->vnum, CurrentFace->vertex[1]->vnum,
+                          CurrentFace->vertex[2]->vnum);
+#endif
+                CalculateTransformMatrices(ActualDirectionCosines[CurrentFace->vertex[0]->vnum - 1],
+                                           ActualDirectionCosines[CurrentFace->vertex[1]->vnum - 1],
+                                           ActualDirectionCosines[CurrentFace->vertex[2]->vnum - 1],
+                                           SyncPoints[CurrentFace->vertex[0]->vnum - 1].TelescopeDirection,
+                                           SyncPoints[CurrentFace->vertex[1]->vnum - 1].TelescopeDirection,
+                                           SyncPoints[CurrentFace->vertex[2]->vnum - 1].TelescopeDirection,
+                                           CurrentFace->pMatrix, nullptr);
+                CurrentFace->matrixValid = true;
+            }
+            CurrentFace = CurrentFace->next;
+        }
+        while (CurrentFace != Model.ActualConvexHull.faces);
+    }
+
+    CurrentFace = Model.ApparentConvexHull.faces;
+#ifdef CONVEX_HULL_DEBUGGING
+    int ApparentFaces = 0;
+#endif
+    if (nullptr != CurrentFace)
+    {
+        do
+        {
+#ifdef CONVEX_HULL_DEBUGGING
+            ApparentFaces++;
+#endif
+            if ((0 == CurrentFace->vertex[0]->vnum) || (0 == CurrentFace->vertex[1]->vnum) ||
+                    (0 == CurrentFace->vertex[2]->vnum))
+            {
+#ifdef CONVEX_HULL_DEBUGGING
+                ASSDEBUGF("Initialise - Ignoring apparent face %d", ApparentFaces);
+#endif
+            }
+            else if (!CurrentFace->matrixValid)
+            {
+#ifdef CONVEX_HULL_DEBUGGING
+                ASSDEBUGF("Initialise - Processing apparent face %d v1 %d v2 %d v3 %d", ApparentFaces,
+                          CurrentFace->vertex[0]->vnum, CurrentFace->vertex[1]->vnum,
+                          CurrentFace->vertex[2]->vnum);
+#endif
+                CalculateTransformMatrices(SyncPoints[CurrentFace->vertex[0]->vnum - 1].TelescopeDirection,
+                                           SyncPoints[CurrentFace->vertex[1]->vnum - 1].TelescopeDirection,
+                                           SyncPoints[CurrentFace->vertex[2]->vnum - 1].TelescopeDirection,
+                                           ActualDirectionCosines[CurrentFace->vertex[0]->vnum - 1],
+                                           ActualDirectionCosines[CurrentFace->vertex[1]->vnum - 1],
+                                           ActualDirectionCosines[CurrentFace->vertex[2]->vnum - 1],
+                                           CurrentFace->pMatrix, nullptr);
+                CurrentFace->matrixValid = true;
+            }
+            CurrentFace = CurrentFace->next;
+        }
+        while (CurrentFace != Model.ApparentConvexHull.faces);
+    }
+
+#ifdef CONVEX_HULL_DEBUGGING
+    ASSDEBUGF("Initialise - ActualFaces %d ApparentFaces %d", ActualFaces, ApparentFaces);
+    Model.ActualConvexHull.PrintObj("ActualHull.obj");
+    Model.ActualConvexHull.PrintOut("ActualHull.log", Model.ActualConvexHull.vertices);
+    Model.ApparentConvexHull.PrintObj("ApparentHull.obj");
+    Model.ApparentConvexHull.PrintOut("ApparentHull.log", Model.ApparentConvexHull.vertices);
+#endif
+}
+
+bool BasicMathPlugin::IsPrefixOf(const ConvexHullModel &Model, const InMemoryDatabase::AlignmentDatabaseType &SyncPoints,
+                                 const IGeographicCoordinates &Position)
+{
+    if (Model.ApproximateMountAlignment != ApproximateMountAlignment || Model.Position.latitude != Position.latitude ||
+            Model.Position.longitude != Position.longitude || Model.SyncPoints.size() > SyncPoints.size())
+        return false;
+
+    for (size_t Index = 0; Index < Model.SyncPoints.size(); Index++)
+    {
+        const AlignmentDatabaseEntry &Built = Model.SyncPoints[Index];
+        const AlignmentDatabaseEntry &Entry = SyncPoints[Index];
+        if (Built.ObservationJulianDate != Entry.ObservationJulianDate || Built.RightAscension != Entry.RightAscension ||
+                Built.Declination != Entry.Declination || Built.TelescopeDirection.x != Entry.TelescopeDirection.x ||
+                Built.TelescopeDirection.y != Entry.TelescopeDirection.y ||
+                Built.TelescopeDirection.z != Entry.TelescopeDirection.z)
+            return false;
+    }
+    return true;
+}
+
+void BasicMathPlugin::DiscardModel()
+{
+    {
+        std::lock_guard<std::mutex> Lock(RebuildMutex);
+        RebuildSyncPoints.clear();
+        RebuiltModel.reset();
+        RebuildGeneration++;
+        RebuildPending = false;
+        RebuildQueued  = false;
+    }
+    RebuildFinished.notify_all();
+    ActiveModel.reset();
+}
+
+void BasicMathPlugin::RebuildThread()
+{
+    std::unique_lock<std::mutex> Lock(RebuildMutex);
+    while (true)
+    {
+        RebuildRequested.wait(Lock, [this] { return RebuildQuit || RebuildQueued; });
+        if (RebuildQuit)
+            return;
+
+        RebuildQueued = false;
+        uint64_t Generation = RebuildGeneration;
+        std::unique_ptr<ConvexHullModel> NewHulls = NewModel(RebuildMountAlignment, RebuildPosition);
+        NewHulls->SyncPoints.swap(RebuildSyncPoints);
+        Lock.unlock();
+
+        // Only the hulls are built here, the matrices need the derived class which may be going away
+        for (const auto &Entry : NewHulls->SyncPoints)
+            AddSyncPoint(*NewHulls, Entry);
+        ConstructHulls(*NewHulls, true);
+
+        Lock.lock();
+        // Superseded while building
+        if (Generation != RebuildGeneration)
+        {
+            Lock.unlock();
+            NewHulls.reset();
+            Lock.lock();
+            continue;
+        }
+        RebuiltModel   = std::move(NewHulls);
+        RebuildPending = false;
+        RebuildFinished.notify_all();
+    }
+}
+
 void BasicMathPlugin::Dump3(const char *Label, gsl_vector *pVector)
 {
     ASSDEBUGF("Vector dump - %s", Label);
@@ -13,6 +13,12 @@
 
 #include <gsl/gsl_matrix.h>
 
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+
 namespace INDI
 {
 namespace AlignmentSubsystem
@@ -20,6 +26,12 @@ namespace AlignmentSubsystem
 /// \class BasicMathPlugin
 /// \brief This class implements the common functionality for the built in
 /// and SVD math plugins
+///
+/// With four or more sync points the model is a pair of convex hulls with a transformation
+/// matrix per facet. Sync points appended to the database are added to the existing hulls and
+/// only the new facets get a matrix. Any other change to a large database rebuilds the hulls on a
+/// background thread. The previous model is dropped at once, conversions wait for the new one
+/// rather than use hulls that no longer match the database.
 class BasicMathPlugin : public AlignmentSubsystemForMathPlugins
 {
     public:
@@ -41,6 +53,9 @@ class BasicMathPlugin : public AlignmentSubsystemForMathPlugins
         virtual bool TransformTelescopeToCelestial(const TelescopeDirectionVector &ApparentTelescopeDirectionVector,
                 double &RightAscension, double &Declination);
 
+        /// \brief Wait for a pending background rebuild of the convex hull model and start using it
+        void WaitForModel();
+
     protected:
         /// \brief Calculate tranformation matrices from the supplied vectors
         /// \param[in] Alpha1 Pointer to the first coordinate in the alpha reference frame
@@ -98,11 +113,67 @@ class BasicMathPlugin : public AlignmentSubsystemForMathPlugins
         gsl_matrix *pActualToApparentTransform;
         gsl_matrix *pApparentToActualTransform;
 
-        // Convex hulls for 4+ sync points case
-        ConvexHull ActualConvexHull;
-        ConvexHull ApparentConvexHull;
-        // Actual direction cosines for the 4+ case
-        std::vector<TelescopeDirectionVector> ActualDirectionCosines;
+        /// \brief Convex hull model for the 4+ sync points case
+        struct ConvexHullModel
+        {
+            ~ConvexHullModel();
+
+            // Sync points, mount alignment and position the model was built from
+            InMemoryDatabase::AlignmentDatabaseType SyncPoints;
+            MountAlignment_t ApproximateMountAlignment;
+            IGeographicCoordinates Position;
+            // Convex hulls, vertex n is SyncPoints[n - 1], vertex 0 is a dummy point at the nadir
+            ConvexHull ActualConvexHull;
+            ConvexHull ApparentConvexHull;
+            // Actual direction cosines of the sync points
+            std::vector<TelescopeDirectionVector> ActualDirectionCosines;
+        };
+
+        /// Databases of at least this size are rebuilt on the background thread
+        static constexpr size_t BackgroundRebuildMinimum = 32;
+
+        /// \brief The model in use, after switching to a finished background rebuild
+        /// \return nullptr if no model has been built for the database yet
+        ConvexHullModel *CurrentModel();
+
+    private:
+        /// \brief Start a new model and add the nadir vertex
+        std::unique_ptr<ConvexHullModel> NewModel(MountAlignment_t Alignment, const IGeographicCoordinates &Position);
+
+        /// \brief Add the vertices for a sync point, ConstructHulls then adds them to the hulls
+        void AddSyncPoint(ConvexHullModel &Model, const AlignmentDatabaseEntry &Entry);
+
+        /// \brief Add the vertices not processed yet to the hulls
+        void ConstructHulls(ConvexHullModel &Model, bool Initial);
+
+        /// \brief Calculate the matrices of the facets that do not have one yet
+        void UpdateMatrices(ConvexHullModel &Model);
+
+        /// \brief Check whether the model was built from the leading entries of the database
+        bool IsPrefixOf(const ConvexHullModel &Model, const InMemoryDatabase::AlignmentDatabaseType &SyncPoints,
+                        const IGeographicCoordinates &Position);
+
+        /// \brief Drop the model and any pending background rebuild
+        void DiscardModel();
+
+        void RebuildThread();
+
+        std::unique_ptr<ConvexHullModel> ActiveModel;
+
+        // Background rebuild state, shared with the rebuild thread
+        std::thread RebuildWorker;
+        std::mutex RebuildMutex;
+        std::condition_variable RebuildRequested;
+        std::condition_variable RebuildFinished;
+        InMemoryDatabase::AlignmentDatabaseType RebuildSyncPoints;
+        MountAlignment_t RebuildMountAlignment { ZENITH };
+        IGeographicCoordinates RebuildPosition { 0, 0, 0 };
+        std::unique_ptr<ConvexHullModel> RebuiltModel;
+        // Incremented for each request, results of older requests are dropped
+        uint64_t RebuildGeneration { 0 };
+        bool RebuildPending { false };
+        bool RebuildQueued { false };
+        bool RebuildQuit { false };
 };
 
 } // namespace AlignmentSubsystem
@@ -145,13 +145,14 @@ class ConvexHull
 
     struct tFaceStructure
     {
-        tFaceStructure() { pMatrix = gsl_matrix_alloc(3, 3); }
+        tFaceStructure() : matrixValid(false) { pMatrix = gsl_matrix_alloc(3, 3); }
         ~tFaceStructure() { gsl_matrix_free(pMatrix); }
         tEdge edge[3];
         tVertex vertex[3];
         bool visible; // True iff face visible from new point.
         tFace next, prev;
         gsl_matrix *pMatrix;
+        bool matrixValid; // True once pMatrix has been computed for this face.
     };
 
     /* Define flags */
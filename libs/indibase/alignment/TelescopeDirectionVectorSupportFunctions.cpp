@@ -8,10 +8,80 @@
 
 #include "TelescopeDirectionVectorSupportFunctions.h"
 
+#include <algorithm>
+#include <cmath>
+
 namespace INDI
 {
 namespace AlignmentSubsystem
 {
+namespace
+{
+// Batches are converted by blocks of contiguous angles small enough to live on the stack
+constexpr size_t BLOCK_SIZE = 64;
+
+// Clockwise azimuths are negated, which gives the same results as the cos(-A) and sin(-A) of the single conversions
+void VectorsFromAngles(const double *AzimuthAngles, double AzimuthSign, const double *PolarAngles,
+                       bool FromAzimuthalPlane, size_t Count, TelescopeDirectionVector *Vectors)
+{
+    double SinAzimuth[BLOCK_SIZE], CosAzimuth[BLOCK_SIZE], SinPolar[BLOCK_SIZE], CosPolar[BLOCK_SIZE];
+
+    for (size_t i = 0; i < Count; i++)
+    {
+        SinAzimuth[i] = sin(AzimuthSign * AzimuthAngles[i]);
+        CosAzimuth[i] = cos(AzimuthSign * AzimuthAngles[i]);
+        SinPolar[i]   = sin(PolarAngles[i]);
+        CosPolar[i]   = cos(PolarAngles[i]);
+    }
+
+    if (FromAzimuthalPlane)
+    {
+        for (size_t i = 0; i < Count; i++)
+        {
+            Vectors[i].x = CosPolar[i] * CosAzimuth[i];
+            Vectors[i].y = CosPolar[i] * SinAzimuth[i];
+            Vectors[i].z = SinPolar[i];
+        }
+    }
+    else
+    {
+        for (size_t i = 0; i < Count; i++)
+        {
+            Vectors[i].x = SinPolar[i] * SinAzimuth[i];
+            Vectors[i].y = SinPolar[i] * CosAzimuth[i];
+            Vectors[i].z = CosPolar[i];
+        }
+    }
+}
+
+void AnglesFromVectors(const TelescopeDirectionVector *Vectors, double AzimuthSign, bool FromAzimuthalPlane,
+                       size_t Count, double *AzimuthAngles, double *PolarAngles)
+{
+    double X[BLOCK_SIZE], Y[BLOCK_SIZE], Z[BLOCK_SIZE];
+
+    for (size_t i = 0; i < Count; i++)
+    {
+        X[i] = Vectors[i].x;
+        Y[i] = AzimuthSign * Vectors[i].y;
+        Z[i] = Vectors[i].z;
+    }
+
+    for (size_t i = 0; i < Count; i++)
+        AzimuthAngles[i] = atan2(Y[i], X[i]);
+
+    if (FromAzimuthalPlane)
+    {
+        for (size_t i = 0; i < Count; i++)
+            PolarAngles[i] = asin(Z[i]);
+    }
+    else
+    {
+        for (size_t i = 0; i < Count; i++)
+            PolarAngles[i] = acos(Z[i]);
+    }
+}
+}
+
 void TelescopeDirectionVectorSupportFunctions::SphericalCoordinateFromTelescopeDirectionVector(
     const TelescopeDirectionVector TelescopeDirectionVector, double &AzimuthAngle,
     AzimuthAngleDirection AzimuthAngleDirection, double &PolarAngle, PolarAngleDirection PolarAngleDirection)
@@ -85,5 +155,100 @@ TelescopeDirectionVectorSupportFunctions::TelescopeDirectionVectorFromSphericalC
     return Vector;
 }
 
+void TelescopeDirectionVectorSupportFunctions::TelescopeDirectionVectorsFromSphericalCoordinates(
+    const double *AzimuthAngles, AzimuthAngleDirection AzimuthAngleDirection, const double *PolarAngles,
+    PolarAngleDirection PolarAngleDirection, size_t Count, TelescopeDirectionVector *TelescopeDirectionVectors)
+{
+    const double AzimuthSign = ANTI_CLOCKWISE == AzimuthAngleDirection ? 1 : -1;
+
+    for (size_t First = 0; First < Count; First += BLOCK_SIZE)
+        VectorsFromAngles(AzimuthAngles + First, AzimuthSign, PolarAngles + First,
+                          FROM_AZIMUTHAL_PLANE == PolarAngleDirection, std::min(BLOCK_SIZE, Count - First),
+                          TelescopeDirectionVectors + First);
+}
+
+void TelescopeDirectionVectorSupportFunctions::SphericalCoordinatesFromTelescopeDirectionVectors(
+    const TelescopeDirectionVector *TelescopeDirectionVectors, size_t Count, double *AzimuthAngles,
+    AzimuthAngleDirection AzimuthAngleDirection, double *PolarAngles, PolarAngleDirection PolarAngleDirection)
+{
+    const double AzimuthSign = ANTI_CLOCKWISE == AzimuthAngleDirection ? 1 : -1;
+
+    for (size_t First = 0; First < Count; First += BLOCK_SIZE)
+        AnglesFromVectors(TelescopeDirectionVectors + First, AzimuthSign, FROM_AZIMUTHAL_PLANE == PolarAngleDirection,
+                          std::min(BLOCK_SIZE, Count - First), AzimuthAngles + First, PolarAngles + First);
+}
+
+void TelescopeDirectionVectorSupportFunctions::TelescopeDirectionVectorsFromEquatorialCoordinates(
+    const INDI::IEquatorialCoordinates *EquatorialCoordinates, size_t Count,
+    TelescopeDirectionVector *TelescopeDirectionVectors)
+{
+    double AzimuthAngles[BLOCK_SIZE], PolarAngles[BLOCK_SIZE];
+
+    for (size_t First = 0; First < Count; First += BLOCK_SIZE)
+    {
+        const size_t Block = std::min(BLOCK_SIZE, Count - First);
+        for (size_t i = 0; i < Block; i++)
+        {
+            AzimuthAngles[i] = DEG_TO_RAD(EquatorialCoordinates[First + i].rightascension * 15.0);
+            PolarAngles[i]   = DEG_TO_RAD(EquatorialCoordinates[First + i].declination);
+        }
+        VectorsFromAngles(AzimuthAngles, 1, PolarAngles, true, Block, TelescopeDirectionVectors + First);
+    }
+}
+
+void TelescopeDirectionVectorSupportFunctions::EquatorialCoordinatesFromTelescopeDirectionVectors(
+    const TelescopeDirectionVector *TelescopeDirectionVectors, size_t Count,
+    INDI::IEquatorialCoordinates *EquatorialCoordinates)
+{
+    double AzimuthAngles[BLOCK_SIZE], PolarAngles[BLOCK_SIZE];
+
+    for (size_t First = 0; First < Count; First += BLOCK_SIZE)
+    {
+        const size_t Block = std::min(BLOCK_SIZE, Count - First);
+        AnglesFromVectors(TelescopeDirectionVectors + First, 1, true, Block, AzimuthAngles, PolarAngles);
+        for (size_t i = 0; i < Block; i++)
+        {
+            EquatorialCoordinates[First + i].rightascension = range24(RAD_TO_DEG(AzimuthAngles[i]) / 15.0);
+            EquatorialCoordinates[First + i].declination    = rangeDec(RAD_TO_DEG(PolarAngles[i]));
+        }
+    }
+}
+
+void TelescopeDirectionVectorSupportFunctions::TelescopeDirectionVectorsFromAltitudeAzimuth(
+    const INDI::IHorizontalCoordinates *HorizontalCoordinates, size_t Count,
+    TelescopeDirectionVector *TelescopeDirectionVectors)
+{
+    double AzimuthAngles[BLOCK_SIZE], PolarAngles[BLOCK_SIZE];
+
+    for (size_t First = 0; First < Count; First += BLOCK_SIZE)
+    {
+        const size_t Block = std::min(BLOCK_SIZE, Count - First);
+        for (size_t i = 0; i < Block; i++)
+        {
+            AzimuthAngles[i] = DEG_TO_RAD(HorizontalCoordinates[First + i].azimuth);
+            PolarAngles[i]   = DEG_TO_RAD(HorizontalCoordinates[First + i].altitude);
+        }
+        VectorsFromAngles(AzimuthAngles, -1, PolarAngles, true, Block, TelescopeDirectionVectors + First);
+    }
+}
+
+void TelescopeDirectionVectorSupportFunctions::AltitudeAzimuthFromTelescopeDirectionVectors(
+    const TelescopeDirectionVector *TelescopeDirectionVectors, size_t Count,
+    INDI::IHorizontalCoordinates *HorizontalCoordinates)
+{
+    double AzimuthAngles[BLOCK_SIZE], PolarAngles[BLOCK_SIZE];
+
+    for (size_t First = 0; First < Count; First += BLOCK_SIZE)
+    {
+        const size_t Block = std::min(BLOCK_SIZE, Count - First);
+        AnglesFromVectors(TelescopeDirectionVectors + First, -1, true, Block, AzimuthAngles, PolarAngles);
+        for (size_t i = 0; i < Block; i++)
+        {
+            HorizontalCoordinates[First + i].azimuth  = range360(RAD_TO_DEG(AzimuthAngles[i]));
+            HorizontalCoordinates[First + i].altitude = RAD_TO_DEG(PolarAngles[i]);
+        }
+    }
+}
+
 } // namespace AlignmentSubsystem
 } // namespace INDI
@@ -12,6 +12,8 @@
 #include "libastro.h"
 #include "indicom.h"
 
+#include <cstddef>
+
 namespace INDI
 {
 namespace AlignmentSubsystem
@@ -176,6 +178,70 @@ class TelescopeDirectionVectorSupportFunctions
         TelescopeDirectionVectorFromSphericalCoordinate(const double AzimuthAngle,
                 AzimuthAngleDirection_t AzimuthAngleDirection,
                 const double PolarAngle, PolarAngleDirection_t PolarAngleDirection);
+
+        /*! \brief Calculates telescope direction vectors from arrays of spherical coordinates
+             * \param[in] AzimuthAngles The azimuth angles in radians
+             * \param[in] AzimuthAngleDirection The direction the azimuth angles have been measured either CLOCKWISE or ANTI_CLOCKWISE
+             * \param[in] PolarAngles The polar angles in radians
+             * \param[in] PolarAngleDirection The direction the polar angles have been measured either FROM_POLAR_AXIS or FROM_AZIMUTHAL_PLANE
+             * \param[in] Count The number of coordinates
+             * \param[out] TelescopeDirectionVectors Count TelescopeDirectionVectors
+             * \note Gives the same vectors as TelescopeDirectionVectorFromSphericalCoordinate. The trigonometry runs in branch free
+             * loops over contiguous blocks of angles so the compiler can vectorise it.
+             */
+        void TelescopeDirectionVectorsFromSphericalCoordinates(const double *AzimuthAngles,
+                AzimuthAngleDirection_t AzimuthAngleDirection,
+                const double *PolarAngles, PolarAngleDirection_t PolarAngleDirection,
+                size_t Count, TelescopeDirectionVector *TelescopeDirectionVectors);
+
+        /*! \brief Calculates spherical coordinates from an array of telescope direction vectors
+             * \param[in] TelescopeDirectionVectors The telescope direction vectors
+             * \param[in] Count The number of vectors
+             * \param[out] AzimuthAngles Count azimuth angles in radians
+             * \param[in] AzimuthAngleDirection The direction the azimuth angles are measured either CLOCKWISE or ANTI_CLOCKWISE
+             * \param[out] PolarAngles Count polar angles in radians
+             * \param[in] PolarAngleDirection The direction the polar angles are measured either FROM_POLAR_AXIS or FROM_AZIMUTHAL_PLANE
+             * \note Gives the same angles as SphericalCoordinateFromTelescopeDirectionVector.
+             */
+        void SphericalCoordinatesFromTelescopeDirectionVectors(const TelescopeDirectionVector *TelescopeDirectionVectors,
+                size_t Count, double *AzimuthAngles, AzimuthAngleDirection_t AzimuthAngleDirection,
+                double *PolarAngles, PolarAngleDirection_t PolarAngleDirection);
+
+        /*! \brief Calculates telescope direction vectors from an array of equatorial coordinates.
+             * \param[in] EquatorialCoordinates The equatorial coordinates in hours and degrees
+             * \param[in] Count The number of coordinates
+             * \param[out] TelescopeDirectionVectors Count TelescopeDirectionVectors
+             * \note Batch version of TelescopeDirectionVectorFromEquatorialCoordinates.
+             */
+        void TelescopeDirectionVectorsFromEquatorialCoordinates(const INDI::IEquatorialCoordinates *EquatorialCoordinates,
+                size_t Count, TelescopeDirectionVector *TelescopeDirectionVectors);
+
+        /*! \brief Calculates equatorial coordinates from an array of telescope direction vectors.
+             * \param[in] TelescopeDirectionVectors The telescope direction vectors
+             * \param[in] Count The number of vectors
+             * \param[out] EquatorialCoordinates Count equatorial coordinates in hours and degrees
+             * \note Batch version of EquatorialCoordinatesFromTelescopeDirectionVector.
+             */
+        void EquatorialCoordinatesFromTelescopeDirectionVectors(const TelescopeDirectionVector *TelescopeDirectionVectors,
+                size_t Count, INDI::IEquatorialCoordinates *EquatorialCoordinates);
+
+        /*! \brief Calculates telescope direction vectors from an array of altitudes and azimuths.
+             * \param[in] HorizontalCoordinates Altitudes and Azimuths in decimal degrees
+             * \param[in] Count The number of coordinates
+             * \param[out] TelescopeDirectionVectors Count TelescopeDirectionVectors
+             * \note Batch version of TelescopeDirectionVectorFromAltitudeAzimuth.
+             */
+        void TelescopeDirectionVectorsFromAltitudeAzimuth(const INDI::IHorizontalCoordinates *HorizontalCoordinates,
+                size_t Count, TelescopeDirectionVector *TelescopeDirectionVectors);
+
+        /*! \brief Calculates altitudes and azimuths from an array of telescope direction vectors.
+             * \param[in] TelescopeDirectionVectors The telescope direction vectors
+             * \param[in] Count The number of vectors
+             * \param[out] HorizontalCoordinates Count Altitudes and Azimuths in decimal degrees
+             * \note Batch version of AltitudeAzimuthFromTelescopeDirectionVector.
+             */
+        void AltitudeAzimuthFromTelescopeDirectionVectors(const TelescopeDirectionVector *TelescopeDirectionVectors,
+                size_t Count, INDI::IHorizontalCoordinates *HorizontalCoordinates);
 };
 
 } // namespace AlignmentSubsystem
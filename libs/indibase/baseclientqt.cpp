@@ -19,6 +19,7 @@
 *******************************************************************************/
 
 #include "baseclientqt.h"
+#include "baseclientqt_p.h"
 
 #include "base64.h"
 #include "basedevice.h"
@@ -27,14 +28,21 @@
 
 #include "indiuserio.h"
 
+#include <QElapsedTimer>
+
 #include <iostream>
 #include <string>
 #include <algorithm>
 
 #include <cstdlib>
+#include <cstring>
 #include <assert.h>
 
+#include <zlib.h>
+
 #define MAXINDIBUF 49152
+/* longest run of messages dispatched before returning to the client event loop, in ms */
+#define MAXDISPATCHMS 10
 
 #if defined(_MSC_VER)
 #define snprintf _snprintf
@@ -50,7 +58,7 @@ INDI::BaseClientQt::BaseClientQt(QObject *parent) : QObject(parent), cServer("lo
     io.write = [](void *user, const void * ptr, size_t count) -> size_t
     {
         BaseClientQt *self = static_cast<BaseClientQt *>(user);
-        return self->client_socket.write(static_cast<const char *>(ptr), count);
+        return self->reader->write(static_cast<const char *>(ptr), count);
     };
 
     io.vprintf = [](void *user, const char * format, va_list ap) -> int
@@ -58,23 +66,32 @@ INDI::BaseClientQt::BaseClientQt(QObject *parent) : QObject(parent), cServer("lo
         BaseClientQt *self = static_cast<BaseClientQt *>(user);
         char message[MAXRBUF];
         vsnprintf(message, MAXRBUF, format, ap);
-        return self->client_socket.write(message, strlen(message));
+        return self->reader->write(message, strlen(message));
     };
 
-    sConnected = false;
-    verbose    = false;
-    lillp      = nullptr;
+    sConnected  = false;
+    verbose     = false;
+    dispatching = nullptr;
 
     timeout_sec = 3;
     timeout_us  = 0;
 
-    connect(&client_socket, SIGNAL(readyRead()), this, SLOT(listenINDI()));
-    connect(&client_socket, SIGNAL(error(QAbstractSocket::SocketError)), this,
-            SLOT(processSocketError(QAbstractSocket::SocketError)));
+    reader = new BaseClientQtReader();
+    reader->moveToThread(&readerThread);
+
+    connect(reader, SIGNAL(messagesReady()), this, SLOT(listenINDI()));
+    connect(reader, SIGNAL(socketError(QString)), this, SLOT(processSocketError(QString)));
+
+    readerThread.start();
 }
 
 INDI::BaseClientQt::~BaseClientQt()
 {
+    QMetaObject::invokeMethod(reader, "disconnectFromServer", Qt::BlockingQueuedConnection);
+    readerThread.quit();
+    readerThread.wait();
+    delete reader;
+
     clear();
 }
 
@@ -118,9 +135,16 @@ void INDI::BaseClientQt::watchProperty(const char *deviceName, const char *prope
 
 bool INDI::BaseClientQt::connectServer()
 {
-    client_socket.connectToHost(cServer.c_str(), cPort);
+    bool connected = false;
 
-    if (client_socket.waitForConnected(timeout_sec * 1000) == false)
+    // The socket lives on the reader thread, wait there for the connection
+    QMetaObject::invokeMethod(reader, "connectToServer", Qt::BlockingQueuedConnection,
+                              Q_RETURN_ARG(bool, connected),
+                              Q_ARG(QString, QString::fromStdString(cServer)),
+                              Q_ARG(quint16, static_cast<quint16>(cPort)),
+                              Q_ARG(int, static_cast<int>(timeout_sec * 1000)));
+
+    if (connected == false)
     {
         sConnected = false;
         return false;
@@ -128,8 +152,6 @@ bool INDI::BaseClientQt::connectServer()
 
     clear();
 
-    lillp = newLilXML();
-
     sConnected = true;
 
     serverConnected();
@@ -163,12 +185,8 @@ bool INDI::BaseClientQt::disconnectServer()
 
     sConnected = false;
 
-    client_socket.close();
-    if (lillp)
-    {
-        delLilXML(lillp);
-        lillp = nullptr;
-    }
+    QMetaObject::invokeMethod(reader, "disconnectFromServer", Qt::BlockingQueuedConnection);
+    reader->clearMessages();
 
     clear();
 
@@ -252,54 +270,47 @@ void *INDI::BaseClientQt::listenHelper(void *context)
 
 void INDI::BaseClientQt::listenINDI()
 {
-    char buffer[MAXINDIBUF];
     char errorMsg[MAXRBUF];
     int err_code = 0;
 
-    XMLEle **nodes;
-    int inode = 0;
-
     if (sConnected == false)
+    {
+        reader->clearMessages();
         return;
+    }
 
-    while (client_socket.bytesAvailable() > 0)
+    QElapsedTimer elapsed;
+    elapsed.start();
+
+    BaseClientQtMessage message;
+    while (reader->takeMessage(message))
     {
-        qint64 readBytes = client_socket.read(buffer, MAXINDIBUF - 1);
-        if (readBytes > 0)
-            buffer[readBytes] = '\0';
+        XMLEle *root = message.root.get();
 
-        nodes = parseXMLChunk(lillp, buffer, readBytes, errorMsg);
-        if (!nodes)
+        if (verbose)
+            prXMLEle(stderr, root, 0);
+
+        dispatching = &message;
+        if ((err_code = dispatchCommand(root, errorMsg)) < 0)
         {
-            if (errorMsg[0])
+            // Silenty ignore property duplication errors
+            if (err_code != INDI_PROPERTY_DUPLICATED)
             {
-                fprintf(stderr, "Bad XML from %s/%ud: %s\n%s\n", cServer.c_str(), cPort, errorMsg, buffer);
-                return;
+                IDLog("Dispatch command error(%d): %s\n", err_code, errorMsg);
+                prXMLEle(stderr, root, 0);
             }
-            return;
         }
-        XMLEle *root = nodes[inode];
-        while (root)
-        {
-            if (verbose)
-                prXMLEle(stderr, root, 0);
+        dispatching = nullptr;
 
-            if ((err_code = dispatchCommand(root, errorMsg)) < 0)
-            {
-                // Silenty ignore property duplication errors
-                if (err_code != INDI_PROPERTY_DUPLICATED)
-                {
-                    IDLog("Dispatch command error(%d): %s\n", err_code, errorMsg);
-                    prXMLEle(stderr, root, 0);
-                }
-            }
+        message.root.reset();
+        message.blobs.clear();
 
-            delXMLEle(root); // not yet, delete and continue
-            inode++;
-            root = nodes[inode];
+        // Let the event loop run, the remaining messages are dispatched on its next turn
+        if (elapsed.elapsed() >= MAXDISPATCHMS)
+        {
+            QMetaObject::invokeMethod(this, "listenINDI", Qt::QueuedConnection);
+            return;
         }
-        free(nodes);
-        inode = 0;
     }
 }
 
@@ -332,7 +343,7 @@ int INDI::BaseClientQt::dispatchCommand(XMLEle *root, char *errmsg)
         if (!strcmp(tagXMLEle(root), "defBLOBVector"))
             return dp->buildProp(root, errmsg);
         else if (!strcmp(tagXMLEle(root), "setBLOBVector"))
-            return dp->setValue(root, errmsg);
+            return setBLOB(dp, root, errmsg);
 
         // Ignore everything else
         return 0;
@@ -356,13 +367,46 @@ int INDI::BaseClientQt::dispatchCommand(XMLEle *root, char *errmsg)
             (!strcmp(tagXMLEle(root), "defBLOBVector")))
         return dp->buildProp(root, errmsg);
     else if (!strcmp(tagXMLEle(root), "setTextVector") || !strcmp(tagXMLEle(root), "setNumberVector") ||
-             !strcmp(tagXMLEle(root), "setSwitchVector") || !strcmp(tagXMLEle(root), "setLightVector") ||
-             !strcmp(tagXMLEle(root), "setBLOBVector"))
+             !strcmp(tagXMLEle(root), "setSwitchVector") || !strcmp(tagXMLEle(root), "setLightVector"))
         return dp->setValue(root, errmsg);
+    else if (!strcmp(tagXMLEle(root), "setBLOBVector"))
+        return setBLOB(dp, root, errmsg);
 
     return INDI_DISPATCH_ERROR;
 }
 
+/* the reader thread removed the oneBLOB elements it decoded, so BaseDevice only sets the
+ * vector state and handles what was left. Hand the decoded buffers over to the BLOB elements.
+ */
+int INDI::BaseClientQt::setBLOB(INDI::BaseDevice *dp, XMLEle *root, char *errmsg)
+{
+    int err_code = dp->setValue(root, errmsg);
+
+    if (err_code < 0 || dispatching == nullptr)
+        return err_code;
+
+    IBLOBVectorProperty *bvp = dp->getBLOB(findXMLAttValu(root, "name"));
+    if (bvp == nullptr)
+        return err_code;
+
+    for (auto &blob : dispatching->blobs)
+    {
+        IBLOB *blobEL = IUFindBLOB(bvp, blob.name.c_str());
+        if (blobEL == nullptr)
+            continue;
+
+        free(blobEL->blob);
+        blobEL->blob    = blob.data.release();
+        blobEL->size    = blob.size;
+        blobEL->bloblen = blob.bloblen;
+        strncpy(blobEL->format, blob.format.c_str(), MAXINDIFORMAT);
+
+        newBLOB(blobEL);
+    }
+
+    return 0;
+}
+
 /* delete the property in the given device, including widgets and data structs.
  * when last property is deleted, delete the device too.
  * if no property name attribute at all, delete the whole device regardless.
@@ -685,17 +729,16 @@ INDI::BaseClientQt::BLOBMode *INDI::BaseClientQt::findBLOBMode(const std::string
     return nullptr;
 }
 
-void INDI::BaseClientQt::processSocketError(QAbstractSocket::SocketError socketError)
+void INDI::BaseClientQt::processSocketError(const QString &message)
 {
     if (sConnected == false)
         return;
 
     // TODO Handle what happens on socket failure!
-    INDI_UNUSED(socketError);
-    IDLog("Socket Error: %s\n", client_socket.errorString().toLatin1().constData());
+    IDLog("Socket Error: %s\n", message.toLatin1().constData());
     fprintf(stderr, "INDI server %s/%d disconnected.\n", cServer.c_str(), cPort);
-    delLilXML(lillp);
-    client_socket.close();
+    // The reader closed the socket already
+    reader->clearMessages();
     // Let client handle server disconnection
     serverDisconnected(-1);
 }
@@ -716,6 +759,297 @@ bool INDI::BaseClientQt::isServerConnected() const
     return sConnected;
 }
 
+INDI::BaseClientQtReader::~BaseClientQtReader()
+{
+    if (lillp)
+        delLilXML(lillp);
+}
+
+bool INDI::BaseClientQtReader::connectToServer(const QString &host, quint16 port, int timeoutMs)
+{
+    if (socket == nullptr)
+    {
+        socket = new QTcpSocket(this);
+        connect(socket, SIGNAL(readyRead()), this, SLOT(readSocket()));
+        connect(socket, SIGNAL(error(QAbstractSocket::SocketError)), this, SLOT(processSocketError()));
+    }
+
+    clearMessages();
+
+    socket->connectToHost(host, port);
+
+    if (socket->waitForConnected(timeoutMs) == false)
+    {
+        socket->abort();
+        return false;
+    }
+
+    if (lillp)
+        delLilXML(lillp);
+    lillp = newLilXML();
+
+    return true;
+}
+
+void INDI::BaseClientQtReader::disconnectFromServer()
+{
+    {
+        std::lock_guard<std::mutex> lock(writeMutex);
+        outgoing.clear();
+    }
+
+    if (socket)
+        socket->close();
+
+    if (lillp)
+    {
+        delLilXML(lillp);
+        lillp = nullptr;
+    }
+
+    clearMessages();
+}
+
+size_t INDI::BaseClientQtReader::write(const char *data, size_t size)
+{
+    bool flushQueued;
+    {
+        std::lock_guard<std::mutex> lock(writeMutex);
+        flushQueued = !outgoing.isEmpty();
+        outgoing.append(data, static_cast<int>(size));
+    }
+
+    if (!flushQueued)
+        QMetaObject::invokeMethod(this, "flush", Qt::QueuedConnection);
+
+    return size;
+}
+
+void INDI::BaseClientQtReader::flush()
+{
+    QByteArray data;
+    {
+        std::lock_guard<std::mutex> lock(writeMutex);
+        data.swap(outgoing);
+    }
+
+    if (socket && socket->state() == QAbstractSocket::ConnectedState)
+        socket->write(data);
+}
+
+void INDI::BaseClientQtReader::readSocket()
+{
+    char buffer[MAXINDIBUF];
+    char errorMsg[MAXRBUF];
+
+    if (lillp == nullptr)
+        return;
+
+    while (socket->bytesAvailable() > 0)
+    {
+        qint64 readBytes = socket->read(buffer, MAXINDIBUF - 1);
+        if (readBytes <= 0)
+            return;
+        buffer[readBytes] = '\0';
+
+        XMLEle **nodes = parseXMLChunk(lillp, buffer, readBytes, errorMsg);
+        if (!nodes)
+        {
+            if (errorMsg[0])
+                fprintf(stderr, "Bad XML from %s/%u: %s\n%s\n", socket->peerName().toLatin1().constData(),
+                        socket->peerPort(), errorMsg, buffer);
+            return;
+        }
+
+        for (int inode = 0; nodes[inode]; inode++)
+        {
+            BaseClientQtMessage message;
+            message.root.reset(nodes[inode]);
+
+            if (!strcmp(tagXMLEle(nodes[inode]), "setBLOBVector"))
+                decodeBLOBs(message);
+
+            enqueue(std::move(message));
+        }
+        free(nodes);
+    }
+}
+
+/* decode the base64 payload of every oneBLOB, and uncompress it if needed, the way
+ * BaseDevice::setBLOB does. Elements that fail or only carry a state change are left in
+ * place for BaseDevice::setBLOB to handle and report on the client thread.
+ */
+void INDI::BaseClientQtReader::decodeBLOBs(BaseClientQtMessage &message)
+{
+    XMLEle *root = message.root.get();
+    std::vector<XMLEle *> decoded;
+
+    for (XMLEle *ep = nextXMLEle(root, 1); ep; ep = nextXMLEle(root, 0))
+    {
+        if (strcmp(tagXMLEle(ep), "oneBLOB"))
+            continue;
+
+        XMLAtt *na = findXMLAtt(ep, "name");
+        XMLAtt *fa = findXMLAtt(ep, "format");
+        XMLAtt *sa = findXMLAtt(ep, "size");
+        if (!na || !fa || !sa || atoi(valuXMLAtt(sa)) == 0)
+            continue;
+
+        BaseClientQtBLOB blob;
+        blob.name   = valuXMLAtt(na);
+        blob.format = valuXMLAtt(fa);
+        blob.size   = atoi(valuXMLAtt(sa));
+
+        uint32_t base64_encoded_size = pcdatalenXMLEle(ep);
+        blob.data.reset(malloc(3 * base64_encoded_size / 4));
+        if (!blob.data)
+            continue;
+        blob.bloblen = from64tobits_fast(static_cast<char *>(blob.data.get()), pcdataXMLEle(ep), base64_encoded_size);
+
+        if (strstr(blob.format.c_str(), ".z"))
+        {
+            uLongf dataSize = blob.size * sizeof(uint8_t);
+            std::unique_ptr<void, BaseClientQtBLOB::FreeDeleter> dataBuffer(malloc(dataSize));
+
+            if (!dataBuffer || uncompress(static_cast<Bytef *>(dataBuffer.get()), &dataSize,
+                                          static_cast<Bytef *>(blob.data.get()), static_cast<uLong>(blob.bloblen)) != Z_OK)
+                continue;
+
+            blob.format.resize(blob.format.size() - 2);
+            blob.size = dataSize;
+            blob.data = std::move(dataBuffer);
+        }
+
+        message.blobs.push_back(std::move(blob));
+        decoded.push_back(ep);
+    }
+
+    // Release the base64 text before the message waits in the queue
+    for (XMLEle *ep : decoded)
+        delXMLEle(ep);
+}
+
+/* true if newer updates the state, timeout and every element of older, so older can be skipped.
+ * Updates carrying a message are always dispatched.
+ */
+bool INDI::BaseClientQtReader::supersedes(XMLEle *newer, XMLEle *older)
+{
+    if (strcmp(tagXMLEle(newer), tagXMLEle(older)))
+        return false;
+
+    if (findXMLAtt(older, "message"))
+        return false;
+
+    if ((findXMLAtt(older, "state") && !findXMLAtt(newer, "state")) ||
+            (findXMLAtt(older, "timeout") && !findXMLAtt(newer, "timeout")))
+        return false;
+
+    for (XMLEle *ep = nextXMLEle(older, 1); ep; ep = nextXMLEle(older, 0))
+    {
+        const char *name = findXMLAttValu(ep, "name");
+        bool found = false;
+        for (XMLEle *np = nextXMLEle(newer, 1); np && !found; np = nextXMLEle(newer, 0))
+            found = !strcmp(name, findXMLAttValu(np, "name"));
+        if (!found)
+            return false;
+    }
+
+    return true;
+}
+
+void INDI::BaseClientQtReader::enqueue(BaseClientQtMessage &&message)
+{
+    XMLEle *root    = message.root.get();
+    const char *tag = tagXMLEle(root);
+    std::string device = findXMLAttValu(root, "device");
+    std::string key    = device + '\n' + findXMLAttValu(root, "name");
+
+    bool notify;
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+
+        // BLOBs are never skipped, their vector still goes through the queue in order
+        if (!strncmp(tag, "set", 3) && strcmp(tag, "setBLOBVector"))
+        {
+            auto it = latest.find(key);
+            if (it != latest.end() && it->second >= head)
+            {
+                BaseClientQtMessage &previous = queue[it->second - head];
+                if (previous.root && supersedes(root, previous.root.get()))
+                    previous.root.reset();
+            }
+            latest[key] = head + queue.size();
+        }
+        // Updates queued before a property is defined or deleted must stay
+        else if (!strncmp(tag, "def", 3))
+            latest.erase(key);
+        else if (!strcmp(tag, "delProperty"))
+        {
+            if (findXMLAtt(root, "name"))
+                latest.erase(key);
+            else
+            {
+                auto it = latest.lower_bound(device + '\n');
+                while (it != latest.end() && !it->first.compare(0, device.size() + 1, device + '\n'))
+                    it = latest.erase(it);
+            }
+        }
+
+        queue.push_back(std::move(message));
+
+        notify   = !notified;
+        notified = true;
+    }
+
+    if (notify)
+        emit messagesReady();
+}
+
+bool INDI::BaseClientQtReader::takeMessage(BaseClientQtMessage &message)
+{
+    std::lock_guard<std::mutex> lock(queueMutex);
+
+    while (!queue.empty())
+    {
+        BaseClientQtMessage front = std::move(queue.front());
+        queue.pop_front();
+        head++;
+
+        if (front.root)
+        {
+            message = std::move(front);
+            return true;
+        }
+    }
+
+    latest.clear();
+    notified = false;
+    return false;
+}
+
+void INDI::BaseClientQtReader::clearMessages()
+{
+    std::lock_guard<std::mutex> lock(queueMutex);
+    queue.clear();
+    latest.clear();
+    head     = 0;
+    notified = false;
+}
+
+void INDI::BaseClientQtReader::processSocketError()
+{
+    // A failed connection attempt is reported by connectToServer
+    if (lillp == nullptr)
+        return;
+
+    QString message = socket->errorString();
+    socket->close();
+    delLilXML(lillp);
+    lillp = nullptr;
+
+    emit socketError(message);
+}
+
 #if defined(_MSC_VER)
 #undef snprintf
 #pragma warning(pop)
@@ -25,6 +25,7 @@
 #include "indibase.h"
 
 #include <QTcpSocket>
+#include <QThread>
 
 #include <vector>
 #include <string>
@@ -38,6 +39,12 @@ typedef SSIZE_T ssize_t;
 
 // #define MAXRBUF 2048 // #PS: defined in indibase.h
 
+namespace INDI
+{
+class BaseClientQtReader;
+struct BaseClientQtMessage;
+}
+
 /**
  * \class INDI::BaseClientQt
    \brief Class to provide basic client functionality based on Qt5 toolkit and is therefore suitable for cross-platform development.
@@ -47,6 +54,11 @@ typedef SSIZE_T ssize_t;
    a set of INDI::BaseDevice devices, and read and write properties seamlessly. Event driven programming is possible due to
    notifications upon reception of new devices or properties.
 
+   The server socket is read on a worker thread, which also parses the XML stream and decodes BLOBs. Parsed messages
+   are dispatched on the thread of the client object in slices of a few milliseconds, so the client event loop stays
+   responsive while large BLOBs are transferred. Property updates that are superseded before the client gets to them
+   are skipped.
+
    \attention All notifications functions defined in INDI::BaseMediator <b>must</b> be implemented in the client class even if
    they are not used because these are pure virtual functions.
 
@@ -236,6 +248,9 @@ class INDI::BaseClientQt : public QObject, public INDI::BaseMediator
         /** \brief Dispatch command received from INDI server to respective devices handled by the client */
         int dispatchCommand(XMLEle *root, char *errmsg);
 
+        /** \brief Set a BLOB vector, applying the BLOBs already decoded by the reader thread */
+        int setBLOB(INDI::BaseDevice *dp, XMLEle *root, char *errmsg);
+
         /** \brief Remove device */
         int deleteDevice(const char *devName, char *errmsg);
 
@@ -281,7 +296,10 @@ class INDI::BaseClientQt : public QObject, public INDI::BaseMediator
          */
         void clear();
 
-        QTcpSocket client_socket;
+        INDI::BaseClientQtReader *reader;
+        QThread readerThread;
+        /** Message being dispatched, holds the BLOBs decoded by the reader */
+        INDI::BaseClientQtMessage *dispatching;
 
         std::vector<INDI::BaseDevice *> cDevices;
         std::vector<std::string> cDeviceNames;
@@ -293,13 +311,11 @@ class INDI::BaseClientQt : public QObject, public INDI::BaseMediator
         bool sConnected;
         bool verbose;
 
-        // Parse & FILE buffers for IO
-
-        LilXML *lillp; /* XML parser context */
         uint32_t timeout_sec, timeout_us;
 
     private slots:
 
+        /** \brief Dispatch the messages parsed by the reader, yielding to the event loop every few milliseconds */
         void listenINDI();
-        void processSocketError(QAbstractSocket::SocketError socketError);
+        void processSocketError(const QString &message);
 };
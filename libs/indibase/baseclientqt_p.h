@@ -0,0 +1,138 @@
+/*******************************************************************************
+  Copyright(c) 2022 INDI Library Developers. All rights reserved.
+
+ INDI Qt Client, reader thread internals
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Library General Public
+ License version 2 as published by the Free Software Foundation.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Library General Public License for more details.
+
+ You should have received a copy of the GNU Library General Public License
+ along with this library; see the file COPYING.LIB.  If not, write to
+ the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ Boston, MA 02110-1301, USA.
+*******************************************************************************/
+
+#pragma once
+
+#include <QObject>
+#include <QByteArray>
+#include <QString>
+#include <QTcpSocket>
+
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <lilxml.h>
+
+namespace INDI
+{
+
+/** @brief One BLOB decoded from base64, and uncompressed if needed, on the reader thread. */
+struct BaseClientQtBLOB
+{
+    struct FreeDeleter
+    {
+        void operator()(void *data) const
+        {
+            free(data);
+        }
+    };
+
+    std::string name;
+    std::string format;
+    int size {0};
+    int bloblen {0};
+    /** malloc'd buffer, its ownership moves to the IBLOB element which frees it with free() */
+    std::unique_ptr<void, FreeDeleter> data;
+};
+
+/** @brief One message parsed on the reader thread, waiting to be dispatched on the client thread. */
+struct BaseClientQtMessage
+{
+    struct XMLDeleter
+    {
+        void operator()(XMLEle *root) const
+        {
+            delXMLEle(root);
+        }
+    };
+
+    /** nullptr once the message was superseded by a later update of the same property */
+    std::unique_ptr<XMLEle, XMLDeleter> root;
+    /** oneBLOB elements already decoded, removed from root */
+    std::vector<BaseClientQtBLOB> blobs;
+};
+
+/**
+ * @brief The BaseClientQtReader class owns the server socket on a worker thread.
+ *
+ * It reads and parses the XML stream and decodes BLOB payloads away from the client thread, then queues the
+ * parsed messages. A set*Vector still waiting in the queue is dropped when a later one of the same property
+ * updates all of its elements, so a client thread that falls behind catches up on the latest values.
+ *
+ * Outgoing data is buffered from any thread and written to the socket on the worker thread.
+ */
+class BaseClientQtReader : public QObject
+{
+        Q_OBJECT
+
+    public:
+        BaseClientQtReader() = default;
+        ~BaseClientQtReader();
+
+        /** @brief Buffer data for the server, safe to call from any thread. */
+        size_t write(const char *data, size_t size);
+
+        /** @brief Take the oldest pending message, false once the queue is empty. */
+        bool takeMessage(BaseClientQtMessage &message);
+
+        /** @brief Drop all pending messages. */
+        void clearMessages();
+
+    public slots:
+        bool connectToServer(const QString &host, quint16 port, int timeoutMs);
+        void disconnectFromServer();
+
+    signals:
+        /** @brief Emitted when the queue goes from empty to non-empty. */
+        void messagesReady();
+        void socketError(const QString &message);
+
+    private slots:
+        void readSocket();
+        void flush();
+        void processSocketError();
+
+    private:
+        void decodeBLOBs(BaseClientQtMessage &message);
+        void enqueue(BaseClientQtMessage &&message);
+        static bool supersedes(XMLEle *newer, XMLEle *older);
+
+        QTcpSocket *socket {nullptr};
+        LilXML *lillp {nullptr};
+
+        std::mutex writeMutex;
+        QByteArray outgoing;
+
+        std::mutex queueMutex;
+        std::deque<BaseClientQtMessage> queue;
+        /** sequence number of the front of the queue */
+        uint64_t head {0};
+        /** latest queued set*Vector of each device and property */
+        std::map<std::string, uint64_t> latest;
+        bool notified {false};
+};
+
+}
@@ -17,6 +17,7 @@
 *******************************************************************************/
 
 #include "connectionserial.h"
+#include "serialportregistry.h"
 #include "indistandardproperty.h"
 #include "indicom.h"
 #include "indilogger.h"
@@ -25,7 +26,6 @@
 #include <cerrno>
 #include <cstring>
 #include <algorithm>
-#include <thread>
 #include <chrono>
 #include <regex>
 
@@ -185,21 +185,34 @@ bool Serial::ISNewSwitch(const char *dev, const char *name, ISState *states, cha
 bool Serial::Connect()
 {
     uint32_t baud = atoi(IUFindOnSwitch(&BaudRateSP)->name);
-    if (Connect(PortT[0].text, baud) && processHandshake())
+    bool autoSearch = AutoSearchS[0].s == ISS_ON && SystemPortS != nullptr && SystemPortSP.nsp > 1;
+
+    // When searching, a busy port is tried again after the other ports instead of waiting for it here
+    if (probePort(PortT[0].text, baud, autoSearch ? 0 : ClaimTimeout) == PROBE_OK)
         return true;
 
-    // Important, disconnect from port immediately
-    // to release the lock, otherwise another driver will find it busy.
-    tty_disconnect(PortFD);
+    // Then the port this device was last found on, its identity survives ports renumbering. Auto search is
+    // usually disabled once the device was found, so the cache is consulted whatever its setting.
+    if (!m_Device->isSimulation())
+    {
+        std::string cachedPort = SerialPortRegistry::instance().lookup(getDeviceName());
+        if (!cachedPort.empty() && SerialPortRegistry::identity(cachedPort) != SerialPortRegistry::identity(PortT[0].text))
+        {
+            LOGF_INFO("Trying %s where %s was last found...", cachedPort.c_str(), getDeviceName());
+            if (probePort(cachedPort, baud, 0) == PROBE_OK)
+            {
+                portFound(cachedPort);
+                return true;
+            }
+        }
+    }
 
     // Start auto-search if option was selected and IF we have system ports to try connecting to
-    if (AutoSearchS[0].s == ISS_ON && SystemPortS != nullptr && SystemPortSP.nsp > 1)
+    if (autoSearch)
     {
         LOGF_WARN("Communication with %s @ %d failed. Starting Auto Search...", PortT[0].text,
                   baud);
 
-        std::this_thread::sleep_for(std::chrono::milliseconds(500 + (rand() % 1000)));
-
         // Try to connect "randomly" so that competing devices don't all try to connect to the same
         // ports at the same time.
         std::vector<std::string> systemPorts;
@@ -213,60 +226,108 @@ bool Serial::Connect()
         }
         std::random_shuffle (systemPorts.begin(), systemPorts.end());
 
-        std::vector<std::string> doubleSearch = systemPorts;
-
         // Try the current port as LAST port again
         systemPorts.push_back(PortT[0].text);
 
-        // Double search just in case some items were BUSY in the first pass
-        systemPorts.insert(systemPorts.end(), doubleSearch.begin(), doubleSearch.end());
-
+        // Ports claimed by other drivers are skipped without waiting, so that drivers searching at the
+        // same time probe different ports in parallel. They are tried again once the first pass is over.
+        std::vector<std::string> busyPorts;
         for (const auto &port : systemPorts)
         {
             LOGF_INFO("Trying connecting to %s @ %d ...", port.c_str(), baud);
-            if (Connect(port.c_str(), baud) && processHandshake())
+            ProbeResult result = probePort(port, baud, 0);
+            if (result == PROBE_OK)
             {
-                IUSaveText(&PortT[0], port.c_str());
-                IDSetText(&PortTP, nullptr);
-
-#ifdef __linux__
-                bool saveConfig = false;
-                // Disable auto-search on Linux if not disabled already
-                if (AutoSearchS[INDI::DefaultDevice::INDI_ENABLED].s == ISS_ON)
-                {
-                    saveConfig = true;
-                    AutoSearchS[INDI::DefaultDevice::INDI_ENABLED].s = ISS_OFF;
-                    AutoSearchS[INDI::DefaultDevice::INDI_DISABLED].s = ISS_ON;
-                    IDSetSwitch(&AutoSearchSP, nullptr);
-                }
-                // Only save config if different from default port
-                if (m_ConfigPort != std::string(PortT[0].text))
-                {
-                    saveConfig = true;
-                }
-
-                if (saveConfig)
-                    m_Device->saveConfig(true);
-#else
-                // Do not overwrite custom ports because it can be actually cause
-                // temporary failure. For users who use mapped named ports (e.g. /dev/mount), it's not good to override their choice.
-                // So only write to config if the port was a system port.
-                if (std::find(m_SystemPorts.begin(), m_SystemPorts.end(), PortT[0].text) != m_SystemPorts.end())
-                    m_Device->saveConfig(true, PortTP.name);
-#endif
+                portFound(port);
                 return true;
             }
+            if (result == PROBE_BUSY)
+                busyPorts.push_back(port);
+        }
 
-            tty_disconnect(PortFD);
-            // sleep randomly anytime between 0.5s and ~1.5s
-            // This enables different competing devices to connect
-            std::this_thread::sleep_for(std::chrono::milliseconds(500 + (rand() % 1000)));
+        // Only probes in progress are waited for, ports of connected devices are skipped by the claim, and the
+        // whole pass waits no longer than a single claim would.
+        const auto passDeadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(ClaimTimeout);
+        for (const auto &port : busyPorts)
+        {
+            auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(passDeadline -
+                             std::chrono::steady_clock::now()).count();
+            LOGF_INFO("Trying connecting to %s @ %d again ...", port.c_str(), baud);
+            if (probePort(port, baud, remaining > 0 ? static_cast<uint32_t>(remaining) : 0) == PROBE_OK)
+            {
+                portFound(port);
+                return true;
+            }
         }
     }
 
     return false;
 }
 
+Serial::ProbeResult Serial::probePort(const std::string &port, uint32_t baud, uint32_t claimTimeout)
+{
+    SerialPortRegistry &registry = SerialPortRegistry::instance();
+    bool simulation = m_Device->isSimulation();
+
+    if (!simulation && !registry.claim(port, getDeviceName(), claimTimeout))
+    {
+        LOGF_DEBUG("Port %s is being used by %s, skipping.", port.c_str(), registry.owner(port).c_str());
+        return PROBE_BUSY;
+    }
+
+    bool connected = Connect(port.c_str(), baud);
+    if (connected && processHandshake())
+    {
+        if (!simulation)
+        {
+            m_ClaimedPort = port;
+            registry.setConnected(port);
+            registry.remember(port, getDeviceName());
+        }
+        return PROBE_OK;
+    }
+
+    // Important, disconnect from port immediately
+    // to release the lock, otherwise another driver will find it busy.
+    tty_disconnect(PortFD);
+    if (!simulation)
+        registry.release(port);
+
+    return connected ? PROBE_FAILED : PROBE_BUSY;
+}
+
+void Serial::portFound(const std::string &port)
+{
+    IUSaveText(&PortT[0], port.c_str());
+    IDSetText(&PortTP, nullptr);
+
+#ifdef __linux__
+    bool saveConfig = false;
+    // Disable auto-search on Linux if not disabled already
+    if (AutoSearchS[INDI::DefaultDevice::INDI_ENABLED].s == ISS_ON)
+    {
+        saveConfig = true;
+        AutoSearchS[INDI::DefaultDevice::INDI_ENABLED].s = ISS_OFF;
+        AutoSearchS[INDI::DefaultDevice::INDI_DISABLED].s = ISS_ON;
+        IDSetSwitch(&AutoSearchSP, nullptr);
+    }
+    // Only save config if different from default port
+    if (m_ConfigPort != std::string(PortT[0].text))
+    {
+        saveConfig = true;
+    }
+
+    if (saveConfig)
+        m_Device->saveConfig(true);
+#else
+    // Do not overwrite custom ports because it can be actually cause
+    // temporary failure. For users who use mapped named ports (e.g. /dev/mount), it's not good to override their choice.
+    // So only write to config if the port was a system port.
+    if (std::find(m_SystemPorts.begin(), m_SystemPorts.end(), PortT[0].text) != m_SystemPorts.end())
+        m_Device->saveConfig(true, PortTP.name);
+#endif
+}
+
 bool Serial::processHandshake()
 {
     LOG_DEBUG("Connection successful, attempting handshake...");
@@ -321,6 +382,11 @@ bool Serial::Disconnect()
         tty_disconnect(PortFD);
         PortFD = -1;
     }
+    if (!m_ClaimedPort.empty())
+    {
+        SerialPortRegistry::instance().release(m_ClaimedPort);
+        m_ClaimedPort.clear();
+    }
     return true;
 }
 
@@ -149,6 +149,19 @@ class Serial : public Interface
         }
 
     protected:
+        typedef enum
+        {
+            /** Connected and handshake successful */
+            PROBE_OK,
+            /** Claimed by another driver, or could not be opened */
+            PROBE_BUSY,
+            /** Opened but the device did not answer the handshake */
+            PROBE_FAILED
+        } ProbeResult;
+
+        /** Milliseconds to wait for other drivers to finish probing ports before giving up on them */
+        static constexpr uint32_t ClaimTimeout = 5000;
+
         /**
          * \brief Connect to serial port device. Default parameters are 8 bits, 1 stop bit, no parity.
          * Override if different from default.
@@ -161,6 +174,16 @@ class Serial : public Interface
 
         virtual bool processHandshake();
 
+        /**
+         * @brief probePort Claim a port in the system wide port registry, then connect and handshake with the device.
+         * The claim is kept while connected, and released on failure.
+         * @param claimTimeout Milliseconds to wait for another driver probing the port to release it.
+         */
+        ProbeResult probePort(const std::string &port, uint32_t baud, uint32_t claimTimeout);
+
+        /** @brief portFound Keep the port found by auto search, or from the port cache, as the device port. */
+        void portFound(const std::string &port);
+
         enum
         {
             SERIAL_DEV,
@@ -192,6 +215,8 @@ class Serial : public Interface
         uint8_t stopBits = 1;
 
         std::string m_ConfigPort;
+        /** Port claimed in the port registry while connected */
+        std::string m_ClaimedPort;
         int m_ConfigBaudRate {-1};
         std::vector<std::string> m_SystemPorts;
 };
@@ -0,0 +1,331 @@
+/*
+    Copyright (C) 2022 INDI Library Developers
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include "serialportregistry.h"
+
+#include "indibase.h"
+#include "indiutility.h"
+#include "lilxml.h"
+
+#include <chrono>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <pwd.h>
+#include <sys/file.h>
+#include <unistd.h>
+
+namespace Connection
+{
+
+#ifdef __linux__
+static const char *SerialByIdPath = "/dev/serial/by-id/";
+#endif
+
+static std::string canonicalPath(const std::string &port)
+{
+    char resolved[PATH_MAX];
+    return realpath(port.c_str(), resolved) ? std::string(resolved) : port;
+}
+
+SerialPortRegistry &SerialPortRegistry::instance()
+{
+    // Never destroyed, claims are released by the system when the driver exits
+    static SerialPortRegistry *registry = []()
+    {
+        const char *home = getenv("HOME");
+        if (home == nullptr)
+        {
+            struct passwd *pw = getpwuid(getuid());
+            home = pw ? pw->pw_dir : "/tmp";
+        }
+        return new SerialPortRegistry(std::string(home) + "/.indi/ports");
+    }();
+    return *registry;
+}
+
+SerialPortRegistry::SerialPortRegistry(const std::string &directory) : m_Directory(directory)
+{
+    INDI::mkpath(m_Directory, 0775);
+}
+
+SerialPortRegistry::~SerialPortRegistry()
+{
+    for (auto &oneClaim : m_Claims)
+        close(oneClaim.second.fd);
+}
+
+std::string SerialPortRegistry::lockFile(const std::string &port) const
+{
+    // One lock per device node, shared by all the links pointing to it
+    std::string name = canonicalPath(port);
+    for (auto &c : name)
+        if (c == '/')
+            c = '_';
+    return m_Directory + "/" + name + ".lock";
+}
+
+void SerialPortRegistry::writeClaim(const Claim &claim)
+{
+    // Owner name, then the state of the claim
+    std::string content = claim.device + (claim.connected ? "\nconnected\n" : "\nprobing\n");
+    if (ftruncate(claim.fd, 0) != 0 || pwrite(claim.fd, content.c_str(), content.size(), 0) < 0)
+    {
+        // The content is advisory only, an unreadable claim is waited for like a probe
+    }
+}
+
+bool SerialPortRegistry::claim(const std::string &port, const std::string &device, uint32_t timeout)
+{
+    const std::string file = lockFile(port);
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout);
+
+    for (;;)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            auto it = m_Claims.find(file);
+            if (it != m_Claims.end())
+            {
+                if (it->second.device == device)
+                    return true;
+            }
+            else
+            {
+                int fd = open(file.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0664);
+                // Without a usable registry, ports are probed as if they were all free
+                if (fd < 0)
+                    return true;
+
+                if (flock(fd, LOCK_EX | LOCK_NB) == 0)
+                {
+                    Claim newClaim {fd, device, false};
+                    writeClaim(newClaim);
+                    m_Claims[file] = newClaim;
+                    return true;
+                }
+                close(fd);
+            }
+        }
+
+        // Connected devices keep their claim until they disconnect, waiting would only delay the caller
+        bool connected = false;
+        if (std::chrono::steady_clock::now() >= deadline || (!holder(file, connected).empty() && connected))
+            return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+}
+
+void SerialPortRegistry::setConnected(const std::string &port)
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    auto it = m_Claims.find(lockFile(port));
+    if (it == m_Claims.end() || it->second.connected)
+        return;
+
+    it->second.connected = true;
+    writeClaim(it->second);
+}
+
+void SerialPortRegistry::release(const std::string &port)
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    auto it = m_Claims.find(lockFile(port));
+    if (it == m_Claims.end())
+        return;
+
+    // Lock files are left in place, removing them would race with drivers opening them
+    close(it->second.fd);
+    m_Claims.erase(it);
+}
+
+std::string SerialPortRegistry::holder(const std::string &file, bool &connected) const
+{
+    connected = false;
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        auto it = m_Claims.find(file);
+        if (it != m_Claims.end())
+        {
+            connected = it->second.connected;
+            return it->second.device;
+        }
+    }
+
+    int fd = open(file.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return std::string();
+
+    std::string result;
+    if (flock(fd, LOCK_SH | LOCK_NB) == 0)
+        flock(fd, LOCK_UN);
+    else
+    {
+        char content[MAXINDIDEVICE + 16] = {0};
+        ssize_t length = read(fd, content, sizeof(content) - 1);
+        size_t end = strcspn(content, "\n");
+        result = length > 0 ? std::string(content, end) : std::string("another driver");
+        connected = length > 0 && content[end] == '\n' && !strncmp(content + end + 1, "connected", 9);
+    }
+    close(fd);
+    return result;
+}
+
+std::string SerialPortRegistry::owner(const std::string &port) const
+{
+    bool connected = false;
+    return holder(lockFile(port), connected);
+}
+
+bool SerialPortRegistry::isConnected(const std::string &port) const
+{
+    bool connected = false;
+    return !holder(lockFile(port), connected).empty() && connected;
+}
+
+std::string SerialPortRegistry::identity(const std::string &port)
+{
+#ifdef __linux__
+    if (port.compare(0, strlen(SerialByIdPath), SerialByIdPath) == 0)
+        return port.substr(strlen(SerialByIdPath));
+
+    const std::string target = canonicalPath(port);
+    std::string result = port;
+    DIR *dir = opendir(SerialByIdPath);
+    if (dir == nullptr)
+        return result;
+
+    while (struct dirent *entry = readdir(dir))
+    {
+        if (entry->d_name[0] == '.')
+            continue;
+        if (canonicalPath(std::string(SerialByIdPath) + entry->d_name) == target)
+        {
+            result = entry->d_name;
+            break;
+        }
+    }
+    closedir(dir);
+    return result;
+#else
+    return port;
+#endif
+}
+
+void SerialPortRegistry::remember(const std::string &port, const std::string &device)
+{
+    const std::string identifier = identity(port);
+    const std::string file = m_Directory + "/SerialPorts.xml";
+
+    // Serialize updates between drivers
+    int lockFd = open((file + ".lock").c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0664);
+    if (lockFd < 0)
+        return;
+    flock(lockFd, LOCK_EX);
+
+    XMLEle *root = nullptr;
+    if (FILE *fp = fopen(file.c_str(), "r"))
+    {
+        char errmsg[MAXRBUF];
+        LilXML *lp = newLilXML();
+        root = readXMLFile(fp, lp, errmsg);
+        delLilXML(lp);
+        fclose(fp);
+    }
+    if (root == nullptr)
+        root = addXMLEle(nullptr, "serialports");
+
+    XMLEle *entry = nullptr;
+    for (XMLEle *ep = nextXMLEle(root, 1); ep != nullptr; ep = nextXMLEle(root, 0))
+    {
+        if (!strcmp(findXMLAttValu(ep, "device"), device.c_str()))
+        {
+            entry = ep;
+            break;
+        }
+    }
+
+    if (entry == nullptr || strcmp(pcdataXMLEle(entry), identifier.c_str()))
+    {
+        if (entry == nullptr)
+        {
+            entry = addXMLEle(root, "port");
+            addXMLAtt(entry, "device", device.c_str());
+        }
+        editXMLEle(entry, identifier.c_str());
+
+        // Replace the file at once so readers never see it half written
+        const std::string temporary = file + ".tmp";
+        if (FILE *fp = fopen(temporary.c_str(), "w"))
+        {
+            prXMLEle(fp, root, 0);
+            if (fclose(fp) == 0)
+                rename(temporary.c_str(), file.c_str());
+            else
+                unlink(temporary.c_str());
+        }
+    }
+
+    delXMLEle(root);
+    close(lockFd);
+}
+
+std::string SerialPortRegistry::lookup(const std::string &device) const
+{
+    const std::string file = m_Directory + "/SerialPorts.xml";
+    FILE *fp = fopen(file.c_str(), "r");
+    if (fp == nullptr)
+        return std::string();
+
+    char errmsg[MAXRBUF];
+    LilXML *lp = newLilXML();
+    XMLEle *root = readXMLFile(fp, lp, errmsg);
+    delLilXML(lp);
+    fclose(fp);
+
+    if (root == nullptr)
+        return std::string();
+
+    std::string identifier;
+    for (XMLEle *ep = nextXMLEle(root, 1); ep != nullptr; ep = nextXMLEle(root, 0))
+    {
+        if (!strcmp(findXMLAttValu(ep, "device"), device.c_str()))
+        {
+            identifier = pcdataXMLEle(ep);
+            break;
+        }
+    }
+    delXMLEle(root);
+
+    if (identifier.empty())
+        return std::string();
+
+#ifdef __linux__
+    std::string port = identifier.find('/') == std::string::npos ? SerialByIdPath + identifier : identifier;
+#else
+    std::string port = identifier;
+#endif
+    return access(port.c_str(), F_OK) == 0 ? port : std::string();
+}
+
+}
@@ -0,0 +1,103 @@
+/*
+    Copyright (C) 2022 INDI Library Developers
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+
+namespace Connection
+{
+
+/**
+ * @class SerialPortRegistry
+ * @brief The SerialPortRegistry class coordinates serial ports between all drivers running on the system.
+ *
+ * A driver claims a port before probing it and keeps the claim while connected, so drivers searching for their
+ * device at the same time skip the ports other drivers are busy with instead of colliding on them. Claims are
+ * advisory locks on files of the registry directory, they are released when the driver exits or crashes. The lock
+ * file tells whether the port is being probed or held by a connected device, only the former is worth waiting for.
+ *
+ * The registry also remembers the stable identity of the port each device last connected to, i.e. its
+ * /dev/serial/by-id name on Linux, so a later start connects directly even if the ports were renumbered.
+ */
+class SerialPortRegistry
+{
+    public:
+        /** @return The registry shared by the devices of the driver, kept in ~/.indi/ports */
+        static SerialPortRegistry &instance();
+
+        explicit SerialPortRegistry(const std::string &directory);
+        ~SerialPortRegistry();
+
+        SerialPortRegistry(const SerialPortRegistry &) = delete;
+        SerialPortRegistry &operator=(const SerialPortRegistry &) = delete;
+
+        /**
+         * @brief claim Claim a port for a device. Aliases of the same port, e.g. by-id links, share the claim.
+         * @param port Port to claim.
+         * @param device Device claiming the port.
+         * @param timeout Milliseconds to wait for the current owner to finish probing the port, 0 to return at once.
+         * A port held by a connected device is not waited for.
+         * @return True if the device holds the claim, false if another device or driver holds it.
+         */
+        bool claim(const std::string &port, const std::string &device, uint32_t timeout = 0);
+
+        /** @brief setConnected Mark the claim of this driver on a port as held by a connected device. */
+        void setConnected(const std::string &port);
+
+        /** @brief release Release a port claimed by this driver. */
+        void release(const std::string &port);
+
+        /** @return Name of the device holding the claim on the port, empty if the port is free. */
+        std::string owner(const std::string &port) const;
+
+        /** @return True if the port is claimed by a connected device, false if it is free or being probed. */
+        bool isConnected(const std::string &port) const;
+
+        /**
+         * @brief remember Record the port a device connected to, under the stable identity of the port.
+         */
+        void remember(const std::string &port, const std::string &device);
+
+        /** @return Current path of the port the device last connected to, empty if unknown or not present. */
+        std::string lookup(const std::string &device) const;
+
+        /** @return Stable identity of a port, its /dev/serial/by-id name on Linux if any, otherwise the port itself. */
+        static std::string identity(const std::string &port);
+
+    private:
+        struct Claim
+        {
+            int fd {-1};
+            std::string device;
+            bool connected {false};
+        };
+
+        std::string lockFile(const std::string &port) const;
+        std::string holder(const std::string &file, bool &connected) const;
+        static void writeClaim(const Claim &claim);
+
+        std::string m_Directory;
+        std::map<std::string, Claim> m_Claims;
+        mutable std::mutex m_Mutex;
+};
+
+}
@@ -87,7 +87,7 @@ bool Convolution::processBLOB(uint8_t *buf, uint32_t dims, int *sizes, int bits_
     if(!PluginActive) return false;
     if(!matrix_loaded) return false;
     setStream(buf, dims, sizes, bits_per_sample);
-    dsp_fourier_dft(stream, 1);
+    computeDFT();
     dsp_fourier_dft(matrix, 1);
     dsp_convolution_convolution(stream, matrix);
     return Interface::processBLOB(getStream(), stream->dims, stream->sizes, bits_per_sample);
@@ -137,9 +137,13 @@ bool Wavelets::processBLOB(uint8_t *buf, uint32_t dims, int *sizes, int bits_per
     double min = dsp_stats_min(stream->buf, stream->len);
     double max = dsp_stats_max(stream->buf, stream->len);
     dsp_stream_p out = dsp_stream_copy(stream);
+    computeDFT();
     for (int i = 0; i < WaveletsNP.nnp; i++) {
         int size = (i+1)*3;
+        // Every wavelet starts from the same transform of the frame
         dsp_stream_p tmp = dsp_stream_copy(stream);
+        tmp->magnitude = dsp_stream_copy(stream->magnitude);
+        tmp->phase = dsp_stream_copy(stream->phase);
         dsp_stream_p matrix = dsp_stream_new();
         dsp_stream_add_dim(matrix, size);
         dsp_stream_add_dim(matrix, size);
@@ -149,7 +153,6 @@ bool Wavelets::processBLOB(uint8_t *buf, uint32_t dims, int *sizes, int bits_per
                 matrix->buf[x + y * size] = sin(static_cast<double>(x)*M_PI/static_cast<double>(size))*sin(static_cast<double>(y)*M_PI/static_cast<double>(size));
             }
         }
-        dsp_fourier_dft(tmp, 1);
         dsp_fourier_dft(matrix, 1);
         dsp_convolution_convolution(tmp, matrix);
         dsp_buffer_sub(tmp, matrix->buf, matrix->len);
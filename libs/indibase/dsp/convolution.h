@@ -32,6 +32,7 @@ class Convolution : public Interface
 {
 public:
     Convolution(INDI::DefaultDevice *dev);
+    bool needsDFT() const override { return true; }
     bool ISNewBLOB(const char *dev, const char *name, int sizes[], int blobsizes[], char *blobs[], char *formats[], char *names[], int n) override;
     virtual bool processBLOB(uint8_t *out, uint32_t dims, int *sizes, int bits_per_sample) override;
 
@@ -52,6 +53,7 @@ class Wavelets : public Interface
 {
 public:
     Wavelets(INDI::DefaultDevice *dev);
+    bool needsDFT() const override { return true; }
     bool ISNewNumber(const char *dev, const char *name, double values[], char *names[], int n) override;
     virtual bool processBLOB(uint8_t *out, uint32_t dims, int *sizes, int bits_per_sample) override;
 
@@ -191,6 +191,35 @@ uint8_t* Interface::Callback(uint8_t* buf, uint32_t ndims, int* dims, int bits_p
 }
 
 bool Interface::processBLOB(uint8_t* buffer, uint32_t ndims, int* dims, int bits_per_sample)
+{
+    if (m_Frame != nullptr)
+    {
+        // Plugins may run in parallel on a shared frame, the Manager sends the results one by one
+        m_QueuedBuffer = buffer;
+        m_QueuedDims = ndims;
+        m_QueuedSizes = dims;
+        m_QueuedBPS = bits_per_sample;
+        return PluginActive && buffer != nullptr;
+    }
+    return sendBLOB(buffer, ndims, dims, bits_per_sample);
+}
+
+void Interface::setFrame(dsp_stream_p frame, bool hasDFT)
+{
+    m_Frame = frame;
+    m_FrameDFT = frame != nullptr && hasDFT;
+}
+
+bool Interface::flush()
+{
+    if (m_QueuedBuffer == nullptr)
+        return false;
+    uint8_t *buffer = m_QueuedBuffer;
+    m_QueuedBuffer = nullptr;
+    return sendBLOB(buffer, m_QueuedDims, m_QueuedSizes, m_QueuedBPS);
+}
+
+bool Interface::sendBLOB(uint8_t* buffer, uint32_t ndims, int* dims, int bits_per_sample)
 {
     bool success = false;
     if(PluginActive)
@@ -622,15 +651,27 @@ int Interface::getFileIndex(const char *dir, const char *prefix, const char *ext
 
 bool Interface::setStream(void *buf, uint32_t dims, int *sizes, int bits_per_sample)
 {
-    stream->sizes = (int*)realloc(stream->sizes, sizeof(int));
-    stream->dims = 0;
-    stream->len = 1;
-    dsp_stream_free_buffer(stream);
-    dsp_stream_free(stream);
-    stream = dsp_stream_new();
-    for(uint32_t dim = 0; dim < dims; dim++)
-        dsp_stream_add_dim(stream, sizes[dim]);
-    dsp_stream_alloc_buffer(stream, stream->len);
+    // Keep the allocations of the previous frame when the geometry did not change
+    bool reuse = stream != nullptr && stream->dims == static_cast<int>(dims);
+    for(uint32_t dim = 0; reuse && dim < dims; dim++)
+        reuse = stream->sizes[dim] == sizes[dim];
+    if (!reuse)
+    {
+        stream->sizes = (int*)realloc(stream->sizes, sizeof(int));
+        stream->dims = 0;
+        stream->len = 1;
+        dsp_stream_free_buffer(stream);
+        dsp_stream_free(stream);
+        stream = dsp_stream_new();
+        for(uint32_t dim = 0; dim < dims; dim++)
+            dsp_stream_add_dim(stream, sizes[dim]);
+        dsp_stream_alloc_buffer(stream, stream->len);
+    }
+    if (m_Frame != nullptr && m_Frame->len == stream->len)
+    {
+        memcpy(stream->buf, m_Frame->buf, sizeof(dsp_t) * stream->len);
+        return true;
+    }
     switch (bits_per_sample)
     {
         case 8:
@@ -659,6 +700,38 @@ bool Interface::setStream(void *buf, uint32_t dims, int *sizes, int bits_per_sam
     return true;
 }
 
+void Interface::computeDFT()
+{
+    if (!m_FrameDFT || m_Frame->len != stream->len || m_Frame->magnitude == nullptr || m_Frame->phase == nullptr)
+    {
+        dsp_fourier_dft(stream, 1);
+        return;
+    }
+    memcpy(stream->dft.buf, m_Frame->dft.buf, sizeof(fftw_complex) * stream->len);
+    if (stream->magnitude == nullptr || stream->magnitude->len != stream->len)
+    {
+        if (stream->magnitude != nullptr)
+        {
+            dsp_stream_free_buffer(stream->magnitude);
+            dsp_stream_free(stream->magnitude);
+        }
+        stream->magnitude = dsp_stream_copy(m_Frame->magnitude);
+    }
+    else
+        memcpy(stream->magnitude->buf, m_Frame->magnitude->buf, sizeof(dsp_t) * stream->len);
+    if (stream->phase == nullptr || stream->phase->len != stream->len)
+    {
+        if (stream->phase != nullptr)
+        {
+            dsp_stream_free_buffer(stream->phase);
+            dsp_stream_free(stream->phase);
+        }
+        stream->phase = dsp_stream_copy(m_Frame->phase);
+    }
+    else
+        memcpy(stream->phase->buf, m_Frame->phase->buf, sizeof(dsp_t) * stream->len);
+}
+
 bool Interface::setMagnitude(void *buf, uint32_t dims, int *sizes, int bits_per_sample)
 {
     if(stream == nullptr) return false;
@@ -76,6 +76,7 @@ class Interface
         DSP_WAVELETS,
         DSP_SPECTRUM,
         DSP_HISTOGRAM,
+        DSP_STACK,
         } Type;
 
         virtual void ISGetProperties(const char *dev);
@@ -96,6 +97,33 @@ class Interface
          */
         virtual bool processBLOB(uint8_t* buf, uint32_t ndims, int* dims, int bits_per_sample);
 
+        /**
+         * @brief isActive
+         * @return True if the plugin was activated by the client.
+         */
+        bool isActive() const { return PluginActive; }
+
+        /**
+         * @brief needsDFT
+         * @return True if the plugin works on the forward DFT of the frame, DSP::Manager then computes it once for all plugins.
+         */
+        virtual bool needsDFT() const { return false; }
+
+        /**
+         * @brief setFrame Share a frame converted once by DSP::Manager.
+         * While a frame is set, setStream() copies it instead of converting the input buffer again, computeDFT() copies
+         * its forward DFT and processBLOB() queues the result until flush() is called.
+         * @param frame The shared frame, nullptr once the Manager is done with it.
+         * @param hasDFT True if the forward DFT of the frame was computed.
+         */
+        void setFrame(dsp_stream_p frame, bool hasDFT);
+
+        /**
+         * @brief flush Send the result queued by processBLOB() while a shared frame was set.
+         * @return True if successful, false otherwise.
+         */
+        bool flush();
+
         /**
          * @brief setSizes Set the returned file dimensions and corresponding sizes.
          * @param num Number of dimensions.
@@ -182,6 +210,10 @@ class Interface
         const char *m_Label {  nullptr };
         Type m_Type {  DSP_NONE };
         bool setStream(void *buf, uint32_t dims, int *sizes, int bits_per_sample);
+        /**
+         * @brief computeDFT Compute the forward DFT of stream, copied from the shared frame when available.
+         */
+        void computeDFT();
         bool setMagnitude(void *buf, uint32_t dims, int *sizes, int bits_per_sample);
         bool setPhase(void *buf, uint32_t dims, int *sizes, int bits_per_sample);
         bool setReal(void *buf, uint32_t dims, int *sizes, int bits_per_sample);
@@ -201,6 +233,14 @@ class Interface
         int *BufferSizes { nullptr };
         int BPS { 16 };
 
+        dsp_stream_p m_Frame { nullptr };
+        bool m_FrameDFT { false };
+        uint8_t *m_QueuedBuffer { nullptr };
+        uint32_t m_QueuedDims { 0 };
+        int *m_QueuedSizes { nullptr };
+        int m_QueuedBPS { 0 };
+
+        bool sendBLOB(uint8_t* buf, uint32_t ndims, int* dims, int bits_per_sample);
         void fits_update_key_s(fitsfile *fptr, int type, std::string name, void *p, std::string explanation, int *status);
         void addFITSKeywords(fitsfile *fptr);
         bool sendFITS(uint8_t *buf, bool sendCapture, bool saveCapture);
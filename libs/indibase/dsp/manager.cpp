@@ -28,6 +28,7 @@
 #include <algorithm>
 #include <thread>
 #include <chrono>
+#include <vector>
 
 namespace DSP
 {
@@ -39,10 +40,16 @@ Manager::Manager(INDI::DefaultDevice *dev)
     spectrum = new Spectrum(dev);
     histogram = new Histogram(dev);
     wavelets = new Wavelets(dev);
+    stack = new Stack(dev);
 }
 
 Manager::~Manager()
 {
+    if (frame != nullptr)
+    {
+        dsp_stream_free_buffer(frame);
+        dsp_stream_free(frame);
+    }
 }
 
 void Manager::ISGetProperties(const char *dev)
@@ -53,6 +60,7 @@ void Manager::ISGetProperties(const char *dev)
     spectrum->ISGetProperties(dev);
     histogram->ISGetProperties(dev);
     wavelets->ISGetProperties(dev);
+    stack->ISGetProperties(dev);
 }
 
 bool Manager::updateProperties()
@@ -64,6 +72,7 @@ bool Manager::updateProperties()
     r |= spectrum->updateProperties();
     r |= histogram->updateProperties();
     r |= wavelets->updateProperties();
+    r |= stack->updateProperties();
     return r;
 }
 
@@ -76,6 +85,7 @@ bool Manager::ISNewSwitch(const char *dev, const char *name, ISState *states, ch
     r |= spectrum->ISNewSwitch(dev, name, states, names, num);
     r |= histogram->ISNewSwitch(dev, name, states, names, num);
     r |= wavelets->ISNewSwitch(dev, name, states, names, num);
+    r |= stack->ISNewSwitch(dev, name, states, names, num);
     return r;
 }
 
@@ -88,6 +98,7 @@ bool Manager::ISNewText(const char *dev, const char *name, char *texts[], char *
     r |= spectrum->ISNewText(dev, name, texts, names, num);
     r |= histogram->ISNewText(dev, name, texts, names, num);
     r |= wavelets->ISNewText(dev, name, texts, names, num);
+    r |= stack->ISNewText(dev, name, texts, names, num);
     return r;
 }
 
@@ -100,6 +111,7 @@ bool Manager::ISNewNumber(const char *dev, const char *name, double values[], ch
     r |= spectrum->ISNewNumber(dev, name, values, names, num);
     r |= histogram->ISNewNumber(dev, name, values, names, num);
     r |= wavelets->ISNewNumber(dev, name, values, names, num);
+    r |= stack->ISNewNumber(dev, name, values, names, num);
     return r;
 }
 
@@ -113,6 +125,7 @@ bool Manager::ISNewBLOB(const char *dev, const char *name, int sizes[], int blob
     r |= spectrum->ISNewBLOB(dev, name, sizes, blobsizes, blobs, formats, names, num);
     r |= histogram->ISNewBLOB(dev, name, sizes, blobsizes, blobs, formats, names, num);
     r |= wavelets->ISNewBLOB(dev, name, sizes, blobsizes, blobs, formats, names, num);
+    r |= stack->ISNewBLOB(dev, name, sizes, blobsizes, blobs, formats, names, num);
     return r;
 }
 
@@ -125,20 +138,109 @@ bool Manager::saveConfigItems(FILE *fp)
     r |= spectrum->saveConfigItems(fp);
     r |= histogram->saveConfigItems(fp);
     r |= wavelets->saveConfigItems(fp);
+    r |= stack->saveConfigItems(fp);
     return r;
 }
 
+namespace
+{
+struct PluginJob
+{
+    std::vector<Interface*> plugins;
+    uint8_t *buf;
+    uint32_t ndims;
+    int *dims;
+    int bits_per_sample;
+};
+
+void processPlugins(void *arg, int thread, int start, int end)
+{
+    PluginJob *job = static_cast<PluginJob*>(arg);
+    INDI_UNUSED(thread);
+    for (int i = start; i < end; i++)
+        job->plugins[i]->processBLOB(job->buf, job->ndims, job->dims, job->bits_per_sample);
+}
+}
+
+bool Manager::setFrame(uint8_t* buf, uint32_t ndims, int* dims, int bits_per_sample)
+{
+    bool reuse = frame != nullptr && frame->dims == static_cast<int>(ndims);
+    for (uint32_t d = 0; reuse && d < ndims; d++)
+        reuse = frame->sizes[d] == dims[d];
+    if (!reuse)
+    {
+        if (frame != nullptr)
+        {
+            dsp_stream_free_buffer(frame);
+            dsp_stream_free(frame);
+        }
+        frame = dsp_stream_new();
+        for (uint32_t d = 0; d < ndims; d++)
+            dsp_stream_add_dim(frame, dims[d]);
+        dsp_stream_alloc_buffer(frame, frame->len);
+    }
+    switch (bits_per_sample)
+    {
+        case 8:
+            dsp_buffer_copy((static_cast<uint8_t *>(buf)), frame->buf, frame->len);
+            break;
+        case 16:
+            dsp_buffer_copy((reinterpret_cast<uint16_t *>(buf)), frame->buf, frame->len);
+            break;
+        case 32:
+            dsp_buffer_copy((reinterpret_cast<uint32_t *>(buf)), frame->buf, frame->len);
+            break;
+        case 64:
+            dsp_buffer_copy((reinterpret_cast<unsigned long *>(buf)), frame->buf, frame->len);
+            break;
+        case -32:
+            dsp_buffer_copy((reinterpret_cast<float *>(buf)), frame->buf, frame->len);
+            break;
+        case -64:
+            dsp_buffer_copy((reinterpret_cast<double *>(buf)), frame->buf, frame->len);
+            break;
+        default:
+            return false;
+    }
+    return true;
+}
+
 bool Manager::processBLOB(uint8_t* buf, uint32_t ndims, int* dims, int bits_per_sample)
 {
+    Interface *plugins[] = { convolution, dft, idft, spectrum, histogram, wavelets, stack };
+    PluginJob job { {}, buf, ndims, dims, bits_per_sample };
+    bool needsDFT = false;
+    for (auto plugin : plugins)
+    {
+        if (plugin->isActive())
+        {
+            job.plugins.push_back(plugin);
+            needsDFT |= plugin->needsDFT();
+        }
+    }
+    if (job.plugins.empty())
+        return false;
+
+    // Convert and transform the frame once, the plugins copy what they need from it
+    if (!setFrame(buf, ndims, dims, bits_per_sample))
+        return false;
+    if (needsDFT)
+        dsp_fourier_dft(frame, 1);
+    for (auto plugin : job.plugins)
+        plugin->setFrame(frame, needsDFT);
+
+    // One plugin per pool participant, a single active plugin keeps the whole pool for its own kernels
+    dsp_parallel_for(job.plugins.size(), 1, processPlugins, &job);
+
     bool r = false;
-    r |= convolution->processBLOB(buf, ndims, dims, bits_per_sample);
-    r |= dft->processBLOB(buf, ndims, dims, bits_per_sample);
-    r |= idft->processBLOB(buf, ndims, dims, bits_per_sample);
-    r |= spectrum->processBLOB(buf, ndims, dims, bits_per_sample);
-    r |= histogram->processBLOB(buf, ndims, dims, bits_per_sample);
-    r |= wavelets->processBLOB(buf, ndims, dims, bits_per_sample);
+    for (auto plugin : job.plugins)
+    {
+        plugin->setFrame(nullptr, false);
+        r |= plugin->flush();
+    }
     return r;
 }
+
 void Manager::setCaptureFileExtension(const char *ext)
 {
     convolution->setCaptureFileExtension(ext);
@@ -147,5 +249,6 @@ void Manager::setCaptureFileExtension(const char *ext)
     spectrum->setCaptureFileExtension(ext);
     histogram->setCaptureFileExtension(ext);
     wavelets->setCaptureFileExtension(ext);
+    stack->setCaptureFileExtension(ext);
 }
 }
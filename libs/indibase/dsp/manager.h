@@ -66,6 +66,12 @@ class Manager
         Spectrum *spectrum;
         Histogram *histogram;
         Wavelets *wavelets;
+        Stack *stack;
+
+        /** The frame converted once and shared by all the active plugins, reused across frames. */
+        dsp_stream_p frame { nullptr };
+        bool setFrame(uint8_t* buf, uint32_t ndims, int* dims, int bits_per_sample);
+
         uint32_t BufferSizesQty;
         int *BufferSizes;
         int BPS;
@@ -45,7 +45,7 @@ bool FourierTransform::processBLOB(uint8_t *buf, uint32_t dims, int *sizes, int
     if(!PluginActive) return false;
     setStream(buf, dims, sizes, bits_per_sample);
 
-    dsp_fourier_dft(stream, 1);
+    computeDFT();
     return Interface::processBLOB(getMagnitude(), stream->magnitude->dims, stream->magnitude->sizes, bits_per_sample);
 }
 
@@ -121,7 +121,7 @@ bool Spectrum::processBLOB(uint8_t *buf, uint32_t dims, int *sizes, int bits_per
     if(!PluginActive) return false;
     setStream(buf, dims, sizes, bits_per_sample);
 
-    dsp_fourier_dft(stream, 1);
+    computeDFT();
     double *histo = dsp_stats_histogram(stream->magnitude, 4096);
     return Interface::processBLOB(static_cast<uint8_t*>(static_cast<void*>(histo)), 1, new int{4096}, -64);
 }
@@ -143,4 +143,127 @@ bool Histogram::processBLOB(uint8_t *buf, uint32_t dims, int *sizes, int bits_pe
     double *histo = dsp_stats_histogram(stream, 4096);
     return Interface::processBLOB(static_cast<uint8_t*>(static_cast<void*>(histo)), 1, new int{4096}, -64);
 }
+Stack::Stack(INDI::DefaultDevice *dev) : Interface(dev, DSP_STACK, "STACK", "Live Stacking")
+{
+    IUFillSwitch(&InterpolationS[DSP_INTERPOLATION_NEAREST], "NEAREST", "Nearest", ISS_OFF);
+    IUFillSwitch(&InterpolationS[DSP_INTERPOLATION_BILINEAR], "BILINEAR", "Bilinear", ISS_ON);
+    IUFillSwitch(&InterpolationS[DSP_INTERPOLATION_LANCZOS], "LANCZOS", "Lanczos", ISS_OFF);
+    IUFillSwitchVector(&InterpolationSP, InterpolationS, 3, m_Device->getDeviceName(), "STACK_INTERPOLATION", "Interpolation",
+                       DSP_TAB, IP_RW, ISR_1OFMANY, 60, IPS_IDLE);
+
+    IUFillNumber(&SettingsN[0], "SIGMA", "Detection sigma", "%.1f", 1.0, 100.0, 0.5, 5.0);
+    IUFillNumber(&SettingsN[1], "RADIUS", "Star radius (px)", "%.0f", 2.0, 64.0, 1.0, 8.0);
+    IUFillNumber(&SettingsN[2], "DECIMALS", "Ratio decimals", "%.1f", 1.0, 4.0, 0.5, 2.0);
+    IUFillNumber(&SettingsN[3], "SCORE", "Minimum score", "%.2f", 0.0, 1.0, 0.05, 0.3);
+    IUFillNumberVector(&SettingsNP, SettingsN, 4, m_Device->getDeviceName(), "STACK_SETTINGS", "Stacking", DSP_TAB, IP_RW, 60,
+                       IPS_IDLE);
+
+    IUFillNumber(&FramesN[0], "STACKED", "Stacked", "%.0f", 0, 1e9, 1, 0);
+    IUFillNumber(&FramesN[1], "REJECTED", "Rejected", "%.0f", 0, 1e9, 1, 0);
+    IUFillNumberVector(&FramesNP, FramesN, 2, m_Device->getDeviceName(), "STACK_FRAMES", "Frames", DSP_TAB, IP_RO, 60, IPS_IDLE);
+
+    IUFillSwitch(&ResetS[0], "RESET", "Reset", ISS_OFF);
+    IUFillSwitchVector(&ResetSP, ResetS, 1, m_Device->getDeviceName(), "STACK_RESET", "Stack", DSP_TAB, IP_RW, ISR_ATMOST1, 60,
+                       IPS_IDLE);
+}
+
+Stack::~Stack()
+{
+    dsp_stack_free(stack);
+}
+
+void Stack::Activated()
+{
+    m_Device->defineProperty(&InterpolationSP);
+    m_Device->defineProperty(&SettingsNP);
+    m_Device->defineProperty(&FramesNP);
+    m_Device->defineProperty(&ResetSP);
+    Interface::Activated();
+}
+
+void Stack::Deactivated()
+{
+    dsp_stack_free(stack);
+    stack = nullptr;
+    m_Device->deleteProperty(InterpolationSP.name);
+    m_Device->deleteProperty(SettingsNP.name);
+    m_Device->deleteProperty(FramesNP.name);
+    m_Device->deleteProperty(ResetSP.name);
+    Interface::Deactivated();
+}
+
+void Stack::updateFrames()
+{
+    FramesN[0].value = stack != nullptr ? stack->frames : 0;
+    FramesN[1].value = stack != nullptr ? stack->rejected : 0;
+    FramesNP.s = IPS_OK;
+    IDSetNumber(&FramesNP, nullptr);
+}
+
+bool Stack::ISNewSwitch(const char *dev, const char *name, ISState *states, char *names[], int n)
+{
+    if (!strcmp(dev, getDeviceName()))
+    {
+        if (!strcmp(name, InterpolationSP.name))
+        {
+            IUUpdateSwitch(&InterpolationSP, states, names, n);
+            if (stack != nullptr)
+                stack->interpolation = IUFindOnSwitchIndex(&InterpolationSP);
+            InterpolationSP.s = IPS_OK;
+            IDSetSwitch(&InterpolationSP, nullptr);
+            return true;
+        }
+        if (!strcmp(name, ResetSP.name))
+        {
+            // The next frame becomes the new reference
+            dsp_stack_reset(stack);
+            ResetS[0].s = ISS_OFF;
+            ResetSP.s = IPS_OK;
+            IDSetSwitch(&ResetSP, nullptr);
+            updateFrames();
+            return true;
+        }
+    }
+    return Interface::ISNewSwitch(dev, name, states, names, n);
+}
+
+bool Stack::ISNewNumber(const char *dev, const char *name, double values[], char *names[], int n)
+{
+    if (!strcmp(dev, getDeviceName()) && !strcmp(name, SettingsNP.name))
+    {
+        IUUpdateNumber(&SettingsNP, values, names, n);
+        if (stack != nullptr)
+        {
+            stack->sigma = SettingsN[0].value;
+            stack->radius = static_cast<int>(SettingsN[1].value);
+            stack->tolerance = SettingsN[2].value;
+            stack->target_score = SettingsN[3].value;
+        }
+        SettingsNP.s = IPS_OK;
+        IDSetNumber(&SettingsNP, nullptr);
+        return true;
+    }
+    return Interface::ISNewNumber(dev, name, values, names, n);
+}
+
+bool Stack::processBLOB(uint8_t *buf, uint32_t dims, int *sizes, int bits_per_sample)
+{
+    if(!PluginActive) return false;
+    setStream(buf, dims, sizes, bits_per_sample);
+
+    if (stack == nullptr)
+        stack = dsp_stack_new(IUFindOnSwitchIndex(&InterpolationSP), SettingsN[0].value, static_cast<int>(SettingsN[1].value),
+                              SettingsN[2].value, SettingsN[3].value);
+    if (dsp_stack_add(stack, stream) & DSP_ALIGN_NO_MATCH)
+        LOGF_WARN("Frame not stacked, no match with the reference of %s", getDeviceName());
+    updateFrames();
+
+    dsp_stream_p mean = dsp_stack_get(stack);
+    if (mean == nullptr)
+        return false;
+    dsp_buffer_copy(mean->buf, stream->buf, stream->len);
+    dsp_stream_free_buffer(mean);
+    dsp_stream_free(mean);
+    return Interface::processBLOB(getStream(), stream->dims, stream->sizes, bits_per_sample);
+}
 }
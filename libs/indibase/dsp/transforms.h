@@ -31,6 +31,7 @@ class FourierTransform : public Interface
 {
 public:
     FourierTransform(INDI::DefaultDevice *dev);
+    bool needsDFT() const override { return true; }
     virtual bool processBLOB(uint8_t *out, uint32_t dims, int *sizes, int bits_per_sample) override;
 
 protected:
@@ -61,6 +62,7 @@ class Spectrum : public Interface
 {
 public:
     Spectrum(INDI::DefaultDevice *dev);
+    bool needsDFT() const override { return true; }
     virtual bool processBLOB(uint8_t *out, uint32_t dims, int *sizes, int bits_per_sample) override;
 
 protected:
@@ -76,4 +78,34 @@ public:
 protected:
     ~Histogram();
 };
+
+class Stack : public Interface
+{
+public:
+    Stack(INDI::DefaultDevice *dev);
+    bool ISNewSwitch(const char *dev, const char *name, ISState *states, char *names[], int n) override;
+    bool ISNewNumber(const char *dev, const char *name, double values[], char *names[], int n) override;
+    virtual bool processBLOB(uint8_t *out, uint32_t dims, int *sizes, int bits_per_sample) override;
+
+protected:
+    ~Stack();
+    void Activated() override;
+    void Deactivated() override;
+
+private:
+    ISwitchVectorProperty InterpolationSP;
+    ISwitch InterpolationS[3];
+
+    INumberVectorProperty SettingsNP;
+    INumber SettingsN[4];
+
+    INumberVectorProperty FramesNP;
+    INumber FramesN[2];
+
+    ISwitchVectorProperty ResetSP;
+    ISwitch ResetS[1];
+
+    dsp_stack_p stack { nullptr };
+    void updateFrames();
+};
 }
@@ -0,0 +1,248 @@
+/*
+    Copyright (C) 2022 INDI Library Developers
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include "indibufferpool.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+namespace INDI
+{
+
+// Small buffers are rounded to pages, large ones to huge pages
+static constexpr size_t PageSize = 4096;
+
+BufferPool &BufferPool::instance()
+{
+    // Never destroyed, drivers are static objects releasing their frames after the other statics are gone
+    static BufferPool *pool = new BufferPool();
+    return *pool;
+}
+
+BufferPool::~BufferPool()
+{
+    trim();
+    for (auto &oneBuffer : m_InUse)
+        free(oneBuffer.second);
+}
+
+size_t BufferPool::roundSize(size_t size)
+{
+    size_t granule = size >= HugePageSize ? HugePageSize : PageSize;
+    return std::max<size_t>(granule, (size + granule - 1) / granule * granule);
+}
+
+BufferPool::Block BufferPool::allocate(size_t capacity)
+{
+    Block block;
+    block.capacity = capacity;
+
+#ifdef __linux__
+    if (capacity >= HugePageSize)
+    {
+        void *data = mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (data != MAP_FAILED)
+        {
+#ifdef MADV_HUGEPAGE
+            madvise(data, capacity, MADV_HUGEPAGE);
+#endif
+            block.data   = data;
+            block.mapped = true;
+            return block;
+        }
+    }
+#endif
+
+    if (posix_memalign(&block.data, Alignment, capacity) != 0)
+        block.data = nullptr;
+    return block;
+}
+
+void BufferPool::free(const Block &block)
+{
+#ifdef __linux__
+    if (block.mapped)
+    {
+        munmap(block.data, block.capacity);
+        return;
+    }
+#endif
+    std::free(block.data);
+}
+
+void *BufferPool::acquire(size_t size)
+{
+    size_t capacity = roundSize(size);
+
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    // Smallest cached buffer that fits without wasting more than the request itself
+    auto best = m_Cache.end();
+    for (auto it = m_Cache.begin(); it != m_Cache.end(); ++it)
+        if (it->capacity >= capacity && it->capacity <= 2 * capacity &&
+                (best == m_Cache.end() || it->capacity < best->capacity))
+            best = it;
+
+    Block block;
+    if (best != m_Cache.end())
+    {
+        block = *best;
+        m_Cache.erase(best);
+        m_Statistics.cached -= block.capacity;
+        m_Statistics.hits++;
+    }
+    else
+    {
+        // Make room for the new buffer within the cache limit before asking the system
+        evict(m_CacheLimit > capacity ? m_CacheLimit - capacity : 0);
+        block = allocate(capacity);
+        if (block.data == nullptr)
+        {
+            evict(0);
+            block = allocate(capacity);
+            if (block.data == nullptr)
+                return nullptr;
+        }
+        m_Statistics.misses++;
+        if (block.mapped)
+            m_Statistics.hugeBuffers++;
+    }
+
+    m_InUse[block.data] = block;
+    m_Statistics.inUse += block.capacity;
+    m_Statistics.peak = std::max(m_Statistics.peak, m_Statistics.inUse + m_Statistics.cached);
+    return block.data;
+}
+
+bool BufferPool::release(void *buffer)
+{
+    if (buffer == nullptr)
+        return true;
+
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    auto it = m_InUse.find(buffer);
+    if (it == m_InUse.end())
+        return false;
+
+    Block block = it->second;
+    m_InUse.erase(it);
+    m_Statistics.inUse -= block.capacity;
+
+    m_Cache.push_back(block);
+    m_Statistics.cached += block.capacity;
+    evict(m_CacheLimit);
+    return true;
+}
+
+bool BufferPool::detach(void *buffer)
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    auto it = m_InUse.find(buffer);
+    if (it == m_InUse.end())
+        return false;
+
+    m_Statistics.inUse -= it->second.capacity;
+    if (it->second.mapped)
+        m_Statistics.hugeBuffers--;
+    m_InUse.erase(it);
+    return true;
+}
+
+bool BufferPool::owns(const void *buffer) const
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return m_InUse.count(buffer) > 0;
+}
+
+size_t BufferPool::capacity(const void *buffer) const
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    auto it = m_InUse.find(buffer);
+    return it == m_InUse.end() ? 0 : it->second.capacity;
+}
+
+void *BufferPool::reallocate(void *buffer, size_t size)
+{
+    BufferPool &pool = instance();
+
+    if (buffer == nullptr)
+        return pool.acquire(size);
+
+    size_t capacity = pool.capacity(buffer);
+    if (capacity == 0)
+        return realloc(buffer, size);
+
+    // Grow in place within the rounded capacity, otherwise at least double to keep appends linear
+    if (size <= capacity)
+        return buffer;
+
+    void *larger = pool.acquire(std::max(size, 2 * capacity));
+    if (larger == nullptr)
+        return nullptr;
+
+    memcpy(larger, buffer, capacity);
+    pool.release(buffer);
+    return larger;
+}
+
+void BufferPool::evict(size_t limit)
+{
+    while (m_Statistics.cached > limit && !m_Cache.empty())
+    {
+        const Block &block = m_Cache.front();
+        m_Statistics.cached -= block.capacity;
+        if (block.mapped)
+            m_Statistics.hugeBuffers--;
+        free(block);
+        m_Cache.pop_front();
+    }
+}
+
+void BufferPool::setCacheLimit(size_t bytes)
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_CacheLimit = bytes;
+    evict(m_CacheLimit);
+}
+
+size_t BufferPool::cacheLimit() const
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return m_CacheLimit;
+}
+
+void BufferPool::trim()
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    evict(0);
+}
+
+BufferPool::Statistics BufferPool::statistics() const
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return m_Statistics;
+}
+
+}
@@ -0,0 +1,139 @@
+/*
+    Copyright (C) 2022 INDI Library Developers
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <mutex>
+
+namespace INDI
+{
+
+/**
+ * @class BufferPool
+ * @brief The BufferPool class recycles the large buffers used for image frames and uploads.
+ *
+ * Released buffers are kept in a cache and handed out again to later requests of a similar size, so switching
+ * between subframes and full frames, or between exposures, does not go back to the system allocator every time.
+ *
+ * All buffers are aligned on 64 bytes. Buffers of at least BufferPool::HugePageSize bytes are mapped directly and
+ * advised to use transparent huge pages where the system supports them.
+ *
+ * The pool is shared by all devices of the driver and is thread safe.
+ */
+class BufferPool
+{
+    public:
+        /** Alignment of every buffer in bytes. */
+        static constexpr size_t Alignment = 64;
+        /** Size from which buffers are mapped on huge page boundaries. */
+        static constexpr size_t HugePageSize = 2 * 1024 * 1024;
+
+        struct Statistics
+        {
+            /** Bytes handed out and not released yet. */
+            size_t inUse {0};
+            /** Bytes released and kept for reuse. */
+            size_t cached {0};
+            /** Largest number of bytes held by the pool at once, in use and cached. */
+            size_t peak {0};
+            /** Requests served from the cache. */
+            uint64_t hits {0};
+            /** Requests that needed a new buffer. */
+            uint64_t misses {0};
+            /** Buffers backed by huge page mappings, in use and cached. */
+            uint32_t hugeBuffers {0};
+        };
+
+        /** @return The pool shared by the driver. */
+        static BufferPool &instance();
+
+        BufferPool() = default;
+        ~BufferPool();
+
+        BufferPool(const BufferPool &) = delete;
+        BufferPool &operator=(const BufferPool &) = delete;
+
+        /**
+         * @brief acquire Get a buffer of at least size bytes, reusing a cached one when possible.
+         * @return Pointer aligned on BufferPool::Alignment, nullptr if the memory could not be allocated.
+         * The content of the buffer is undefined.
+         */
+        void *acquire(size_t size);
+
+        /**
+         * @brief release Give a buffer back to the pool.
+         * @return False if the buffer was not acquired from this pool, in which case it is left untouched.
+         */
+        bool release(void *buffer);
+
+        /**
+         * @brief detach Stop tracking a buffer without reusing or freeing it, for buffers handed over to code that
+         * manages them itself. The memory stays valid, buffers smaller than BufferPool::HugePageSize can then be
+         * freed with free(), larger ones may be mapped and are never given back to the system.
+         * @return False if the buffer was not acquired from this pool.
+         */
+        bool detach(void *buffer);
+
+        /** @return True if the buffer was acquired from this pool and not released yet. */
+        bool owns(const void *buffer) const;
+
+        /** @return Usable size of a buffer acquired from this pool, 0 if it is not one of them. */
+        size_t capacity(const void *buffer) const;
+
+        /**
+         * @brief reallocate realloc() replacement for buffers of the shared pool, e.g. for fits_create_memfile().
+         * Buffers that do not belong to the pool are passed on to realloc().
+         */
+        static void *reallocate(void *buffer, size_t size);
+
+        /** @brief setCacheLimit Set the number of released bytes kept for reuse, older buffers are freed first. */
+        void setCacheLimit(size_t bytes);
+        size_t cacheLimit() const;
+
+        /** @brief trim Free all cached buffers. */
+        void trim();
+
+        Statistics statistics() const;
+
+    private:
+        struct Block
+        {
+            void *data {nullptr};
+            size_t capacity {0};
+            bool mapped {false};
+        };
+
+        static size_t roundSize(size_t size);
+        static Block allocate(size_t capacity);
+        void free(const Block &block);
+        void evict(size_t limit);
+
+        std::map<const void *, Block> m_InUse;
+        /** Released buffers, oldest first */
+        std::list<Block> m_Cache;
+        size_t m_CacheLimit {sizeof(void *) == 4 ? 256 * 1024 * 1024U : 1024 * 1024 * 1024U};
+        Statistics m_Statistics;
+
+        mutable std::mutex m_Mutex;
+};
+
+}
@@ -28,6 +28,7 @@
 #define _FILE_OFFSET_BITS 64
 
 #include "indiccd.h"
+#include "indibufferpool.h"
 
 #include "fpack/fpack.h"
 #include "indicom.h"
@@ -43,13 +44,16 @@
 #include <libnova/ln_types.h>
 #include <libastro.h>
 
+#include <algorithm>
 #include <cmath>
 #include <regex>
+#include <sstream>
 
 #include <dirent.h>
 #include <cerrno>
 #include <cstdlib>
 #include <zlib.h>
+#include <jpeglib.h>
 #include <sys/stat.h>
 
 const char * IMAGE_SETTINGS_TAB = "Image Settings";
@@ -64,6 +68,61 @@ uint16_t INDIWSServer::m_global_port = 11623;
 namespace INDI
 {
 
+// Room for the FITS headers in pooled upload buffers, cfitsio still grows the memfile past it if needed
+static constexpr size_t FITSHeaderReserve = 16 * 2880;
+
+/**
+ * @brief binPreview Average factor x factor blocks of the frame into an interleaved preview buffer.
+ * Bayer frames are debayered on the fly by accumulating each color of the CFA pattern separately.
+ */
+template <typename T>
+static void binPreview(const T *buffer, int width, int height, bool isColor, const char *pattern, int offsetX,
+                       int offsetY, int factor, std::vector<float> &preview)
+{
+    const int previewWidth  = width / factor;
+    const int previewHeight = height / factor;
+    const int channels      = (isColor || pattern) ? 3 : 1;
+    const size_t plane      = static_cast<size_t>(width) * height;
+    int cfa[4] = {0, 0, 0, 0};
+
+    if (pattern)
+    {
+        for (int i = 0; i < 4; i++)
+            cfa[i] = (pattern[i] == 'R') ? 0 : (pattern[i] == 'G') ? 1 : 2;
+    }
+
+    for (int py = 0; py < previewHeight; py++)
+    {
+        for (int px = 0; px < previewWidth; px++)
+        {
+            double sum[3] = {0, 0, 0};
+            int count[3] = {0, 0, 0};
+            for (int y = py * factor; y < (py + 1) * factor; y++)
+            {
+                const T *row = buffer + static_cast<size_t>(y) * width;
+                for (int x = px * factor; x < (px + 1) * factor; x++)
+                {
+                    if (pattern)
+                    {
+                        int c = cfa[((y + offsetY) & 1) * 2 + ((x + offsetX) & 1)];
+                        sum[c] += row[x];
+                        count[c]++;
+                    }
+                    else
+                    {
+                        for (int c = 0; c < channels; c++)
+                            sum[c] += row[x + c * plane];
+                        count[0]++;
+                    }
+                }
+            }
+            float *out = &preview[(static_cast<size_t>(py) * previewWidth + px) * channels];
+            for (int c = 0; c < channels; c++)
+                out[c] = sum[c] / std::max(1, count[pattern ? c : 0]);
+        }
+    }
+}
+
 CCD::CCD()
 {
     //ctor
@@ -410,6 +469,79 @@ bool CCD::initProperties()
     IUFillNumberVector(&FastExposureCountNP, FastExposureCountN, 1, getDeviceName(), "CCD_FAST_COUNT", "Fast Count",
                        OPTIONS_TAB, IP_RW, 0, IPS_IDLE);
 
+    /**********************************************/
+    /********************* Burst ******************/
+    /***************** Primary CCD Only ***********/
+    BurstSP[INDI_ENABLED].fill("INDI_ENABLED", "Enabled", ISS_OFF);
+    BurstSP[INDI_DISABLED].fill("INDI_DISABLED", "Disabled", ISS_ON);
+    BurstSP.fill(getDeviceName(), "CCD_BURST", "Burst", OPTIONS_TAB, IP_RW, ISR_1OFMANY, 60, IPS_IDLE);
+
+    BurstNP[0].fill("FRAMES", "Frames", "%.f", 2, 10000, 10, 100);
+    BurstNP.fill(getDeviceName(), "CCD_BURST_FRAMES", "Burst", OPTIONS_TAB, IP_RW, 60, IPS_IDLE);
+
+    /**********************************************/
+    /******************* Calibration **************/
+    /***************** Primary CCD Only ***********/
+    CalibrationSP[INDI_ENABLED].fill("INDI_ENABLED", "Enabled", ISS_OFF);
+    CalibrationSP[INDI_DISABLED].fill("INDI_DISABLED", "Disabled", ISS_ON);
+    CalibrationSP.fill(getDeviceName(), "CCD_CALIBRATION", "Calibration", OPTIONS_TAB, IP_RW, ISR_1OFMANY, 60, IPS_IDLE);
+
+    CalibrationTP[CCDCalibration::MASTER_BIAS].fill("MASTER_BIAS", "Bias", "");
+    CalibrationTP[CCDCalibration::MASTER_DARK].fill("MASTER_DARK", "Dark", "");
+    CalibrationTP[CCDCalibration::MASTER_FLAT].fill("MASTER_FLAT", "Flat", "");
+    CalibrationTP[CCDCalibration::MASTER_HOT_PIXELS].fill("MASTER_HOT_PIXELS", "Hot pixels", "");
+    CalibrationTP.fill(getDeviceName(), "CCD_CALIBRATION_MASTERS", "Masters", OPTIONS_TAB, IP_RW, 60, IPS_IDLE);
+
+    CalibrationSettingsNP[CALIBRATION_DARK_DOUBLING].fill("CALIBRATION_DARK_DOUBLING", "Dark doubling (C)", "%.1f", 0, 20,
+            0.5, 6);
+    CalibrationSettingsNP.fill(getDeviceName(), "CCD_CALIBRATION_SETTINGS", "Calibration", OPTIONS_TAB, IP_RW, 60,
+                               IPS_IDLE);
+
+    /**********************************************/
+    /****************** Star Detection ************/
+    /***************** Primary CCD Only ***********/
+    StarDetectionSP[STAR_DETECTION_DISABLED].fill("STAR_DETECTION_DISABLED", "Disabled", ISS_ON);
+    StarDetectionSP[STAR_DETECTION_ENABLED].fill("STAR_DETECTION_ENABLED", "Enabled", ISS_OFF);
+    StarDetectionSP[STAR_DETECTION_ONLY].fill("STAR_DETECTION_ONLY", "Metrics only", ISS_OFF);
+    StarDetectionSP.fill(getDeviceName(), "CCD_STAR_DETECTION", "Star Detection", OPTIONS_TAB, IP_RW, ISR_1OFMANY, 60,
+                         IPS_IDLE);
+
+    StarDetectionSettingsNP[DETECTION_SIGMA].fill("DETECTION_SIGMA", "Threshold (sigma)", "%.1f", 1, 50, 0.5, 5);
+    StarDetectionSettingsNP[DETECTION_RADIUS].fill("DETECTION_RADIUS", "Star radius (px)", "%.f", 2, 64, 1, 12);
+    StarDetectionSettingsNP[DETECTION_MAX_STARS].fill("DETECTION_MAX_STARS", "Max stars", "%.f", 0, 1000, 10, 50);
+    StarDetectionSettingsNP.fill(getDeviceName(), "CCD_STAR_DETECTION_SETTINGS", "Detection", OPTIONS_TAB, IP_RW, 60,
+                                 IPS_IDLE);
+
+    StarMetricsNP[METRICS_STARS].fill("METRICS_STARS", "Stars", "%.f", 0, 100000, 0, 0);
+    StarMetricsNP[METRICS_HFR].fill("METRICS_HFR", "HFR (px)", "%.2f", 0, 1000, 0, 0);
+    StarMetricsNP[METRICS_FWHM].fill("METRICS_FWHM", "FWHM (px)", "%.2f", 0, 1000, 0, 0);
+    StarMetricsNP[METRICS_BACKGROUND].fill("METRICS_BACKGROUND", "Background", "%.1f", 0, 4294967295., 0, 0);
+    StarMetricsNP[METRICS_NOISE].fill("METRICS_NOISE", "Noise", "%.1f", 0, 4294967295., 0, 0);
+    StarMetricsNP[METRICS_CENTROID_X].fill("METRICS_CENTROID_X", "Centroid X", "%.2f", 0, 100000, 0, 0);
+    StarMetricsNP[METRICS_CENTROID_Y].fill("METRICS_CENTROID_Y", "Centroid Y", "%.2f", 0, 100000, 0, 0);
+    StarMetricsNP[METRICS_PEAK].fill("METRICS_PEAK", "Peak", "%.f", 0, 4294967295., 0, 0);
+    StarMetricsNP.fill(getDeviceName(), "CCD_STAR_METRICS", "Star Metrics", IMAGE_INFO_TAB, IP_RO, 60, IPS_IDLE);
+
+    IUFillBLOB(&StarListB, "STAR_LIST", "Stars", "");
+    IUFillBLOBVector(&StarListBP, &StarListB, 1, getDeviceName(), "CCD_STARS", "Star List", IMAGE_INFO_TAB, IP_RO, 60,
+                     IPS_IDLE);
+
+    /**********************************************/
+    /********************* Preview ****************/
+    /***************** Primary CCD Only ***********/
+    PreviewSP[PREVIEW_DISABLED].fill("PREVIEW_DISABLED", "Disabled", ISS_ON);
+    PreviewSP[PREVIEW_ENABLED].fill("PREVIEW_ENABLED", "Enabled", ISS_OFF);
+    PreviewSP[PREVIEW_ONLY].fill("PREVIEW_ONLY", "Preview only", ISS_OFF);
+    PreviewSP.fill(getDeviceName(), "CCD_PREVIEW_MODE", "Preview", OPTIONS_TAB, IP_RW, ISR_1OFMANY, 60, IPS_IDLE);
+
+    PreviewSettingsNP[PREVIEW_SIZE].fill("PREVIEW_SIZE", "Max size (px)", "%.f", 160, 8192, 160, 1280);
+    PreviewSettingsNP[PREVIEW_QUALITY].fill("PREVIEW_QUALITY", "JPEG quality", "%.f", 10, 100, 5, 75);
+    PreviewSettingsNP.fill(getDeviceName(), "CCD_PREVIEW_SETTINGS", "Preview", OPTIONS_TAB, IP_RW, 60, IPS_IDLE);
+
+    IUFillBLOB(&PreviewB, "PREVIEW", "Preview", "");
+    IUFillBLOBVector(&PreviewBP, &PreviewB, 1, getDeviceName(), "CCD_PREVIEW", "Preview", IMAGE_INFO_TAB, IP_RO, 60,
+                     IPS_IDLE);
+
     /**********************************************/
     /**************** Web Socket ******************/
     /**********************************************/
@@ -600,6 +732,22 @@ bool CCD::updateProperties()
 
         defineProperty(&FastExposureToggleSP);
         defineProperty(&FastExposureCountNP);
+
+        defineProperty(&BurstSP);
+        defineProperty(&BurstNP);
+
+        defineProperty(&CalibrationSP);
+        defineProperty(&CalibrationTP);
+        defineProperty(&CalibrationSettingsNP);
+
+        defineProperty(&StarDetectionSP);
+        defineProperty(&StarDetectionSettingsNP);
+        defineProperty(&StarMetricsNP);
+        defineProperty(&StarListBP);
+
+        defineProperty(&PreviewSP);
+        defineProperty(&PreviewSettingsNP);
+        defineProperty(&PreviewBP);
     }
     else
     {
@@ -687,6 +835,21 @@ bool CCD::updateProperties()
 #endif
         deleteProperty(FastExposureToggleSP.name);
         deleteProperty(FastExposureCountNP.name);
+
+        deleteProperty(BurstSP.getName());
+        deleteProperty(BurstNP.getName());
+        deleteProperty(CalibrationSP.getName());
+        deleteProperty(CalibrationTP.getName());
+        deleteProperty(CalibrationSettingsNP.getName());
+
+        deleteProperty(StarDetectionSP.getName());
+        deleteProperty(StarDetectionSettingsNP.getName());
+        deleteProperty(StarMetricsNP.getName());
+        deleteProperty(StarListBP.name);
+
+        deleteProperty(PreviewSP.getName());
+        deleteProperty(PreviewSettingsNP.getName());
+        deleteProperty(PreviewBP.name);
     }
 
     // Streamer
@@ -957,6 +1120,17 @@ bool CCD::ISNewText(const char * dev, const char * name, char * texts[], char *
             IDSetText(&UploadSettingsTP, nullptr);
             return true;
         }
+
+        // Calibration masters, read on the next frame
+        if (CalibrationTP.isNameMatch(name))
+        {
+            CalibrationTP.update(texts, names, n);
+            for (int i = 0; i < CCDCalibration::MASTER_COUNT; i++)
+                m_Calibration.setMasterFile(static_cast<CCDCalibration::MasterType>(i), CalibrationTP[i].getText());
+            CalibrationTP.setState(IPS_OK);
+            CalibrationTP.apply();
+            return true;
+        }
     }
 
     // Streamer
@@ -1192,6 +1366,43 @@ bool CCD::ISNewNumber(const char * dev, const char * name, double values[], char
             return true;
         }
 
+        // Burst Frames
+        if (BurstNP.isNameMatch(name))
+        {
+            BurstNP.update(values, names, n);
+            BurstNP.setState(IPS_OK);
+            BurstNP.apply();
+            return true;
+        }
+
+        // Calibration Settings
+        if (CalibrationSettingsNP.isNameMatch(name))
+        {
+            CalibrationSettingsNP.update(values, names, n);
+            m_Calibration.setTemperatureDoubling(CalibrationSettingsNP[CALIBRATION_DARK_DOUBLING].getValue());
+            CalibrationSettingsNP.setState(IPS_OK);
+            CalibrationSettingsNP.apply();
+            return true;
+        }
+
+        // Preview Settings
+        if (PreviewSettingsNP.isNameMatch(name))
+        {
+            PreviewSettingsNP.update(values, names, n);
+            PreviewSettingsNP.setState(IPS_OK);
+            PreviewSettingsNP.apply();
+            return true;
+        }
+
+        // Star Detection Settings
+        if (StarDetectionSettingsNP.isNameMatch(name))
+        {
+            StarDetectionSettingsNP.update(values, names, n);
+            StarDetectionSettingsNP.setState(IPS_OK);
+            StarDetectionSettingsNP.apply();
+            return true;
+        }
+
         // Fast Exposure Count
         if (!strcmp(name, FastExposureCountNP.name))
         {
@@ -1395,6 +1606,7 @@ bool CCD::ISNewSwitch(const char * dev, const char * name, ISState * states, cha
                 m_UploadTime = 0;
                 if (PrimaryCCD.isExposing())
                     AbortExposure();
+                flushBurst();
             }
 
             FastExposureToggleSP.s = IPS_OK;
@@ -1402,6 +1614,58 @@ bool CCD::ISNewSwitch(const char * dev, const char * name, ISState * states, cha
             return true;
         }
 
+        // Burst
+        if (BurstSP.isNameMatch(name))
+        {
+            BurstSP.update(states, names, n);
+            BurstSP.setState(IPS_OK);
+            BurstSP.apply();
+
+            if (BurstSP[INDI_ENABLED].getState() == ISS_ON && FastExposureToggleS[INDI_ENABLED].s != ISS_ON)
+                LOG_INFO("Burst mode applies to fast exposure sequences only.");
+
+            // Do not lose frames already captured when the burst is stopped early
+            if (BurstSP[INDI_DISABLED].getState() == ISS_ON)
+                flushBurst();
+            return true;
+        }
+
+        // Calibration
+        if (CalibrationSP.isNameMatch(name))
+        {
+            CalibrationSP.update(states, names, n);
+            CalibrationSP.setState(IPS_OK);
+            CalibrationSP.apply();
+
+            if (CalibrationSP[INDI_ENABLED].getState() == ISS_ON && !m_Calibration.hasMasters())
+                LOG_WARN("Calibration is enabled but no master frame is set.");
+            return true;
+        }
+
+        // Star Detection
+        if (StarDetectionSP.isNameMatch(name))
+        {
+            StarDetectionSP.update(states, names, n);
+            StarDetectionSP.setState(IPS_OK);
+            StarDetectionSP.apply();
+
+            if (StarDetectionSP[STAR_DETECTION_ONLY].getState() == ISS_ON && UploadS[UPLOAD_LOCAL].s != ISS_ON)
+                LOG_INFO("Star metrics only: frames are analyzed but no longer uploaded to the client.");
+            return true;
+        }
+
+        // Preview
+        if (PreviewSP.isNameMatch(name))
+        {
+            PreviewSP.update(states, names, n);
+            PreviewSP.setState(IPS_OK);
+            PreviewSP.apply();
+
+            if (PreviewSP[PREVIEW_ONLY].getState() == ISS_ON && UploadS[UPLOAD_LOCAL].s != ISS_ON)
+                LOG_INFO("Preview only: full frames are no longer uploaded to the client.");
+            return true;
+        }
+
 
 #ifdef HAVE_WEBSOCKET
         // Websocket Enable/Disable
@@ -1492,6 +1756,8 @@ bool CCD::ISNewSwitch(const char * dev, const char * name, ISState * states, cha
                 IDSetNumber(&FastExposureCountNP, nullptr);
             }
 
+            flushBurst();
+
             IDSetSwitch(&PrimaryCCD.AbortExposureSP, nullptr);
             IDSetNumber(&PrimaryCCD.ImageExposureNP, nullptr);
 
@@ -2148,26 +2414,71 @@ bool CCD::ExposureCompletePrivate(CCDChip * targetChip)
     exposureDuration = targetChip->getExposureDuration();
     strncpy(exposureStartTime, targetChip->getExposureStartTime(), MAXINDINAME);
 
+    // Calibrate first so the preview, the metrics and the uploaded frame all see the calibrated data.
+    // The steps stay local, exposures may complete while this one is still being uploaded.
+    std::string calibrationSteps;
+    if (targetChip == &PrimaryCCD && CalibrationSP[INDI_ENABLED].getState() == ISS_ON &&
+            targetChip->getFrameType() == CCDChip::LIGHT_FRAME)
+        calibrateFrame(targetChip, calibrationSteps);
+
     if(HasDSP())
     {
-        uint8_t* buf = static_cast<uint8_t*>(malloc(targetChip->getFrameBufferSize()));
+        uint8_t* buf = static_cast<uint8_t*>(BufferPool::instance().acquire(targetChip->getFrameBufferSize()));
         memcpy(buf, targetChip->getFrameBuffer(), targetChip->getFrameBufferSize());
         DSP->processBLOB(buf, 2, new int[2] { targetChip->getXRes() / targetChip->getBinX(), targetChip->getYRes() / targetChip->getBinY() },
                          targetChip->getBPP());
-        free(buf);
+        BufferPool::instance().release(buf);
     }
 
+    if (targetChip == &PrimaryCCD && PreviewSP[PREVIEW_DISABLED].getState() != ISS_ON)
+        uploadPreview(targetChip);
+
+    if (targetChip == &PrimaryCCD && StarDetectionSP[STAR_DETECTION_DISABLED].getState() != ISS_ON)
+        detectStars(targetChip);
+
     if (processFastExposure(targetChip) == false)
+    {
+        flushBurst();
         return false;
+    }
 
     bool sendImage = (UploadS[UPLOAD_CLIENT].s == ISS_ON || UploadS[UPLOAD_BOTH].s == ISS_ON);
     bool saveImage = (UploadS[UPLOAD_LOCAL].s == ISS_ON || UploadS[UPLOAD_BOTH].s == ISS_ON);
 
+    // Clients running focus or guide loops on the star metrics, or framing on the preview, do not need the frame itself.
+    if (targetChip == &PrimaryCCD && (StarDetectionSP[STAR_DETECTION_ONLY].getState() == ISS_ON ||
+                                      PreviewSP[PREVIEW_ONLY].getState() == ISS_ON))
+        sendImage = false;
+
     // Do not send or save an empty image.
     if (targetChip->getFrameBufferSize() == 0)
         sendImage = saveImage = false;
 
-    if (sendImage || saveImage)
+    if (targetChip == &PrimaryCCD && BurstSP[INDI_ENABLED].getState() == ISS_ON &&
+            FastExposureToggleS[INDI_ENABLED].s == ISS_ON && EncodeFormatSP[FORMAT_FITS].getState() == ISS_ON &&
+            (sendImage || saveImage))
+    {
+        std::unique_lock<std::mutex> burstGuard(m_BurstLock);
+
+        m_BurstSendImage = sendImage;
+        m_BurstSaveImage = saveImage;
+
+        if (addBurstFrame(targetChip, calibrationSteps) == false)
+        {
+            targetChip->setExposureFailed();
+            return false;
+        }
+
+        // Upload once the burst is full or the fast exposure sequence is over, or could not start the next frame
+        bool lastFrame = FastExposureCountNP.s != IPS_BUSY || PrimaryCCD.ImageExposureNP.s == IPS_ALERT;
+        if ((m_BurstFrames >= BurstNP[0].getValue() || lastFrame) &&
+                uploadBurst(targetChip, sendImage, saveImage, m_BurstDurations.front(), m_BurstStartTimes.front().c_str()) == false)
+        {
+            targetChip->setExposureFailed();
+            return false;
+        }
+    }
+    else if (sendImage || saveImage)
     {
         if (EncodeFormatSP[FORMAT_FITS].getState() == ISS_ON)
         {
@@ -2225,22 +2536,24 @@ bool CCD::ExposureCompletePrivate(CCDChip * targetChip)
             std::unique_lock<std::mutex> guard(ccdBufferLock);
 
             //  Now we have to send fits format data to the client
+            //  The memfile starts small as before, but sits in a pooled buffer large enough for the whole
+            //  file so cfitsio grows it in place.
             memsize = 5760;
-            memptr  = malloc(memsize);
+            memptr  = BufferPool::instance().acquire(memsize + nelements * targetChip->getBPP() / 8 + FITSHeaderReserve);
             if (!memptr)
             {
                 LOGF_ERROR("Error: failed to allocate memory: %lu", memsize);
                 return false;
             }
 
-            fits_create_memfile(&fptr, &memptr, &memsize, 2880, realloc, &status);
+            fits_create_memfile(&fptr, &memptr, &memsize, 2880, BufferPool::reallocate, &status);
 
             if (status)
             {
                 fits_report_error(stderr, status); /* print out any error messages */
                 fits_get_errstatus(status, error_status);
                 fits_close_file(fptr, &status);
-                free(memptr);
+                BufferPool::instance().release(memptr);
                 LOGF_ERROR("FITS Error: %s", error_status);
                 return false;
             }
@@ -2252,12 +2565,14 @@ bool CCD::ExposureCompletePrivate(CCDChip * targetChip)
                 fits_report_error(stderr, status); /* print out any error messages */
                 fits_get_errstatus(status, error_status);
                 fits_close_file(fptr, &status);
-                free(memptr);
+                BufferPool::instance().release(memptr);
                 LOGF_ERROR("FITS Error: %s", error_status);
                 return false;
             }
 
             addFITSKeywords(fptr, targetChip);
+            if (!calibrationSteps.empty())
+                fits_update_key_str(fptr, "CALSTAT", calibrationSteps.c_str(), "Calibration steps applied", &status);
 
             fits_write_img(fptr, byte_type, 1, nelements, targetChip->getFrameBuffer(), &status);
 
@@ -2266,7 +2581,7 @@ bool CCD::ExposureCompletePrivate(CCDChip * targetChip)
                 fits_report_error(stderr, status); /* print out any error messages */
                 fits_get_errstatus(status, error_status);
                 fits_close_file(fptr, &status);
-                free(memptr);
+                BufferPool::instance().release(memptr);
                 LOGF_ERROR("FITS Error: %s", error_status);
                 return false;
             }
@@ -2275,7 +2590,7 @@ bool CCD::ExposureCompletePrivate(CCDChip * targetChip)
 
             bool rc = uploadFile(targetChip, memptr, memsize, sendImage, saveImage);
 
-            free(memptr);
+            BufferPool::instance().release(memptr);
 
             guard.unlock();
 
@@ -2308,6 +2623,435 @@ bool CCD::ExposureCompletePrivate(CCDChip * targetChip)
     return true;
 }
 
+bool CCD::calibrateFrame(CCDChip * targetChip, std::string &steps)
+{
+    CCDCalibration::Geometry geometry;
+    geometry.binX   = targetChip->getBinX();
+    geometry.binY   = targetChip->getBinY();
+    geometry.x      = targetChip->getSubX() / geometry.binX;
+    geometry.y      = targetChip->getSubY() / geometry.binY;
+    geometry.width  = targetChip->getSubW() / geometry.binX;
+    geometry.height = targetChip->getSubH() / geometry.binY;
+    int planes = targetChip->getNAxis() == 3 ? 3 : 1;
+
+    if (geometry.width <= 0 || geometry.height <= 0 ||
+            targetChip->getFrameBufferSize() < geometry.width * geometry.height * planes * targetChip->getBPP() / 8)
+        return false;
+
+    double temperature = (HasCooler() || TemperatureNP.p == IP_RO) ? TemperatureN[0].value :
+                         std::numeric_limits<double>::quiet_NaN();
+    std::string error;
+
+    // Masters are read from disk without holding the frame buffer
+    bool rc = m_Calibration.load(geometry, error);
+    if (rc)
+    {
+        std::unique_lock<std::mutex> guard(ccdBufferLock);
+        rc = m_Calibration.calibrate(targetChip->getFrameBuffer(), targetChip->getBPP(), planes, geometry,
+                                     HasBayer() && planes == 1, targetChip->getExposureDuration(), temperature, error,
+                                     &steps);
+    }
+
+    if (rc == false)
+    {
+        // Report once, the frame is sent uncalibrated until the masters are fixed
+        if (CalibrationSP.getState() != IPS_ALERT)
+        {
+            LOGF_ERROR("%s", error.c_str());
+            CalibrationSP.setState(IPS_ALERT);
+            CalibrationSP.apply();
+        }
+        return false;
+    }
+
+    if (CalibrationSP.getState() != IPS_OK)
+    {
+        CalibrationSP.setState(IPS_OK);
+        CalibrationSP.apply();
+    }
+    return true;
+}
+
+bool CCD::detectStars(CCDChip * targetChip)
+{
+    int width  = targetChip->getSubW() / targetChip->getBinX();
+    int height = targetChip->getSubH() / targetChip->getBinY();
+    int planes = targetChip->getNAxis() == 3 ? 3 : 1;
+
+    if (width <= 0 || height <= 0 || targetChip->getFrameBufferSize() < width * height * planes * targetChip->getBPP() / 8)
+        return false;
+
+    dsp_stream_p stream = dsp_stream_new();
+    dsp_stream_add_dim(stream, width);
+    dsp_stream_add_dim(stream, height);
+    dsp_stream_alloc_buffer(stream, stream->len);
+    dsp_buffer_set(stream->buf, stream->len, 0);
+
+    // Color frames are analyzed on the sum of their planes
+    std::unique_lock<std::mutex> guard(ccdBufferLock);
+    for (int plane = 0; plane < planes; plane++)
+    {
+        uint8_t *buffer = targetChip->getFrameBuffer() + plane * stream->len * targetChip->getBPP() / 8;
+        for (int i = 0; i < stream->len; i++)
+        {
+            switch (targetChip->getBPP())
+            {
+                case 8:
+                    stream->buf[i] += buffer[i];
+                    break;
+                case 16:
+                    stream->buf[i] += reinterpret_cast<uint16_t *>(buffer)[i];
+                    break;
+                case 32:
+                    stream->buf[i] += reinterpret_cast<uint32_t *>(buffer)[i];
+                    break;
+            }
+        }
+    }
+    guard.unlock();
+
+    double background = 0, noise = 0;
+    dsp_stats_background(stream, &background, &noise);
+    int count = dsp_align_find_stars_background(stream, background, noise, StarDetectionSettingsNP[DETECTION_SIGMA].getValue(),
+                                                StarDetectionSettingsNP[DETECTION_RADIUS].getValue(),
+                                                StarDetectionSettingsNP[DETECTION_MAX_STARS].getValue());
+
+    std::vector<double> hfr, fwhm;
+    std::ostringstream list;
+    list << "x,y,hfr,fwhm,flux,peak\n";
+    for (int i = 0; i < count; i++)
+    {
+        const dsp_star &star = stream->stars[i];
+        hfr.push_back(star.diameter / 2);
+        fwhm.push_back(star.fwhm);
+        list << star.center.location[0] << "," << star.center.location[1] << "," << star.diameter / 2 << ","
+             << star.fwhm << "," << star.flux << "," << star.peak << "\n";
+    }
+
+    auto median = [](std::vector<double> &values)
+    {
+        if (values.empty())
+            return 0.0;
+        std::nth_element(values.begin(), values.begin() + values.size() / 2, values.end());
+        return values[values.size() / 2];
+    };
+
+    // Stars are sorted by brightness, the first one is the guide star candidate
+    StarMetricsNP[METRICS_STARS].setValue(count);
+    StarMetricsNP[METRICS_HFR].setValue(median(hfr));
+    StarMetricsNP[METRICS_FWHM].setValue(median(fwhm));
+    StarMetricsNP[METRICS_BACKGROUND].setValue(background);
+    StarMetricsNP[METRICS_NOISE].setValue(noise);
+    StarMetricsNP[METRICS_CENTROID_X].setValue(count > 0 ? stream->stars[0].center.location[0] : 0);
+    StarMetricsNP[METRICS_CENTROID_Y].setValue(count > 0 ? stream->stars[0].center.location[1] : 0);
+    StarMetricsNP[METRICS_PEAK].setValue(count > 0 ? stream->stars[0].peak : 0);
+    StarMetricsNP.setState(count > 0 ? IPS_OK : IPS_ALERT);
+    StarMetricsNP.apply();
+
+    m_StarList = list.str();
+    StarListB.blob    = const_cast<char *>(m_StarList.data());
+    StarListB.bloblen = StarListB.size = m_StarList.size();
+    strncpy(StarListB.format, ".csv", MAXINDIBLOBFMT);
+    StarListBP.s = IPS_OK;
+    IDSetBLOB(&StarListBP, nullptr);
+
+    LOGF_DEBUG("Star detection: %d stars, HFR %.2f, FWHM %.2f, background %.1f +/- %.1f", count,
+               StarMetricsNP[METRICS_HFR].getValue(), StarMetricsNP[METRICS_FWHM].getValue(), background, noise);
+
+    dsp_stream_free_buffer(stream);
+    dsp_stream_free(stream);
+    return count > 0;
+}
+
+bool CCD::uploadPreview(CCDChip * targetChip)
+{
+    int width  = targetChip->getSubW() / targetChip->getBinX();
+    int height = targetChip->getSubH() / targetChip->getBinY();
+    int bpp    = targetChip->getBPP();
+    bool isColor = targetChip->getNAxis() == 3;
+    const char *pattern = (HasBayer() && !isColor && BayerT[2].text && strlen(BayerT[2].text) == 4) ? BayerT[2].text :
+                          nullptr;
+
+    if (width <= 0 || height <= 0 || (bpp != 8 && bpp != 16 && bpp != 32) ||
+            targetChip->getFrameBufferSize() < width * height * (isColor ? 3 : 1) * bpp / 8)
+        return false;
+
+    // Bin by an integer factor to fit the requested size, keeping whole bayer cells in each preview pixel
+    int factor = std::max(1, static_cast<int>(std::ceil(std::max(width, height) / PreviewSettingsNP[PREVIEW_SIZE].getValue())));
+    if (pattern && factor % 2)
+        factor++;
+    int previewWidth  = width / factor;
+    int previewHeight = height / factor;
+    int channels      = (isColor || pattern) ? 3 : 1;
+    if (previewWidth == 0 || previewHeight == 0)
+        return false;
+
+    int offsetX = pattern ? atoi(BayerT[0].text) : 0;
+    int offsetY = pattern ? atoi(BayerT[1].text) : 0;
+    std::vector<float> preview(previewWidth * previewHeight * channels);
+    std::unique_lock<std::mutex> guard(ccdBufferLock);
+    switch (bpp)
+    {
+        case 8:
+            binPreview(targetChip->getFrameBuffer(), width, height, isColor, pattern, offsetX, offsetY, factor, preview);
+            break;
+        case 16:
+            binPreview(reinterpret_cast<uint16_t *>(targetChip->getFrameBuffer()), width, height, isColor, pattern,
+                       offsetX, offsetY, factor, preview);
+            break;
+        case 32:
+            binPreview(reinterpret_cast<uint32_t *>(targetChip->getFrameBuffer()), width, height, isColor, pattern,
+                       offsetX, offsetY, factor, preview);
+            break;
+    }
+    guard.unlock();
+
+    // Screen transfer function on each channel: clip the shadows below the background and move its median to 25%
+    const double maxValue = std::pow(2.0, bpp) - 1;
+    const size_t pixels = previewWidth * previewHeight;
+    std::vector<uint8_t> stretched(pixels * channels);
+    std::vector<float> sorted(pixels);
+    auto mtf = [](double m, double x)
+    {
+        return (x <= 0) ? 0 : (x >= 1) ? 1 : ((m - 1) * x) / ((2 * m - 1) * x - m);
+    };
+    for (int c = 0; c < channels; c++)
+    {
+        for (size_t i = 0; i < pixels; i++)
+            sorted[i] = preview[i * channels + c] / maxValue;
+        std::nth_element(sorted.begin(), sorted.begin() + pixels / 2, sorted.end());
+        double median = sorted[pixels / 2];
+        for (size_t i = 0; i < pixels; i++)
+            sorted[i] = std::abs(preview[i * channels + c] / maxValue - median);
+        std::nth_element(sorted.begin(), sorted.begin() + pixels / 2, sorted.end());
+        double mad = sorted[pixels / 2] * 1.4826;
+
+        double shadows = std::max(0.0, median - 2.8 * mad);
+        double midtones = mtf(0.25, median - shadows);
+        for (size_t i = 0; i < pixels; i++)
+        {
+            double x = (preview[i * channels + c] / maxValue - shadows) / (1 - shadows);
+            stretched[i * channels + c] = static_cast<uint8_t>(255 * mtf(midtones, x) + 0.5);
+        }
+    }
+
+    struct jpeg_compress_struct cinfo;
+    struct jpeg_error_mgr jerr;
+    unsigned char *jpeg = nullptr;
+    unsigned long jpegSize = 0;
+    cinfo.err = jpeg_std_error(&jerr);
+    jpeg_create_compress(&cinfo);
+    jpeg_mem_dest(&cinfo, &jpeg, &jpegSize);
+    cinfo.image_width      = previewWidth;
+    cinfo.image_height     = previewHeight;
+    cinfo.input_components = channels;
+    cinfo.in_color_space   = channels == 3 ? JCS_RGB : JCS_GRAYSCALE;
+    jpeg_set_defaults(&cinfo);
+    jpeg_set_quality(&cinfo, PreviewSettingsNP[PREVIEW_QUALITY].getValue(), TRUE);
+    jpeg_start_compress(&cinfo, TRUE);
+    while (cinfo.next_scanline < cinfo.image_height)
+    {
+        JSAMPROW row = stretched.data() + cinfo.next_scanline * previewWidth * channels;
+        jpeg_write_scanlines(&cinfo, &row, 1);
+    }
+    jpeg_finish_compress(&cinfo);
+    jpeg_destroy_compress(&cinfo);
+
+    m_PreviewBuffer.assign(jpeg, jpeg + jpegSize);
+    free(jpeg);
+
+    PreviewB.blob    = m_PreviewBuffer.data();
+    PreviewB.bloblen = PreviewB.size = m_PreviewBuffer.size();
+    strncpy(PreviewB.format, ".jpg", MAXINDIBLOBFMT);
+    PreviewBP.s = IPS_OK;
+    IDSetBLOB(&PreviewBP, nullptr);
+
+    LOGF_DEBUG("Preview %dx%d sent (%d bytes).", previewWidth, previewHeight, PreviewB.bloblen);
+    return true;
+}
+
+bool CCD::addBurstFrame(CCDChip * targetChip, const std::string &calibrationSteps)
+{
+    long naxes[3] = {targetChip->getSubW() / targetChip->getBinX(), targetChip->getSubH() / targetChip->getBinY(), 3};
+    int naxis     = targetChip->getNAxis();
+    int bpp       = targetChip->getBPP();
+    size_t frameSize = naxes[0] * naxes[1] * (naxis == 3 ? 3 : 1) * bpp / 8;
+    size_t frames    = BurstNP[0].getValue();
+
+    if (bpp != 8 && bpp != 16 && bpp != 32)
+    {
+        LOGF_ERROR("Unsupported bits per pixel value %d", bpp);
+        return false;
+    }
+
+    // Geometry changed in the middle of a burst: send what we have before starting over
+    if (m_BurstFrames > 0 && (frameSize != m_BurstFrameSize || naxis != m_BurstNAxis || bpp != m_BurstBPP ||
+                              memcmp(naxes, m_BurstAxes, sizeof(naxes)) != 0))
+    {
+        if (uploadBurst(targetChip, m_BurstSendImage, m_BurstSaveImage, m_BurstDurations.front(),
+                        m_BurstStartTimes.front().c_str()) == false)
+            return false;
+    }
+
+    std::unique_lock<std::mutex> guard(ccdBufferLock);
+
+    if (m_BurstFrames == 0)
+    {
+        if (m_BurstBuffer.size() != frameSize * frames)
+        {
+            try
+            {
+                m_BurstBuffer.resize(frameSize * frames);
+            }
+            catch (const std::bad_alloc &)
+            {
+                LOGF_ERROR("Error: failed to allocate burst buffer of %d frames.", static_cast<int>(frames));
+                return false;
+            }
+        }
+        m_BurstStartTimes.clear();
+        m_BurstDurations.clear();
+        m_BurstCalibrationSteps = calibrationSteps;
+        m_BurstFrameSize = frameSize;
+        m_BurstNAxis     = naxis;
+        m_BurstBPP       = bpp;
+        memcpy(m_BurstAxes, naxes, sizeof(naxes));
+    }
+
+    // The requested burst size may have shrunk while the burst was running.
+    if ((m_BurstFrames + 1) * frameSize > m_BurstBuffer.size())
+        m_BurstBuffer.resize((m_BurstFrames + 1) * frameSize);
+
+    memcpy(m_BurstBuffer.data() + m_BurstFrames * frameSize, targetChip->getFrameBuffer(), frameSize);
+    m_BurstStartTimes.push_back(targetChip->getExposureStartTime());
+    m_BurstDurations.push_back(targetChip->getExposureDuration());
+    m_BurstFrames++;
+
+    return true;
+}
+
+bool CCD::flushBurst()
+{
+    std::unique_lock<std::mutex> burstGuard(m_BurstLock);
+
+    if (m_BurstFrames == 0)
+        return true;
+
+    return uploadBurst(&PrimaryCCD, m_BurstSendImage, m_BurstSaveImage, m_BurstDurations.front(),
+                       m_BurstStartTimes.front().c_str());
+}
+
+bool CCD::uploadBurst(CCDChip * targetChip, bool sendImage, bool saveImage, double duration, const char *startTime)
+{
+    void * memptr;
+    size_t memsize;
+    int img_type  = 0;
+    int byte_type = 0;
+    int status    = 0;
+    long naxes[4] = {m_BurstAxes[0], m_BurstAxes[1], 0, 0};
+    int naxis     = m_BurstNAxis + 1;
+    char error_status[MAXRBUF];
+    fitsfile * fptr = nullptr;
+
+    if (m_BurstFrames == 0)
+        return true;
+
+    switch (m_BurstBPP)
+    {
+        case 8:
+            byte_type = TBYTE;
+            img_type  = BYTE_IMG;
+            break;
+
+        case 16:
+            byte_type = TUSHORT;
+            img_type  = USHORT_IMG;
+            break;
+
+        default:
+            byte_type = TULONG;
+            img_type  = ULONG_IMG;
+            break;
+    }
+
+    if (m_BurstNAxis == 3)
+    {
+        naxes[2] = 3;
+        naxes[3] = m_BurstFrames;
+    }
+    else
+        naxes[2] = m_BurstFrames;
+
+    std::unique_lock<std::mutex> guard(ccdBufferLock);
+
+    memsize = 5760;
+    memptr  = BufferPool::instance().acquire(memsize + m_BurstFrames * m_BurstFrameSize + FITSHeaderReserve);
+    if (!memptr)
+    {
+        LOGF_ERROR("Error: failed to allocate memory: %lu", memsize);
+        return false;
+    }
+
+    fits_create_memfile(&fptr, &memptr, &memsize, 2880, BufferPool::reallocate, &status);
+    fits_create_img(fptr, img_type, naxis, naxes, &status);
+    if (status == 0)
+    {
+        addFITSKeywords(fptr, targetChip);
+
+        // The primary header describes the first frame of the burst, not the exposure in flight
+        fits_update_key_dbl(fptr, "EXPTIME", duration, 6, "Total Exposure Time (s)", &status);
+        if (targetChip->getFrameType() == CCDChip::DARK_FRAME)
+            fits_update_key_dbl(fptr, "DARKTIME", duration, 6, "Total Dark Exposure Time (s)", &status);
+        fits_update_key_str(fptr, "DATE-OBS", startTime, "UTC start date of observation", &status);
+        if (!m_BurstCalibrationSteps.empty())
+            fits_update_key_str(fptr, "CALSTAT", m_BurstCalibrationSteps.c_str(), "Calibration steps applied", &status);
+
+        fits_write_img(fptr, byte_type, 1, m_BurstFrames * m_BurstFrameSize / (m_BurstBPP / 8), m_BurstBuffer.data(),
+                       &status);
+    }
+
+    // Per-frame timestamps
+    if (status == 0)
+    {
+        char ttype0[] = "DATE-OBS", ttype1[] = "EXPTIME";
+        char tform0[] = "24A", tform1[] = "1D";
+        char tunit0[] = "", tunit1[] = "s";
+        char extname[] = "FRAMES";
+        char *ttype[] = {ttype0, ttype1};
+        char *tform[] = {tform0, tform1};
+        char *tunit[] = {tunit0, tunit1};
+        std::vector<char *> startTimes;
+        for (auto &oneTime : m_BurstStartTimes)
+            startTimes.push_back(const_cast<char *>(oneTime.c_str()));
+
+        fits_create_tbl(fptr, BINARY_TBL, m_BurstFrames, 2, ttype, tform, tunit, extname, &status);
+        fits_write_col(fptr, TSTRING, 1, 1, 1, m_BurstFrames, startTimes.data(), &status);
+        fits_write_col(fptr, TDOUBLE, 2, 1, 1, m_BurstFrames, m_BurstDurations.data(), &status);
+    }
+
+    if (status)
+    {
+        fits_report_error(stderr, status); /* print out any error messages */
+        fits_get_errstatus(status, error_status);
+        fits_close_file(fptr, &status);
+        BufferPool::instance().release(memptr);
+        m_BurstFrames = 0;
+        LOGF_ERROR("FITS Error: %s", error_status);
+        return false;
+    }
+
+    fits_close_file(fptr, &status);
+
+    LOGF_DEBUG("Uploading burst of %d frames.", m_BurstFrames);
+    m_BurstFrames = 0;
+
+    bool rc = uploadFile(targetChip, memptr, memsize, sendImage, saveImage);
+
+    BufferPool::instance().release(memptr);
+
+    return rc;
+}
+
 bool CCD::uploadFile(CCDChip * targetChip, const void * fitsData, size_t totalBytes, bool sendImage,
                      bool saveImage)
 {
@@ -2400,12 +3144,11 @@ bool CCD::uploadFile(CCDChip * targetChip, const void * fitsData, size_t totalBy
         else
         {
             uLong compressedBytes = sizeof(char) * totalBytes + totalBytes / 64 + 16 + 3;
-            compressedData  = new uint8_t[compressedBytes];
+            compressedData  = static_cast<uint8_t *>(BufferPool::instance().acquire(compressedBytes));
 
             if (fitsData == nullptr || compressedData == nullptr)
             {
-                if (compressedData)
-                    delete [] compressedData;
+                BufferPool::instance().release(compressedData);
                 LOG_ERROR("Error: Ran out of memory compressing image");
                 return false;
             }
@@ -2415,7 +3158,7 @@ bool CCD::uploadFile(CCDChip * targetChip, const void * fitsData, size_t totalBy
             {
                 /* this should NEVER happen */
                 LOG_ERROR("Error: Failed to compress image");
-                delete [] compressedData;
+                BufferPool::instance().release(compressedData);
                 return false;
             }
 
@@ -2460,10 +3203,14 @@ bool CCD::uploadFile(CCDChip * targetChip, const void * fitsData, size_t totalBy
         }
     }
 
-    if (compressedData)
-        delete [] compressedData;
+    // fpack allocates its output with malloc()
+    if (compressedData && BufferPool::instance().release(compressedData) == false)
+        free(compressedData);
 
-    DEBUG(Logger::DBG_DEBUG, "Upload complete");
+    BufferPool::Statistics pool = BufferPool::instance().statistics();
+    LOGF_DEBUG("Upload complete. Buffer pool: %zu KiB in use, %zu KiB cached, %zu KiB peak, %llu hits, %llu misses.",
+               pool.inUse / 1024, pool.cached / 1024, pool.peak / 1024,
+               static_cast<unsigned long long>(pool.hits), static_cast<unsigned long long>(pool.misses));
 
     return true;
 }
@@ -2564,6 +3311,14 @@ bool CCD::saveConfigItems(FILE * fp)
     IUSaveConfigText(fp, &UploadSettingsTP);
     IUSaveConfigSwitch(fp, &TelescopeTypeSP);
     IUSaveConfigSwitch(fp, &FastExposureToggleSP);
+    IUSaveConfigNumber(fp, &BurstNP);
+    IUSaveConfigSwitch(fp, &CalibrationSP);
+    IUSaveConfigText(fp, &CalibrationTP);
+    IUSaveConfigNumber(fp, &CalibrationSettingsNP);
+    IUSaveConfigSwitch(fp, &StarDetectionSP);
+    IUSaveConfigNumber(fp, &StarDetectionSettingsNP);
+    IUSaveConfigSwitch(fp, &PreviewSP);
+    IUSaveConfigNumber(fp, &PreviewSettingsNP);
 
     IUSaveConfigSwitch(fp, &PrimaryCCD.CompressSP);
 
@@ -27,10 +27,12 @@
 #pragma once
 
 #include "indiccdchip.h"
+#include "indiccdcalibration.h"
 #include "defaultdevice.h"
 #include "indiguiderinterface.h"
 #include "indipropertynumber.h"
 #include "indipropertyswitch.h"
+#include "indipropertytext.h"
 #include "inditimer.h"
 #include "indielapsedtimer.h"
 #include "dsp/manager.h"
@@ -759,6 +761,96 @@ class CCD : public DefaultDevice, GuiderInterface
         double m_UploadTime = { 0 };
         std::chrono::system_clock::time_point FastExposureToggleStartup;
 
+        /**
+         * @brief BurstSP Burst mode: primary chip FITS frames are accumulated in the driver and uploaded as a single
+         * data cube (NAXIS3, or NAXIS4 for color frames, is the frame index) followed by a FRAMES binary table holding
+         * the per-frame DATE-OBS and EXPTIME. Only applies to fast exposure sequences, a partial burst is uploaded when
+         * the sequence ends, fails or is aborted.
+         */
+        INDI::PropertySwitch BurstSP {2};
+
+        // Number of frames per burst
+        INDI::PropertyNumber BurstNP {1};
+
+        // Star Detection
+        INDI::PropertySwitch StarDetectionSP {3};
+        enum
+        {
+            STAR_DETECTION_DISABLED,
+            STAR_DETECTION_ENABLED,
+            STAR_DETECTION_ONLY         /*!< Publish star metrics but do not upload the image to the client. */
+        };
+
+        // Star Detection Settings
+        INDI::PropertyNumber StarDetectionSettingsNP {3};
+        enum
+        {
+            DETECTION_SIGMA,
+            DETECTION_RADIUS,
+            DETECTION_MAX_STARS
+        };
+
+        /**
+         * @brief StarMetricsNP Star metrics measured on the last primary chip frame. HFR and FWHM are the medians
+         * of all detected stars, the centroid and peak are those of the brightest star.
+         */
+        INDI::PropertyNumber StarMetricsNP {8};
+        enum
+        {
+            METRICS_STARS,
+            METRICS_HFR,
+            METRICS_FWHM,
+            METRICS_BACKGROUND,
+            METRICS_NOISE,
+            METRICS_CENTROID_X,
+            METRICS_CENTROID_Y,
+            METRICS_PEAK
+        };
+
+        // Detected stars list, one star per line in CSV format.
+        IBLOB StarListB;
+        IBLOBVectorProperty StarListBP;
+
+        // Preview
+        INDI::PropertySwitch PreviewSP {3};
+        enum
+        {
+            PREVIEW_DISABLED,
+            PREVIEW_ENABLED,
+            PREVIEW_ONLY                /*!< Send the preview but do not upload the full frame to the client. */
+        };
+
+        // Preview Settings
+        INDI::PropertyNumber PreviewSettingsNP {2};
+        enum
+        {
+            PREVIEW_SIZE,
+            PREVIEW_QUALITY
+        };
+
+        /**
+         * @brief PreviewBP Downsampled, auto-stretched and debayered JPEG of the last primary chip frame.
+         * It is sent before the full frame is encoded and uploaded.
+         */
+        IBLOB PreviewB;
+        IBLOBVectorProperty PreviewBP;
+
+        /**
+         * @brief CalibrationSP Calibrate primary chip light frames against the masters of CalibrationTP before they
+         * are previewed, analyzed and encoded. The steps applied are recorded in the CALSTAT keyword.
+         */
+        INDI::PropertySwitch CalibrationSP {2};
+
+        // Master frames, FITS files indexed by CCDCalibration::MasterType
+        INDI::PropertyText CalibrationTP {CCDCalibration::MASTER_COUNT};
+
+        // Calibration Settings
+        INDI::PropertyNumber CalibrationSettingsNP {1};
+        enum
+        {
+            CALIBRATION_DARK_DOUBLING
+        };
+
         // FITS Header
         IText FITSHeaderT[2] {};
         ITextVectorProperty FITSHeaderTP;
@@ -775,6 +867,27 @@ class CCD : public DefaultDevice, GuiderInterface
         std::string m_ConfigCaptureFormatLabel;
         int m_ConfigEncodeFormatIndex {-1};
         int m_ConfigFastExposureIndex {INDI_DISABLED};
+        std::string m_StarList;
+        std::vector<uint8_t> m_PreviewBuffer;
+
+        // Burst frames, preallocated for the whole burst and reused across bursts.
+        // m_BurstLock guards all burst state and is always taken before ccdBufferLock.
+        std::mutex m_BurstLock;
+        std::vector<uint8_t> m_BurstBuffer;
+        std::vector<std::string> m_BurstStartTimes;
+        std::vector<double> m_BurstDurations;
+        // Calibration steps of the first frame, the header describes that frame
+        std::string m_BurstCalibrationSteps;
+        size_t m_BurstFrameSize {0};
+        int m_BurstFrames {0};
+        long m_BurstAxes[3] {0, 0, 0};
+        int m_BurstNAxis {0};
+        int m_BurstBPP {0};
+        bool m_BurstSendImage {false};
+        bool m_BurstSaveImage {false};
+
+        // Masters cached for the primary chip
+        CCDCalibration m_Calibration;
 
         ///////////////////////////////////////////////////////////////////////////////
         /// Utility Functions
@@ -783,6 +896,14 @@ class CCD : public DefaultDevice, GuiderInterface
         void getMinMax(double * min, double * max, CCDChip * targetChip);
         int getFileIndex(const char * dir, const char * prefix, const char * ext);
         bool ExposureCompletePrivate(CCDChip * targetChip);
+        bool calibrateFrame(CCDChip * targetChip, std::string &steps);
+        bool detectStars(CCDChip * targetChip);
+        bool uploadPreview(CCDChip * targetChip);
+        // Called with m_BurstLock held
+        bool addBurstFrame(CCDChip * targetChip, const std::string &calibrationSteps);
+        bool uploadBurst(CCDChip * targetChip, bool sendImage, bool saveImage, double duration, const char *startTime);
+        // Upload the frames collected so far, if any
+        bool flushBurst();
 
         // Threading for Websocket
 #ifdef HAVE_WEBSOCKET
@@ -0,0 +1,437 @@
+/*
+    Copyright (C) 2022 INDI Library Developers
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include "indiccdcalibration.h"
+
+#include "dsp.h"
+
+#include <fitsio.h>
+
+#include <algorithm>
+#include <limits>
+#include <type_traits>
+
+namespace INDI
+{
+
+static const char *MasterNames[CCDCalibration::MASTER_COUNT] = { "bias", "dark", "flat", "hot pixel map" };
+
+namespace
+{
+
+struct Frame
+{
+    void *pixels;
+    int width;
+    int height;
+    const float *offset;
+    const float *thermal;
+    const float *gain;
+    double scale;
+};
+
+/**
+ * @brief calibrateRows Calibrate the rows [start, end) of all planes of a frame.
+ * The per-pixel terms are contiguous and branch free in the inner loop, which the compiler vectorizes.
+ */
+template <typename T, bool Thermal, bool Flat>
+void calibrateRows(void *arg, int, int start, int end)
+{
+    // 32 bits pixels do not fit the mantissa of a float. Clipping after the conversion keeps the loop branch free.
+    using Value = typename std::conditional<sizeof(T) < 4, float, double>::type;
+    using Integer = typename std::conditional<sizeof(T) < 4, int32_t, int64_t>::type;
+
+    const Frame *frame = static_cast<const Frame *>(arg);
+    const Integer maximum = std::numeric_limits<T>::max();
+    const Value scale = static_cast<Value>(frame->scale);
+    const int width = frame->width;
+
+    for (int row = start; row < end; row++)
+    {
+        T *pixels = static_cast<T *>(frame->pixels) + static_cast<size_t>(row) * width;
+        size_t first = static_cast<size_t>(row % frame->height) * width;
+        const float *offset = frame->offset + first;
+        const float *thermal = Thermal ? frame->thermal + first : nullptr;
+        const float *gain = Flat ? frame->gain + first : nullptr;
+
+        for (int i = 0; i < width; i++)
+        {
+            Value value = static_cast<Value>(pixels[i]) - offset[i];
+            if (Thermal)
+                value -= scale * thermal[i];
+            if (Flat)
+                value *= gain[i];
+            Integer rounded = static_cast<Integer>(value + Value(0.5));
+            rounded = rounded < 0 ? 0 : rounded;
+            pixels[i] = static_cast<T>(rounded > maximum ? maximum : rounded);
+        }
+    }
+}
+
+template <typename T>
+void calibratePixels(Frame &frame, int planes, bool thermal, bool flat)
+{
+    void (*kernel)(void *, int, int, int) = nullptr;
+    if (thermal)
+        kernel = flat ? calibrateRows<T, true, true> : calibrateRows<T, true, false>;
+    else
+        kernel = flat ? calibrateRows<T, false, true> : calibrateRows<T, false, false>;
+
+    dsp_parallel_for(frame.height * planes, 0, kernel, &frame);
+}
+
+/**
+ * @brief correctHotPixels Replace each hot pixel by the median of its neighbours of the same color.
+ * Neighbours which are hot pixels themselves are skipped.
+ */
+template <typename T>
+void correctHotPixels(T *pixels, int width, int height, const std::vector<uint32_t> &hotPixels, int step)
+{
+    T neighbours[8];
+    for (uint32_t index : hotPixels)
+    {
+        int x = index % width;
+        int y = index / width;
+        int count = 0;
+
+        for (int dy = -step; dy <= step; dy += step)
+        {
+            for (int dx = -step; dx <= step; dx += step)
+            {
+                int nx = x + dx, ny = y + dy;
+                if ((dx == 0 && dy == 0) || nx < 0 || ny < 0 || nx >= width || ny >= height)
+                    continue;
+                uint32_t neighbour = static_cast<uint32_t>(ny) * width + nx;
+                if (std::binary_search(hotPixels.begin(), hotPixels.end(), neighbour))
+                    continue;
+                neighbours[count++] = pixels[neighbour];
+            }
+        }
+
+        if (count == 0)
+            continue;
+        std::nth_element(neighbours, neighbours + count / 2, neighbours + count);
+        pixels[index] = neighbours[count / 2];
+    }
+}
+
+}
+
+void CCDCalibration::setMasterFile(MasterType type, const std::string &file)
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    Slot &slot = m_Slots[type];
+    if (slot.file == file && (slot.loaded || file.empty()))
+        return;
+
+    slot.file = file;
+    slot.loaded = false;
+    slot.master = Master();
+    m_Prepared = false;
+}
+
+void CCDCalibration::setMaster(MasterType type, Master master)
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    Slot &slot = m_Slots[type];
+    slot.file.clear();
+    slot.loaded = true;
+    slot.master = std::move(master);
+    m_Prepared = false;
+}
+
+bool CCDCalibration::hasMasters() const
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    for (const Slot &slot : m_Slots)
+        if (slot.loaded || !slot.file.empty())
+            return true;
+    return false;
+}
+
+void CCDCalibration::setTemperatureDoubling(double celsius)
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_TemperatureDoubling = celsius;
+}
+
+std::string CCDCalibration::steps() const
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return m_Steps;
+}
+
+bool CCDCalibration::readMaster(const std::string &file, Master &master, std::string &error)
+{
+    fitsfile *fptr = nullptr;
+    int status = 0;
+    char errorStatus[FLEN_STATUS] = {0};
+
+    if (fits_open_diskfile(&fptr, file.c_str(), READONLY, &status))
+    {
+        fits_get_errstatus(status, errorStatus);
+        error = file + ": " + errorStatus;
+        return false;
+    }
+
+    int naxis = 0;
+    long naxes[2] = {0, 0};
+    fits_get_img_dim(fptr, &naxis, &status);
+    if (status == 0 && naxis != 2)
+    {
+        fits_close_file(fptr, &status);
+        error = file + ": masters must be 2D images";
+        return false;
+    }
+    fits_get_img_size(fptr, 2, naxes, &status);
+
+    // Keywords are optional, masters without binning keywords are taken as unbinned
+    auto readKey = [&](const char *name, int type, void *value)
+    {
+        if (status)
+            return false;
+        fits_read_key(fptr, type, name, value, nullptr, &status);
+        if (status == KEY_NO_EXIST)
+        {
+            status = 0;
+            return false;
+        }
+        return status == 0;
+    };
+
+    Master result;
+    result.width = naxes[0];
+    result.height = naxes[1];
+    if (!readKey("DARKTIME", TDOUBLE, &result.exposure))
+        readKey("EXPTIME", TDOUBLE, &result.exposure);
+    readKey("CCD-TEMP", TDOUBLE, &result.temperature);
+    readKey("XBINNING", TINT, &result.binX);
+    readKey("YBINNING", TINT, &result.binY);
+
+    if (status == 0)
+    {
+        long firstPixel[2] = {1, 1};
+        result.data.resize(static_cast<size_t>(result.width) * result.height);
+        fits_read_pix(fptr, TFLOAT, firstPixel, result.data.size(), nullptr, result.data.data(), nullptr, &status);
+    }
+
+    if (status)
+    {
+        fits_get_errstatus(status, errorStatus);
+        error = file + ": " + errorStatus;
+        status = 0;
+        fits_close_file(fptr, &status);
+        return false;
+    }
+
+    fits_close_file(fptr, &status);
+    master = std::move(result);
+    return true;
+}
+
+bool CCDCalibration::crop(const Master &master, const Geometry &geometry, std::vector<float> &out,
+                          std::string &error) const
+{
+    if (master.binX != geometry.binX || master.binY != geometry.binY)
+    {
+        error = "binning " + std::to_string(master.binX) + "x" + std::to_string(master.binY) +
+                " does not match the frame binning " + std::to_string(geometry.binX) + "x" + std::to_string(geometry.binY);
+        return false;
+    }
+
+    // A master of the frame size is used as is, a larger one is assumed to cover the full frame
+    int x = geometry.x, y = geometry.y;
+    if (master.width == geometry.width && master.height == geometry.height)
+        x = y = 0;
+    else if (x + geometry.width > master.width || y + geometry.height > master.height)
+    {
+        error = "size " + std::to_string(master.width) + "x" + std::to_string(master.height) +
+                " does not cover the frame";
+        return false;
+    }
+
+    out.resize(static_cast<size_t>(geometry.width) * geometry.height);
+    for (int row = 0; row < geometry.height; row++)
+    {
+        const float *source = master.data.data() + static_cast<size_t>(y + row) * master.width + x;
+        std::copy(source, source + geometry.width, out.begin() + static_cast<size_t>(row) * geometry.width);
+    }
+    return true;
+}
+
+bool CCDCalibration::prepare(const Geometry &geometry, std::string &error)
+{
+    for (int type = 0; type < MASTER_COUNT; type++)
+    {
+        Slot &slot = m_Slots[type];
+        if (slot.loaded || slot.file.empty())
+            continue;
+
+        if (!readMaster(slot.file, slot.master, error))
+        {
+            error = std::string("Failed to read master ") + MasterNames[type] + " " + error;
+            return false;
+        }
+        slot.loaded = true;
+        m_Prepared = false;
+    }
+
+    if (m_Prepared && m_Geometry == geometry)
+        return true;
+
+    std::vector<float> terms[MASTER_COUNT];
+    for (int type = 0; type < MASTER_COUNT; type++)
+    {
+        if (m_Slots[type].loaded && !crop(m_Slots[type].master, geometry, terms[type], error))
+        {
+            error = std::string("Master ") + MasterNames[type] + " " + error + ".";
+            return false;
+        }
+    }
+
+    std::vector<float> &bias = terms[MASTER_BIAS];
+    std::vector<float> &dark = terms[MASTER_DARK];
+    std::vector<float> &flat = terms[MASTER_FLAT];
+    size_t size = static_cast<size_t>(geometry.width) * geometry.height;
+
+    m_Steps.clear();
+    m_Offset.assign(size, 0);
+    m_Thermal.clear();
+    m_Gain.clear();
+    m_HotPixels.clear();
+
+    if (!bias.empty())
+    {
+        m_Offset = bias;
+        m_Steps += "B";
+    }
+
+    if (!dark.empty())
+    {
+        if (bias.empty())
+            m_Offset = dark;
+        else
+        {
+            m_Thermal.resize(size);
+            for (size_t i = 0; i < size; i++)
+                m_Thermal[i] = dark[i] - bias[i];
+        }
+        m_Steps += "D";
+    }
+
+    if (!flat.empty())
+    {
+        // Normalized on the whole master so subframes keep the levels of full frames
+        const std::vector<float> &full = m_Slots[MASTER_FLAT].master.data;
+        double sum = 0;
+        for (float value : full)
+            sum += value;
+        float mean = full.empty() ? 1 : sum / full.size();
+
+        m_Gain.resize(size);
+        for (size_t i = 0; i < size; i++)
+            m_Gain[i] = flat[i] > 0 ? mean / flat[i] : 1;
+        m_Steps += "F";
+    }
+
+    for (size_t i = 0; i < terms[MASTER_HOT_PIXELS].size(); i++)
+        if (terms[MASTER_HOT_PIXELS][i] != 0)
+            m_HotPixels.push_back(i);
+
+    m_Geometry = geometry;
+    m_Prepared = true;
+    return true;
+}
+
+bool CCDCalibration::load(const Geometry &geometry, std::string &error)
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return prepare(geometry, error);
+}
+
+bool CCDCalibration::calibrate(uint8_t *buffer, int bpp, int planes, const Geometry &geometry, bool cfa,
+                               double exposure, double temperature, std::string &error, std::string *steps)
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    if (bpp != 8 && bpp != 16 && bpp != 32)
+    {
+        error = "Calibration does not support " + std::to_string(bpp) + " bits per pixel.";
+        return false;
+    }
+
+    if (!prepare(geometry, error))
+        return false;
+
+    if (steps)
+        *steps = m_Steps;
+
+    // Thermal signal scaled to the exposure time and temperature of the frame
+    double scale = 1;
+    if (!m_Thermal.empty())
+    {
+        const Master &dark = m_Slots[MASTER_DARK].master;
+        if (dark.exposure > 0)
+            scale = exposure / dark.exposure;
+        if (m_TemperatureDoubling > 0 && !std::isnan(temperature) && !std::isnan(dark.temperature))
+            scale *= std::pow(2.0, (temperature - dark.temperature) / m_TemperatureDoubling);
+    }
+
+    Frame frame { buffer, geometry.width, geometry.height, m_Offset.data(), m_Thermal.data(), m_Gain.data(), scale };
+    bool thermal = !m_Thermal.empty(), flat = !m_Gain.empty();
+    size_t planeSize = static_cast<size_t>(geometry.width) * geometry.height;
+
+    switch (bpp)
+    {
+        case 8:
+            calibratePixels<uint8_t>(frame, planes, thermal, flat);
+            break;
+        case 16:
+            calibratePixels<uint16_t>(frame, planes, thermal, flat);
+            break;
+        case 32:
+            calibratePixels<uint32_t>(frame, planes, thermal, flat);
+            break;
+    }
+
+    if (!m_HotPixels.empty())
+    {
+        int step = cfa ? 2 : 1;
+        for (int plane = 0; plane < planes; plane++)
+        {
+            switch (bpp)
+            {
+                case 8:
+                    correctHotPixels(buffer + plane * planeSize, geometry.width, geometry.height, m_HotPixels, step);
+                    break;
+                case 16:
+                    correctHotPixels(reinterpret_cast<uint16_t *>(buffer) + plane * planeSize, geometry.width,
+                                     geometry.height, m_HotPixels, step);
+                    break;
+                case 32:
+                    correctHotPixels(reinterpret_cast<uint32_t *>(buffer) + plane * planeSize, geometry.width,
+                                     geometry.height, m_HotPixels, step);
+                    break;
+            }
+        }
+    }
+
+    return true;
+}
+
+}
@@ -0,0 +1,158 @@
+/*
+    Copyright (C) 2022 INDI Library Developers
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace INDI
+{
+
+/**
+ * @class CCDCalibration
+ * @brief The CCDCalibration class calibrates raw frames against master bias, dark and flat frames and a hot pixel map.
+ *
+ * Each calibrated pixel is (raw - bias - k * (dark - bias)) * mean(flat) / flat, where k scales the thermal signal of
+ * the master dark to the exposure time and temperature of the frame. Hot pixels are then replaced by the median of
+ * their neighbours of the same color.
+ *
+ * Masters are read once and kept in memory. For each frame geometry, i.e. subframe and binning, the masters are
+ * cropped and combined into per-pixel offset, thermal and gain terms once, so calibrating a frame is a single pass
+ * over the pixels run on the libdsp worker pool.
+ *
+ * The master dark is expected to include the bias signal, like a plain average of dark frames. The master flat is
+ * expected to be calibrated already. The hot pixel map flags hot pixels with non-zero values. Without a master bias,
+ * the master dark is subtracted as is since its thermal signal cannot be told apart from the bias.
+ */
+class CCDCalibration
+{
+    public:
+        enum MasterType
+        {
+            MASTER_BIAS,
+            MASTER_DARK,
+            MASTER_FLAT,
+            MASTER_HOT_PIXELS,
+            MASTER_COUNT
+        };
+
+        struct Master
+        {
+            int width {0};
+            int height {0};
+            int binX {1};
+            int binY {1};
+            /** Exposure time of a master dark in seconds. */
+            double exposure {0};
+            /** Sensor temperature of a master dark in Celsius, NAN if unknown. */
+            double temperature {NAN};
+            std::vector<float> data;
+        };
+
+        /** Binned frame geometry. x and y are the binned offsets of the subframe within the full frame. */
+        struct Geometry
+        {
+            int x {0};
+            int y {0};
+            int width {0};
+            int height {0};
+            int binX {1};
+            int binY {1};
+
+            bool operator==(const Geometry &other) const
+            {
+                return x == other.x && y == other.y && width == other.width && height == other.height &&
+                       binX == other.binX && binY == other.binY;
+            }
+        };
+
+        /**
+         * @brief setMasterFile Set the FITS file of a master, an empty name removes the master.
+         * The file is read on the next call to calibrate().
+         */
+        void setMasterFile(MasterType type, const std::string &file);
+
+        /** @brief setMaster Use a master already in memory. */
+        void setMaster(MasterType type, Master master);
+
+        /** @return True if at least one master is set. */
+        bool hasMasters() const;
+
+        /** @brief setTemperatureDoubling Temperature increase doubling the dark current, 0 disables temperature scaling. */
+        void setTemperatureDoubling(double celsius);
+
+        /**
+         * @brief load Read the masters not read yet and combine them for the given geometry, so that calibrate() on a
+         * frame of that geometry only processes its pixels. Calling it first keeps file reads out of the caller's locks.
+         * @return False if the masters could not be read or do not fit the geometry.
+         */
+        bool load(const Geometry &geometry, std::string &error);
+
+        /**
+         * @brief calibrate Calibrate a frame in place.
+         * @param buffer Frame of unsigned 8, 16 or 32 bits pixels, color frames are stored plane by plane.
+         * @param bpp Bits per pixel.
+         * @param planes Number of planes, 1 or 3.
+         * @param geometry Geometry of the frame.
+         * @param cfa True for bayered frames, hot pixels are then corrected from neighbours of the same color.
+         * @param exposure Exposure time of the frame in seconds.
+         * @param temperature Sensor temperature during the frame in Celsius, NAN if unknown.
+         * @param error Reason of the failure.
+         * @param steps If not null, set to the masters applied to this frame, as for CALSTAT.
+         * @return True if the frame was calibrated, false if the masters could not be read or do not fit the frame.
+         */
+        bool calibrate(uint8_t *buffer, int bpp, int planes, const Geometry &geometry, bool cfa, double exposure,
+                       double temperature, std::string &error, std::string *steps = nullptr);
+
+        /** @return Masters applied by the last calibration, e.g. "BDF" for bias, dark and flat, as for CALSTAT. */
+        std::string steps() const;
+
+        /** @brief readMaster Read a 2D FITS master, including its exposure time, temperature and binning. */
+        static bool readMaster(const std::string &file, Master &master, std::string &error);
+
+    private:
+        struct Slot
+        {
+            std::string file;
+            bool loaded {false};
+            Master master;
+        };
+
+        bool prepare(const Geometry &geometry, std::string &error);
+        bool crop(const Master &master, const Geometry &geometry, std::vector<float> &out, std::string &error) const;
+
+        Slot m_Slots[MASTER_COUNT];
+        double m_TemperatureDoubling {6};
+
+        // Terms combined for the current geometry
+        bool m_Prepared {false};
+        Geometry m_Geometry;
+        std::vector<float> m_Offset;
+        std::vector<float> m_Thermal;
+        std::vector<float> m_Gain;
+        std::vector<uint32_t> m_HotPixels;
+        std::string m_Steps;
+
+        mutable std::mutex m_Mutex;
+};
+
+}
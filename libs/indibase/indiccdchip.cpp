@@ -18,6 +18,7 @@
 #include "indiccdchip.h"
 #include "indidevapi.h"
 #include "locale_compat.h"
+#include "indibufferpool.h"
 
 #include <cstring>
 #include <ctime>
@@ -30,10 +31,30 @@ CCDChip::CCDChip()
     strncpy(ImageExtention, "fits", MAXINDIBLOBFMT);
 }
 
+// Frame buffers come from the shared pool, unless the driver handed its own buffer over with setFrameBuffer()
+static uint8_t *allocFrame(uint32_t size)
+{
+    return static_cast<uint8_t *>(BufferPool::instance().acquire(size));
+}
+
+static void freeFrame(uint8_t *buffer)
+{
+    if (BufferPool::instance().release(buffer) == false)
+        delete [] buffer;
+}
+
+void CCDChip::setFrameBuffer(uint8_t *buffer)
+{
+    // The driver may still hold the pool buffer it got from getFrameBuffer(), it must not be handed out again
+    if (buffer != RawFrame)
+        BufferPool::instance().detach(RawFrame);
+    RawFrame = buffer;
+}
+
 CCDChip::~CCDChip()
 {
-    delete [] RawFrame;
-    delete[] BinFrame;
+    freeFrame(RawFrame);
+    freeFrame(BinFrame);
 }
 
 void CCDChip::setFrameType(CCD_FRAME type)
@@ -150,14 +171,14 @@ void CCDChip::setFrameBufferSize(uint32_t nbuf, bool allocMem)
     if (allocMem == false)
         return;
 
-    delete [] RawFrame;
-    RawFrame = new uint8_t[nbuf];
-
+    // Release first so the pool can hand the same buffers back when the size switches back and forth
+    freeFrame(RawFrame);
     if (BinFrame)
     {
-        delete [] BinFrame;
-        BinFrame = new uint8_t[nbuf];
+        freeFrame(BinFrame);
+        BinFrame = allocFrame(nbuf);
     }
+    RawFrame = allocFrame(nbuf);
 }
 
 void CCDChip::setExposureLeft(double duration)
@@ -240,7 +261,7 @@ void CCDChip::binFrame()
 
     // Jasem: Keep full frame shadow in memory to enhance performance and just swap frame pointers after operation is complete
     if (BinFrame == nullptr)
-        BinFrame = new uint8_t[RawFrameSize];
+        BinFrame = allocFrame(RawFrameSize);
 
     memset(BinFrame, 0, RawFrameSize);
 
@@ -327,7 +348,7 @@ void CCDChip::binBayerFrame()
 
     // Jasem: Keep full frame shadow in memory to enhance performance and just swap frame pointers after operation is complete
     if (BinFrame == nullptr)
-        BinFrame = new uint8_t[RawFrameSize];
+        BinFrame = allocFrame(RawFrameSize);
 
     memset(BinFrame, 0, RawFrameSize);
 
@@ -183,6 +183,9 @@ class CCDChip
         /**
          * @brief getFrameBuffer Get raw frame buffer of the CCD chip.
          * @return raw frame buffer of the CCD chip.
+         * @warning Buffers allocated by setFrameBufferSize() belong to INDI::BufferPool, they are not allocated
+         * with new[]. Never delete[], free() or realloc() them, change the frame size with setFrameBufferSize()
+         * instead, or hand over a buffer of your own with setFrameBuffer().
          */
         inline uint8_t *getFrameBuffer()
         {
@@ -196,11 +199,12 @@ class CCDChip
          * with allocMem set to true which is the default behavior. If you allocated the memory
          * yourself (i.e. allocMem is false), then you must call this function to set the pointer
          * to the raw frame buffer.
+         * @note A buffer of your own must be allocated with new[], the chip deletes it when the frame size changes
+         * or the chip is destroyed. The pool buffer it replaces is detached from INDI::BufferPool rather than
+         * recycled, so it stays valid if you still use it, and may be released with free() if smaller than
+         * INDI::BufferPool::HugePageSize.
          */
-        void setFrameBuffer(uint8_t *buffer)
-        {
-            RawFrame = buffer;
-        }
+        void setFrameBuffer(uint8_t *buffer);
 
         /**
          * @brief isCompressed
@@ -306,6 +310,8 @@ class CCDChip
          * the prior parameters gets updated.
          * @param nbuf size of buffer in bytes.
          * @param allocMem if True, it will allocate memory of nbut size bytes.
+         * @note Frame buffers are 64-byte aligned and recycled through INDI::BufferPool, so changing the frame size
+         * back and forth reuses the same memory.
          */
         void setFrameBufferSize(uint32_t nbuf, bool allocMem = true);
 
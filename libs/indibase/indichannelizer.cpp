@@ -0,0 +1,212 @@
+/*
+    Copyright (C) 2022 INDI Library Developers
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include "indichannelizer.h"
+
+#include "dsp.h"
+
+#include <fftw3.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <type_traits>
+
+namespace INDI
+{
+
+Channelizer::Channelizer()
+{
+}
+
+Channelizer::~Channelizer()
+{
+    destroyPlan();
+}
+
+void Channelizer::destroyPlan()
+{
+    dsp_fourier_plan_lock();
+    if (m_Plan != nullptr)
+        fftw_destroy_plan(static_cast<fftw_plan>(m_Plan));
+    fftw_free(m_In);
+    fftw_free(m_Out);
+    dsp_fourier_plan_unlock();
+
+    m_Plan = nullptr;
+    m_In = m_Out = nullptr;
+    m_Channels = 0;
+}
+
+bool Channelizer::configure(int channels, double overlap, int averages, Window window)
+{
+    if (channels < 2 || overlap < 0 || overlap > 0.9 || averages < 0)
+        return false;
+
+    // Measuring the plan takes a while, it is done once per channel count
+    if (channels != m_Channels)
+    {
+        destroyPlan();
+
+        dsp_fourier_plan_lock();
+        m_In  = static_cast<double *>(fftw_malloc(sizeof(fftw_complex) * channels));
+        m_Out = static_cast<double *>(fftw_malloc(sizeof(fftw_complex) * channels));
+        if (m_In != nullptr && m_Out != nullptr)
+            m_Plan = fftw_plan_dft_1d(channels, reinterpret_cast<fftw_complex *>(m_In),
+                                      reinterpret_cast<fftw_complex *>(m_Out), FFTW_FORWARD, FFTW_MEASURE);
+        dsp_fourier_plan_unlock();
+
+        if (m_Plan == nullptr)
+        {
+            destroyPlan();
+            return false;
+        }
+        m_Channels = channels;
+    }
+
+    m_Hop = std::max(1, static_cast<int>(std::lround(channels * (1 - overlap))));
+    m_Averages = averages;
+
+    m_Window.resize(channels);
+    m_WindowEnergy = 0;
+    for (int i = 0; i < channels; i++)
+    {
+        double phase = 2 * M_PI * i / channels;
+        switch (window)
+        {
+            case WINDOW_RECTANGULAR:
+                m_Window[i] = 1;
+                break;
+            case WINDOW_HANN:
+                m_Window[i] = 0.5 - 0.5 * std::cos(phase);
+                break;
+            case WINDOW_BLACKMAN:
+                m_Window[i] = 0.42 - 0.5 * std::cos(phase) + 0.08 * std::cos(2 * phase);
+                break;
+        }
+        m_WindowEnergy += m_Window[i] * m_Window[i];
+    }
+
+    m_Segment.resize(2 * channels);
+    m_Power.resize(channels);
+    reset();
+    return true;
+}
+
+void Channelizer::reset()
+{
+    std::fill(m_Power.begin(), m_Power.end(), 0);
+    m_Spectra.clear();
+    m_Filled = 0;
+    m_Accumulated = 0;
+    m_Segments = 0;
+    m_Samples = 0;
+}
+
+template <typename T>
+void Channelizer::processSamples(const T *buf, size_t count, double offset)
+{
+    const double scale = 1.0 / offset;
+    const double center = std::is_unsigned<T>::value ? offset : 0;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        m_Segment[2 * m_Filled]     = (buf[2 * i] - center) * scale;
+        m_Segment[2 * m_Filled + 1] = (buf[2 * i + 1] - center) * scale;
+
+        if (++m_Filled == m_Channels)
+        {
+            transform();
+
+            // The overlapping part of the segment starts the next one
+            m_Filled = m_Channels - m_Hop;
+            memmove(m_Segment.data(), m_Segment.data() + 2 * m_Hop, sizeof(double) * 2 * m_Filled);
+        }
+    }
+    m_Samples += count;
+}
+
+bool Channelizer::process(const uint8_t *buf, size_t len, int bps)
+{
+    if (m_Plan == nullptr)
+        return false;
+
+    // Integer samples are scaled to a full scale of 1
+    switch (bps)
+    {
+        case 8:
+            processSamples(buf, len / 2, 127.5);
+            break;
+        case 16:
+            processSamples(reinterpret_cast<const int16_t *>(buf), len / 4, 32768.0);
+            break;
+        case 32:
+            processSamples(reinterpret_cast<const int32_t *>(buf), len / 8, 2147483648.0);
+            break;
+        case -32:
+            processSamples(reinterpret_cast<const float *>(buf), len / 8, 1.0);
+            break;
+        case -64:
+            processSamples(reinterpret_cast<const double *>(buf), len / 16, 1.0);
+            break;
+        default:
+            return false;
+    }
+    return true;
+}
+
+void Channelizer::transform()
+{
+    for (int i = 0; i < m_Channels; i++)
+    {
+        m_In[2 * i]     = m_Segment[2 * i] * m_Window[i];
+        m_In[2 * i + 1] = m_Segment[2 * i + 1] * m_Window[i];
+    }
+
+    fftw_execute(static_cast<fftw_plan>(m_Plan));
+
+    for (int i = 0; i < m_Channels; i++)
+        m_Power[i] += m_Out[2 * i] * m_Out[2 * i] + m_Out[2 * i + 1] * m_Out[2 * i + 1];
+
+    m_Segments++;
+    if (++m_Accumulated == m_Averages)
+        addRow();
+}
+
+void Channelizer::addRow()
+{
+    if (m_Accumulated == 0)
+        return;
+
+    // Negative frequencies first, the center frequency lands on channel m_Channels / 2
+    const int shift = (m_Channels + 1) / 2;
+    const double norm = 1.0 / (m_Accumulated * m_WindowEnergy);
+    for (int i = 0; i < m_Channels; i++)
+        m_Spectra.push_back(m_Power[(i + shift) % m_Channels] * norm);
+
+    std::fill(m_Power.begin(), m_Power.end(), 0);
+    m_Accumulated = 0;
+}
+
+const std::vector<float> &Channelizer::finish()
+{
+    addRow();
+    return m_Spectra;
+}
+
+}
@@ -0,0 +1,140 @@
+/*
+    Copyright (C) 2022 INDI Library Developers
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace INDI
+{
+
+/**
+ * @class Channelizer
+ * @brief The Channelizer class turns a stream of complex I/Q samples into averaged power spectra.
+ *
+ * Samples are cut into segments of one FFT length, optionally overlapping as in Welch's method. Each segment is
+ * windowed and transformed, and its power is accumulated. Every averages segments, or once at the end of the
+ * integration, the mean power is appended to the spectra as one row.
+ *
+ * Rows are ordered by ascending frequency, the center frequency is channel channels / 2. Powers are normalized by
+ * the window energy so the noise floor does not depend on the window.
+ *
+ * The FFT plan is created once per channel count and kept across integrations. Samples may be fed in blocks of
+ * any size, segments spanning two blocks are carried over.
+ */
+class Channelizer
+{
+    public:
+        enum Window
+        {
+            WINDOW_RECTANGULAR,
+            WINDOW_HANN,
+            WINDOW_BLACKMAN
+        };
+
+        Channelizer();
+        ~Channelizer();
+
+        Channelizer(const Channelizer &) = delete;
+        Channelizer &operator=(const Channelizer &) = delete;
+
+        /**
+         * @brief configure Set the spectrum parameters and reset the accumulated spectra.
+         * @param channels FFT length, i.e. number of channels of the spectra, at least 2.
+         * @param overlap Fraction of each segment shared with the next one, from 0 to 0.9.
+         * @param averages Number of segments averaged in each row, 0 to average the whole integration in one row.
+         * @param window Window applied to each segment.
+         * @return False if the parameters are out of range or the plan could not be created.
+         */
+        bool configure(int channels, double overlap, int averages, Window window);
+
+        /** @brief reset Discard the accumulated spectra and the samples carried over. */
+        void reset();
+
+        /**
+         * @brief process Add samples to the integration.
+         * @param buf Interleaved I/Q samples.
+         * @param len Size of the buffer in bytes.
+         * @param bps Bits per sample component as in SensorInterface::setBPS(). 8 bits samples are unsigned offset
+         * binary as sent by RTL-SDR dongles, 16 and 32 bits samples are signed, -32 and -64 are floating point.
+         * @return False if the sample format is not supported.
+         */
+        bool process(const uint8_t *buf, size_t len, int bps);
+
+        /**
+         * @brief finish Close the integration, the segments accumulated since the last row make a last row.
+         * @return Spectra, rows() rows of channels() values.
+         */
+        const std::vector<float> &finish();
+
+        int channels() const
+        {
+            return m_Channels;
+        }
+
+        int rows() const
+        {
+            return m_Channels > 0 ? m_Spectra.size() / m_Channels : 0;
+        }
+
+        /** @return Number of segments transformed since the last reset. */
+        uint64_t segments() const
+        {
+            return m_Segments;
+        }
+
+        /** @return Number of complex samples processed since the last reset. */
+        uint64_t samples() const
+        {
+            return m_Samples;
+        }
+
+    private:
+        template <typename T>
+        void processSamples(const T *buf, size_t count, double offset);
+        void transform();
+        void addRow();
+        void destroyPlan();
+
+        int m_Channels {0};
+        int m_Hop {0};
+        int m_Averages {0};
+
+        // FFTW buffers and plan, fftw_complex and fftw_plan kept opaque
+        double *m_In {nullptr};
+        double *m_Out {nullptr};
+        void *m_Plan {nullptr};
+
+        std::vector<double> m_Window;
+        double m_WindowEnergy {1};
+
+        // Samples of the current segment, interleaved I/Q
+        std::vector<double> m_Segment;
+        int m_Filled {0};
+
+        std::vector<double> m_Power;
+        int m_Accumulated {0};
+        std::vector<float> m_Spectra;
+
+        uint64_t m_Segments {0};
+        uint64_t m_Samples {0};
+};
+
+}
@@ -20,11 +20,19 @@
 
 #include "indifilterinterface.h"
 #include <cstring>
+#include <sys/time.h>
 #include "indilogger.h"
 
 namespace INDI
 {
 
+static uint64_t motionClock()
+{
+    struct timeval tv;
+    IEGetClockTime(&tv);
+    return tv.tv_sec * 1000ULL + tv.tv_usec / 1000;
+}
+
 FilterInterface::FilterInterface(DefaultDevice *defaultDevice) : m_defaultDevice(defaultDevice)
 {
     FilterNameTP = new ITextVectorProperty;
@@ -103,6 +111,15 @@ bool FilterInterface::processNumber(const char *dev, const char *name, double va
         }
 
         IDSetNumber(&FilterSlotNP, nullptr);
+
+        if (FilterSlotNP.s == IPS_BUSY)
+        {
+            m_FilterMotion.start(CurrentFilter, TargetFilter, motionClock());
+
+            // Drivers polling through getFilterPollingPeriod() pick up the fast rate now instead of after a full period
+            if (m_FilterPolling)
+                m_defaultDevice->SetTimer(getFilterPollingPeriod());
+        }
         return true;
     }
 
@@ -177,6 +194,7 @@ void FilterInterface::SelectFilterDone(int f)
 {
     //  The hardware has finished changing
     //  filters
+    m_FilterMotion.finish();
     FilterSlotN[0].value = f;
     FilterSlotNP.s       = IPS_OK;
     // Tell the clients we are done, and
@@ -184,6 +202,20 @@ void FilterInterface::SelectFilterDone(int f)
     IDSetNumber(&FilterSlotNP, nullptr);
 }
 
+uint32_t FilterInterface::getFilterPollingPeriod()
+{
+    const uint64_t now = motionClock();
+    m_FilterPolling = true;
+
+    if (FilterSlotNP.s != IPS_BUSY)
+        m_FilterMotion.finish();
+    else
+        m_FilterMotion.update(CurrentFilter, now);
+
+    m_FilterMotion.setPeriods(m_FilterMotion.fastPeriod(), m_defaultDevice->getCurrentPollingPeriod());
+    return m_FilterMotion.nextDelay(now);
+}
+
 void FilterInterface::generateSampleFilters()
 {
     char filterName[MAXINDINAME];
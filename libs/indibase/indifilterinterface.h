@@ -23,6 +23,7 @@
 #include <string>
 #include <vector>
 #include "indibase.h"
+#include "indimotionpoller.h"
 
 /**
  * \class FilterInterface
@@ -36,6 +37,10 @@
    \e IMPORTANT: processFilterSlot() must be called in your driver's ISNewNumber() function. processFilterSlot() will call the driver's
       SelectFilter() accordingly.
 
+   Drivers polling the wheel in TimerHit() should reschedule with SetTimer(getFilterPollingPeriod()) so the wheel is polled
+   fast only while it moves. Wheels that report the end of a move on their own should call m_FilterMotion.setEventDriven(true)
+   in the constructor, and SelectFilterDone() when the report arrives.
+
    \note Filter position starts from 1 and \e not 0
 \author Gerry Rozema, Jasem Mutlaq
 */
@@ -117,6 +122,16 @@ class FilterInterface
          */
         bool saveConfigItems(FILE *fp);
 
+        /**
+         * @brief getFilterPollingPeriod Record CurrentFilter as a sample of the move in progress, if any.
+         * @return Delay in milliseconds until the wheel should be polled next. While moving, the wheel is polled when
+         * it is expected to reach its target, and never slower than the polling period.
+         */
+        uint32_t getFilterPollingPeriod();
+
+        // Decides when a moving wheel is polled next
+        MotionPoller m_FilterMotion;
+
         //  A number vector for filter slot
         INumberVectorProperty FilterSlotNP;
         INumber FilterSlotN[1];
@@ -138,5 +153,8 @@ class FilterInterface
          * @note This is only called in initProperties() of FilterInterface
          */
         bool loadFilterNames();
+
+        // Set once the driver schedules TimerHit() with getFilterPollingPeriod()
+        bool m_FilterPolling { false };
 };
 }
@@ -254,6 +254,7 @@ void Focuser::processButton(const char *button_n, ISState state)
     {
         if (AbortFocuser())
         {
+            m_FocusMotion.finish();
             FocusAbortSP.s = IPS_OK;
             DEBUG(Logger::DBG_SESSION, "Focuser aborted.");
             if (CanAbsMove() && FocusAbsPosNP.s != IPS_IDLE)
@@ -24,10 +24,18 @@
 
 #include <cstring>
 #include <cmath>
+#include <sys/time.h>
 
 namespace INDI
 {
 
+static uint64_t motionClock()
+{
+    struct timeval tv;
+    IEGetClockTime(&tv);
+    return tv.tv_sec * 1000ULL + tv.tv_usec / 1000;
+}
+
 FocuserInterface::FocuserInterface(DefaultDevice * defaultDevice) : m_defaultDevice(defaultDevice)
 {
 }
@@ -331,6 +339,7 @@ bool FocuserInterface::processNumber(const char * dev, const char * name, double
             FocusAbsPosNP.s = IPS_BUSY;
             DEBUGFDEVICE(dev, Logger::DBG_SESSION, "Focuser is moving to position %d", newPos);
             IDSetNumber(&FocusAbsPosNP, nullptr);
+            startFocusMotion(newPos);
             return true;
         }
 
@@ -399,6 +408,11 @@ bool FocuserInterface::processNumber(const char * dev, const char * name, double
             IDSetNumber(&FocusAbsPosNP, "Focuser is moving %d steps %s...", newPos,
                         FocusMotionS[0].s == ISS_ON ? "inward" : "outward");
             IDSetNumber(&FocusAbsPosNP, nullptr);
+            // Relative focusers have no target position, they are polled fast until done
+            if (CanAbsMove())
+                startFocusMotion(FocusAbsPosN[0].value + (FocusMotionS[0].s == ISS_ON ? -newPos : newPos));
+            else
+                startFocusMotion(FocusAbsPosN[0].value);
             return true;
         }
 
@@ -474,6 +488,7 @@ bool FocuserInterface::processSwitch(const char * dev, const char * name, ISStat
 
         if (AbortFocuser())
         {
+            m_FocusMotion.finish();
             FocusAbortSP.s = IPS_OK;
             if (CanAbsMove() && FocusAbsPosNP.s != IPS_IDLE)
             {
@@ -608,4 +623,43 @@ bool FocuserInterface::saveConfigItems(FILE * fp)
     return true;
 }
 
+void FocuserInterface::startFocusMotion(double target)
+{
+    m_FocusMotion.start(FocusAbsPosN[0].value, target, motionClock());
+
+    // Drivers polling through getFocusPollingPeriod() pick up the fast rate now instead of after a full period
+    if (m_FocusPolling)
+        m_defaultDevice->SetTimer(getFocusPollingPeriod());
+}
+
+void FocuserInterface::MoveFocuserDone(uint32_t position, IPState state)
+{
+    m_FocusMotion.finish();
+
+    FocusAbsPosN[0].value = position;
+    FocusAbsPosNP.s = state;
+    IDSetNumber(&FocusAbsPosNP, nullptr);
+
+    if (FocusRelPosNP.s == IPS_BUSY)
+    {
+        FocusRelPosNP.s = state;
+        IDSetNumber(&FocusRelPosNP, nullptr);
+    }
+}
+
+uint32_t FocuserInterface::getFocusPollingPeriod()
+{
+    const uint64_t now = motionClock();
+    m_FocusPolling = true;
+
+    // Polling drivers settle the property states themselves once the focuser stops
+    if (FocusAbsPosNP.s != IPS_BUSY && FocusRelPosNP.s != IPS_BUSY)
+        m_FocusMotion.finish();
+    else
+        m_FocusMotion.update(FocusAbsPosN[0].value, now);
+
+    m_FocusMotion.setPeriods(m_FocusMotion.fastPeriod(), m_defaultDevice->getCurrentPollingPeriod());
+    return m_FocusMotion.nextDelay(now);
+}
+
 }
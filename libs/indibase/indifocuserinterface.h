@@ -21,6 +21,7 @@
 #pragma once
 
 #include "indibase.h"
+#include "indimotionpoller.h"
 
 #include <stdint.h>
 
@@ -56,6 +57,10 @@ namespace INDI
    + **DC Motor**: Focusers without any position feedback. The only way to reliably control them is by using timers and moving them for specific pulses in or
    out.
 
+   Drivers polling the focuser position in TimerHit() should reschedule with SetTimer(FI::getFocusPollingPeriod()) so the
+   focuser is polled fast only while it moves. Focusers that report the end of a move on their own should call
+   m_FocusMotion.setEventDriven(true) in the constructor and FI::MoveFocuserDone() when the report arrives.
+
    Implement and overwrite the rest of the virtual functions as needed. INDI GPhoto driver is a good example to check for an actual implementation
    of a focuser interface within a CCD driver.
 \author Jasem Mutlaq
@@ -264,6 +269,23 @@ class FocuserInterface
          */
         bool saveConfigItems(FILE * fp);
 
+        /**
+         * @brief MoveFocuserDone Complete the move in progress, e.g. from the handler of an unsolicited device status.
+         * @param position Position reached by the focuser.
+         * @param state IPS_OK if the focuser reached the requested position, IPS_ALERT if the move failed.
+         */
+        void MoveFocuserDone(uint32_t position, IPState state = IPS_OK);
+
+        /**
+         * @brief getFocusPollingPeriod Record FocusAbsPosN as a sample of the move in progress, if any.
+         * @return Delay in milliseconds until the focuser should be polled next. While moving, the focuser is polled when
+         * it is expected to reach its target, and never slower than the polling period.
+         */
+        uint32_t getFocusPollingPeriod();
+
+        // Decides when a moving focuser is polled next
+        MotionPoller m_FocusMotion;
+
         // Focuser Speed (if variable speeds are supported)
         INumberVectorProperty FocusSpeedNP;
         INumber FocusSpeedN[1];
@@ -315,5 +337,11 @@ class FocuserInterface
         double lastTimerValue = { 0 };
 
         DefaultDevice * m_defaultDevice { nullptr };
+
+    private:
+        void startFocusMotion(double target);
+
+        // Set once the driver schedules TimerHit() with getFocusPollingPeriod()
+        bool m_FocusPolling { false };
 };
 }
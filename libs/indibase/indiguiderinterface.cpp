@@ -19,6 +19,7 @@
 */
 
 #include "indiguiderinterface.h"
+#include "indipulsescheduler.h"
 
 #include <cstring>
 
@@ -44,6 +45,13 @@ void GuiderInterface::initGuiderProperties(const char *deviceName, const char *g
     IUFillNumber(&GuideWEN[DIRECTION_EAST], "TIMED_GUIDE_E", "East (ms)", "%.f", 0, 60000, 100, 0);
     IUFillNumberVector(&GuideWENP, GuideWEN, 2, deviceName, "TELESCOPE_TIMED_GUIDE_WE", "Guide E/W", groupName, IP_RW,
                        60, IPS_IDLE);
+
+    IUFillNumber(&GuidePulseErrorN[GUIDE_PULSES], "PULSES", "Pulses", "%.f", 0, 1e9, 0, 0);
+    IUFillNumber(&GuidePulseErrorN[GUIDE_MEAN_ERROR], "MEAN_ERROR", "Mean error (ms)", "%.3f", 0, 1e6, 0, 0);
+    IUFillNumber(&GuidePulseErrorN[GUIDE_RMS_ERROR], "RMS_ERROR", "RMS error (ms)", "%.3f", 0, 1e6, 0, 0);
+    IUFillNumber(&GuidePulseErrorN[GUIDE_MAX_ERROR], "MAX_ERROR", "Max error (ms)", "%.3f", 0, 1e6, 0, 0);
+    IUFillNumberVector(&GuidePulseErrorNP, GuidePulseErrorN, 4, deviceName, "GUIDE_PULSE_ERROR", "Pulse Error", groupName,
+                       IP_RO, 60, IPS_IDLE);
 }
 
 void GuiderInterface::processGuiderProperties(const char *name, double values[], char *names[], int n)
@@ -83,6 +91,45 @@ void GuiderInterface::processGuiderProperties(const char *name, double values[],
     }
 }
 
+void GuiderInterface::schedulePulse(INDI_EQ_AXIS axis, uint32_t ms, std::function<void()> stop)
+{
+    if (!m_PulseScheduler)
+        m_PulseScheduler.reset(new PulseScheduler([this](INDI_EQ_AXIS axis)
+        {
+            pulseComplete(axis);
+        }));
+    m_PulseScheduler->start(axis, ms, std::move(stop));
+}
+
+void GuiderInterface::abortPulses()
+{
+    if (!m_PulseScheduler)
+        return;
+    m_PulseScheduler->abort(AXIS_RA);
+    m_PulseScheduler->abort(AXIS_DE);
+}
+
+void GuiderInterface::pulseComplete(INDI_EQ_AXIS axis)
+{
+    if (axis == AXIS_DE)
+    {
+        GuideNSN[DIRECTION_NORTH].value = GuideNSN[DIRECTION_SOUTH].value = 0;
+    }
+    else
+    {
+        GuideWEN[DIRECTION_WEST].value = GuideWEN[DIRECTION_EAST].value = 0;
+    }
+    GuideComplete(axis);
+
+    PulseScheduler::Statistics statistics = m_PulseScheduler->statistics();
+    GuidePulseErrorN[GUIDE_PULSES].value     = statistics.pulses;
+    GuidePulseErrorN[GUIDE_MEAN_ERROR].value = statistics.mean;
+    GuidePulseErrorN[GUIDE_RMS_ERROR].value  = statistics.rms;
+    GuidePulseErrorN[GUIDE_MAX_ERROR].value  = statistics.max;
+    GuidePulseErrorNP.s = IPS_OK;
+    IDSetNumber(&GuidePulseErrorNP, nullptr);
+}
+
 void GuiderInterface::GuideComplete(INDI_EQ_AXIS axis)
 {
     switch (axis)
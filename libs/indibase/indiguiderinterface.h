@@ -43,10 +43,14 @@
  */
 
 #include <stdint.h>
+#include <functional>
+#include <memory>
 
 namespace INDI
 {
 
+class PulseScheduler;
+
 class GuiderInterface
 {
   public:
@@ -107,9 +111,42 @@ class GuiderInterface
      */
     void processGuiderProperties(const char *name, double values[], char *names[], int n);
 
+    /**
+     * @brief schedulePulse Time a guiding pulse on the pulse scheduler thread instead of an event loop timer.
+     * The stop function is called from the scheduler thread at the end of the pulse, it must be thread safe.
+     * GuideComplete() is then called from the event loop and GuidePulseErrorNP is updated, drivers using the
+     * scheduler define GuidePulseErrorNP along with GuideNSNP and GuideWENP.
+     * @param axis AXIS_DE for N/S pulses, AXIS_RA for W/E pulses. Pulses on both axes run concurrently.
+     * @param ms duration of the pulse in milliseconds.
+     * @param stop function ending the pulse, may be empty when the device ends the pulse by itself.
+     */
+    void schedulePulse(INDI_EQ_AXIS axis, uint32_t ms, std::function<void()> stop = nullptr);
+
+    /**
+     * @brief abortPulses Cancel the scheduled pulses, typically called when motion is aborted.
+     * Neither the stop functions nor GuideComplete() are called for the cancelled pulses.
+     */
+    void abortPulses();
+
     INumber GuideNSN[2];
     INumberVectorProperty GuideNSNP;
     INumber GuideWEN[2];
     INumberVectorProperty GuideWENP;
+
+    // Lateness of the pulses ended by the pulse scheduler
+    INumber GuidePulseErrorN[4];
+    INumberVectorProperty GuidePulseErrorNP;
+    enum
+    {
+        GUIDE_PULSES,
+        GUIDE_MEAN_ERROR,
+        GUIDE_RMS_ERROR,
+        GUIDE_MAX_ERROR
+    };
+
+    std::unique_ptr<PulseScheduler> m_PulseScheduler;
+
+  private:
+    void pulseComplete(INDI_EQ_AXIS axis);
 };
 }
@@ -0,0 +1,86 @@
+/*
+    Copyright (C) 2022 INDI Library Developers
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include "indimotionpoller.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace INDI
+{
+
+MotionPoller::MotionPoller()
+{
+}
+
+void MotionPoller::setPeriods(uint32_t fastPeriod, uint32_t idlePeriod)
+{
+    m_FastPeriod = std::max<uint32_t>(1, fastPeriod);
+    m_IdlePeriod = std::max<uint32_t>(1, idlePeriod);
+}
+
+void MotionPoller::start(double position, double target, uint64_t now)
+{
+    m_Moving = true;
+    m_Target = target;
+    m_Position = position;
+    m_SampleTime = now;
+    m_Speed = 0;
+    m_Samples = 0;
+}
+
+void MotionPoller::update(double position, uint64_t now)
+{
+    if (!m_Moving)
+        return;
+
+    m_Samples++;
+
+    // The speed is measured over the last interval only, so the acceleration ramp does not hold it down
+    if (now > m_SampleTime && position != m_Position)
+        m_Speed = std::fabs(position - m_Position) / (now - m_SampleTime);
+
+    m_Position = position;
+    m_SampleTime = now;
+}
+
+void MotionPoller::finish()
+{
+    m_Moving = false;
+}
+
+uint32_t MotionPoller::nextDelay(uint64_t now) const
+{
+    if (!m_Moving || m_EventDriven)
+        return m_IdlePeriod;
+
+    // A polling period shorter than the fast period wins
+    const uint32_t fast = std::min(m_FastPeriod, m_IdlePeriod);
+
+    // Not moving yet, or the target is unknown
+    if (m_Speed <= 0 || m_Position == m_Target)
+        return fast;
+
+    double remaining = std::fabs(m_Target - m_Position) / m_Speed;
+    if (now > m_SampleTime)
+        remaining -= now - m_SampleTime;
+
+    return std::max<double>(fast, std::min<double>(m_IdlePeriod, std::ceil(remaining)));
+}
+
+}
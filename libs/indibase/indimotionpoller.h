@@ -0,0 +1,111 @@
+/*
+    Copyright (C) 2022 INDI Library Developers
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#pragma once
+
+#include <cstdint>
+
+namespace INDI
+{
+
+/**
+ * @class MotionPoller
+ * @brief The MotionPoller class decides when a moving device, e.g. a focuser or a filter wheel, is polled next.
+ *
+ * Idle devices are polled at the idle period. While a move is in progress the device is polled fast until its speed
+ * is known, then right when it is expected to reach its target given the speed measured between the last two
+ * position samples. The delay never goes below the fast period nor above the idle period.
+ *
+ * Devices that report move completion on their own (unsolicited status, event streams) are event driven: the move
+ * completes as soon as the device says so and polling stays at the idle period, as a watchdog only.
+ *
+ * All times are in milliseconds on a caller supplied monotonic clock so the poller can be driven by tests.
+ */
+class MotionPoller
+{
+    public:
+        MotionPoller();
+
+        /**
+         * @brief setPeriods Set the polling periods in milliseconds.
+         * @param fastPeriod shortest delay between two polls while moving.
+         * @param idlePeriod delay between two polls when not moving, and longest delay while moving.
+         */
+        void setPeriods(uint32_t fastPeriod, uint32_t idlePeriod);
+        uint32_t fastPeriod() const
+        {
+            return m_FastPeriod;
+        }
+        uint32_t idlePeriod() const
+        {
+            return m_IdlePeriod;
+        }
+
+        /** @brief setEventDriven Set whether the device reports move completion without being polled. */
+        void setEventDriven(bool enabled)
+        {
+            m_EventDriven = enabled;
+        }
+        bool isEventDriven() const
+        {
+            return m_EventDriven;
+        }
+
+        /**
+         * @brief start Start tracking a move.
+         * @param position current position of the device.
+         * @param target position the device is moving to. Pass the current position if unknown.
+         * @param now monotonic time in milliseconds.
+         */
+        void start(double position, double target, uint64_t now);
+
+        /** @brief update Record a position read from, or reported by, the device. */
+        void update(double position, uint64_t now);
+
+        /** @brief finish Stop tracking the move, it completed or was aborted. */
+        void finish();
+
+        bool isMoving() const
+        {
+            return m_Moving;
+        }
+
+        /** @return Milliseconds until the device should be polled next. */
+        uint32_t nextDelay(uint64_t now) const;
+
+        /** @return Number of position samples recorded during the current or last move. */
+        uint32_t samples() const
+        {
+            return m_Samples;
+        }
+
+    private:
+        uint32_t m_FastPeriod {100};
+        uint32_t m_IdlePeriod {1000};
+        bool m_EventDriven {false};
+
+        bool m_Moving {false};
+        double m_Target {0};
+        double m_Position {0};
+        uint64_t m_SampleTime {0};
+        // Speed in position units per millisecond, 0 while unknown
+        double m_Speed {0};
+        uint32_t m_Samples {0};
+};
+
+}
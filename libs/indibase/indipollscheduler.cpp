@@ -0,0 +1,173 @@
+/*
+    Copyright (C) 2022 INDI Library Developers
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include "indipollscheduler.h"
+
+#include <algorithm>
+
+namespace INDI
+{
+
+PollScheduler::PollScheduler()
+{
+    std::fill(m_BasePeriods, m_BasePeriods + MOTION_STATES, 1000);
+}
+
+void PollScheduler::addQuantity(const std::string &name, ReadFunction read, double multiplier, uint32_t maxAge)
+{
+    Quantity *quantity = find(name);
+    if (quantity == nullptr)
+    {
+        m_Quantities.push_back(Quantity());
+        quantity = &m_Quantities.back();
+    }
+
+    quantity->name       = name;
+    quantity->read       = read;
+    quantity->multiplier = std::max(multiplier, 0.0);
+    quantity->maxAge     = maxAge;
+    quantity->lastRead   = 0;
+    quantity->reads      = 0;
+    quantity->valid      = false;
+    quantity->due        = true;
+}
+
+void PollScheduler::removeQuantities()
+{
+    m_Quantities.clear();
+}
+
+void PollScheduler::setBasePeriod(MotionState state, uint32_t period)
+{
+    m_BasePeriods[state] = period;
+}
+
+void PollScheduler::setMotionState(MotionState state)
+{
+    m_MotionState = state;
+}
+
+void PollScheduler::boost(uint64_t until)
+{
+    m_BoostUntil = std::max(m_BoostUntil, until);
+}
+
+void PollScheduler::invalidate(const std::string &name)
+{
+    Quantity *quantity = find(name);
+    if (quantity)
+    {
+        quantity->valid = false;
+        quantity->due   = true;
+    }
+}
+
+uint32_t PollScheduler::period(const Quantity &quantity, uint64_t now) const
+{
+    MotionState state = (now < m_BoostUntil) ? MOTION_SLEWING : m_MotionState;
+    uint32_t value = static_cast<uint32_t>(m_BasePeriods[state] * quantity.multiplier);
+
+    if (quantity.maxAge > 0)
+        value = std::min(value, quantity.maxAge);
+
+    return value;
+}
+
+bool PollScheduler::read(Quantity &quantity, uint64_t now)
+{
+    quantity.reads++;
+    quantity.lastRead = now;
+    quantity.due      = false;
+    quantity.valid    = quantity.read();
+    return quantity.valid;
+}
+
+bool PollScheduler::poll(uint64_t now)
+{
+    bool rc = true;
+
+    for (auto &quantity : m_Quantities)
+    {
+        // A failed read is retried on the next period rather than immediately
+        if (!quantity.due && now < quantity.lastRead + period(quantity, now))
+            continue;
+
+        rc &= read(quantity, now);
+    }
+
+    return rc;
+}
+
+bool PollScheduler::refresh(const std::string &name, uint64_t now, uint32_t maxAge)
+{
+    Quantity *quantity = find(name);
+    if (quantity == nullptr)
+        return false;
+
+    if (quantity->valid && now < quantity->lastRead + maxAge)
+        return true;
+
+    return read(*quantity, now);
+}
+
+uint32_t PollScheduler::nextDelay(uint64_t now) const
+{
+    uint64_t next = UINT64_MAX;
+
+    for (const auto &quantity : m_Quantities)
+    {
+        if (quantity.due)
+            return 0;
+        next = std::min(next, quantity.lastRead + period(quantity, now));
+    }
+
+    // A boost ending changes the schedule, wake up to re-evaluate it.
+    if (now < m_BoostUntil)
+        next = std::min(next, m_BoostUntil);
+
+    if (next == UINT64_MAX)
+        return m_BasePeriods[m_MotionState];
+
+    return next > now ? static_cast<uint32_t>(next - now) : 0;
+}
+
+uint32_t PollScheduler::readCount(const std::string &name) const
+{
+    const Quantity *quantity = find(name);
+    return quantity ? quantity->reads : 0;
+}
+
+PollScheduler::Quantity *PollScheduler::find(const std::string &name)
+{
+    auto it = std::find_if(m_Quantities.begin(), m_Quantities.end(), [&name](const Quantity & quantity)
+    {
+        return quantity.name == name;
+    });
+    return it == m_Quantities.end() ? nullptr : &(*it);
+}
+
+const PollScheduler::Quantity *PollScheduler::find(const std::string &name) const
+{
+    auto it = std::find_if(m_Quantities.begin(), m_Quantities.end(), [&name](const Quantity & quantity)
+    {
+        return quantity.name == name;
+    });
+    return it == m_Quantities.end() ? nullptr : &(*it);
+}
+
+}
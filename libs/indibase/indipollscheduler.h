@@ -0,0 +1,146 @@
+/*
+    Copyright (C) 2022 INDI Library Developers
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace INDI
+{
+
+/**
+ * @class PollScheduler
+ * @brief The PollScheduler class decides which device quantities must be read on each poll.
+ *
+ * Each quantity (e.g. coordinates, pier side, site, time) is registered with a read function and a period
+ * multiplier. The effective refresh period of a quantity is the base period of the current motion state
+ * multiplied by the quantity multiplier, so fast changing quantities are refreshed often while slewing and
+ * rarely once the mount is parked.
+ *
+ * A quantity is never read twice within its staleness budget: refresh() only performs the read when the
+ * cached value is older than the requested age, which deduplicates reads requested from several places within
+ * the same poll cycle.
+ *
+ * All times are in milliseconds on a caller supplied monotonic clock so the scheduler can be driven by tests.
+ */
+class PollScheduler
+{
+    public:
+        enum MotionState
+        {
+            MOTION_SLEWING,
+            MOTION_TRACKING,
+            MOTION_IDLE,
+            MOTION_PARKED,
+            MOTION_STATES
+        };
+
+        /** Read function, returns false if the device could not be read. */
+        using ReadFunction = std::function<bool()>;
+
+        PollScheduler();
+
+        /**
+         * @brief addQuantity Register a quantity to be polled.
+         * @param name unique name of the quantity.
+         * @param read function reading the quantity from the device.
+         * @param multiplier refresh period as a multiple of the motion state base period.
+         * @param maxAge staleness budget in milliseconds. The quantity is refreshed at least this often regardless
+         * of the motion state. 0 means no budget.
+         */
+        void addQuantity(const std::string &name, ReadFunction read, double multiplier = 1, uint32_t maxAge = 0);
+
+        /** @brief removeQuantities Remove all registered quantities. */
+        void removeQuantities();
+
+        /** @return True if no quantities are registered. */
+        bool isEmpty() const
+        {
+            return m_Quantities.empty();
+        }
+
+        /** @brief setBasePeriod Set the base refresh period in milliseconds of a motion state. */
+        void setBasePeriod(MotionState state, uint32_t period);
+        uint32_t basePeriod(MotionState state) const
+        {
+            return m_BasePeriods[state];
+        }
+
+        /** @brief setMotionState Set the current motion state. Due times follow the new state immediately. */
+        void setMotionState(MotionState state);
+        MotionState motionState() const
+        {
+            return m_MotionState;
+        }
+
+        /**
+         * @brief boost Poll as if slewing until the given time, e.g. while a guide pulse is in progress.
+         * @param until monotonic time in milliseconds at which the boost ends.
+         */
+        void boost(uint64_t until);
+
+        /** @brief invalidate Mark a quantity as stale so it is read on the next poll. */
+        void invalidate(const std::string &name);
+
+        /**
+         * @brief poll Read all quantities that are due.
+         * @param now monotonic time in milliseconds.
+         * @return False if any read failed.
+         */
+        bool poll(uint64_t now);
+
+        /**
+         * @brief refresh Read a quantity now unless it was read within maxAge milliseconds.
+         * @return False if the quantity is unknown or the read failed.
+         */
+        bool refresh(const std::string &name, uint64_t now, uint32_t maxAge);
+
+        /** @return Milliseconds until the next quantity becomes due. */
+        uint32_t nextDelay(uint64_t now) const;
+
+        /** @return Number of reads performed for a quantity since it was registered. */
+        uint32_t readCount(const std::string &name) const;
+
+    private:
+        struct Quantity
+        {
+            std::string name;
+            ReadFunction read;
+            double multiplier;
+            uint32_t maxAge;
+            uint64_t lastRead;
+            uint32_t reads;
+            bool valid;
+            bool due;
+        };
+
+        uint32_t period(const Quantity &quantity, uint64_t now) const;
+        bool read(Quantity &quantity, uint64_t now);
+        Quantity *find(const std::string &name);
+        const Quantity *find(const std::string &name) const;
+
+        std::vector<Quantity> m_Quantities;
+        uint32_t m_BasePeriods[MOTION_STATES];
+        MotionState m_MotionState {MOTION_IDLE};
+        uint64_t m_BoostUntil {0};
+};
+
+}
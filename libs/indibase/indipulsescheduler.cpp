@@ -0,0 +1,193 @@
+/*
+    Copyright (C) 2022 INDI Library Developers
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include "indipulsescheduler.h"
+
+#include "indidevapi.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace INDI
+{
+
+PulseScheduler::PulseScheduler(CompleteFunction complete) : m_Complete(std::move(complete))
+{
+    if (pipe(m_Pipe) == 0)
+    {
+        fcntl(m_Pipe[0], F_SETFL, fcntl(m_Pipe[0], F_GETFL) | O_NONBLOCK);
+        fcntl(m_Pipe[1], F_SETFL, fcntl(m_Pipe[1], F_GETFL) | O_NONBLOCK);
+        m_CallbackID = IEAddCallback(m_Pipe[0], dispatchHelper, this);
+    }
+    m_Thread = std::thread(&PulseScheduler::run, this);
+}
+
+PulseScheduler::~PulseScheduler()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Quit = true;
+    }
+    m_Wake.notify_all();
+    m_Thread.join();
+    if (m_CallbackID >= 0)
+        IERmCallback(m_CallbackID);
+    for (int fd : m_Pipe)
+        if (fd >= 0)
+            close(fd);
+}
+
+void PulseScheduler::start(INDI_EQ_AXIS axis, uint32_t ms, StopFunction stop)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        Pulse &pulse = m_Pulses[axis];
+        pulse.generation++;
+        pulse.active = true;
+        pulse.ended = false;
+        pulse.deadline = Clock::now() + std::chrono::milliseconds(ms);
+        pulse.stop = std::move(stop);
+    }
+    m_Wake.notify_all();
+}
+
+void PulseScheduler::abort(INDI_EQ_AXIS axis)
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    Pulse &pulse = m_Pulses[axis];
+    pulse.generation++;
+    pulse.active = false;
+    pulse.ended = false;
+    pulse.stop = nullptr;
+}
+
+bool PulseScheduler::isActive(INDI_EQ_AXIS axis) const
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return m_Pulses[axis].active;
+}
+
+void PulseScheduler::run()
+{
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    while (!m_Quit)
+    {
+        Pulse *next = nullptr;
+        for (auto &pulse : m_Pulses)
+            if (pulse.active && !pulse.ended && (next == nullptr || pulse.deadline < next->deadline))
+                next = &pulse;
+
+        if (next == nullptr)
+        {
+            m_Wake.wait(lock);
+            continue;
+        }
+
+        // Absolute deadline on the monotonic clock, woken early only when pulses change
+        if (Clock::now() < next->deadline)
+        {
+            m_Wake.wait_until(lock, next->deadline);
+            continue;
+        }
+
+        uint32_t generation = next->generation;
+        StopFunction stop = std::move(next->stop);
+        Clock::time_point deadline = next->deadline;
+        lock.unlock();
+        if (stop)
+            stop();
+        // The motion ends when the stop returned, waiting on the device is part of the lateness
+        double late = std::chrono::duration<double, std::milli>(Clock::now() - deadline).count();
+        lock.lock();
+
+        // Restarted or aborted while stopping
+        if (next->generation != generation)
+            continue;
+
+        next->ended = true;
+        m_Count++;
+        m_Sum += late;
+        m_SumSquares += late * late;
+        m_Max = std::max(m_Max, late);
+
+        char wake = 0;
+        if (m_Pipe[1] >= 0 && write(m_Pipe[1], &wake, 1) < 0)
+        {
+            // The pipe is full, the loop has pending wake ups already
+        }
+    }
+}
+
+int PulseScheduler::dispatch()
+{
+    char buffer[16];
+    while (m_Pipe[0] >= 0 && read(m_Pipe[0], buffer, sizeof(buffer)) > 0);
+
+    std::vector<INDI_EQ_AXIS> ended;
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        for (int axis = AXIS_RA; axis <= AXIS_DE; axis++)
+        {
+            Pulse &pulse = m_Pulses[axis];
+            if (pulse.active && pulse.ended)
+            {
+                pulse.active = false;
+                pulse.ended = false;
+                ended.push_back(static_cast<INDI_EQ_AXIS>(axis));
+            }
+        }
+    }
+
+    if (m_Complete)
+        for (auto axis : ended)
+            m_Complete(axis);
+    return static_cast<int>(ended.size());
+}
+
+void PulseScheduler::dispatchHelper(int fd, void *context)
+{
+    INDI_UNUSED(fd);
+    static_cast<PulseScheduler *>(context)->dispatch();
+}
+
+PulseScheduler::Statistics PulseScheduler::statistics() const
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    Statistics statistics;
+    statistics.pulses = m_Count;
+    if (m_Count > 0)
+    {
+        statistics.mean = m_Sum / m_Count;
+        statistics.rms = std::sqrt(m_SumSquares / m_Count);
+        statistics.max = m_Max;
+    }
+    return statistics;
+}
+
+void PulseScheduler::resetStatistics()
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Count = 0;
+    m_Sum = m_SumSquares = m_Max = 0;
+}
+
+}
@@ -0,0 +1,127 @@
+/*
+    Copyright (C) 2022 INDI Library Developers
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#pragma once
+
+#include "indibasetypes.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace INDI
+{
+
+/**
+ * @class PulseScheduler
+ * @brief The PulseScheduler class times guide pulses on a dedicated thread.
+ *
+ * Guide pulses timed with IEAddTimer() end when the event loop gets to the timer, which can be tens of milliseconds
+ * late while the loop is busy with serial I/O or BLOB output. The scheduler thread instead sleeps until the absolute
+ * deadline of each pulse on the monotonic clock and calls the stop function of the pulse right there.
+ *
+ * One pulse per axis can run at a time, N/S and W/E pulses run concurrently. Once a pulse ended, the completion
+ * function is called from the event loop through a pipe watched with IEAddCallback(). Completion never runs on the
+ * scheduler thread, so it can safely update properties.
+ *
+ * The lateness of every pulse is taken once its stop function returned, so time spent waiting for the device, e.g.
+ * behind a serial transaction in flight, counts as lateness. It is accumulated into statistics.
+ */
+class PulseScheduler
+{
+    public:
+        /** Function stopping the guide motion, called from the scheduler thread. */
+        using StopFunction = std::function<void()>;
+        /** Function called from the event loop once the pulse of an axis ended. */
+        using CompleteFunction = std::function<void(INDI_EQ_AXIS axis)>;
+
+        struct Statistics
+        {
+            /** Number of pulses that ended. */
+            uint32_t pulses {0};
+            /** Mean lateness of the stops in milliseconds, measured when the stop function returned. */
+            double mean {0};
+            /** Root mean square lateness of the stops in milliseconds. */
+            double rms {0};
+            /** Largest lateness of a stop in milliseconds. */
+            double max {0};
+        };
+
+        explicit PulseScheduler(CompleteFunction complete);
+        ~PulseScheduler();
+
+        /**
+         * @brief start Start timing a pulse on an axis, replacing the pulse running on the same axis if any.
+         * @param axis AXIS_DE for N/S pulses, AXIS_RA for W/E pulses.
+         * @param ms duration of the pulse in milliseconds, counted from this call.
+         * @param stop function called at the end of the pulse, may be empty if the device times the pulse itself.
+         */
+        void start(INDI_EQ_AXIS axis, uint32_t ms, StopFunction stop = nullptr);
+
+        /** @brief abort Cancel the pulse of an axis, its stop and completion functions are not called. */
+        void abort(INDI_EQ_AXIS axis);
+
+        /** @return True if a pulse is running on the axis or its completion was not dispatched yet. */
+        bool isActive(INDI_EQ_AXIS axis) const;
+
+        /**
+         * @brief dispatch Call the completion function of the pulses that ended.
+         * Called from the event loop, it can also be called directly when no event loop runs.
+         * @return Number of completions called.
+         */
+        int dispatch();
+
+        Statistics statistics() const;
+        void resetStatistics();
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        struct Pulse
+        {
+            bool active {false};
+            bool ended {false};
+            uint32_t generation {0};
+            Clock::time_point deadline;
+            StopFunction stop;
+        };
+
+        void run();
+        static void dispatchHelper(int fd, void *context);
+
+        CompleteFunction m_Complete;
+        Pulse m_Pulses[2];
+        bool m_Quit {false};
+
+        uint32_t m_Count {0};
+        double m_Sum {0};
+        double m_SumSquares {0};
+        double m_Max {0};
+
+        int m_Pipe[2] { -1, -1 };
+        int m_CallbackID { -1 };
+
+        mutable std::mutex m_Mutex;
+        std::condition_variable m_Wake;
+        std::thread m_Thread;
+};
+
+}
@@ -61,6 +61,25 @@ bool Receiver::initProperties()
     IUFillNumber(&ReceiverSettingsN[RECEIVER_ANTENNA], "RECEIVER_ANTENNA", "Antenna", "%16.2f", 1, 4, 1, 1);
     IUFillNumberVector(&ReceiverSettingsNP, ReceiverSettingsN, 6, getDeviceName(), "RECEIVER_SETTINGS", "Receiver Settings", MAIN_CONTROL_TAB, IP_RW, 60, IPS_IDLE);
 
+    // Spectrometer
+    SpectrometerSP[INDI_ENABLED].fill("INDI_ENABLED", "Enabled", ISS_OFF);
+    SpectrometerSP[INDI_DISABLED].fill("INDI_DISABLED", "Disabled", ISS_ON);
+    SpectrometerSP.fill(getDeviceName(), "RECEIVER_SPECTROMETER", "Spectrometer", MAIN_CONTROL_TAB, IP_RW, ISR_1OFMANY, 60,
+                        IPS_IDLE);
+
+    SpectrometerSettingsNP[SPECTROMETER_CHANNELS].fill("SPECTROMETER_CHANNELS", "Channels", "%.f", 16, 65536, 16, 1024);
+    SpectrometerSettingsNP[SPECTROMETER_OVERLAP].fill("SPECTROMETER_OVERLAP", "Overlap (%)", "%.f", 0, 90, 5, 50);
+    SpectrometerSettingsNP[SPECTROMETER_AVERAGES].fill("SPECTROMETER_AVERAGES", "Averages (0 = all)", "%.f", 0, 1000000, 1,
+            0);
+    SpectrometerSettingsNP.fill(getDeviceName(), "RECEIVER_SPECTROMETER_SETTINGS", "Spectrometer", MAIN_CONTROL_TAB, IP_RW,
+                                60, IPS_IDLE);
+
+    SpectrometerWindowSP[Channelizer::WINDOW_RECTANGULAR].fill("WINDOW_RECTANGULAR", "Rectangular", ISS_OFF);
+    SpectrometerWindowSP[Channelizer::WINDOW_HANN].fill("WINDOW_HANN", "Hann", ISS_ON);
+    SpectrometerWindowSP[Channelizer::WINDOW_BLACKMAN].fill("WINDOW_BLACKMAN", "Blackman", ISS_OFF);
+    SpectrometerWindowSP.fill(getDeviceName(), "RECEIVER_SPECTROMETER_WINDOW", "Window", MAIN_CONTROL_TAB, IP_RW,
+                              ISR_1OFMANY, 60, IPS_IDLE);
+
     setDriverInterface(SPECTROGRAPH_INTERFACE);
 
     return SensorInterface::initProperties();
@@ -76,6 +95,9 @@ bool Receiver::updateProperties()
     if (isConnected())
     {
         defineProperty(&ReceiverSettingsNP);
+        defineProperty(&SpectrometerSP);
+        defineProperty(&SpectrometerSettingsNP);
+        defineProperty(&SpectrometerWindowSP);
 
         if (HasCooler())
             defineProperty(&TemperatureNP);
@@ -83,6 +105,9 @@ bool Receiver::updateProperties()
     else
     {
         deleteProperty(ReceiverSettingsNP.name);
+        deleteProperty(SpectrometerSP.getName());
+        deleteProperty(SpectrometerSettingsNP.getName());
+        deleteProperty(SpectrometerWindowSP.getName());
 
         if (HasCooler())
             deleteProperty(TemperatureNP.name);
@@ -105,14 +130,43 @@ bool Receiver::ISNewNumber(const char *dev, const char *name, double values[], c
     if (dev && !strcmp(dev, getDeviceName()) && !strcmp(name, ReceiverSettingsNP.name)) {
         IDSetNumber(&ReceiverSettingsNP, nullptr);
     }
-    if (dev && !strcmp(dev, getDeviceName()) && !strcmp(name, ReceiverSettingsNP.name)) {
-        IDSetNumber(&ReceiverSettingsNP, nullptr);
+    if (dev && !strcmp(dev, getDeviceName()) && SpectrometerSettingsNP.isNameMatch(name)) {
+        SpectrometerSettingsNP.update(values, names, n);
+        SpectrometerSettingsNP.setState(configureSpectrometer() ? IPS_OK : IPS_ALERT);
+        SpectrometerSettingsNP.apply();
+        return true;
     }
+    // Samples left over from an aborted or failed integration must not end up in the next spectra
+    if (dev && !strcmp(dev, getDeviceName()) && !strcmp(name, FramedIntegrationNP.name))
+        resetSpectrometer();
     return processNumber(dev, name, values, names, n);
 }
 
 bool Receiver::ISNewSwitch(const char *dev, const char *name, ISState *values, char *names[], int n)
 {
+    if (dev && !strcmp(dev, getDeviceName()))
+    {
+        if (SpectrometerSP.isNameMatch(name))
+        {
+            SpectrometerSP.update(values, names, n);
+            SpectrometerSP.setState(IPS_OK);
+            if (SpectrometerSP[INDI_ENABLED].getState() == ISS_ON && configureSpectrometer() == false)
+                SpectrometerSP.setState(IPS_ALERT);
+            SpectrometerSP.apply();
+            return true;
+        }
+
+        if (SpectrometerWindowSP.isNameMatch(name))
+        {
+            SpectrometerWindowSP.update(values, names, n);
+            SpectrometerWindowSP.setState(configureSpectrometer() ? IPS_OK : IPS_ALERT);
+            SpectrometerWindowSP.apply();
+            return true;
+        }
+
+        if (!strcmp(name, AbortIntegrationSP.name))
+            resetSpectrometer();
+    }
     return processSwitch(dev, name, values, names, n);
 }
 
@@ -164,6 +218,110 @@ void Receiver::SetReceiverCapability(uint32_t cap)
     setDriverInterface(getDriverInterface());
 }
 
+bool Receiver::configureSpectrometer()
+{
+    int window = SpectrometerWindowSP.findOnSwitchIndex();
+    std::lock_guard<std::mutex> lock(m_ChannelizerLock);
+    if (m_Channelizer.configure(SpectrometerSettingsNP[SPECTROMETER_CHANNELS].getValue(),
+                                SpectrometerSettingsNP[SPECTROMETER_OVERLAP].getValue() / 100,
+                                SpectrometerSettingsNP[SPECTROMETER_AVERAGES].getValue(),
+                                static_cast<Channelizer::Window>(window < 0 ? Channelizer::WINDOW_HANN : window)))
+        return true;
+
+    LOG_ERROR("Invalid spectrometer settings.");
+    return false;
+}
+
+void Receiver::resetSpectrometer()
+{
+    std::lock_guard<std::mutex> lock(m_ChannelizerLock);
+    m_Channelizer.reset();
+}
+
+bool Receiver::addSamples(const uint8_t *buf, int len, int bps)
+{
+    if (SpectrometerSP[INDI_ENABLED].getState() != ISS_ON)
+        return false;
+
+    std::lock_guard<std::mutex> lock(m_ChannelizerLock);
+    if (m_Channelizer.channels() == 0)
+        return false;
+    return m_Channelizer.process(buf, len, bps != 0 ? bps : getBPS());
+}
+
+bool Receiver::IntegrationComplete()
+{
+    bool spectrometer = SpectrometerSP[INDI_ENABLED].getState() == ISS_ON;
+    if (spectrometer)
+    {
+        std::lock_guard<std::mutex> lock(m_ChannelizerLock);
+        spectrometer = m_Channelizer.channels() > 0;
+    }
+
+    // Raw samples are uploaded if the spectrometer is disabled or misconfigured
+    if (spectrometer == false)
+        return SensorInterface::IntegrationComplete();
+
+    // Reset POLLMS to default value
+    setCurrentPollingPeriod(getPollingPeriod());
+
+    // Run async
+    std::thread(&Receiver::IntegrationCompleteSpectra, this).detach();
+
+    return true;
+}
+
+void Receiver::IntegrationCompleteSpectra()
+{
+    bool sendIntegration = (UploadS[0].s == ISS_ON || UploadS[2].s == ISS_ON);
+    bool saveIntegration = (UploadS[1].s == ISS_ON || UploadS[2].s == ISS_ON);
+
+    std::unique_lock<std::mutex> lock(m_ChannelizerLock);
+
+    // Samples the driver did not feed during the integration are all in the buffer
+    if (m_Channelizer.samples() == 0)
+        m_Channelizer.process(getBuffer(), getBufferSize(), getBPS());
+
+    std::vector<float> spectra = m_Channelizer.finish();
+    int channels = m_Channelizer.channels();
+    int rows = m_Channelizer.rows();
+    uint64_t segments = m_Channelizer.segments();
+    m_Channelizer.reset();
+    lock.unlock();
+
+    if (rows == 0)
+        LOG_WARN("Integration too short for a single spectrum, no spectrum is uploaded.");
+    else if (sendIntegration || saveIntegration)
+    {
+        // Spectra are always FITS, the frequency axis is in the header
+        m_SpectraChannels = channels;
+        m_SpectraSegments = segments;
+        void *blob = sendFITS(reinterpret_cast<uint8_t *>(spectra.data()), channels, -32, rows);
+        m_SpectraChannels = 0;
+
+        if (sendIntegration && blob != nullptr)
+            IDSetBLOB(&FitsBP, nullptr);
+        free(blob);
+
+        LOGF_DEBUG("Uploaded %d spectra of %d channels from %llu segments", rows, channels,
+                   static_cast<unsigned long long>(segments));
+    }
+
+    FramedIntegrationNP.s = IPS_OK;
+    IDSetNumber(&FramedIntegrationNP, nullptr);
+}
+
+bool Receiver::saveConfigItems(FILE *fp)
+{
+    SensorInterface::saveConfigItems(fp);
+
+    IUSaveConfigSwitch(fp, &SpectrometerSP);
+    IUSaveConfigNumber(fp, &SpectrometerSettingsNP);
+    IUSaveConfigSwitch(fp, &SpectrometerWindowSP);
+
+    return true;
+}
+
 bool Receiver::StartIntegration(double duration)
 {
     INDI_UNUSED(duration);
@@ -215,6 +373,22 @@ void Receiver::addFITSKeywords(fitsfile *fptr, uint8_t* buf, int len)
     sprintf(fitsString, "%lf", getGain());
     fits_update_key_s(fptr, TSTRING, "GAIN", fitsString, "Gain", &status);
 
+    // Spectra: channels along the first axis, centered on the observed frequency
+    if (m_SpectraChannels > 0)
+    {
+        double refPixel = m_SpectraChannels / 2 + 1;
+        double frequency = getFrequency();
+        double channelWidth = getSampleRate() / m_SpectraChannels;
+        fits_update_key_s(fptr, TSTRING, "CTYPE1", const_cast<char *>("FREQ"), "Frequency axis", &status);
+        fits_update_key_s(fptr, TSTRING, "CUNIT1", const_cast<char *>("Hz"), "Frequency unit", &status);
+        fits_update_key_s(fptr, TDOUBLE, "CRPIX1", &refPixel, "Channel of the center frequency", &status);
+        fits_update_key_s(fptr, TDOUBLE, "CRVAL1", &frequency, "Center frequency", &status);
+        fits_update_key_s(fptr, TDOUBLE, "CDELT1", &channelWidth, "Channel width", &status);
+        fits_update_key_s(fptr, TINT, "NCHAN", &m_SpectraChannels, "Number of channels", &status);
+        long long segments = m_SpectraSegments;
+        fits_update_key_s(fptr, TLONGLONG, "NSEGMENT", &segments, "FFT segments integrated", &status);
+    }
+
     SensorInterface::addFITSKeywords(fptr, buf, len);
 }
 }
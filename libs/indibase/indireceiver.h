@@ -19,6 +19,9 @@
 #pragma once
 
 #include "indisensorinterface.h"
+#include "indichannelizer.h"
+#include "indipropertynumber.h"
+#include "indipropertyswitch.h"
 #include "dsp.h"
 #include <fitsio.h>
 
@@ -80,6 +83,7 @@ class Receiver : public virtual SensorInterface
         virtual bool ISSnoopDevice(XMLEle *root) override;
 
         virtual bool StartIntegration(double duration) override;
+        virtual bool IntegrationComplete() override;
         virtual void addFITSKeywords(fitsfile *fptr, uint8_t* buf, int len) override;
 
         /**
@@ -189,7 +193,50 @@ class Receiver : public virtual SensorInterface
         INumberVectorProperty ReceiverSettingsNP;
         INumber ReceiverSettingsN[7];
 
+    protected:
+        virtual bool saveConfigItems(FILE *fp) override;
+
+        /**
+         * @brief addSamples Feed the I/Q samples received during the integration to the spectrometer, so they need
+         * not be kept in the integration buffer. Drivers which do not call it leave the samples in the buffer, they
+         * are then channelized all at once in IntegrationComplete().
+         * @param buf Interleaved I/Q samples.
+         * @param len Size of the buffer in bytes.
+         * @param bps Bits of each I and Q value as described in Channelizer::process(), 0 to use getBPS().
+         * @return True if the spectrometer took the samples, false if it is disabled.
+         */
+        bool addSamples(const uint8_t *buf, int len, int bps = 0);
+
+        /**
+         * @brief SpectrometerSP When enabled, integrations are uploaded as averaged power spectra instead of raw
+         * samples, as a FITS image of one spectrum per row with a frequency axis.
+         */
+        INDI::PropertySwitch SpectrometerSP {2};
+
+        // Spectrometer settings
+        INDI::PropertyNumber SpectrometerSettingsNP {3};
+        enum
+        {
+            SPECTROMETER_CHANNELS,
+            SPECTROMETER_OVERLAP,
+            SPECTROMETER_AVERAGES
+        };
+
+        // Spectrometer window, indexed by Channelizer::Window
+        INDI::PropertySwitch SpectrometerWindowSP {3};
+
 private:
+        bool configureSpectrometer();
+        // Drop the samples fed so far, called when an integration starts or is aborted
+        void resetSpectrometer();
+        void IntegrationCompleteSpectra();
+
+        Channelizer m_Channelizer;
+        std::mutex m_ChannelizerLock;
+        // Channels of the spectra being encoded, 0 while encoding raw samples
+        int m_SpectraChannels {0};
+        uint64_t m_SpectraSegments {0};
+
         double Frequency;
         double SampleRate;
         double Bandwidth;
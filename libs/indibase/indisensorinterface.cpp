@@ -752,7 +752,7 @@ void SensorInterface::fits_update_key_s(fitsfile *fptr, int type, std::string na
     fits_update_key(fptr, type, name.c_str(), p, const_cast<char *>(explanation.c_str()), status);
 }
 
-void* SensorInterface::sendFITS(uint8_t *buf, int len)
+void* SensorInterface::sendFITS(uint8_t *buf, int len, int bps, int rows)
 {
     bool sendIntegration = (UploadS[0].s == ISS_ON || UploadS[2].s == ISS_ON);
     bool saveIntegration = (UploadS[1].s == ISS_ON || UploadS[2].s == ISS_ON);
@@ -767,7 +767,7 @@ void* SensorInterface::sendFITS(uint8_t *buf, int len)
     int nelements = 0;
     std::string bit_depth;
     char error_status[MAXRBUF];
-    switch (getBPS())
+    switch (bps)
     {
         case 8:
             byte_type = TBYTE;
@@ -806,13 +806,13 @@ void* SensorInterface::sendFITS(uint8_t *buf, int len)
             break;
 
         default:
-            DEBUGF(Logger::DBG_ERROR, "Unsupported bits per sample value %d", getBPS());
+            DEBUGF(Logger::DBG_ERROR, "Unsupported bits per sample value %d", bps);
             return nullptr;
     }
     naxes[0] = len;
     naxes[0] = naxes[0] < 1 ? 1 : naxes[0];
-    naxes[1] = 1;
-    nelements = naxes[0];
+    naxes[1] = rows < 1 ? 1 : rows;
+    nelements = naxes[0] * naxes[1];
 
     /*DEBUGF(Logger::DBG_DEBUG, "Exposure complete. Image Depth: %s. Width: %d Height: %d nelements: %d", bit_depth.c_str(), naxes[0],
             naxes[1], nelements);*/
@@ -899,7 +899,7 @@ bool SensorInterface::IntegrationCompletePrivate()
         void* blob = nullptr;
         if (!strcmp(getIntegrationFileExtension(), "fits"))
         {
-            blob = sendFITS(getBuffer(), getBufferSize() * 8 / abs(getBPS()));
+            blob = sendFITS(getBuffer(), getBufferSize() * 8 / abs(getBPS()), getBPS());
         }
         else
         {
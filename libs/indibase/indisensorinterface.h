@@ -517,6 +517,16 @@ protected:
         /// For Serial & TCP connections
         int PortFD = -1;
 
+        /**
+         * @brief sendFITS Encode samples as a FITS image, then upload and save it according to the upload mode.
+         * @param buf Samples.
+         * @param len Number of samples per row.
+         * @param bps Bits per sample, as for setBPS().
+         * @param rows Number of rows.
+         * @return The FITS data to free() once the BLOB is sent, nullptr on error.
+         */
+        void* sendFITS(uint8_t* buf, int len, int bps, int rows = 1);
+
       private:
         bool callHandshake();
         uint8_t sensorConnection = CONNECTION_NONE;
@@ -536,6 +546,5 @@ protected:
         int getFileIndex(const char *dir, const char *prefix, const char *ext);
 
         bool IntegrationCompletePrivate();
-        void* sendFITS(uint8_t* buf, int len);
 };
 }
@@ -26,6 +26,7 @@
 #include <libnova/sidereal_time.h>
 #include <libnova/transform.h>
 
+#include <chrono>
 #include <cmath>
 #include <cerrno>
 #include <pwd.h>
@@ -216,6 +217,18 @@ bool Telescope::initProperties()
     ReverseMovementSP[REVERSE_WE].fill("REVERSE_WE", "West/East", ISS_OFF);
     ReverseMovementSP.fill(getDeviceName(), "TELESCOPE_REVERSE_MOTION", "Reverse", MOTION_TAB, IP_RW, ISR_NOFMANY, 60, IPS_IDLE);
 
+    // Poll scheduler. Factors of 1 poll everything at the polling period, as before.
+    PollFactorsNP[PollScheduler::MOTION_SLEWING].fill("SLEWING", "Slewing", "%.2f", 0.1, 100, 0.1, 1);
+    PollFactorsNP[PollScheduler::MOTION_TRACKING].fill("TRACKING", "Tracking", "%.2f", 0.1, 100, 0.1, 1);
+    PollFactorsNP[PollScheduler::MOTION_IDLE].fill("IDLE", "Idle", "%.2f", 0.1, 100, 0.1, 1);
+    PollFactorsNP[PollScheduler::MOTION_PARKED].fill("PARKED", "Parked", "%.2f", 0.1, 100, 0.1, 1);
+    PollFactorsNP.fill(getDeviceName(), "TELESCOPE_POLL_FACTORS", "Poll Factors", OPTIONS_TAB, IP_RW, 60, IPS_IDLE);
+
+    m_PollScheduler.addQuantity(SCOPE_STATUS_QUANTITY, [this]()
+    {
+        return ReadScopeStatus();
+    });
+
     IUFillNumber(&ScopeParametersN[0], "TELESCOPE_APERTURE", "Aperture (mm)", "%g", 10, 5000, 0, 0.0);
     IUFillNumber(&ScopeParametersN[1], "TELESCOPE_FOCAL_LENGTH", "Focal Length (mm)", "%g", 10, 10000, 0, 0.0);
     IUFillNumber(&ScopeParametersN[2], "GUIDER_APERTURE", "Guider Aperture (mm)", "%g", 10, 5000, 0, 0.0);
@@ -427,6 +440,7 @@ bool Telescope::updateProperties()
 
         defineProperty(&ScopeConfigNameTP);
         defineProperty(&ScopeConfigsSP);
+        defineProperty(&PollFactorsNP);
     }
     else
     {
@@ -489,6 +503,7 @@ bool Telescope::updateProperties()
 
         deleteProperty(ScopeConfigNameTP.name);
         deleteProperty(ScopeConfigsSP.name);
+        deleteProperty(PollFactorsNP.getName());
     }
 
     if (CanGOTO())
@@ -681,6 +696,7 @@ bool Telescope::saveConfigItems(FILE *fp)
     IUSaveConfigSwitch(fp, &MotionControlModeTP);
     IUSaveConfigSwitch(fp, &LockAxisSP);
     IUSaveConfigSwitch(fp, &SimulatePierSideSP);
+    IUSaveConfigNumber(fp, &PollFactorsNP);
 
     return true;
 }
@@ -1015,6 +1031,18 @@ bool Telescope::ISNewNumber(const char *dev, const char *name, double values[],
             IDSetNumber(&TrackRateNP, nullptr);
             return true;
         }
+
+        ///////////////////////////////////
+        // Poll Factors
+        ///////////////////////////////////
+        if (PollFactorsNP.isNameMatch(name))
+        {
+            PollFactorsNP.update(values, names, n);
+            PollFactorsNP.setState(IPS_OK);
+            PollFactorsNP.apply();
+            saveConfig(true, PollFactorsNP.getName());
+            return true;
+        }
     }
 
     return DefaultDevice::ISNewNumber(dev, name, values, names, n);
@@ -1629,23 +1657,70 @@ bool Telescope::Handshake()
     return ReadScopeStatus();
 }
 
+static uint64_t pollClock()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
 void Telescope::TimerHit()
 {
     if (isConnected())
     {
-        bool rc;
+        uint64_t now = pollClock();
 
-        rc = ReadScopeStatus();
+        updatePollSchedule();
 
-        if (!rc)
+        if (!m_PollScheduler.poll(now))
         {
             //  read was not good
             EqNP.s = lastEqState = IPS_ALERT;
             IDSetNumber(&EqNP, nullptr);
         }
 
-        SetTimer(getCurrentPollingPeriod());
+        // Motion state may have changed during the reads
+        updatePollSchedule();
+        SetTimer(m_PollScheduler.nextDelay(now));
+    }
+}
+
+void Telescope::updatePollSchedule()
+{
+    PollScheduler::MotionState state;
+
+    switch (TrackState)
+    {
+        case SCOPE_SLEWING:
+        case SCOPE_PARKING:
+            state = PollScheduler::MOTION_SLEWING;
+            break;
+        case SCOPE_TRACKING:
+            state = PollScheduler::MOTION_TRACKING;
+            break;
+        case SCOPE_PARKED:
+            state = PollScheduler::MOTION_PARKED;
+            break;
+        default:
+            state = PollScheduler::MOTION_IDLE;
+            break;
     }
+
+    if (MovementNSSP.s == IPS_BUSY || MovementWESP.s == IPS_BUSY)
+        state = PollScheduler::MOTION_SLEWING;
+
+    m_PollScheduler.setMotionState(state);
+
+    for (int i = 0; i < PollScheduler::MOTION_STATES; i++)
+        m_PollScheduler.setBasePeriod(static_cast<PollScheduler::MotionState>(i),
+                                      getCurrentPollingPeriod() * PollFactorsNP[i].getValue());
+}
+
+void Telescope::boostPolling(uint32_t duration)
+{
+    m_PollScheduler.boost(pollClock() + duration);
+
+    // Pick up the boosted rate now instead of at the end of a possibly long parked period
+    if (isConnected())
+        SetTimer(0);
 }
 
 bool Telescope::Goto(double ra, double dec)
@@ -21,6 +21,8 @@
 #include "defaultdevice.h"
 #include "libastro.h"
 #include "indipropertyswitch.h"
+#include "indipropertynumber.h"
+#include "indipollscheduler.h"
 #include <libnova/julian_day.h>
 
 #include <string>
@@ -754,6 +756,25 @@ class Telescope : public DefaultDevice
             REVERSE_WE
         };
 
+        // Poll period of each motion state as a multiple of the polling period
+        INDI::PropertyNumber PollFactorsNP {4};
+
+        /**
+         * @brief m_PollScheduler decides what is read on each TimerHit(). ReadScopeStatus() is registered as
+         * SCOPE_STATUS_QUANTITY. Child classes may register additional quantities that change slowly (pier side,
+         * site, time...) with a larger multiplier instead of reading them on every ReadScopeStatus().
+         */
+        PollScheduler m_PollScheduler;
+        static constexpr const char *SCOPE_STATUS_QUANTITY {"SCOPE_STATUS"};
+
+        /**
+         * @brief boostPolling Poll at the slewing rate for the given duration, e.g. once a slew or park started.
+         * The status is read right away, so do not use it for guide pulses: that read would compete with the end of
+         * the pulse for the device.
+         * @param duration boost duration in milliseconds.
+         */
+        void boostPolling(uint32_t duration);
+
         // Slew Rate
         ISwitchVectorProperty SlewRateSP;
         ISwitch *SlewRateS {nullptr};
@@ -909,6 +930,7 @@ class Telescope : public DefaultDevice
 
     private:
         bool processTimeInfo(const char *utc, const char *offset);
+        void updatePollSchedule();
         bool processLocationInfo(double latitude, double longitude, double elevation);
         void triggerSnoop(const char *driverName, const char *propertyName);
 
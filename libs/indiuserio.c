@@ -23,6 +23,7 @@
 #include "base64.h"
 
 #include <stdlib.h>
+#include <string.h>
 
 static void s_userio_xml_message_vprintf(const userio *io, void *user, const char *fmt, va_list ap)
 {
@@ -38,6 +39,19 @@ static void s_userio_xml_message_vprintf(const userio *io, void *user, const cha
 }
 
 
+static int s_userio_write_all(const userio *io, void *user, const char *data, size_t count)
+{
+    while (count > 0)
+    {
+        size_t wr = userio_write(io, user, data, count);
+        if (wr == 0 || wr > count)
+            return 0;
+        data  += wr;
+        count -= wr;
+    }
+    return 1;
+}
+
 void IUUserIONumberContext(const userio *io, void *user, const INumberVectorProperty *nvp)
 {
     for (int i = 0; i < nvp->nnp; i++)
@@ -132,27 +146,32 @@ void IUUserIOBLOBContextOne(
         userio_prints    (io, user, "    format='");
         userio_xml_escape(io, user, format);
         userio_prints    (io, user, "'>\n");
+
+        // Lines of 72 characters are gathered in a block, so the payload goes out in a few large writes
+        // rather than two writes per line, each of which may be a system call.
+        char block[64 * 73];
+        size_t used    = 0;
         size_t written = 0;
 
         while ((int)written < l)
         {
-            size_t towrite = ((l - written) > 72) ? 72 : l - written;
-            size_t wr      = userio_write(io, user, encblob + written, towrite);
+            size_t line = ((l - written) > 72) ? 72 : l - written;
+            memcpy(block + used, encblob + written, line);
+            used += line;
+            block[used++] = '\n';
+            written += line;
 
-            if (wr == 0)
+            if (used + 73 > sizeof(block) || (int)written == l)
             {
-                free(encblob);
-                return;
+                if (!s_userio_write_all(io, user, block, used))
+                {
+                    free(encblob);
+                    return;
+                }
+                used = 0;
             }
-
-            written += wr;
-            if ((written % 72) == 0)
-                userio_putc(io, user, '\n');
         }
 
-        if ((written % 72) != 0)
-            userio_putc(io, user, '\n');
-
         free(encblob);
     }
 
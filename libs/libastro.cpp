@@ -39,6 +39,7 @@
 #include <libnova/aberration.h>
 #include <libnova/transform.h>
 #include <libnova/nutation.h>
+#include <libnova/sidereal_time.h>
 
 namespace INDI
 {
@@ -168,5 +169,91 @@ void HorizontalToEquatorial(IHorizontalCoordinates *object, IGeographicCoordinat
 
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////
+/// rotation from the equatorial frame (x to RA 0, z to the pole) to the horizontal frame of
+/// libnova (x to the south, y to the west, z to the zenith) for the observer and epoch
+//////////////////////////////////////////////////////////////////////////////////////////////
+static void horizontalRotation(IGeographicCoordinates *observer, double JD, double rotation[3][3])
+{
+    double longitude = observer->longitude > 180 ? observer->longitude - 360 : observer->longitude;
+    double lst = ln_get_apparent_sidereal_time(JD) * M_PI / 12.0 + DEG_TO_RAD(longitude);
+    double latitude = DEG_TO_RAD(observer->latitude);
+
+    double sinLst = sin(lst), cosLst = cos(lst);
+    double sinLat = sin(latitude), cosLat = cos(latitude);
+
+    // hour angle H = LST - RA, then equ 12.5 and 12.6 as vector transformations
+    rotation[0][0] = sinLat * cosLst;
+    rotation[0][1] = sinLat * sinLst;
+    rotation[0][2] = -cosLat;
+    rotation[1][0] = sinLst;
+    rotation[1][1] = -cosLst;
+    rotation[1][2] = 0;
+    rotation[2][0] = cosLat * cosLst;
+    rotation[2][1] = cosLat * sinLst;
+    rotation[2][2] = sinLat;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+///
+//////////////////////////////////////////////////////////////////////////////////////////////
+void EquatorialToHorizontal(const IEquatorialCoordinates *objects, size_t count, IGeographicCoordinates *observer,
+                            double JD, IHorizontalCoordinates *positions)
+{
+    double r[3][3];
+    horizontalRotation(observer, JD, r);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        double ra = DEG_TO_RAD(objects[i].rightascension * 15.0);
+        double dec = DEG_TO_RAD(objects[i].declination);
+        double cosDec = cos(dec);
+        double x = cosDec * cos(ra), y = cosDec * sin(ra), z = sin(dec);
+
+        double south = r[0][0] * x + r[0][1] * y + r[0][2] * z;
+        double west  = r[1][0] * x + r[1][1] * y;
+        double up    = r[2][0] * x + r[2][1] * y + r[2][2] * z;
+
+        // same handling of the zenith and nadir as libnova
+        if (sqrt(south * south + west * west) < 1e-5)
+        {
+            positions[i].azimuth = objects[i].declination > 0 ? 0 : 180;
+            positions[i].altitude = (objects[i].declination > 0) == (observer->latitude > 0) ? 90 : -90;
+            continue;
+        }
+
+        positions[i].azimuth = range360(180 + RAD_TO_DEG(atan2(west, south)));
+        positions[i].altitude = RAD_TO_DEG(asin(fmin(1, fmax(-1, up))));
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+///
+//////////////////////////////////////////////////////////////////////////////////////////////
+void HorizontalToEquatorial(const IHorizontalCoordinates *objects, size_t count, IGeographicCoordinates *observer,
+                            double JD, IEquatorialCoordinates *positions)
+{
+    double r[3][3];
+    horizontalRotation(observer, JD, r);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        // INDI azimuth is measured from the north, libnova azimuth from the south
+        double azimuth = objects[i].azimuth + 180;
+        double az = DEG_TO_RAD(azimuth);
+        double alt = DEG_TO_RAD(objects[i].altitude);
+        double cosAlt = cos(alt);
+        double south = cosAlt * cos(az), west = cosAlt * sin(az), up = sin(alt);
+
+        // the rotation is orthonormal, its inverse is its transpose
+        double x = r[0][0] * south + r[1][0] * west + r[2][0] * up;
+        double y = r[0][1] * south + r[1][1] * west + r[2][1] * up;
+        double z = r[0][2] * south + r[2][2] * up;
+
+        positions[i].rightascension = range360(RAD_TO_DEG(atan2(y, x))) / 15.0;
+        positions[i].declination = RAD_TO_DEG(asin(fmin(1, fmax(-1, z))));
+    }
+}
+
 
 }
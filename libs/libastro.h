@@ -30,6 +30,8 @@
 
 #include <libnova/utility.h>
 
+#include <cstddef>
+
 namespace INDI
 {
 
@@ -115,6 +117,30 @@ void EquatorialToHorizontal(IEquatorialCoordinates *object, IGeographicCoordinat
 void HorizontalToEquatorial(IHorizontalCoordinates *object, IGeographicCoordinates *observer, double JD,
                             IEquatorialCoordinates *position);
 
+/**
+ * @brief EquatorialToHorizontal Calculate horizontal coordinates of several objects for the same observer and epoch.
+ * @param objects Equatorial Object Coordinates in INDI standaard (RA Hours, DE degrees).
+ * @param count Number of objects.
+ * @param observer Observer Location in INDI Standard (Longitude 0 to 360 Increasing Eastward)
+ * @param JD Julian Date
+ * @param positions Calculated Horizontal Coordinates, count elements.
+ * @note Same results as the single object version, the sidereal time and the rotation to the observer horizon are
+ * computed once for all objects.
+ */
+void EquatorialToHorizontal(const IEquatorialCoordinates *objects, size_t count, IGeographicCoordinates *observer,
+                            double JD, IHorizontalCoordinates *positions);
+
+/**
+ * @brief HorizontalToEquatorial Calculate Equatorial EOD Coordinates of several objects for the same observer and epoch.
+ * @param objects Horizontal Object Coordinates
+ * @param count Number of objects.
+ * @param observer Observer Location in INDI Standard (Longitude 0 to 360 Increasing Eastward)
+ * @param JD Julian Date
+ * @param positions Calculated Equatorial Coordinates in INDI standards (RA hours, DE degrees), count elements.
+ */
+void HorizontalToEquatorial(const IHorizontalCoordinates *objects, size_t count, IGeographicCoordinates *observer,
+                            double JD, IEquatorialCoordinates *positions);
+
 /**
 * \brief ln_get_equ_nut applies or removes nutation in place for the epoch JD
 * \param posn position, nutation is applied or removed in place
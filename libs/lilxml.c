@@ -68,6 +68,7 @@ static void appendString(String *sp, const char *str);
 static void freeString(String *sp);
 static void newString(String *sp);
 static void *moremem(void *old, int n);
+static void dirtyXMLEle(XMLEle *ep);
 
 typedef enum {
     LOOK4START = 0, /* looking for first element start */
@@ -114,6 +115,8 @@ struct xml_ele_
     int eit;           /* used to iterate over el[] */
     String pcdata;     /* character data in this element */
     int pcdata_hasent; /* 1 if pcdata contains an entity char*/
+    int prl;           /* cached sprlXMLEle() at level prlevel, 0 if unknown */
+    int prlevel;       /* level prl was computed for */
 };
 
 /* internal representation of an attribute */
@@ -128,6 +131,17 @@ struct xml_att_
  */
 static char entities[] = "&<>'\"";
 
+/* entity sequence of each character in entities[], indexed by character */
+typedef struct
+{
+    const char *s; /* entity sequence, NULL if the character is written as is */
+    int l;         /* strlen(s) */
+} Entity;
+static const Entity entitymap[256] = {
+    ['&'] = { "&amp;", 5 }, ['<'] = { "&lt;", 4 }, ['>'] = { "&gt;", 4 },
+    ['\''] = { "&apos;", 6 }, ['"'] = { "&quot;", 6 },
+};
+
 /* default memory managers, override with lilxmlMalloc() */
 static void *(*mymalloc)(size_t size)             = malloc;
 static void *(*myrealloc)(void *ptr, size_t size) = realloc;
@@ -200,6 +214,7 @@ void delXMLEle(XMLEle *ep)
             if (pe->el[i] == ep)
             {
                 memmove(&pe->el[i], &pe->el[i + 1], (--pe->nel - i) * sizeof(XMLEle *));
+                dirtyXMLEle(pe);
                 break;
             }
         }
@@ -650,6 +665,7 @@ void appXMLEle(XMLEle *ep, XMLEle *newep)
 {
     ep->el            = (XMLEle **)moremem(ep->el, (ep->nel + 1) * sizeof(XMLEle *));
     ep->el[ep->nel++] = newep;
+    dirtyXMLEle(ep);
 }
 
 /* set the pcdata of the given element */
@@ -658,6 +674,7 @@ void editXMLEle(XMLEle *ep, const char *pcdata)
     freeString(&ep->pcdata);
     appendString(&ep->pcdata, pcdata);
     ep->pcdata_hasent = (strpbrk(pcdata, entities) != NULL);
+    dirtyXMLEle(ep);
 }
 
 /* add an attribute to the given XML element */
@@ -666,6 +683,7 @@ XMLAtt *addXMLAtt(XMLEle *ep, const char *name, const char *valu)
     XMLAtt *ap = growAtt(ep);
     appendString(&ap->name, name);
     appendString(&ap->valu, valu);
+    dirtyXMLEle(ep);
     return (ap);
 }
 
@@ -680,6 +698,7 @@ void rmXMLAtt(XMLEle *ep, const char *name)
         {
             freeAtt(ep->at[i]);
             memmove(&ep->at[i], &ep->at[i + 1], (--ep->nat - i) * sizeof(XMLAtt *));
+            dirtyXMLEle(ep);
             return;
         }
     }
@@ -690,6 +709,58 @@ void editXMLAtt(XMLAtt *ap, const char *str)
 {
     freeString(&ap->valu);
     appendString(&ap->valu, str);
+    dirtyXMLEle(ap->ce);
+}
+
+/* number of bytes of the sl bytes at s once entities are expanded */
+static int entityLen(const char *s, int sl)
+{
+    const unsigned char *u = (const unsigned char *)s;
+    int l = sl;
+    int i;
+
+    for (i = 0; i < sl; i++)
+        if (entitymap[u[i]].s)
+            l += entitymap[u[i]].l - 1;
+    return (l);
+}
+
+/* copy the sl bytes at s to d expanding entities, runs without any are copied
+ * in one go. return pointer to the end of the copy in d.
+ */
+static char *entityCpy(char *d, const char *s, int sl)
+{
+    const char *run = s;
+    const char *end = s + sl;
+
+    for (; s < end; s++)
+    {
+        const Entity *ent = &entitymap[(unsigned char)*s];
+        if (ent->s)
+        {
+            memcpy(d, run, s - run);
+            d += s - run;
+            memcpy(d, ent->s, ent->l);
+            d += ent->l;
+            run = s + 1;
+        }
+    }
+    memcpy(d, run, end - run);
+    return (d + (end - run));
+}
+
+/* copy the sl bytes at s to d, return pointer to the end of the copy in d */
+static char *strCpy(char *d, const char *s, int sl)
+{
+    memcpy(d, s, sl);
+    return (d + sl);
+}
+
+/* forget the cached print length of ep and of the elements containing it */
+static void dirtyXMLEle(XMLEle *ep)
+{
+    for (; ep; ep = ep->pe)
+        ep->prl = 0;
 }
 
 /* sample print ep to fp
@@ -697,34 +768,105 @@ void editXMLAtt(XMLAtt *ap, const char *str)
  */
 #define PRINDENT 4 /* sample print indent each level */
 void prXMLEle(FILE *fp, XMLEle *ep, int level)
+{
+    char *buf;
+    int l;
+
+    /* same format as sprXMLEle(), written with a single fwrite */
+    l   = sprlXMLEle(ep, level);
+    buf = (char *)(*mymalloc)(l + 1);
+    if (buf)
+    {
+        fwrite(buf, 1, sprXMLEle(buf, ep, level), fp);
+        (*myfree)(buf);
+    }
+}
+
+/* segments being filled by sprsXMLEle() */
+typedef struct
+{
+    XMLSegment *seg; /* next segment */
+    char *start;     /* start of the current text segment */
+    int minpcdata;   /* pcdata at least this long is referenced in place */
+} SegPrint;
+
+/* return 1 if the pcdata of ep is printed as a segment of its own */
+static int isSegPcdata(XMLEle *ep, int minpcdata)
+{
+    return (!ep->pcdata_hasent && ep->pcdata.sl >= minpcdata);
+}
+
+/* print ep to s, return pointer to the end of the output in s.
+ * if sp, large pcdata is referenced as a segment instead of being copied.
+ */
+static char *sprXMLEleEnd(char *s, XMLEle *ep, int level, SegPrint *sp)
 {
     int indent = level * PRINDENT;
     int i;
 
-    fprintf(fp, "%*s<%s", indent, "", ep->tag.s);
+    memset(s, ' ', indent);
+    s    += indent;
+    *s++ = '<';
+    s    = strCpy(s, ep->tag.s, ep->tag.sl);
     for (i = 0; i < ep->nat; i++)
-        fprintf(fp, " %s=\"%s\"", ep->at[i]->name.s, entityXML(ep->at[i]->valu.s));
+    {
+        XMLAtt *ap = ep->at[i];
+        *s++ = ' ';
+        s    = strCpy(s, ap->name.s, ap->name.sl);
+        *s++ = '=';
+        *s++ = '"';
+        s    = entityCpy(s, ap->valu.s, ap->valu.sl);
+        *s++ = '"';
+    }
     if (ep->nel > 0)
     {
-        fprintf(fp, ">\n");
+        *s++ = '>';
+        *s++ = '\n';
         for (i = 0; i < ep->nel; i++)
-            prXMLEle(fp, ep->el[i], level + 1);
+            s = sprXMLEleEnd(s, ep->el[i], level + 1, sp);
     }
     if (ep->pcdata.sl > 0)
     {
         if (ep->nel == 0)
-            fprintf(fp, ">\n");
-        if (ep->pcdata_hasent)
-            fprintf(fp, "%s", entityXML(ep->pcdata.s));
+        {
+            *s++ = '>';
+            *s++ = '\n';
+        }
+        if (sp && isSegPcdata(ep, sp->minpcdata))
+        {
+            sp->seg->s = sp->start;
+            sp->seg->l = s - sp->start;
+            sp->seg++;
+            sp->seg->s = ep->pcdata.s;
+            sp->seg->l = ep->pcdata.sl;
+            sp->seg++;
+            sp->start = s;
+        }
+        else if (ep->pcdata_hasent)
+            s = entityCpy(s, ep->pcdata.s, ep->pcdata.sl);
         else
-            fprintf(fp, "%s", ep->pcdata.s);
+            s = strCpy(s, ep->pcdata.s, ep->pcdata.sl);
         if (ep->pcdata.s[ep->pcdata.sl - 1] != '\n')
-            fprintf(fp, "\n");
+            *s++ = '\n';
     }
     if (ep->nel > 0 || ep->pcdata.sl > 0)
-        fprintf(fp, "%*s</%s>\n", indent, "", ep->tag.s);
+    {
+        memset(s, ' ', indent);
+        s    += indent;
+        *s++ = '<';
+        *s++ = '/';
+        s    = strCpy(s, ep->tag.s, ep->tag.sl);
+        *s++ = '>';
+        *s++ = '\n';
+    }
     else
-        fprintf(fp, "/>\n");
+    {
+        *s++ = '/';
+        *s++ = '>';
+        *s++ = '\n';
+    }
+
+    return (s);
 }
 
 /* sample print ep to string s.
@@ -734,43 +876,69 @@ void prXMLEle(FILE *fp, XMLEle *ep, int level)
  */
 int sprXMLEle(char *s, XMLEle *ep, int level)
 {
-    int indent = level * PRINDENT;
-    int sl     = 0;
+    char *end = sprXMLEleEnd(s, ep, level, NULL);
+
+    *end = '\0';
+    return (end - s);
+}
+
+/* print ep as segments to string s and segs.
+ * N.B. s must be at least as large as that reported by sprslXMLEle()+1.
+ * return number of segments
+ */
+int sprsXMLEle(char *s, XMLEle *ep, int level, int minpcdata, XMLSegment segs[])
+{
+    SegPrint sp;
+    char *end;
+
+    sp.seg       = segs;
+    sp.start     = s;
+    sp.minpcdata = minpcdata > 0 ? minpcdata : 1;
+    end          = sprXMLEleEnd(s, ep, level, &sp);
+    *end         = '\0';
+
+    /* closing text segment */
+    sp.seg->s = sp.start;
+    sp.seg->l = end - sp.start;
+    sp.seg++;
+
+    return (sp.seg - segs);
+}
+
+/* return total length of the pcdata referenced in place by sprsXMLEle() in ep and its children,
+ * add the number of such pcdata to *npcdata.
+ */
+static int segPcdataLen(XMLEle *ep, int minpcdata, int *npcdata)
+{
+    int l = 0;
     int i;
 
-    sl += sprintf(s + sl, "%*s<%s", indent, "", ep->tag.s);
-    for (i = 0; i < ep->nat; i++)
-        sl += sprintf(s + sl, " %s=\"%s\"", ep->at[i]->name.s, entityXML(ep->at[i]->valu.s));
-    if (ep->nel > 0)
+    if (ep->pcdata.sl > 0 && isSegPcdata(ep, minpcdata))
     {
-        sl += sprintf(s + sl, ">\n");
-        for (i = 0; i < ep->nel; i++)
-            sl += sprXMLEle(s + sl, ep->el[i], level + 1);
-    }
-    if (ep->pcdata.sl > 0)
-    {
-        if (ep->nel == 0)
-            sl += sprintf(s + sl, ">\n");
-        if (ep->pcdata_hasent)
-            sl += sprintf(s + sl, "%s", entityXML(ep->pcdata.s));
-        else
-        {
-            strcpy(s + sl, ep->pcdata.s);
-            sl += ep->pcdata.sl;
-        }
-        if (ep->pcdata.s[ep->pcdata.sl - 1] != '\n')
-            sl += sprintf(s + sl, "\n");
+        l += ep->pcdata.sl;
+        (*npcdata)++;
     }
-    if (ep->nel > 0 || ep->pcdata.sl > 0)
-        sl += sprintf(s + sl, "%*s</%s>\n", indent, "", ep->tag.s);
-    else
-        sl += sprintf(s + sl, "/>\n");
+    for (i = 0; i < ep->nel; i++)
+        l += segPcdataLen(ep->el[i], minpcdata, npcdata);
 
-    return (sl);
+    return (l);
+}
+
+/* return number of bytes in a string guaranteed able to hold the text of sprsXMLEle(ep) (sans trailing \0),
+ * set *nsegs to its number of segments.
+ */
+int sprslXMLEle(XMLEle *ep, int level, int minpcdata, int *nsegs)
+{
+    int npcdata = 0;
+    int l       = sprlXMLEle(ep, level) - segPcdataLen(ep, minpcdata > 0 ? minpcdata : 1, &npcdata);
+
+    *nsegs = 2 * npcdata + 1;
+    return (l);
 }
 
 /* return number of bytes in a string guaranteed able to hold result of
  * sprXLMEle(ep) (sans trailing \0).
+ * the result is cached in ep until it or one of its children is edited.
  * N.B. set level = 0 on first call
  */
 int sprlXMLEle(XMLEle *ep, int level)
@@ -779,9 +947,12 @@ int sprlXMLEle(XMLEle *ep, int level)
     int l      = 0;
     int i;
 
+    if (ep->prl > 0 && ep->prlevel == level)
+        return (ep->prl);
+
     l += indent + 1 + ep->tag.sl;
     for (i = 0; i < ep->nat; i++)
-        l += ep->at[i]->name.sl + 4 + strlen(entityXML(ep->at[i]->valu.s));
+        l += ep->at[i]->name.sl + 4 + entityLen(ep->at[i]->valu.s, ep->at[i]->valu.sl);
 
     if (ep->nel > 0)
     {
@@ -794,7 +965,7 @@ int sprlXMLEle(XMLEle *ep, int level)
         if (ep->nel == 0)
             l += 2;
         if (ep->pcdata_hasent)
-            l += strlen(entityXML(ep->pcdata.s));
+            l += entityLen(ep->pcdata.s, ep->pcdata.sl);
         else
             l += ep->pcdata.sl;
         if (ep->pcdata.s[ep->pcdata.sl - 1] != '\n')
@@ -805,6 +976,8 @@ int sprlXMLEle(XMLEle *ep, int level)
     else
         l += 3;
 
+    ep->prl     = l;
+    ep->prlevel = level;
     return (l);
 }
 
@@ -815,42 +988,11 @@ int sprlXMLEle(XMLEle *ep, int level)
 char *entityXML(char *s)
 {
     static char *malbuf;
-    int nmalbuf = 0;
-    char *sret = NULL;
-    char *ep = NULL;
-
-    /* scan for each entity, if any */
-    for (sret = s; (ep = strpbrk(s, entities)) != NULL; s = ep + 1)
-    {
-        /* found another entity, copy preceding to malloced buffer */
-        int nnew = ep - s; /* all but entity itself */
-        sret = malbuf = moremem(malbuf, nmalbuf + nnew + 10);
-        memcpy(malbuf + nmalbuf, s, nnew);
-        nmalbuf += nnew;
-
-        /* replace with entity encoding */
-        switch (*ep)
-        {
-            case '&':
-                nmalbuf += sprintf(malbuf + nmalbuf, "&amp;");
-                break;
-            case '<':
-                nmalbuf += sprintf(malbuf + nmalbuf, "&lt;");
-                break;
-            case '>':
-                nmalbuf += sprintf(malbuf + nmalbuf, "&gt;");
-                break;
-            case '\'':
-                nmalbuf += sprintf(malbuf + nmalbuf, "&apos;");
-                break;
-            case '"':
-                nmalbuf += sprintf(malbuf + nmalbuf, "&quot;");
-                break;
-        }
-    }
+    int sl = strlen(s);
+    int l  = entityLen(s, sl);
 
     /* return s if no entities, else malloc cleaned-up copy */
-    if (sret == s)
+    if (l == sl)
     {
         /* using s, so free any alloced memory from last time */
         if (malbuf)
@@ -860,15 +1002,10 @@ char *entityXML(char *s)
         }
         return s;
     }
-    else
-    {
-        /* put remaining part of s into malbuf */
-        int nleft = strlen(s) + 1; /* include \0 */
-        sret = malbuf = moremem(malbuf, nmalbuf + nleft);
-        memcpy(malbuf + nmalbuf, s, nleft);
-    }
 
-    return (sret);
+    malbuf = moremem(malbuf, l + 1);
+    *entityCpy(malbuf, s, sl) = '\0';
+    return (malbuf);
 }
 
 /* if ent is a recognized xml entity sequence, set *cp to char and return 1
@@ -1183,6 +1320,7 @@ static XMLEle *growEle(XMLEle *pe)
     {
         pe->el            = (XMLEle **)moremem(pe->el, (pe->nel + 1) * sizeof(XMLEle *));
         pe->el[pe->nel++] = newe;
+        dirtyXMLEle(pe);
     }
 
     return (newe);
@@ -1345,6 +1483,225 @@ int main(int ac, char *av[])
 }
 #endif
 
+#if defined(BENCH_LILXML)
+
+/* to build a stand-alone commandline benchmark program:
+ *   cc -O2 -DBENCH_LILXML -Ilibs -o lilxml libs/lilxml.c
+ * run ./lilxml [iterations] to compare the time to size and print typical
+ * outbound messages with the previous sprintf based serializer.
+ */
+
+#include <time.h>
+
+/* previous serializer, kept here for comparison */
+static char *oldEntityXML(char *s)
+{
+    static char *malbuf;
+    int nmalbuf = 0;
+    char *sret  = NULL;
+    char *ep    = NULL;
+
+    for (sret = s; (ep = strpbrk(s, entities)) != NULL; s = ep + 1)
+    {
+        int nnew = ep - s;
+        sret = malbuf = moremem(malbuf, nmalbuf + nnew + 10);
+        memcpy(malbuf + nmalbuf, s, nnew);
+        nmalbuf += nnew;
+        nmalbuf += sprintf(malbuf + nmalbuf, "%s", entitymap[(unsigned char)*ep].s);
+    }
+    if (sret == s)
+        return s;
+    sret = malbuf = moremem(malbuf, nmalbuf + strlen(s) + 1);
+    memcpy(malbuf + nmalbuf, s, strlen(s) + 1);
+    return (sret);
+}
+
+static int oldSprXMLEle(char *s, XMLEle *ep, int level)
+{
+    int indent = level * PRINDENT;
+    int sl     = 0;
+    int i;
+
+    sl += sprintf(s + sl, "%*s<%s", indent, "", ep->tag.s);
+    for (i = 0; i < ep->nat; i++)
+        sl += sprintf(s + sl, " %s=\"%s\"", ep->at[i]->name.s, oldEntityXML(ep->at[i]->valu.s));
+    if (ep->nel > 0)
+    {
+        sl += sprintf(s + sl, ">\n");
+        for (i = 0; i < ep->nel; i++)
+            sl += oldSprXMLEle(s + sl, ep->el[i], level + 1);
+    }
+    if (ep->pcdata.sl > 0)
+    {
+        if (ep->nel == 0)
+            sl += sprintf(s + sl, ">\n");
+        if (ep->pcdata_hasent)
+            sl += sprintf(s + sl, "%s", oldEntityXML(ep->pcdata.s));
+        else
+        {
+            strcpy(s + sl, ep->pcdata.s);
+            sl += ep->pcdata.sl;
+        }
+        if (ep->pcdata.s[ep->pcdata.sl - 1] != '\n')
+            sl += sprintf(s + sl, "\n");
+    }
+    if (ep->nel > 0 || ep->pcdata.sl > 0)
+        sl += sprintf(s + sl, "%*s</%s>\n", indent, "", ep->tag.s);
+    else
+        sl += sprintf(s + sl, "/>\n");
+    return (sl);
+}
+
+static int oldSprlXMLEle(XMLEle *ep, int level)
+{
+    int indent = level * PRINDENT;
+    int l      = 0;
+    int i;
+
+    l += indent + 1 + ep->tag.sl;
+    for (i = 0; i < ep->nat; i++)
+        l += ep->at[i]->name.sl + 4 + strlen(oldEntityXML(ep->at[i]->valu.s));
+    if (ep->nel > 0)
+    {
+        l += 2;
+        for (i = 0; i < ep->nel; i++)
+            l += oldSprlXMLEle(ep->el[i], level + 1);
+    }
+    if (ep->pcdata.sl > 0)
+    {
+        if (ep->nel == 0)
+            l += 2;
+        if (ep->pcdata_hasent)
+            l += strlen(oldEntityXML(ep->pcdata.s));
+        else
+            l += ep->pcdata.sl;
+        if (ep->pcdata.s[ep->pcdata.sl - 1] != '\n')
+            l += 1;
+    }
+    if (ep->nel > 0 || ep->pcdata.sl > 0)
+        l += indent + 4 + ep->tag.sl;
+    else
+        l += 3;
+    return (l);
+}
+
+static double nowBench(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (ts.tv_sec * 1e6 + ts.tv_nsec / 1e3);
+}
+
+static XMLEle *benchNumberVector(void)
+{
+    XMLEle *root = addXMLEle(NULL, "setNumberVector");
+    char name[32], value[32];
+    int i;
+
+    addXMLAtt(root, "device", "CCD Simulator");
+    addXMLAtt(root, "name", "CCD_TEMPERATURE");
+    addXMLAtt(root, "state", "Busy");
+    addXMLAtt(root, "timeout", "60");
+    addXMLAtt(root, "timestamp", "2022-03-04T21:12:05");
+    for (i = 0; i < 8; i++)
+    {
+        XMLEle *ep = addXMLEle(root, "oneNumber");
+        sprintf(name, "AXIS_%d", i);
+        sprintf(value, "%.6f", i * 1.234567);
+        addXMLAtt(ep, "name", name);
+        editXMLEle(ep, value);
+    }
+    return (root);
+}
+
+static XMLEle *benchTextVector(void)
+{
+    XMLEle *root = addXMLEle(NULL, "defTextVector");
+    int i;
+
+    addXMLAtt(root, "device", "Telescope Simulator");
+    addXMLAtt(root, "name", "DRIVER_INFO");
+    addXMLAtt(root, "label", "Driver Info");
+    addXMLAtt(root, "group", "General Info");
+    addXMLAtt(root, "state", "Idle");
+    addXMLAtt(root, "perm", "ro");
+    for (i = 0; i < 4; i++)
+    {
+        XMLEle *ep = addXMLEle(root, "defText");
+        addXMLAtt(ep, "name", "DRIVER_NAME");
+        addXMLAtt(ep, "label", "Name & <version>");
+        editXMLEle(ep, "Telescope \"Simulator\" & 'friends' <1.0>");
+    }
+    return (root);
+}
+
+static XMLEle *benchBLOBVector(int size)
+{
+    XMLEle *root = addXMLEle(NULL, "setBLOBVector");
+    XMLEle *ep   = addXMLEle(root, "oneBLOB");
+    char *b64    = (char *)malloc(size + 1);
+    char len[32];
+    int i;
+
+    for (i = 0; i < size; i++)
+        b64[i] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/"[i % 64];
+    b64[size] = '\0';
+    sprintf(len, "%d", size);
+    addXMLAtt(root, "device", "CCD Simulator");
+    addXMLAtt(root, "name", "CCD1");
+    addXMLAtt(root, "state", "Ok");
+    addXMLAtt(ep, "name", "CCD1");
+    addXMLAtt(ep, "size", len);
+    addXMLAtt(ep, "format", ".fits");
+    editXMLEle(ep, b64);
+    free(b64);
+    return (root);
+}
+
+static void bench(const char *label, XMLEle *root, int n)
+{
+    int l    = oldSprlXMLEle(root, 0);
+    char *s1 = (char *)malloc(l + 1);
+    char *s2 = (char *)malloc(l + 1);
+    double t0, t1, t2;
+    int i;
+
+    t0 = nowBench();
+    for (i = 0; i < n; i++)
+    {
+        /* size then print, as setMsgXMLEle() in indiserver does */
+        oldSprlXMLEle(root, 0);
+        oldSprXMLEle(s1, root, 0);
+    }
+    t1 = nowBench();
+    for (i = 0; i < n; i++)
+    {
+        /* each message is a new element, nothing cached yet */
+        dirtyXMLEle(root);
+        sprlXMLEle(root, 0);
+        sprXMLEle(s2, root, 0);
+    }
+    t2 = nowBench();
+
+    printf("%-16s %8d bytes  old %9.2f us  new %9.2f us  x%.1f  %s\n", label, l, (t1 - t0) / n, (t2 - t1) / n,
+           (t1 - t0) / (t2 - t1), strcmp(s1, s2) || l != sprlXMLEle(root, 0) ? "MISMATCH" : "same output");
+    free(s1);
+    free(s2);
+    delXMLEle(root);
+}
+
+int main(int ac, char *av[])
+{
+    int n = ac > 1 ? atoi(av[1]) : 100000;
+
+    bench("setNumberVector", benchNumberVector(), n);
+    bench("defTextVector", benchTextVector(), n);
+    bench("setBLOBVector", benchBLOBVector(4 * 1024 * 1024), n / 1000 + 1);
+    return (0);
+}
+
+#endif /* BENCH_LILXML */
+
 #if defined(_MSC_VER)
 #undef snprintf
 #pragma warning(pop)
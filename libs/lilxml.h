@@ -74,6 +74,13 @@ typedef struct xml_att_ XMLAtt;
 typedef struct xml_ele_ XMLEle;
 typedef struct LilXML_ LilXML;
 
+/* one piece of the printed form of an element, see sprsXMLEle() */
+typedef struct
+{
+    const char *s; /* first character of the piece, not \0 terminated */
+    int l;         /* number of characters */
+} XMLSegment;
+
 /**
  * \defgroup lilxmlFunctions XML Functions: Functions to parse, process, and search XML.
  */
@@ -265,10 +272,25 @@ extern void prXMLEle(FILE *fp, XMLEle *e, int level);
 extern int sprXMLEle(char *s, XMLEle *ep, int level);
 
 /** \brief return number of bytes in a string guaranteed able to hold result of sprXLMEle(ep) (sans trailing @\0@).
+*   The result is cached in ep until ep or one of its children is changed with the editing functions.
 *   N.B. set level = 0 on first call.
 */
 extern int sprlXMLEle(XMLEle *ep, int level);
 
+/** \brief print ep like sprXMLEle() as a list of segments, without copying large pcdata.
+*   pcdata of at least minpcdata characters needing no entities is referenced in place in ep instead of being copied
+*   to s, so a large BLOB can be written out without a second copy of it. The text segments point into s, the
+*   pcdata segments point into ep which must then be neither edited nor deleted while segs is in use.
+*   N.B. s must be at least as large as that reported by sprslXMLEle()+1, segs must hold nsegs entries.
+*   \return number of segments filled in segs, whose lengths add up to the length of sprXMLEle().
+*/
+extern int sprsXMLEle(char *s, XMLEle *ep, int level, int minpcdata, XMLSegment segs[]);
+
+/** \brief return number of bytes in a string guaranteed able to hold the text of sprsXMLEle(ep) (sans trailing @\0@).
+*   \param nsegs set to the number of segments sprsXMLEle() fills in.
+*/
+extern int sprslXMLEle(XMLEle *ep, int level, int minpcdata, int *nsegs);
+
 /* install alternatives to malloc/realloc/free */
 extern void indi_xmlMalloc(void *(*newmalloc)(size_t size), void *(*newrealloc)(void *ptr, size_t size),
                            void (*newfree)(void *ptr));
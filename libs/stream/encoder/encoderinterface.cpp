@@ -56,4 +56,14 @@ bool EncoderInterface::setPixelFormat(INDI_PIXEL_FORMAT pixelFormat, uint8_t pix
     this->pixelDepth = pixelDepth;
     return true;
 }
+
+void EncoderInterface::setQuality(int quality)
+{
+    INDI_UNUSED(quality);
+}
+
+void EncoderInterface::setScale(int scale)
+{
+    INDI_UNUSED(scale);
+}
 }
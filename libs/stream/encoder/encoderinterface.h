@@ -54,6 +54,16 @@ class EncoderInterface
 
     virtual bool upload(IBLOB *bp, const uint8_t *buffer, uint32_t nbytes, bool isCompressed=false) = 0;
 
+    /**
+     * @brief setQuality Set the quality of lossy encoders, from 1 to 100. Lossless encoders ignore it.
+     */
+    virtual void setQuality(int quality);
+
+    /**
+     * @brief setScale Set an additional downscale factor of the uploaded frames. Encoders that cannot scale ignore it.
+     */
+    virtual void setScale(int scale);
+
     const char *getName();
 
   protected:
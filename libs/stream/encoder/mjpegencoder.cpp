@@ -22,6 +22,7 @@
 #include "mjpegencoder.h"
 #include "stream/streammanager.h"
 #include "indiccd.h"
+#include <algorithm>
 #include <cmath>
 #include <zlib.h>
 #include <jpeglib.h>
@@ -85,10 +86,26 @@ bool MJPEGEncoder::upload(IBLOB *bp, const uint8_t *buffer, uint32_t nbytes, boo
     // Scale image DOWN by this factor
     // 640 is now selected arbitrary to test mpeg streaming performance
     int scale = std::max(1, static_cast<int>(std::floor(rawWidth / SCALE_WIDTH)));
+    scale = std::min(SCALE_MAX, scale * extraScale);
+
+    const uint8_t *src = buffer;
+    uint16_t width = rawWidth, height = rawHeight;
+    int components = (pixelFormat == INDI_RGB) ? 3 : 1;
+#if JPEG_LIB_VERSION < 70
+    // libjpeg 6.2 and libjpeg-turbo in its default ABI cannot scale while compressing
+    if (scale > 1 && rawWidth >= scale && rawHeight >= scale)
+    {
+        src    = downscale(buffer, components, scale);
+        width  = rawWidth / scale;
+        height = rawHeight / scale;
+        scale  = 1;
+    }
+#endif
+
     if (pixelFormat == INDI_RGB)
-        jpeg_compress_8u_rgb(buffer, rawWidth, rawHeight, rawWidth * 3, scale, jpegBuffer, &bufsize, 85);
+        jpeg_compress_8u_rgb(src, width, height, width * 3, scale, jpegBuffer, &bufsize, jpegQuality);
     else
-        jpeg_compress_8u_gray(buffer, rawWidth, rawHeight, rawWidth, scale, jpegBuffer, &bufsize, 85);
+        jpeg_compress_8u_gray(src, width, height, width, scale, jpegBuffer, &bufsize, jpegQuality);
 
     bp->blob    = jpegBuffer;
     bp->bloblen = bufsize;
@@ -98,6 +115,46 @@ bool MJPEGEncoder::upload(IBLOB *bp, const uint8_t *buffer, uint32_t nbytes, boo
     return true;
 }
 
+void MJPEGEncoder::setQuality(int quality)
+{
+    jpegQuality = std::max(1, std::min(100, quality));
+}
+
+void MJPEGEncoder::setScale(int scale)
+{
+    extraScale = std::max(1, scale);
+}
+
+/* Average each scale x scale block of the raw frame into one pixel, dropping the partial blocks at the edges */
+const uint8_t *MJPEGEncoder::downscale(const uint8_t * src, int components, int scale)
+{
+    int width  = rawWidth / scale;
+    int height = rawHeight / scale;
+    int area   = scale * scale;
+    int stride = rawWidth * components;
+    std::vector<uint32_t> sums(width * components);
+
+    scaledBuffer.resize(width * height * components);
+    uint8_t *dest = scaledBuffer.data();
+
+    for (int y = 0; y < height; y++)
+    {
+        std::fill(sums.begin(), sums.end(), 0);
+        for (int row = 0; row < scale; row++)
+        {
+            const uint8_t *line = src + (y * scale + row) * stride;
+            for (int x = 0; x < width; x++)
+                for (int col = 0; col < scale; col++)
+                    for (int c = 0; c < components; c++)
+                        sums[x * components + c] += line[(x * scale + col) * components + c];
+        }
+        for (int i = 0; i < width * components; i++)
+            *dest++ = static_cast<uint8_t>(sums[i] / area);
+    }
+
+    return scaledBuffer.data();
+}
+
 /*
 FROM: https://svn.csail.mit.edu/rrg_pods/jpeg-utils/
 
@@ -23,13 +23,16 @@
 
 #include "encoderinterface.h"
 
+#include <vector>
+
 namespace INDI
 {
 
 /**
  * @brief The MJPEGEncoder class encodes frames in JPEG format before transmitting them to the client.
  *
- * The quality is now hard-coded at 70 when encoding the JPEG image. Further compression is not supported.
+ * Frames wider than SCALE_WIDTH are downscaled, setScale() downscales them further. The quality defaults to 85 and
+ * may be changed by setQuality(), e.g. by the adaptive preview controller.
  */
 class MJPEGEncoder : public EncoderInterface
 {
@@ -38,6 +41,8 @@ class MJPEGEncoder : public EncoderInterface
         ~MJPEGEncoder();
 
         virtual bool upload(IBLOB *bp, const uint8_t *buffer, uint32_t nbytes, bool isCompressed = false) override;
+        virtual void setQuality(int quality) override;
+        virtual void setScale(int scale) override;
 
     private:
         const char *getDeviceName();
@@ -45,10 +50,17 @@ class MJPEGEncoder : public EncoderInterface
                                    int * destsize, int quality);
         int jpeg_compress_8u_rgb (const uint8_t * src, uint16_t width, uint16_t height, int stride, int scale, uint8_t * dest,
                                   int * destsize, int quality);
+        const uint8_t *downscale(const uint8_t * src, int components, int scale);
         uint8_t *jpegBuffer = nullptr;
+        // Frames averaged down in software when libjpeg cannot scale while compressing
+        std::vector<uint8_t> scaledBuffer;
         uint16_t jpegBufferSize = 1;
+        int jpegQuality = 85;
+        int extraScale = 1;
 
         static const int SCALE_WIDTH = 640;
+        // libjpeg scales by 1/1 to 1/16
+        static const int SCALE_MAX = 16;
 
 };
 
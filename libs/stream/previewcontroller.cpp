@@ -0,0 +1,208 @@
+/*
+    Copyright (C) 2022 INDI Library Developers
+
+    Preview Controller
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+*/
+
+#include "previewcontroller.h"
+
+#include <algorithm>
+
+namespace INDI
+{
+
+constexpr double PreviewController::WINDOW;
+constexpr int PreviewController::QUIET_WINDOWS;
+constexpr double PreviewController::HIGH_LOAD;
+constexpr double PreviewController::LOW_LOAD;
+constexpr int PreviewController::QUALITY_STEP;
+
+PreviewController::PreviewController()
+{
+    reset();
+}
+
+void PreviewController::setMode(Mode mode)
+{
+    m_Mode = mode;
+    reset();
+}
+
+void PreviewController::setTarget(double bitrate, double latency)
+{
+    m_TargetBitrate = std::max(1.0, bitrate);
+    m_TargetLatency = std::max(0.001, latency);
+    m_QuietWindows = 0;
+}
+
+void PreviewController::setLimits(const Limits &limits)
+{
+    m_Limits.minQuality = std::max(1, std::min(100, limits.minQuality));
+    m_Limits.maxQuality = std::max(m_Limits.minQuality, std::min(100, limits.maxQuality));
+    m_Limits.maxScale   = std::max(1, limits.maxScale);
+    m_Limits.maxSkip    = std::max(0, limits.maxSkip);
+
+    if (m_Mode == MODE_FIXED)
+        reset();
+    else
+        clampPoint();
+}
+
+void PreviewController::reset()
+{
+    m_Point.quality = m_Limits.maxQuality;
+    m_Point.scale   = 1;
+    m_Point.skip    = 0;
+
+    m_WindowStart = -1;
+    m_WindowBytes = 0;
+    m_WindowUploadTime = 0;
+    m_WindowFrames = 0;
+    m_WindowDropped = 0;
+    m_QuietWindows = 0;
+    m_SkipCounter = 0;
+
+    m_Bitrate = 0;
+    m_Latency = 0;
+    m_TotalDropped = 0;
+}
+
+void PreviewController::clampPoint()
+{
+    m_Point.quality = std::max(m_Limits.minQuality, std::min(m_Limits.maxQuality, m_Point.quality));
+    m_Point.scale   = std::min(m_Limits.maxScale, m_Point.scale);
+    m_Point.skip    = std::min(m_Limits.maxSkip, m_Point.skip);
+}
+
+bool PreviewController::skipFrame()
+{
+    if (m_SkipCounter < m_Point.skip)
+    {
+        m_SkipCounter++;
+        return true;
+    }
+
+    m_SkipCounter = 0;
+    return false;
+}
+
+void PreviewController::dropped()
+{
+    m_WindowDropped++;
+    m_TotalDropped++;
+}
+
+bool PreviewController::update(size_t bytes, double uploadTime, double now)
+{
+    // The first frame opens the window at the start of its upload
+    if (m_WindowStart < 0)
+        m_WindowStart = now - uploadTime;
+
+    m_WindowBytes += bytes;
+    m_WindowUploadTime += uploadTime;
+    m_WindowFrames++;
+
+    const double elapsed = now - m_WindowStart;
+    if (elapsed < WINDOW)
+        return false;
+
+    m_Bitrate = m_WindowBytes / elapsed;
+    m_Latency = m_WindowUploadTime / m_WindowFrames;
+
+    double load = 0;
+    switch (m_Mode)
+    {
+        case MODE_FIXED:
+            break;
+        case MODE_BITRATE:
+            load = m_Bitrate / m_TargetBitrate;
+            break;
+        case MODE_LATENCY:
+            load = m_Latency / m_TargetLatency;
+            break;
+    }
+
+    // Frames piling up behind the upload mean the link is saturated whatever the measurements say
+    if (m_WindowDropped > 0)
+        load = std::max(load, HIGH_LOAD * 2);
+
+    m_WindowStart = now;
+    m_WindowBytes = 0;
+    m_WindowUploadTime = 0;
+    m_WindowFrames = 0;
+    m_WindowDropped = 0;
+
+    if (m_Mode == MODE_FIXED)
+        return true;
+
+    if (load > HIGH_LOAD)
+    {
+        m_QuietWindows = 0;
+        stepDown();
+    }
+    else if (load < LOW_LOAD)
+    {
+        if (++m_QuietWindows >= QUIET_WINDOWS)
+        {
+            m_QuietWindows = 0;
+            stepUp();
+        }
+    }
+    else
+        m_QuietWindows = 0;
+
+    return true;
+}
+
+void PreviewController::stepDown()
+{
+    if (m_Point.quality > m_Limits.minQuality)
+    {
+        m_Point.quality = std::max(m_Limits.minQuality, m_Point.quality - QUALITY_STEP);
+        return;
+    }
+
+    if (m_Point.scale < m_Limits.maxScale)
+    {
+        m_Point.scale = std::min(m_Limits.maxScale, m_Point.scale * 2);
+        return;
+    }
+
+    if (m_Point.skip < m_Limits.maxSkip)
+        m_Point.skip++;
+}
+
+void PreviewController::stepUp()
+{
+    if (m_Point.skip > 0)
+    {
+        m_Point.skip--;
+        return;
+    }
+
+    if (m_Point.scale > 1)
+    {
+        m_Point.scale = std::max(1, m_Point.scale / 2);
+        return;
+    }
+
+    if (m_Point.quality < m_Limits.maxQuality)
+        m_Point.quality = std::min(m_Limits.maxQuality, m_Point.quality + QUALITY_STEP / 2);
+}
+
+}
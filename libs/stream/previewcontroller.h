@@ -0,0 +1,173 @@
+/*
+    Copyright (C) 2022 INDI Library Developers
+
+    Preview Controller
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace INDI
+{
+
+/**
+ * @brief The PreviewController class adapts the preview stream to a bandwidth or latency budget.
+ *
+ * Every uploaded frame reports its encoded size and upload time, and every frame the preview could not keep up with
+ * is reported as dropped. Once per measurement window the load, i.e. the measured bitrate or mean upload time over
+ * its target, decides whether the preview steps down or up the quality ladder:
+ *
+ * - stepping down lowers the JPEG quality first, then doubles the downscale factor, then skips more frames.
+ * - stepping up undoes the same steps in the reverse order.
+ *
+ * Dropped frames always count as an overloaded link. Stepping up requires several quiet windows in a row so the
+ * operating point does not oscillate around the target.
+ */
+class PreviewController
+{
+    public:
+        enum Mode
+        {
+            MODE_FIXED,     /*!< Best operating point within limits, no adaptation */
+            MODE_BITRATE,   /*!< Keep the upload bitrate under the target */
+            MODE_LATENCY    /*!< Keep the mean upload time under the target */
+        };
+
+        struct Limits
+        {
+            int minQuality {30};
+            int maxQuality {85};
+            int maxScale {4};
+            int maxSkip {10};
+        };
+
+        struct OperatingPoint
+        {
+            int quality {85};
+            int scale {1};
+            int skip {0};
+        };
+
+    public:
+        PreviewController();
+
+        void setMode(Mode mode);
+        Mode mode() const
+        {
+            return m_Mode;
+        }
+
+        /**
+         * @brief setTarget Set the budget the controller aims for.
+         * @param bitrate Upload bitrate in bytes per second, used in MODE_BITRATE.
+         * @param latency Mean upload time of a frame in seconds, used in MODE_LATENCY.
+         */
+        void setTarget(double bitrate, double latency);
+
+        /**
+         * @brief setLimits Set the range of the operating point. Encoders without a quality or scale setting use
+         * minQuality == maxQuality and maxScale == 1 so only frame skipping is adapted.
+         */
+        void setLimits(const Limits &limits);
+
+        /** @brief reset Restart measurements from the best operating point within limits. */
+        void reset();
+
+        /**
+         * @brief skipFrame Called for every frame offered to the preview.
+         * @return True if the frame should not be uploaded to follow the current frame skip.
+         */
+        bool skipFrame();
+
+        /**
+         * @brief update Account an uploaded frame.
+         * @param bytes Encoded size of the frame.
+         * @param uploadTime Time spent encoding and sending the frame in seconds.
+         * @param now Monotonic time in seconds.
+         * @return True if the frame closed a measurement window, i.e. the measurements were refreshed and the operating
+         * point may have changed.
+         */
+        bool update(size_t bytes, double uploadTime, double now);
+
+        /** @brief dropped Account a frame the preview had no time to upload. */
+        void dropped();
+
+        const OperatingPoint &operatingPoint() const
+        {
+            return m_Point;
+        }
+
+        /** @return Bitrate in bytes per second measured over the last window. */
+        double bitrate() const
+        {
+            return m_Bitrate;
+        }
+
+        /** @return Mean upload time in seconds measured over the last window. */
+        double latency() const
+        {
+            return m_Latency;
+        }
+
+        /** @return Frames dropped since the last reset. */
+        uint64_t droppedFrames() const
+        {
+            return m_TotalDropped;
+        }
+
+    public:
+        /** Length of a measurement window in seconds */
+        static constexpr double WINDOW = 1.0;
+        /** Number of quiet windows before stepping up */
+        static constexpr int QUIET_WINDOWS = 3;
+        /** Load above which the controller steps down */
+        static constexpr double HIGH_LOAD = 1.0;
+        /** Load under which a window is quiet */
+        static constexpr double LOW_LOAD = 0.6;
+        /** JPEG quality change of a step down, steps up are half of it */
+        static constexpr int QUALITY_STEP = 10;
+
+    private:
+        void stepDown();
+        void stepUp();
+        void clampPoint();
+
+        Mode m_Mode {MODE_FIXED};
+        Limits m_Limits;
+        OperatingPoint m_Point;
+        double m_TargetBitrate {1000000};
+        double m_TargetLatency {0.2};
+
+        // Current window
+        double m_WindowStart {-1};
+        size_t m_WindowBytes {0};
+        double m_WindowUploadTime {0};
+        int m_WindowFrames {0};
+        int m_WindowDropped {0};
+        int m_QuietWindows {0};
+
+        int m_SkipCounter {0};
+
+        double m_Bitrate {0};
+        double m_Latency {0};
+        uint64_t m_TotalDropped {0};
+};
+
+}
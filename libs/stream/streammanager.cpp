@@ -169,6 +169,30 @@ bool StreamManagerPrivate::initProperties()
     LimitsNP[LIMITS_BUFFER_MAX ].fill("LIMITS_BUFFER_MAX",  "Maximum Buffer Size (MB)", "%.0f", 1, 1024*64, 1, 512);
     LimitsNP[LIMITS_PREVIEW_FPS].fill("LIMITS_PREVIEW_FPS", "Maximum Preview FPS",      "%.0f", 1, 120,     1,  10);
     LimitsNP.fill(getDeviceName(), "LIMITS", "Limits", STREAM_TAB, IP_RW, 0, IPS_IDLE);
+
+    // Adaptive preview
+    PreviewControlSP[PREVIEW_FIXED        ].fill("PREVIEW_FIXED",         "Fixed",   ISS_ON);
+    PreviewControlSP[PREVIEW_ADAPT_BITRATE].fill("PREVIEW_ADAPT_BITRATE", "Bitrate", ISS_OFF);
+    PreviewControlSP[PREVIEW_ADAPT_LATENCY].fill("PREVIEW_ADAPT_LATENCY", "Latency", ISS_OFF);
+    PreviewControlSP.fill(getDeviceName(), "PREVIEW_CONTROL", "Preview Control", STREAM_TAB, IP_RW, ISR_1OFMANY, 0, IPS_IDLE);
+
+    PreviewSettingsNP[PREVIEW_TARGET_BITRATE].fill("PREVIEW_TARGET_BITRATE", "Target Bitrate (kB/s)", "%.0f", 10, 1000000, 100, 1000);
+    PreviewSettingsNP[PREVIEW_TARGET_LATENCY].fill("PREVIEW_TARGET_LATENCY", "Target Latency (s)",    "%.3f", 0.001, 10, 0.01, 0.2);
+    PreviewSettingsNP[PREVIEW_QUALITY_MIN   ].fill("PREVIEW_QUALITY_MIN",    "Minimum Quality",       "%.0f", 1, 100, 5, 30);
+    PreviewSettingsNP[PREVIEW_QUALITY_MAX   ].fill("PREVIEW_QUALITY_MAX",    "Maximum Quality",       "%.0f", 1, 100, 5, 85);
+    PreviewSettingsNP[PREVIEW_SCALE_MAX     ].fill("PREVIEW_SCALE_MAX",      "Maximum Downscale",     "%.0f", 1, 16, 1, 4);
+    PreviewSettingsNP[PREVIEW_SKIP_MAX      ].fill("PREVIEW_SKIP_MAX",       "Maximum Frame Skip",    "%.0f", 0, 100, 1, 10);
+    PreviewSettingsNP.fill(getDeviceName(), "PREVIEW_SETTINGS", "Preview Settings", STREAM_TAB, IP_RW, 0, IPS_IDLE);
+
+    PreviewStatusNP[PREVIEW_QUALITY].fill("PREVIEW_QUALITY", "Quality",        "%.0f", 0, 100, 0, 85);
+    PreviewStatusNP[PREVIEW_SCALE  ].fill("PREVIEW_SCALE",   "Downscale",      "%.0f", 1, 16, 0, 1);
+    PreviewStatusNP[PREVIEW_SKIP   ].fill("PREVIEW_SKIP",    "Frame Skip",     "%.0f", 0, 100, 0, 0);
+    PreviewStatusNP[PREVIEW_BITRATE].fill("PREVIEW_BITRATE", "Bitrate (kB/s)", "%.1f", 0, 1000000, 0, 0);
+    PreviewStatusNP[PREVIEW_LATENCY].fill("PREVIEW_LATENCY", "Latency (s)",    "%.3f", 0, 60, 0, 0);
+    PreviewStatusNP[PREVIEW_DROPPED].fill("PREVIEW_DROPPED", "Dropped Frames", "%.0f", 0, 1e9, 0, 0);
+    PreviewStatusNP.fill(getDeviceName(), "PREVIEW_STATUS", "Preview Status", STREAM_TAB, IP_RO, 0, IPS_IDLE);
+
+    applyPreviewSettings();
     return true;
 }
 
@@ -196,6 +220,9 @@ void StreamManagerPrivate::ISGetProperties(const char *dev)
         currentDevice->defineProperty(EncoderSP);
         currentDevice->defineProperty(RecorderSP);
         currentDevice->defineProperty(LimitsNP);
+        currentDevice->defineProperty(PreviewControlSP);
+        currentDevice->defineProperty(PreviewSettingsNP);
+        currentDevice->defineProperty(PreviewStatusNP);
     }
 }
 
@@ -230,6 +257,9 @@ bool StreamManagerPrivate::updateProperties()
         currentDevice->defineProperty(EncoderSP);
         currentDevice->defineProperty(RecorderSP);
         currentDevice->defineProperty(LimitsNP);
+        currentDevice->defineProperty(PreviewControlSP);
+        currentDevice->defineProperty(PreviewSettingsNP);
+        currentDevice->defineProperty(PreviewStatusNP);
     }
     else
     {
@@ -245,6 +275,9 @@ bool StreamManagerPrivate::updateProperties()
         currentDevice->deleteProperty(EncoderSP.getName());
         currentDevice->deleteProperty(RecorderSP.getName());
         currentDevice->deleteProperty(LimitsNP.getName());
+        currentDevice->deleteProperty(PreviewControlSP.getName());
+        currentDevice->deleteProperty(PreviewSettingsNP.getName());
+        currentDevice->deleteProperty(PreviewStatusNP.getName());
     }
 
     return true;
@@ -462,6 +495,13 @@ void StreamManagerPrivate::asyncStreamThread()
         // You can reduce the number of frames by setting a frame limit.
         if (isStreaming && FPSPreview.newFrame())
         {
+            // The adaptive preview may skip frames to save bandwidth
+            {
+                std::lock_guard<std::mutex> lock(previewMutex);
+                if (previewController.skipFrame())
+                    continue;
+            }
+
             // Downscale to 8bit always for streaming to reduce bandwidth
             if (PixelFormat != INDI_JPG && PixelDepth > 8)
             {
@@ -479,14 +519,31 @@ void StreamManagerPrivate::asyncStreamThread()
             }
 
             //uploadStream(sourceBuffer->data(), sourceBuffer->size());
-            previewThreadPool.tryStart(std::bind([this, &previewElapsed](const std::atomic_bool &isAboutToQuit, std::vector<uint8_t> frame){
+            bool started = previewThreadPool.tryStart(std::bind([this, &previewElapsed](const std::atomic_bool &isAboutToQuit, std::vector<uint8_t> frame){
                 INDI_UNUSED(isAboutToQuit);
+                uint32_t uploadedBytes = 0;
+                {
+                    std::lock_guard<std::mutex> lock(previewMutex);
+                    encoder->setQuality(previewController.operatingPoint().quality);
+                    encoder->setScale(previewController.operatingPoint().scale);
+                }
                 previewElapsed.start();
-                uploadStream(frame.data(), frame.size());
-                StreamTimeNP[0].setValue(previewElapsed.nsecsElapsed() / 1000000000.0);
+                bool uploaded = uploadStream(frame.data(), frame.size(), &uploadedBytes);
+                double uploadTime = previewElapsed.nsecsElapsed() / 1000000000.0;
+                StreamTimeNP[0].setValue(uploadTime);
                 StreamTimeNP.apply();
 
+                if (uploaded)
+                    updatePreview(uploadedBytes, uploadTime);
+
             }, std::placeholders::_1, std::move(*sourceBuffer)));
+
+            // The previous frame is still being uploaded, the client cannot keep up
+            if (!started)
+            {
+                std::lock_guard<std::mutex> lock(previewMutex);
+                previewController.dropped();
+            }
         }
     }
 }
@@ -562,6 +619,9 @@ bool StreamManagerPrivate::setPixelFormat(INDI_PIXEL_FORMAT pixelFormat, uint8_t
 
     PixelFormat = pixelFormat;
     PixelDepth  = pixelDepth;
+
+    // JPEG frames are uploaded as they are
+    applyPreviewSettings();
     return true;
 }
 
@@ -852,6 +912,7 @@ bool StreamManagerPrivate::ISNewSwitch(const char * dev, const char * name, ISSt
                 oneEncoder->setPixelFormat(PixelFormat, PixelDepth);
 
                 encoder = oneEncoder;
+                applyPreviewSettings();
 
                 EncoderSP.setState(IPS_OK);
             }
@@ -860,6 +921,16 @@ bool StreamManagerPrivate::ISNewSwitch(const char * dev, const char * name, ISSt
         return true;
     }
 
+    // Adaptive preview mode
+    if (PreviewControlSP.isNameMatch(name))
+    {
+        PreviewControlSP.update(states, names, n);
+        applyPreviewSettings();
+        PreviewControlSP.setState(IPS_OK);
+        PreviewControlSP.apply();
+        return true;
+    }
+
     // Recorder Selection
     if (RecorderSP.isNameMatch(name))
     {
@@ -952,6 +1023,18 @@ bool StreamManagerPrivate::ISNewNumber(const char * dev, const char * name, doub
         return true;
     }
 
+    /* Adaptive preview budget and limits */
+    if (PreviewSettingsNP.isNameMatch(name))
+    {
+        PreviewSettingsNP.update(values, names, n);
+        if (PreviewSettingsNP[PREVIEW_QUALITY_MIN].getValue() > PreviewSettingsNP[PREVIEW_QUALITY_MAX].getValue())
+            PreviewSettingsNP[PREVIEW_QUALITY_MIN].setValue(PreviewSettingsNP[PREVIEW_QUALITY_MAX].getValue());
+        applyPreviewSettings();
+        PreviewSettingsNP.setState(IPS_OK);
+        PreviewSettingsNP.apply();
+        return true;
+    }
+
     /* Record Options */
     if (RecordOptionsNP.isNameMatch(name))
     {
@@ -1035,6 +1118,11 @@ bool StreamManagerPrivate::setStream(bool enable)
             FPSPreview.reset();
             FPSPreview.setTimeWindow(1000.0 / LimitsNP[LIMITS_PREVIEW_FPS].getValue());
             frameCountDivider = 0;
+            {
+                std::lock_guard<std::mutex> lock(previewMutex);
+                previewController.reset();
+                previewClock.start();
+            }
             
             if(currentDevice->getDriverInterface() & INDI::DefaultDevice::CCD_INTERFACE)
             {
@@ -1130,6 +1218,8 @@ bool StreamManager::saveConfigItems(FILE * fp)
     d->RecordOptionsNP.save(fp);
     d->RecorderSP.save(fp);
     d->LimitsNP.save(fp);
+    d->PreviewControlSP.save(fp);
+    d->PreviewSettingsNP.save(fp);
     return true;
 }
 
@@ -1160,8 +1250,11 @@ void StreamManager::getStreamFrame(uint16_t * x, uint16_t * y, uint16_t * w, uin
     d->getStreamFrame(x, y, w, h);
 }
 
-bool StreamManagerPrivate::uploadStream(const uint8_t * buffer, uint32_t nbytes)
+bool StreamManagerPrivate::uploadStream(const uint8_t * buffer, uint32_t nbytes, uint32_t *uploadedBytes)
 {
+    if (uploadedBytes != nullptr)
+        *uploadedBytes = nbytes;
+
     // Send as is, already encoded.
     if (PixelFormat == INDI_JPG)
     {
@@ -1217,6 +1310,9 @@ bool StreamManagerPrivate::uploadStream(const uint8_t * buffer, uint32_t nbytes)
                 return true;
             }
 #endif
+            if (uploadedBytes != nullptr)
+                *uploadedBytes = imageBP->at(0)->getBlobLen();
+
             // Upload to client now
             imageBP->setState(IPS_OK);
             imageBP->apply();
@@ -1227,6 +1323,9 @@ bool StreamManagerPrivate::uploadStream(const uint8_t * buffer, uint32_t nbytes)
     {
         if (encoder->upload(imageBP->at(0), buffer, nbytes, false))//dynamic_cast<INDI::SensorInterface*>(currentDevice)->isCompressed()))
         {
+            if (uploadedBytes != nullptr)
+                *uploadedBytes = imageBP->at(0)->getBlobLen();
+
             // Upload to client now
             imageBP->setState(IPS_OK);
             imageBP->apply();
@@ -1237,6 +1336,58 @@ bool StreamManagerPrivate::uploadStream(const uint8_t * buffer, uint32_t nbytes)
     return false;
 }
 
+void StreamManagerPrivate::applyPreviewSettings()
+{
+    PreviewController::Limits limits;
+    limits.minQuality = PreviewSettingsNP[PREVIEW_QUALITY_MIN].getValue();
+    limits.maxQuality = PreviewSettingsNP[PREVIEW_QUALITY_MAX].getValue();
+    limits.maxScale   = PreviewSettingsNP[PREVIEW_SCALE_MAX].getValue();
+    limits.maxSkip    = PreviewSettingsNP[PREVIEW_SKIP_MAX].getValue();
+
+    // Raw frames and JPEG frames from the camera can only be skipped
+    bool isMJPEG = EncoderSP[ENCODER_MJPEG].getState() == ISS_ON && PixelFormat != INDI_JPG;
+    if (!isMJPEG)
+    {
+        limits.minQuality = limits.maxQuality;
+        limits.maxScale = 1;
+    }
+
+    PreviewController::Mode mode = PreviewController::MODE_FIXED;
+    switch (PreviewControlSP.findOnSwitchIndex())
+    {
+        case PREVIEW_ADAPT_BITRATE:
+            mode = PreviewController::MODE_BITRATE;
+            break;
+        case PREVIEW_ADAPT_LATENCY:
+            mode = PreviewController::MODE_LATENCY;
+            break;
+    }
+
+    std::lock_guard<std::mutex> lock(previewMutex);
+    if (mode != previewController.mode())
+        previewController.setMode(mode);
+    previewController.setTarget(PreviewSettingsNP[PREVIEW_TARGET_BITRATE].getValue() * 1000,
+                                PreviewSettingsNP[PREVIEW_TARGET_LATENCY].getValue());
+    previewController.setLimits(limits);
+}
+
+void StreamManagerPrivate::updatePreview(uint32_t bytes, double uploadTime)
+{
+    std::lock_guard<std::mutex> lock(previewMutex);
+    if (previewController.update(bytes, uploadTime, previewClock.nsecsElapsed() / 1000000000.0) == false)
+        return;
+
+    const PreviewController::OperatingPoint &point = previewController.operatingPoint();
+    PreviewStatusNP[PREVIEW_QUALITY].setValue(point.quality);
+    PreviewStatusNP[PREVIEW_SCALE  ].setValue(point.scale);
+    PreviewStatusNP[PREVIEW_SKIP   ].setValue(point.skip);
+    PreviewStatusNP[PREVIEW_BITRATE].setValue(previewController.bitrate() / 1000);
+    PreviewStatusNP[PREVIEW_LATENCY].setValue(previewController.latency());
+    PreviewStatusNP[PREVIEW_DROPPED].setValue(previewController.droppedFrames());
+    PreviewStatusNP.setState(previewController.mode() == PreviewController::MODE_FIXED ? IPS_IDLE : IPS_OK);
+    PreviewStatusNP.apply();
+}
+
 RecorderInterface *StreamManager::getRecorder() const
 {
     D_PTR(const StreamManager);
@@ -27,6 +27,7 @@
 #include "recorder/recordermanager.h"
 #include "encoder/encodermanager.h"
 #include "fpsmeter.h"
+#include "previewcontroller.h"
 #include "uniquequeue.h"
 #include "gammalut16.h"
 
@@ -37,6 +38,7 @@
 
 #include "indiccdchip.h"
 #include "indisensorinterface.h"
+#include "indielapsedtimer.h"
 
 /* Smart Widget-Property */
 #include "indipropertytext.h"
@@ -129,9 +131,22 @@ public:
      * @brief uploadStream Upload frame to client using the selected encoder
      * @param buffer pointer to frame image buffer
      * @param nbytes size of frame in bytes
+     * @param uploadedBytes if not null, set to the size of the frame sent to the client
      * @return True if frame is encoded and sent to client, false otherwise.
      */
-    bool uploadStream(const uint8_t *buffer, uint32_t nbytes);
+    bool uploadStream(const uint8_t *buffer, uint32_t nbytes, uint32_t *uploadedBytes = nullptr);
+
+    /**
+     * @brief applyPreviewSettings Pass the adaptive preview properties to the controller. Quality and scale are only
+     * adapted by encoders supporting them, frame skip always is.
+     */
+    void applyPreviewSettings();
+
+    /**
+     * @brief updatePreview Account an uploaded preview frame, apply the operating point to the encoder and publish it
+     * once per measurement window.
+     */
+    void updatePreview(uint32_t bytes, double uploadTime);
 
     /**
      * @brief recordStream Calls the backend recorder to record a single frame.
@@ -207,6 +222,24 @@ public:
     INDI::PropertyNumber LimitsNP {2};
     enum { LIMITS_BUFFER_MAX, LIMITS_PREVIEW_FPS };
 
+    // Adaptive preview. Mode, budget and operating point limits, current operating point and measurements.
+    INDI::PropertySwitch PreviewControlSP {3};
+    enum { PREVIEW_FIXED, PREVIEW_ADAPT_BITRATE, PREVIEW_ADAPT_LATENCY };
+
+    INDI::PropertyNumber PreviewSettingsNP {6};
+    enum
+    {
+        PREVIEW_TARGET_BITRATE,
+        PREVIEW_TARGET_LATENCY,
+        PREVIEW_QUALITY_MIN,
+        PREVIEW_QUALITY_MAX,
+        PREVIEW_SCALE_MAX,
+        PREVIEW_SKIP_MAX
+    };
+
+    INDI::PropertyNumber PreviewStatusNP {6};
+    enum { PREVIEW_QUALITY, PREVIEW_SCALE, PREVIEW_SKIP, PREVIEW_BITRATE, PREVIEW_LATENCY, PREVIEW_DROPPED };
+
     std::atomic<bool> isStreaming { false };
     std::atomic<bool> isRecording { false };
     std::atomic<bool> isRecordingAboutToClose { false };
@@ -248,6 +281,10 @@ public:
     std::mutex               fastFPSUpdate;
     std::mutex               recordMutex;
 
+    PreviewController        previewController;
+    std::mutex               previewMutex;
+    INDI::ElapsedTimer       previewClock;
+
     GammaLut16               gammaLut16;
 };
 
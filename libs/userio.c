@@ -71,29 +71,30 @@ int userio_putc(const struct userio *io, void *user, int ch)
     return io->write(user, &c, sizeof(c));
 }
 
+// entity sequence of each character that needs escaping, indexed by character
+static const struct
+{
+    const char *s;
+    size_t l;
+} s_xml_entities[256] = {
+    ['&']  = { "&amp;",  5 }, ['\''] = { "&apos;", 6 }, ['"'] = { "&quot;", 6 },
+    ['<']  = { "&lt;",   4 }, ['>']  = { "&gt;",   4 },
+};
+
 size_t userio_xml_escape(const struct userio *io, void *user, const char *src)
 {
     size_t total = 0;
     const char *ptr = src;
-    const char *replacement;
 
+    // runs without entities are written in one go
     for(; *ptr; ++ptr)
     {
-        switch(*ptr)
-        {
-        case  '&': replacement = "&amp;";  break;
-        case '\'': replacement = "&apos;"; break;
-        case  '"': replacement = "&quot;"; break;
-        case  '<': replacement = "&lt;";   break;
-        case  '>': replacement = "&gt;";   break;
-        default:   replacement = NULL;
-        }
-
-        if (replacement != NULL)
+        unsigned char ch = (unsigned char)*ptr;
+        if (s_xml_entities[ch].s != NULL)
         {
             total += userio_write(io, user, src, (size_t)(ptr - src));
             src = ptr + 1;
-            total += userio_write(io, user, replacement, strlen(replacement));
+            total += userio_write(io, user, s_xml_entities[ch].s, s_xml_entities[ch].l);
         }
     }
     total += userio_write(io, user, src, (size_t)(ptr - src));
@@ -30,6 +30,7 @@
 // PWC framerate support
 #include "pwc-ioctl.h"
 
+#include <algorithm>
 #include <iostream>
 
 #include <sys/ioctl.h>
@@ -37,6 +38,7 @@
 #include <sys/stat.h>
 #include <assert.h>
 #include <fcntl.h>
+#include <poll.h>
 #include <unistd.h>
 #include <stdio.h>
 #include <cerrno>
@@ -149,7 +151,9 @@ V4L2_Base::V4L2_Base()
     buffers   = nullptr;
     n_buffers = 0;
 
-    callback = nullptr;
+    callback      = nullptr;
+    errorCallback = nullptr;
+    errorUptr     = nullptr;
 
     cancrop      = true;
     cansetrate   = true;
@@ -184,6 +188,7 @@ V4L2_Base::V4L2_Base()
 
 V4L2_Base::~V4L2_Base()
 {
+    stop_capture_thread();
     delete v4l2_decode;
 }
 
@@ -388,6 +393,8 @@ int V4L2_Base::connectCam(const char * devpath, char * errmsg, int pixelFormat,
 
 void V4L2_Base::disconnectCam(bool stopcapture)
 {
+    stop_capture_thread();
+
     if (selectCallBackID != -1)
         rmCallback(selectCallBackID);
 
@@ -492,177 +499,36 @@ int V4L2_Base::read_frame(char * errmsg)
             break;
 
         case IO_METHOD_MMAP:
-            DEBUGFDEVICE(deviceName, INDI::Logger::DBG_DEBUG, "%s: using MMAP to recover frame buffer", __FUNCTION__);
-            CLEAR(buf);
-
-            buf.type   = V4L2_BUF_TYPE_VIDEO_CAPTURE;
-            buf.memory = V4L2_MEMORY_MMAP;
-
-            /* For debugging purposes */
-            if (false)
-            {
-                for (i = 0; i < n_buffers; ++i)
-                {
-                    buf.index = i;
-                    if (-1 == XIOCTL(fd, VIDIOC_QUERYBUF, &buf))
-                        switch (errno)
-                        {
-                            case EINVAL:
-                                DEBUGFDEVICE(deviceName, INDI::Logger::DBG_DEBUG,
-                                             "%s: invalid buffer query, doing as if buffer was in output queue",
-                                             __FUNCTION__);
-                                break;
-
-                            default:
-                                return errno_exit("ReadFrame IO_METHOD_MMAP: VIDIOC_QUERYBUF", errmsg);
-                        }
-
-                    DEBUGFDEVICE(deviceName, INDI::Logger::DBG_DEBUG, "%s: " DBG_STR_BUF, __FUNCTION__, DBG_BUF(buf));
-                }
-            }
-
-            if (-1 == XIOCTL(fd, VIDIOC_DQBUF, &buf))
-                switch (errno)
-                {
-                    case EAGAIN:
-                        DEBUGFDEVICE(deviceName, INDI::Logger::DBG_DEBUG,
-                                     "%s: no buffer found with DQBUF ioctl (EAGAIN) - frame not ready or not requested",
-                                     __FUNCTION__);
-                        return 0;
-
-                    case EIO:
-                        /* Could ignore EIO, see spec. */
-                        /* Fall through */
-                        DEBUGFDEVICE(deviceName, INDI::Logger::DBG_DEBUG,
-                                     "%s: transitory internal error with DQBUF ioctl (EIO)", __FUNCTION__);
-                        return 0;
-
-                    case EINVAL:
-                    case EPIPE:
-                    default:
-                        return errno_exit("ReadFrame IO_METHOD_MMAP: VIDIOC_DQBUF", errmsg);
-                }
-
-            DEBUGFDEVICE(deviceName, INDI::Logger::DBG_DEBUG, "%s: buffer #%d dequeued from fd:%d\n", __FUNCTION__,
-                         buf.index, fd);
-
-            if (buf.flags & V4L2_BUF_FLAG_ERROR)
-            {
-                DEBUGFDEVICE(deviceName, INDI::Logger::DBG_DEBUG,
-                             "%s: recoverable error with DQBUF ioctl (BUF_FLAG_ERROR) - frame should be dropped",
-                             __FUNCTION__);
-                if (-1 == XIOCTL(fd, VIDIOC_QBUF, &buf))
-                    return errno_exit("ReadFrame IO_METHOD_MMAP: VIDIOC_QBUF", errmsg);
-                buf.bytesused = 0;
-                return 0;
-            }
-
-            if (!is_compressed() && buf.bytesused != fmt.fmt.pix.sizeimage)
-            {
-                DEBUGFDEVICE(deviceName, INDI::Logger::DBG_DEBUG,
-                             "%s: frame is %d-byte long, expected %d - frame should be dropped", __FUNCTION__,
-                             buf.bytesused, fmt.fmt.pix.sizeimage);
-
-                if (false)
-                {
-                    unsigned char const * b   = (unsigned char const *)buffers[buf.index].start;
-                    unsigned char const * end = b + buf.bytesused;
-
-                    do
-                        DEBUGFDEVICE(deviceName, INDI::Logger::DBG_DEBUG,
-                                     "%s: [%p] %02X%02X%02X%02X %02X%02X%02X%02X %02X%02X%02X%02X %02X%02X%02X%02X",
-                                     __FUNCTION__, b, b[0 * 4 + 0], b[0 * 4 + 1], b[0 * 4 + 2], b[0 * 4 + 3],
-                                     b[1 * 4 + 0], b[1 * 4 + 1], b[1 * 4 + 2], b[1 * 4 + 3], b[2 * 4 + 0], b[2 * 4 + 1],
-                                     b[2 * 4 + 2], b[2 * 4 + 3], b[3 * 4 + 0], b[3 * 4 + 1], b[3 * 4 + 2],
-                                     b[3 * 4 + 3]);
-                    while ((b += 16) < end);
-                }
-
-                if (-1 == XIOCTL(fd, VIDIOC_QBUF, &buf))
-                    return errno_exit("ReadFrame IO_METHOD_MMAP: VIDIOC_QBUF", errmsg);
-                buf.bytesused = 0;
-                return 0;
-            }
+        {
+            char wake[16];
+            while (read(frameNotify[0], wake, sizeof(wake)) > 0);
 
-#if (LINUX_VERSION_CODE >= KERNEL_VERSION(3, 15, 0))
-            /* TODO: the timestamp can be checked against the expected exposure to validate the frame - doesn't work, yet */
-            switch (buf.flags & V4L2_BUF_FLAG_TIMESTAMP_MASK)
+            /* Frames were dequeued, copied and requeued by the capture thread, process them in order */
+            std::unique_lock<std::mutex> lock(frameMutex);
+            while (streamactive && !readyFrames.empty())
             {
-                case V4L2_BUF_FLAG_TIMESTAMP_UNKNOWN:
-                /* FIXME: try monotonic clock when timestamp clock type is unknown */
-                case V4L2_BUF_FLAG_TIMESTAMP_MONOTONIC:
-                {
-                    struct timespec uptime = { 0, 0 };
-                    clock_gettime(CLOCK_MONOTONIC, &uptime);
-
-                    struct timeval epochtime = { 0, 0 };
-                    /*gettimeofday(&epochtime, nullptr); uncomment this to get the timestamp from epoch start */
-
-                    float const secs =
-                        (epochtime.tv_sec - uptime.tv_sec + buf.timestamp.tv_sec) +
-                        (epochtime.tv_usec - uptime.tv_nsec / 1000.0f + buf.timestamp.tv_usec) / 1000000.0f;
-
-                    if (V4L2_BUF_FLAG_TSTAMP_SRC_SOE == (buf.flags & V4L2_BUF_FLAG_TSTAMP_SRC_MASK))
-                    {
-                        DEBUGFDEVICE(deviceName, INDI::Logger::DBG_DEBUG,
-                                     "%s: frame exposure started %.03f seconds ago", __FUNCTION__, -secs);
-                    }
-                    else if (V4L2_BUF_FLAG_TSTAMP_SRC_EOF == (buf.flags & V4L2_BUF_FLAG_TSTAMP_SRC_MASK))
-                    {
-                        DEBUGFDEVICE(deviceName, INDI::Logger::DBG_DEBUG,
-                                     "%s: frame finished capturing %.03f seconds ago", __FUNCTION__, -secs);
-                    }
-                    else
-                        DEBUGFDEVICE(deviceName, INDI::Logger::DBG_DEBUG, "%s: unsupported timestamp in frame",
-                                     __FUNCTION__);
-
-                    break;
-                }
-
-                case V4L2_BUF_FLAG_TIMESTAMP_COPY:
-                default:
-                    DEBUGFDEVICE(deviceName, INDI::Logger::DBG_DEBUG, "%s: no usable timestamp found in frame",
-                                 __FUNCTION__);
-            }
-#endif
+                std::unique_ptr<CapturedFrame> frame = std::move(readyFrames.front());
+                readyFrames.pop_front();
+                lock.unlock();
 
-            /* TODO: there is probably a better error handling than asserting the buffer index */
-            assert(buf.index < n_buffers);
+                buf = frame->buf;
+                process_frame(frame->data.data());
 
-            if (dodecode)
-            {
-                DEBUGFDEVICE(deviceName, INDI::Logger::DBG_DEBUG, "%s: [%p] decoding %d-byte buffer %p cropset %c",
-                             __FUNCTION__, decoder, buf.bytesused, buffers[buf.index].start, cropset ? 'Y' : 'N');
-                decoder->decode((unsigned char *)(buffers[buf.index].start), &buf);
+                lock.lock();
+                freeFrames.push_back(std::move(frame));
             }
 
-            /*
-            if (dorecord)
-            {
-                DEBUGFDEVICE(deviceName, INDI::Logger::DBG_DEBUG, "%s: [%p] recording %d-byte buffer %p", __FUNCTION__,
-                             recorder, buf.bytesused, buffers[buf.index].start);
-                recorder->writeFrame((unsigned char *)(buffers[buf.index].start));
-            }
-            */
-
-            //DEBUGFDEVICE(deviceName, INDI::Logger::DBG_DEBUG,"lxstate is %d, dropFrame %c\n", lxstate, (dropFrame?'Y':'N'));
-
-            /* Requeue buffer */
-            if (-1 == XIOCTL(fd, VIDIOC_QBUF, &buf))
-                return errno_exit("ReadFrame IO_METHOD_MMAP: VIDIOC_QBUF", errmsg);
-
-            if (lxstate == LX_ACTIVE)
+            /* The capture thread stopped on a device error, report it like a failed read */
+            if (captureErrorSource != nullptr)
             {
-                /* Call provided callback function if any */
-                //if (callback && !dorecord)
-                if (callback)
-                    (*callback)(uptr);
+                const char * source = captureErrorSource;
+                errno               = captureErrno;
+                captureErrorSource  = nullptr;
+                lock.unlock();
+                return errno_exit(source, errmsg);
             }
-
-            if (lxstate == LX_TRIGGERED)
-                lxstate = LX_ACTIVE;
-
             break;
+        }
 
         case IO_METHOD_USERPTR:
             cerr << "in read Frame method userptr" << endl;
@@ -702,6 +568,126 @@ int V4L2_Base::read_frame(char * errmsg)
     return 0;
 }
 
+/** @internal Process a frame dequeued by the capture thread, on the event loop
+ *
+ * Corrupted frames are counted as dropped. Valid frames are decoded if decoding is
+ * enabled, and handed to the registered callback depending on the long exposure state.
+ *
+ * @param data is the copy of the mapped buffer, described by 'buf'.
+ */
+void V4L2_Base::process_frame(unsigned char * data)
+{
+    DEBUGFDEVICE(deviceName, INDI::Logger::DBG_DEBUG, "%s: processing frame #%u from buffer #%d", __FUNCTION__,
+                 buf.sequence, buf.index);
+
+    if (buf.flags & V4L2_BUF_FLAG_ERROR)
+    {
+        DEBUGFDEVICE(deviceName, INDI::Logger::DBG_DEBUG,
+                     "%s: recoverable error with DQBUF ioctl (BUF_FLAG_ERROR) - frame should be dropped",
+                     __FUNCTION__);
+        droppedFrames++;
+        buf.bytesused = 0;
+        return;
+    }
+
+    if (!is_compressed() && buf.bytesused != fmt.fmt.pix.sizeimage)
+    {
+        DEBUGFDEVICE(deviceName, INDI::Logger::DBG_DEBUG,
+                     "%s: frame is %d-byte long, expected %d - frame should be dropped", __FUNCTION__,
+                     buf.bytesused, fmt.fmt.pix.sizeimage);
+
+        if (false)
+        {
+            unsigned char const * b   = data;
+            unsigned char const * end = b + buf.bytesused;
+
+            do
+                DEBUGFDEVICE(deviceName, INDI::Logger::DBG_DEBUG,
+                             "%s: [%p] %02X%02X%02X%02X %02X%02X%02X%02X %02X%02X%02X%02X %02X%02X%02X%02X",
+                             __FUNCTION__, b, b[0 * 4 + 0], b[0 * 4 + 1], b[0 * 4 + 2], b[0 * 4 + 3],
+                             b[1 * 4 + 0], b[1 * 4 + 1], b[1 * 4 + 2], b[1 * 4 + 3], b[2 * 4 + 0], b[2 * 4 + 1],
+                             b[2 * 4 + 2], b[2 * 4 + 3], b[3 * 4 + 0], b[3 * 4 + 1], b[3 * 4 + 2],
+                             b[3 * 4 + 3]);
+            while ((b += 16) < end);
+        }
+
+        droppedFrames++;
+        buf.bytesused = 0;
+        return;
+    }
+
+#if (LINUX_VERSION_CODE >= KERNEL_VERSION(3, 15, 0))
+    /* TODO: the timestamp can be checked against the expected exposure to validate the frame - doesn't work, yet */
+    switch (buf.flags & V4L2_BUF_FLAG_TIMESTAMP_MASK)
+    {
+        case V4L2_BUF_FLAG_TIMESTAMP_UNKNOWN:
+        /* FIXME: try monotonic clock when timestamp clock type is unknown */
+        case V4L2_BUF_FLAG_TIMESTAMP_MONOTONIC:
+        {
+            struct timespec uptime = { 0, 0 };
+            clock_gettime(CLOCK_MONOTONIC, &uptime);
+
+            struct timeval epochtime = { 0, 0 };
+            /*gettimeofday(&epochtime, nullptr); uncomment this to get the timestamp from epoch start */
+
+            float const secs =
+                (epochtime.tv_sec - uptime.tv_sec + buf.timestamp.tv_sec) +
+                (epochtime.tv_usec - uptime.tv_nsec / 1000.0f + buf.timestamp.tv_usec) / 1000000.0f;
+
+            if (V4L2_BUF_FLAG_TSTAMP_SRC_SOE == (buf.flags & V4L2_BUF_FLAG_TSTAMP_SRC_MASK))
+            {
+                DEBUGFDEVICE(deviceName, INDI::Logger::DBG_DEBUG,
+                             "%s: frame exposure started %.03f seconds ago", __FUNCTION__, -secs);
+            }
+            else if (V4L2_BUF_FLAG_TSTAMP_SRC_EOF == (buf.flags & V4L2_BUF_FLAG_TSTAMP_SRC_MASK))
+            {
+                DEBUGFDEVICE(deviceName, INDI::Logger::DBG_DEBUG,
+                             "%s: frame finished capturing %.03f seconds ago", __FUNCTION__, -secs);
+            }
+            else
+                DEBUGFDEVICE(deviceName, INDI::Logger::DBG_DEBUG, "%s: unsupported timestamp in frame",
+                             __FUNCTION__);
+
+            break;
+        }
+
+        case V4L2_BUF_FLAG_TIMESTAMP_COPY:
+        default:
+            DEBUGFDEVICE(deviceName, INDI::Logger::DBG_DEBUG, "%s: no usable timestamp found in frame",
+                         __FUNCTION__);
+    }
+#endif
+
+    if (dodecode)
+    {
+        DEBUGFDEVICE(deviceName, INDI::Logger::DBG_DEBUG, "%s: [%p] decoding %d-byte buffer %p cropset %c",
+                     __FUNCTION__, decoder, buf.bytesused, data, cropset ? 'Y' : 'N');
+        decoder->decode(data, &buf);
+    }
+
+    /*
+    if (dorecord)
+    {
+        DEBUGFDEVICE(deviceName, INDI::Logger::DBG_DEBUG, "%s: [%p] recording %d-byte buffer %p", __FUNCTION__,
+                     recorder, buf.bytesused, buffers[buf.index].start);
+        recorder->writeFrame((unsigned char *)(buffers[buf.index].start));
+    }
+    */
+
+    //DEBUGFDEVICE(deviceName, INDI::Logger::DBG_DEBUG,"lxstate is %d, dropFrame %c\n", lxstate, (dropFrame?'Y':'N'));
+
+    if (lxstate == LX_ACTIVE)
+    {
+        /* Call provided callback function if any */
+        //if (callback && !dorecord)
+        if (callback)
+            (*callback)(uptr);
+    }
+
+    if (lxstate == LX_TRIGGERED)
+        lxstate = LX_ACTIVE;
+}
+
 int V4L2_Base::stop_capturing(char * errmsg)
 {
     enum v4l2_buf_type type;
@@ -721,6 +707,8 @@ int V4L2_Base::stop_capturing(char * errmsg)
             // N.B. I used this as a hack to solve a problem with capturing a frame
             // long time ago. I recently tried taking this hack off, and it worked fine!
 
+            stop_capture_thread();
+
             type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
             if (selectCallBackID != -1)
             {
@@ -771,8 +759,12 @@ int V4L2_Base::start_capturing(char * errmsg)
             if (-1 == XIOCTL(fd, VIDIOC_STREAMON, &type))
                 return errno_exit("VIDIOC_STREAMON", errmsg);
 
-            selectCallBackID = IEAddCallback(fd, newFrame, this);
-            streamactive     = true;
+            if (start_capture_thread(errmsg) < 0)
+            {
+                XIOCTL(fd, VIDIOC_STREAMOFF, &type);
+                return -1;
+            }
+            streamactive = true;
 
             break;
 
@@ -805,11 +797,217 @@ int V4L2_Base::start_capturing(char * errmsg)
     return 0;
 }
 
+/** @internal Start the thread dequeuing the mapped buffers of a streaming device
+ *
+ * The thread copies each frame in a bounded queue and requeues the buffer right away,
+ * so that the device never starves while the event loop decodes or processes frames.
+ * The event loop is woken up through a pipe, and processes the queued frames in read_frame.
+ *
+ * @param errmsg is the error messsage updated in case of error.
+ * @return 0 if the thread is running, or -1 with error message updated.
+ */
+int V4L2_Base::start_capture_thread(char * errmsg)
+{
+    stop_capture_thread();
+
+    if (pipe(captureWake) != 0 || pipe(frameNotify) != 0)
+    {
+        snprintf(errmsg, ERRMSGSIZ, "capture pipe error %d, %s\n", errno, strerror(errno));
+        stop_capture_thread();
+        return -1;
+    }
+
+    for (int oneFd : { captureWake[0], captureWake[1], frameNotify[0], frameNotify[1] })
+        fcntl(oneFd, F_SETFL, fcntl(oneFd, F_GETFL) | O_NONBLOCK);
+
+    droppedFrames      = 0;
+    sequenceGaps       = 0;
+    captureQuit        = false;
+    captureErrorSource = nullptr;
+
+    selectCallBackID = IEAddCallback(frameNotify[0], newFrame, this);
+    captureWorker    = std::thread(&V4L2_Base::capture_thread, this);
+    return 0;
+}
+
+/** @internal Stop the capture thread if it is running, and give the frames still queued back to the pool. */
+void V4L2_Base::stop_capture_thread()
+{
+    if (captureWorker.joinable())
+    {
+        captureQuit = true;
+        char wake   = 0;
+        if (write(captureWake[1], &wake, 1) < 0)
+        {
+            // The pipe is full, the thread has pending wake ups already
+        }
+        captureWorker.join();
+    }
+
+    if (selectCallBackID != -1 && frameNotify[0] >= 0)
+    {
+        IERmCallback(selectCallBackID);
+        selectCallBackID = -1;
+    }
+
+    for (int * oneFd : { &captureWake[0], &captureWake[1], &frameNotify[0], &frameNotify[1] })
+    {
+        if (*oneFd >= 0)
+            close(*oneFd);
+        *oneFd = -1;
+    }
+
+    std::lock_guard<std::mutex> lock(frameMutex);
+    while (!readyFrames.empty())
+    {
+        freeFrames.push_back(std::move(readyFrames.front()));
+        readyFrames.pop_front();
+    }
+}
+
+/** @internal Capture thread body, dequeues, copies and requeues mapped buffers until stopped
+ *
+ * Frames missing from the V4L2 sequence numbers are counted as sequence gaps. When the event
+ * loop falls behind and the queue is full, the oldest queued frame is dropped for the new one.
+ */
+void V4L2_Base::capture_thread()
+{
+    bool haveSequence     = false;
+    uint32_t lastSequence = 0;
+    struct pollfd fds[2]  = { { fd, POLLIN, 0 }, { captureWake[0], POLLIN, 0 } };
+
+    while (!captureQuit)
+    {
+        if (poll(fds, 2, -1) < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            capture_failed("poll", errno);
+            break;
+        }
+
+        if (fds[1].revents != 0)
+            break;
+
+        if (!(fds[0].revents & POLLIN))
+        {
+            /* The device went away while streaming */
+            if (fds[0].revents & (POLLERR | POLLHUP | POLLNVAL))
+            {
+                capture_failed("poll", ENODEV);
+                break;
+            }
+            continue;
+        }
+
+        struct v4l2_buffer dqbuf;
+        CLEAR(dqbuf);
+        dqbuf.type   = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        dqbuf.memory = V4L2_MEMORY_MMAP;
+
+        int r = -1;
+        do
+        {
+            r = ioctl(fd, VIDIOC_DQBUF, &dqbuf);
+        }
+        while (-1 == r && EINTR == errno);
+
+        if (-1 == r)
+        {
+            /* Frame not ready, or transitory internal error */
+            if (errno == EAGAIN || errno == EIO)
+                continue;
+            capture_failed("VIDIOC_DQBUF", errno);
+            break;
+        }
+
+        if (dqbuf.index >= n_buffers)
+            continue;
+
+        if (haveSequence && dqbuf.sequence > lastSequence + 1)
+            sequenceGaps += dqbuf.sequence - lastSequence - 1;
+        lastSequence = dqbuf.sequence;
+        haveSequence = true;
+
+        std::unique_ptr<CapturedFrame> frame;
+        {
+            std::lock_guard<std::mutex> lock(frameMutex);
+            if (!freeFrames.empty())
+            {
+                frame = std::move(freeFrames.back());
+                freeFrames.pop_back();
+            }
+            else if (allocatedFrames < FrameQueueSize)
+            {
+                frame.reset(new CapturedFrame());
+                allocatedFrames++;
+            }
+            else if (!readyFrames.empty())
+            {
+                frame = std::move(readyFrames.front());
+                readyFrames.pop_front();
+                droppedFrames++;
+            }
+        }
+
+        if (frame)
+        {
+            unsigned char const * start = (unsigned char const *)buffers[dqbuf.index].start;
+            size_t const size           = std::min<size_t>(dqbuf.bytesused, buffers[dqbuf.index].length);
+            frame->buf                  = dqbuf;
+            frame->data.assign(start, start + size);
+        }
+        else
+            droppedFrames++;
+
+        /* Requeue buffer */
+        do
+        {
+            r = ioctl(fd, VIDIOC_QBUF, &dqbuf);
+        }
+        while (-1 == r && EINTR == errno);
+
+        if (!frame)
+            continue;
+
+        bool notify = false;
+        {
+            std::lock_guard<std::mutex> lock(frameMutex);
+            notify = readyFrames.empty();
+            readyFrames.push_back(std::move(frame));
+        }
+
+        char wake = 0;
+        if (notify && write(frameNotify[1], &wake, 1) < 0)
+        {
+            // The pipe is full, the loop has pending wake ups already
+        }
+    }
+}
+
+/** @internal Record the error that stopped the capture thread, and wake the event loop up so read_frame reports it. */
+void V4L2_Base::capture_failed(const char * source, int error)
+{
+    {
+        std::lock_guard<std::mutex> lock(frameMutex);
+        captureErrorSource = source;
+        captureErrno       = error;
+    }
+
+    char wake = 0;
+    if (write(frameNotify[1], &wake, 1) < 0)
+    {
+        // The pipe is full, the loop has pending wake ups already
+    }
+}
+
 void V4L2_Base::newFrame(int /*fd*/, void * p)
 {
     char errmsg[ERRMSGSIZ];
+    V4L2_Base * base = (V4L2_Base *)(p);
 
-    ((V4L2_Base *)(p))->read_frame(errmsg);
+    if (base->read_frame(errmsg) < 0 && base->errorCallback)
+        (*base->errorCallback)(errmsg, base->errorUptr);
 }
 
 int V4L2_Base::uninit_device(char * errmsg)
@@ -1970,6 +2168,12 @@ float * V4L2_Base::getLinearY()
     return decoder->getLinearY();
 }
 
+void V4L2_Base::registerErrorCallback(CaptureErrorFunc * fp, void * ud)
+{
+    errorCallback = fp;
+    errorUptr     = ud;
+}
+
 void V4L2_Base::registerCallback(WPF * fp, void * ud)
 {
     callback = fp;
@@ -35,8 +35,15 @@
 #include "stream/streammanager.h"
 
 #include <stdio.h>
+#include <atomic>
+#include <cstdint>
 #include <cstdlib>
+#include <deque>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 #include <dirent.h>
 #include <linux/videodev2.h>
@@ -105,6 +112,10 @@ class V4L2_Base
 
         void registerCallback(WPF *fp, void *ud);
 
+        /** Called from the event loop with the error message when capture stopped on a device error. */
+        typedef void (CaptureErrorFunc)(const char *errmsg, void *ud);
+        void registerErrorCallback(CaptureErrorFunc *fp, void *ud);
+
         int start_capturing(char *errmsg);
         int stop_capturing(char *errmsg);
         static void newFrame(int fd, void *p);
@@ -151,6 +162,23 @@ class V4L2_Base
             return streamactive;
         }
 
+        /** @return Frames dequeued since capture started that never reached the callback, because the frame queue
+         *  was full or the frame was corrupted. */
+        uint64_t getDroppedFrames() const
+        {
+            return droppedFrames;
+        }
+        /** @return Frames the device skipped since capture started, according to the V4L2 sequence numbers. */
+        uint64_t getSequenceGaps() const
+        {
+            return sequenceGaps;
+        }
+        /** @return Device timestamp of the frame being processed by the callback. */
+        struct timeval getFrameTimestamp() const
+        {
+            return buf.timestamp;
+        }
+
         void doDecode(bool);
 
     protected:
@@ -158,6 +186,7 @@ class V4L2_Base
         int ioctl_set_format(struct v4l2_format new_fmt, char *errmsg);
 
         int read_frame(char *errsg);
+        void process_frame(unsigned char *data);
         int uninit_device(char *errmsg);
         int open_device(const char *devpath, char *errmsg);
         int check_device(char *errmsg);
@@ -202,6 +231,8 @@ class V4L2_Base
 
         WPF *callback;
         void *uptr;
+        CaptureErrorFunc *errorCallback;
+        void *errorUptr;
         char dev_name[64];
         const char *path;
         io_method io;
@@ -224,6 +255,39 @@ class V4L2_Base
 
         int bpp;
 
+        /** @brief One frame copied out of a mapped V4L2 buffer by the capture thread. */
+        struct CapturedFrame
+        {
+            struct v4l2_buffer buf;
+            std::vector<unsigned char> data;
+        };
+
+        /** Frames waiting for the event loop, the oldest one is dropped when a new frame does not fit */
+        static constexpr size_t FrameQueueSize = 4;
+
+        int start_capture_thread(char *errmsg);
+        void stop_capture_thread();
+        void capture_thread();
+        void capture_failed(const char *source, int error);
+
+        std::thread captureWorker;
+        std::atomic<bool> captureQuit {false};
+        /** Wakes the capture thread up when capture stops */
+        int captureWake[2] {-1, -1};
+        /** Wakes the event loop up when frames are queued, watched with selectCallBackID */
+        int frameNotify[2] {-1, -1};
+
+        std::mutex frameMutex;
+        std::deque<std::unique_ptr<CapturedFrame>> readyFrames;
+        std::vector<std::unique_ptr<CapturedFrame>> freeFrames;
+        size_t allocatedFrames {0};
+        /** Set by the capture thread when it stopped on a device error, reported by read_frame */
+        const char *captureErrorSource {nullptr};
+        int captureErrno {0};
+
+        std::atomic<uint64_t> droppedFrames {0};
+        std::atomic<uint64_t> sequenceGaps {0};
+
         friend class ::V4L2_Driver;
 
         char deviceName[MAXINDIDEVICE];
@@ -0,0 +1,389 @@
+/* a two lane message queue keeping small messages ahead of bulk ones.
+ * Copyright (C) 2022 INDI Library Developers
+ * includes standalone commandline benchmark program, see below.
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+ */
+
+/** \file lq.c
+    \brief a two lane message queue keeping small messages ahead of bulk ones.
+
+   An LQ holds the messages waiting to be written to one indiserver client or
+   driver. Messages are queued either on the control lane or on the bulk lane,
+   each lane being a FIFO. The next message to send is taken from the control
+   lane whenever it is not empty, so a small command never waits for more than
+   the one bulk message being written at that time.
+
+   Messages are only ever reordered between different properties. A control
+   message is queued on the bulk lane instead while a bulk message of the same
+   device and property is waiting, an empty device or property name matching
+   any. Once the first byte of a message is written, it stays the next message
+   until it is popped so messages are never interleaved on the wire.
+
+   The time each message spends in the queue, from push to pop, is kept for
+   the most recent messages of each lane to report latency percentiles.
+
+     \author INDI Library Developers
+*/
+
+#include "lq.h"
+
+#include "fq.h"
+#include "indiapi.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define LQ_NSAMPLES 512 /* latencies kept per lane for the percentiles */
+
+/* one queued message */
+typedef struct
+{
+    void *e;                   /* caller's element */
+    double t;                  /* push time, ms */
+    char dev[MAXINDIDEVICE];   /* device of the message, empty for all */
+    char name[MAXINDINAME];    /* property of the message, empty for all */
+} LQEntry;
+
+struct _LQ
+{
+    FQ *lane[LQ_NLANES];                     /* LQEntry FIFO per lane */
+    int cur;                                 /* lane of the message being sent, -1 between messages */
+    float samples[LQ_NLANES][LQ_NSAMPLES];   /* ring of the latest latencies per lane, ms */
+    unsigned long n[LQ_NLANES];              /* messages popped per lane */
+    double max[LQ_NLANES];                   /* largest latency per lane, ms */
+};
+
+/* monotonic time in ms */
+static double nowLQ(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0);
+}
+
+/* return 1 if the message queued as ep and the one of dev/name may concern the same property */
+static int sameProperty(LQEntry *ep, const char *dev, const char *name)
+{
+    if (!dev[0] || !ep->dev[0])
+        return (1);
+    if (strcmp(dev, ep->dev))
+        return (0);
+    return (!name[0] || !ep->name[0] || !strcmp(name, ep->name));
+}
+
+/* lane the next message comes from, -1 if empty */
+static int nextLane(LQ *q)
+{
+    if (q->cur >= 0 && nFQ(q->lane[q->cur]) > 0)
+        return (q->cur);
+    if (nFQ(q->lane[LQ_CONTROL]) > 0)
+        return (LQ_CONTROL);
+    if (nFQ(q->lane[LQ_BULK]) > 0)
+        return (LQ_BULK);
+    return (-1);
+}
+
+/* return pointer to a new LQ.
+ * grow is an efficiency hint passed to the FQ of each lane.
+ */
+LQ *newLQ(int grow)
+{
+    LQ *q = (LQ *)calloc(1, sizeof(LQ));
+    int i;
+
+    for (i = 0; i < LQ_NLANES; i++)
+        q->lane[i] = newFQ(grow);
+    q->cur = -1;
+    return (q);
+}
+
+/* delete a LQ no longer needed, the elements still queued are not freed */
+void delLQ(LQ *q)
+{
+    int i;
+
+    for (i = 0; i < LQ_NLANES; i++)
+    {
+        LQEntry *ep;
+        while ((ep = (LQEntry *)popFQ(q->lane[i])) != NULL)
+            free(ep);
+        delFQ(q->lane[i]);
+    }
+    free(q);
+}
+
+/* push element e of property dev/name onto the given LQ.
+ * bulk messages always go to the bulk lane, others to the control lane unless
+ * that would let them overtake a bulk message of the same property.
+ * return the lane used.
+ */
+int pushLQ(LQ *q, void *e, int bulk, const char *dev, const char *name)
+{
+    LQEntry *ep = (LQEntry *)malloc(sizeof(LQEntry));
+    int lane    = bulk ? LQ_BULK : LQ_CONTROL;
+    int i;
+
+    ep->e = e;
+    ep->t = nowLQ();
+    strncpy(ep->dev, dev ? dev : "", MAXINDIDEVICE - 1);
+    ep->dev[MAXINDIDEVICE - 1] = '\0';
+    strncpy(ep->name, name ? name : "", MAXINDINAME - 1);
+    ep->name[MAXINDINAME - 1] = '\0';
+
+    for (i = 0; lane == LQ_CONTROL && i < nFQ(q->lane[LQ_BULK]); i++)
+    {
+        if (sameProperty((LQEntry *)peekiFQ(q->lane[LQ_BULK], i), ep->dev, ep->name))
+            lane = LQ_BULK;
+    }
+
+    pushFQ(q->lane[lane], ep);
+    return (lane);
+}
+
+/* return the next element to send leaving it on the q, or NULL if empty.
+ * the element is then kept as the next one until popped.
+ */
+void *peekLQ(LQ *q)
+{
+    int lane = nextLane(q);
+
+    if (lane < 0)
+        return (NULL);
+    q->cur = lane;
+    return (((LQEntry *)peekFQ(q->lane[lane]))->e);
+}
+
+/* pop and return the next element, or NULL if empty.
+ * its time in the queue is accounted to the latency of its lane.
+ */
+void *popLQ(LQ *q)
+{
+    int lane = nextLane(q);
+    LQEntry *ep;
+    double latency;
+    void *e;
+
+    if (lane < 0)
+        return (NULL);
+
+    ep      = (LQEntry *)popFQ(q->lane[lane]);
+    latency = nowLQ() - ep->t;
+    q->samples[lane][q->n[lane]++ % LQ_NSAMPLES] = (float)latency;
+    if (latency > q->max[lane])
+        q->max[lane] = latency;
+    q->cur = -1;
+
+    e = ep->e;
+    free(ep);
+    return (e);
+}
+
+/* return ith element of the given LQ, control lane first.
+ * this can be used for iteration as:
+ *   for (i = 0; i < nLQ(q); i++)
+ *     void *e = peekiLQ(q,i);
+ */
+void *peekiLQ(LQ *q, int i)
+{
+    int nc = nFQ(q->lane[LQ_CONTROL]);
+
+    if (i < nc)
+        return (((LQEntry *)peekiFQ(q->lane[LQ_CONTROL], i))->e);
+    if (i - nc < nFQ(q->lane[LQ_BULK]))
+        return (((LQEntry *)peekiFQ(q->lane[LQ_BULK], i - nc))->e);
+    return (NULL);
+}
+
+/* return the number of elements in the given LQ */
+int nLQ(LQ *q)
+{
+    return (nFQ(q->lane[LQ_CONTROL]) + nFQ(q->lane[LQ_BULK]));
+}
+
+/* return the number of elements in one lane of the given LQ */
+int nLaneLQ(LQ *q, int lane)
+{
+    return (nFQ(q->lane[lane]));
+}
+
+static int cmpLatency(const void *a, const void *b)
+{
+    float fa = *(const float *)a, fb = *(const float *)b;
+    return ((fa > fb) - (fa < fb));
+}
+
+/* fill s with the latency percentiles of the most recent messages of lane */
+void statsLQ(LQ *q, int lane, LQStats *s)
+{
+    float sorted[LQ_NSAMPLES];
+    int n = q->n[lane] < LQ_NSAMPLES ? (int)q->n[lane] : LQ_NSAMPLES;
+
+    memset(s, 0, sizeof(*s));
+    s->n   = q->n[lane];
+    s->max = q->max[lane];
+    if (n == 0)
+        return;
+
+    memcpy(sorted, q->samples[lane], n * sizeof(float));
+    qsort(sorted, n, sizeof(float), cmpLatency);
+    s->p50 = sorted[(int)(0.50 * (n - 1) + 0.5)];
+    s->p95 = sorted[(int)(0.95 * (n - 1) + 0.5)];
+    s->p99 = sorted[(int)(0.99 * (n - 1) + 0.5)];
+}
+
+#if defined(TEST_LQ)
+
+/* to build a stand-alone commandline benchmark program:
+ *   cc -DTEST_LQ -I. -Ilibs -o lq lq.c fq.c -lpthread
+ * run ./lq [link MB/s] to measure how long small abort commands wait while
+ * image BLOBs saturate a slow link, once with every message on one FIFO as
+ * indiserver used to do and once with the control lane.
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+
+#define BLOBSIZ  (4 * 1024 * 1024) /* bytes per BLOB message */
+#define NBLOBS   4                 /* BLOBs kept queued */
+#define NABORTS  25                /* abort commands to time */
+#define ABORTMS  150               /* ms between abort commands */
+#define WSIZ     49152             /* max bytes/write, as MAXWSIZ in indiserver */
+
+typedef struct
+{
+    unsigned long cl;
+    char *cp;
+    double t; /* push time, ms */
+} BenchMsg;
+
+static int rate = 20; /* link speed, MB/s */
+
+/* drain the far end of the link no faster than rate */
+static void *slowLink(void *arg)
+{
+    int fd = *(int *)arg;
+    static char buf[65536];
+    ssize_t nr;
+
+    while ((nr = read(fd, buf, sizeof(buf))) > 0)
+        usleep((useconds_t)(nr * 1000000.0 / (rate * 1024.0 * 1024.0)));
+    return (NULL);
+}
+
+static BenchMsg *newBenchMsg(unsigned long cl, char c)
+{
+    BenchMsg *mp = (BenchMsg *)malloc(sizeof(BenchMsg));
+    mp->cl       = cl;
+    mp->t        = nowLQ();
+    mp->cp       = (char *)malloc(cl);
+    memset(mp->cp, c, cl);
+    return (mp);
+}
+
+static int cmpDouble(const void *a, const void *b)
+{
+    double da = *(const double *)a, db = *(const double *)b;
+    return ((da > db) - (da < db));
+}
+
+static void bench(int lanes)
+{
+    int sv[2], sndbuf = 256 * 1024, aborts = 0, nlat = 0;
+    unsigned long nsent = 0;
+    double nextabort, lat[NABORTS];
+    pthread_t reader;
+    LQ *q = newLQ(1);
+    BenchMsg *mp;
+
+    socketpair(AF_UNIX, SOCK_STREAM, 0, sv);
+    setsockopt(sv[0], SOL_SOCKET, SO_SNDBUF, &sndbuf, sizeof(sndbuf));
+    pthread_create(&reader, NULL, slowLink, &sv[1]);
+
+    nextabort = nowLQ() + ABORTMS;
+    while (nlat < NABORTS)
+    {
+        fd_set ws;
+        struct timeval tv = { 0, 1000 };
+        ssize_t nsend, nw;
+
+        /* keep the link saturated with BLOBs, like a camera streaming */
+        while (nLaneLQ(q, LQ_BULK) < NBLOBS)
+            pushLQ(q, newBenchMsg(BLOBSIZ, 'B'), 1, "CCD Simulator", "CCD1");
+
+        /* then a mount abort every so often, on the bulk lane when lanes are off */
+        if (aborts < NABORTS && nowLQ() >= nextabort)
+        {
+            pushLQ(q, newBenchMsg(120, 'A'), !lanes, "Telescope Simulator", "TELESCOPE_ABORT_MOTION");
+            nextabort += ABORTMS;
+            aborts++;
+        }
+
+        FD_ZERO(&ws);
+        FD_SET(sv[0], &ws);
+        if (select(sv[0] + 1, NULL, &ws, NULL, &tv) <= 0)
+            continue;
+
+        mp    = (BenchMsg *)peekLQ(q);
+        nsend = mp->cl - nsent;
+        if (nsend > WSIZ)
+            nsend = WSIZ;
+        nw = write(sv[0], &mp->cp[nsent], nsend);
+        if (nw <= 0)
+            break;
+        nsent += nw;
+        if (nsent == mp->cl)
+        {
+            if (mp->cp[0] == 'A')
+                lat[nlat++] = nowLQ() - mp->t;
+            popLQ(q);
+            free(mp->cp);
+            free(mp);
+            nsent = 0;
+        }
+    }
+
+    qsort(lat, nlat, sizeof(double), cmpDouble);
+    printf("%-12s abort latency over %d: p50 %8.1f ms  p95 %8.1f ms  max %8.1f ms\n", lanes ? "two lanes" : "single FIFO",
+           nlat, lat[nlat / 2], lat[(int)(0.95 * (nlat - 1) + 0.5)], lat[nlat - 1]);
+
+    shutdown(sv[0], SHUT_RDWR);
+    close(sv[0]);
+    pthread_join(reader, NULL);
+    close(sv[1]);
+    while ((mp = (BenchMsg *)popLQ(q)) != NULL)
+    {
+        free(mp->cp);
+        free(mp);
+    }
+    delLQ(q);
+}
+
+int main(int ac, char *av[])
+{
+    if (ac > 1)
+        rate = atoi(av[1]) > 0 ? atoi(av[1]) : rate;
+
+    printf("%d MB/s link saturated with %d MB BLOBs\n", rate, BLOBSIZ / (1024 * 1024));
+    bench(0);
+    bench(1);
+    return (0);
+}
+#endif /* TEST_LQ */
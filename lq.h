@@ -0,0 +1,45 @@
+/* a two lane message queue keeping small messages ahead of bulk ones.
+ * Copyright (C) 2022 INDI Library Developers
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#pragma once
+
+#define LQ_CONTROL 0 /* lane of small property messages and commands */
+#define LQ_BULK    1 /* lane of BLOBs and of messages that must stay behind them */
+#define LQ_NLANES  2
+
+typedef struct _LQ LQ;
+
+/* queueing latency of the most recent messages of one lane, in milliseconds */
+typedef struct
+{
+    unsigned long n; /* messages sent since the queue was created */
+    double p50;
+    double p95;
+    double p99;
+    double max; /* largest latency since the queue was created */
+} LQStats;
+
+extern LQ *newLQ(int grow);
+extern void delLQ(LQ *q);
+extern int pushLQ(LQ *q, void *e, int bulk, const char *dev, const char *name);
+extern void *peekLQ(LQ *q);
+extern void *popLQ(LQ *q);
+extern void *peekiLQ(LQ *q, int i);
+extern int nLQ(LQ *q);
+extern int nLaneLQ(LQ *q, int lane);
+extern void statsLQ(LQ *q, int lane, LQStats *s);
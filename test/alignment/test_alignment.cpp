@@ -21,14 +21,20 @@
 #include "config.h"
 #endif
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
 #include <cstdlib>
 #include <cstring>
 #include <stdio.h>
+#include <vector>
 
 #include <indilogger.h>
 
 #include "alignment_scope.h"
 
+#include <alignment/BuiltInMathPlugin.h>
+
 double round(double value, int decimal_places)
 {
     const double multiplier = std::pow(10.0, decimal_places);
@@ -151,6 +157,239 @@ TEST(ALIGNMENT_TEST, Test_ThreeSyncPointsAltAz)
     ASSERT_DOUBLE_EQ(round(testPointAz, 1), round(roundTripAz, 1));
 }
 
+// Sync points spread over the sky with a small, position dependent mount error
+static void AddSyncPoint(INDI::AlignmentSubsystem::InMemoryDatabase &Database, int Index, int Count)
+{
+    INDI::AlignmentSubsystem::BuiltInMathPlugin Plugin;
+    INDI::AlignmentSubsystem::AlignmentDatabaseEntry Entry;
+    Entry.ObservationJulianDate = 2459000.5;
+    Entry.RightAscension = std::fmod(Index * 0.618034 * 24.0, 24.0);
+    Entry.Declination = std::asin(-0.8 + 1.6 * (Index + 0.5) / Count) * 180.0 / M_PI;
+    INDI::IEquatorialCoordinates MountRaDec {Entry.RightAscension + 0.02 * std::sin(Index), Entry.Declination + 0.3};
+    Entry.TelescopeDirection = Plugin.TelescopeDirectionVectorFromEquatorialCoordinates(MountRaDec);
+    Database.GetAlignmentDatabase().push_back(Entry);
+}
+
+static void ExpectSameTransforms(INDI::AlignmentSubsystem::BasicMathPlugin &First,
+                                 INDI::AlignmentSubsystem::BasicMathPlugin &Second)
+{
+    for (double ra = 0.5; ra < 24; ra += 1.5)
+    {
+        for (double dec = -50; dec <= 70; dec += 15)
+        {
+            TelescopeDirectionVector FirstTDV, SecondTDV;
+            ASSERT_TRUE(First.TransformCelestialToTelescope(ra, dec, 0, FirstTDV));
+            ASSERT_TRUE(Second.TransformCelestialToTelescope(ra, dec, 0, SecondTDV));
+            EXPECT_NEAR(FirstTDV.x, SecondTDV.x, 1e-12);
+            EXPECT_NEAR(FirstTDV.y, SecondTDV.y, 1e-12);
+            EXPECT_NEAR(FirstTDV.z, SecondTDV.z, 1e-12);
+
+            double FirstRA, FirstDec, SecondRA, SecondDec;
+            ASSERT_TRUE(First.TransformTelescopeToCelestial(FirstTDV, FirstRA, FirstDec));
+            ASSERT_TRUE(Second.TransformTelescopeToCelestial(FirstTDV, SecondRA, SecondDec));
+            EXPECT_NEAR(FirstRA, SecondRA, 1e-9);
+            EXPECT_NEAR(FirstDec, SecondDec, 1e-9);
+        }
+    }
+}
+
+TEST(ALIGNMENT_TEST, Test_IncrementalConvexHull)
+{
+    using namespace INDI::AlignmentSubsystem;
+    const int Count = 48;
+
+    InMemoryDatabase Database;
+    Database.SetDatabaseReferencePosition(29.05, 48.15);
+
+    // Sync points added one at a time extend the existing hulls
+    BuiltInMathPlugin Incremental;
+    Incremental.SetApproximateMountAlignment(NORTH_CELESTIAL_POLE);
+    for (int Index = 0; Index < Count; Index++)
+    {
+        AddSyncPoint(Database, Index, Count);
+        ASSERT_TRUE(Incremental.Initialise(&Database));
+    }
+
+    // Loading the whole database at once builds the hulls in the background
+    BuiltInMathPlugin Full;
+    Full.SetApproximateMountAlignment(NORTH_CELESTIAL_POLE);
+    ASSERT_TRUE(Full.Initialise(&Database));
+    Full.WaitForModel();
+    ExpectSameTransforms(Incremental, Full);
+
+    // Deleting a sync point rebuilds the hulls, conversions made meanwhile already use the new model
+    Database.GetAlignmentDatabase().erase(Database.GetAlignmentDatabase().begin() + 7);
+    ASSERT_TRUE(Incremental.Initialise(&Database));
+
+    BuiltInMathPlugin Rebuilt;
+    Rebuilt.SetApproximateMountAlignment(NORTH_CELESTIAL_POLE);
+    ASSERT_TRUE(Rebuilt.Initialise(&Database));
+    ExpectSameTransforms(Incremental, Rebuilt);
+}
+
+// Points spread over the sky, not a multiple of the batch block size
+static std::vector<INDI::IEquatorialCoordinates> SkyGrid(size_t Count)
+{
+    std::vector<INDI::IEquatorialCoordinates> Points(Count);
+    for (size_t Index = 0; Index < Count; Index++)
+    {
+        Points[Index].rightascension = std::fmod(Index * 0.618034 * 24.0, 24.0);
+        Points[Index].declination = std::asin(-0.98 + 1.96 * (Index + 0.5) / Count) * 180.0 / M_PI;
+    }
+    return Points;
+}
+
+// Difference of two angles accounting for the wrap around
+static double AngleDifference(double First, double Second, double Period)
+{
+    double Difference = std::fmod(std::fabs(First - Second), Period);
+    return std::min(Difference, Period - Difference);
+}
+
+TEST(ALIGNMENT_TEST, Test_BatchTDVMatchesSingle)
+{
+    TelescopeDirectionVectorSupportFunctions Functions;
+    std::vector<INDI::IEquatorialCoordinates> RaDec = SkyGrid(1000);
+    const size_t Count = RaDec.size();
+
+    std::vector<TelescopeDirectionVector> TDVs(Count);
+    std::vector<INDI::IEquatorialCoordinates> RaDecResults(Count);
+    Functions.TelescopeDirectionVectorsFromEquatorialCoordinates(RaDec.data(), Count, TDVs.data());
+    Functions.EquatorialCoordinatesFromTelescopeDirectionVectors(TDVs.data(), Count, RaDecResults.data());
+
+    std::vector<INDI::IHorizontalCoordinates> AltAz(Count), AltAzResults(Count);
+    for (size_t Index = 0; Index < Count; Index++)
+    {
+        AltAz[Index].azimuth = RaDec[Index].rightascension * 15.0;
+        AltAz[Index].altitude = RaDec[Index].declination;
+    }
+    std::vector<TelescopeDirectionVector> AltAzTDVs(Count);
+    Functions.TelescopeDirectionVectorsFromAltitudeAzimuth(AltAz.data(), Count, AltAzTDVs.data());
+    Functions.AltitudeAzimuthFromTelescopeDirectionVectors(AltAzTDVs.data(), Count, AltAzResults.data());
+
+    for (size_t Index = 0; Index < Count; Index++)
+    {
+        TelescopeDirectionVector TDV = Functions.TelescopeDirectionVectorFromEquatorialCoordinates(RaDec[Index]);
+        ASSERT_DOUBLE_EQ(TDV.x, TDVs[Index].x);
+        ASSERT_DOUBLE_EQ(TDV.y, TDVs[Index].y);
+        ASSERT_DOUBLE_EQ(TDV.z, TDVs[Index].z);
+
+        INDI::IEquatorialCoordinates RaDecResult;
+        Functions.EquatorialCoordinatesFromTelescopeDirectionVector(TDV, RaDecResult);
+        ASSERT_DOUBLE_EQ(RaDecResult.rightascension, RaDecResults[Index].rightascension);
+        ASSERT_DOUBLE_EQ(RaDecResult.declination, RaDecResults[Index].declination);
+
+        TDV = Functions.TelescopeDirectionVectorFromAltitudeAzimuth(AltAz[Index]);
+        ASSERT_DOUBLE_EQ(TDV.x, AltAzTDVs[Index].x);
+        ASSERT_DOUBLE_EQ(TDV.y, AltAzTDVs[Index].y);
+        ASSERT_DOUBLE_EQ(TDV.z, AltAzTDVs[Index].z);
+
+        INDI::IHorizontalCoordinates AltAzResult;
+        Functions.AltitudeAzimuthFromTelescopeDirectionVector(TDV, AltAzResult);
+        ASSERT_DOUBLE_EQ(AltAzResult.azimuth, AltAzResults[Index].azimuth);
+        ASSERT_DOUBLE_EQ(AltAzResult.altitude, AltAzResults[Index].altitude);
+    }
+
+    // Spherical coordinates measured from the polar axis, clockwise
+    std::vector<double> Azimuths(Count), Polars(Count), AzimuthResults(Count), PolarResults(Count);
+    for (size_t Index = 0; Index < Count; Index++)
+    {
+        Azimuths[Index] = DEG_TO_RAD(AltAz[Index].azimuth);
+        Polars[Index] = DEG_TO_RAD(90 - AltAz[Index].altitude);
+    }
+    Functions.TelescopeDirectionVectorsFromSphericalCoordinates(Azimuths.data(),
+            TelescopeDirectionVectorSupportFunctions::CLOCKWISE, Polars.data(),
+            TelescopeDirectionVectorSupportFunctions::FROM_POLAR_AXIS, Count, TDVs.data());
+    Functions.SphericalCoordinatesFromTelescopeDirectionVectors(TDVs.data(), Count, AzimuthResults.data(),
+            TelescopeDirectionVectorSupportFunctions::CLOCKWISE, PolarResults.data(),
+            TelescopeDirectionVectorSupportFunctions::FROM_POLAR_AXIS);
+    for (size_t Index = 0; Index < Count; Index++)
+    {
+        TelescopeDirectionVector TDV = Functions.TelescopeDirectionVectorFromSphericalCoordinate(Azimuths[Index],
+                                       TelescopeDirectionVectorSupportFunctions::CLOCKWISE, Polars[Index],
+                                       TelescopeDirectionVectorSupportFunctions::FROM_POLAR_AXIS);
+        ASSERT_DOUBLE_EQ(TDV.x, TDVs[Index].x);
+        ASSERT_DOUBLE_EQ(TDV.y, TDVs[Index].y);
+        ASSERT_DOUBLE_EQ(TDV.z, TDVs[Index].z);
+
+        double Azimuth, Polar;
+        Functions.SphericalCoordinateFromTelescopeDirectionVector(TDV, Azimuth,
+                TelescopeDirectionVectorSupportFunctions::CLOCKWISE, Polar,
+                TelescopeDirectionVectorSupportFunctions::FROM_POLAR_AXIS);
+        ASSERT_DOUBLE_EQ(Azimuth, AzimuthResults[Index]);
+        ASSERT_DOUBLE_EQ(Polar, PolarResults[Index]);
+    }
+}
+
+TEST(ALIGNMENT_TEST, Test_BatchEquatorialHorizontalMatchesSingle)
+{
+    INDI::IGeographicCoordinates Location {48.15, 29.05, 0};
+    const double JD = 2459000.5;
+    std::vector<INDI::IEquatorialCoordinates> RaDec = SkyGrid(1000);
+    const size_t Count = RaDec.size();
+
+    std::vector<INDI::IHorizontalCoordinates> AltAz(Count);
+    std::vector<INDI::IEquatorialCoordinates> RaDecResults(Count);
+    INDI::EquatorialToHorizontal(RaDec.data(), Count, &Location, JD, AltAz.data());
+    INDI::HorizontalToEquatorial(AltAz.data(), Count, &Location, JD, RaDecResults.data());
+
+    for (size_t Index = 0; Index < Count; Index++)
+    {
+        INDI::IHorizontalCoordinates Expected;
+        INDI::EquatorialToHorizontal(&RaDec[Index], &Location, JD, &Expected);
+        EXPECT_LT(AngleDifference(Expected.azimuth, AltAz[Index].azimuth, 360), 1e-9);
+        EXPECT_NEAR(Expected.altitude, AltAz[Index].altitude, 1e-9);
+
+        INDI::IEquatorialCoordinates ExpectedRaDec;
+        INDI::HorizontalToEquatorial(&AltAz[Index], &Location, JD, &ExpectedRaDec);
+        EXPECT_LT(AngleDifference(ExpectedRaDec.rightascension, RaDecResults[Index].rightascension, 24), 1e-9);
+        EXPECT_NEAR(ExpectedRaDec.declination, RaDecResults[Index].declination, 1e-9);
+
+        // Round trip
+        EXPECT_LT(AngleDifference(RaDec[Index].rightascension, RaDecResults[Index].rightascension, 24), 1e-9);
+        EXPECT_NEAR(RaDec[Index].declination, RaDecResults[Index].declination, 1e-9);
+    }
+}
+
+TEST(ALIGNMENT_TEST, Test_BatchBenchmark)
+{
+    TelescopeDirectionVectorSupportFunctions Functions;
+    INDI::IGeographicCoordinates Location {48.15, 29.05, 0};
+    const double JD = 2459000.5;
+    std::vector<INDI::IEquatorialCoordinates> RaDec = SkyGrid(20000);
+    const size_t Count = RaDec.size();
+
+    std::vector<INDI::IHorizontalCoordinates> AltAz(Count);
+    std::vector<TelescopeDirectionVector> TDVs(Count);
+    std::vector<INDI::IEquatorialCoordinates> RaDecResults(Count);
+
+    // RA/Dec -> Alt/Az -> TDV -> Alt/Az -> RA/Dec, one point at a time
+    auto Start = std::chrono::steady_clock::now();
+    for (size_t Index = 0; Index < Count; Index++)
+    {
+        INDI::EquatorialToHorizontal(&RaDec[Index], &Location, JD, &AltAz[Index]);
+        TDVs[Index] = Functions.TelescopeDirectionVectorFromAltitudeAzimuth(AltAz[Index]);
+        Functions.AltitudeAzimuthFromTelescopeDirectionVector(TDVs[Index], AltAz[Index]);
+        INDI::HorizontalToEquatorial(&AltAz[Index], &Location, JD, &RaDecResults[Index]);
+    }
+    auto Single = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - Start).count();
+
+    // Same, with the batch conversions
+    Start = std::chrono::steady_clock::now();
+    INDI::EquatorialToHorizontal(RaDec.data(), Count, &Location, JD, AltAz.data());
+    Functions.TelescopeDirectionVectorsFromAltitudeAzimuth(AltAz.data(), Count, TDVs.data());
+    Functions.AltitudeAzimuthFromTelescopeDirectionVectors(TDVs.data(), Count, AltAz.data());
+    INDI::HorizontalToEquatorial(AltAz.data(), Count, &Location, JD, RaDecResults.data());
+    auto Batch = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - Start).count();
+
+    RecordProperty("SingleMicroseconds", static_cast<int>(Single));
+    RecordProperty("BatchMicroseconds", static_cast<int>(Batch));
+
+    // Timings are only recorded, wall-clock comparisons are unreliable on loaded CI machines
+    for (size_t Index = 0; Index < Count; Index += 97)
+        EXPECT_NEAR(RaDec[Index].declination, RaDecResults[Index].declination, 1e-9);
+}
+
 int main(int argc, char **argv)
 {
     INDI::Logger::getInstance().configure("", INDI::Logger::file_off,
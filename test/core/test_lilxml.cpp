@@ -0,0 +1,136 @@
+/*******************************************************************************
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Library General Public
+ License version 2 as published by the Free Software Foundation.
+ .
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Library General Public License for more details.
+ .
+ You should have received a copy of the GNU Library General Public License
+ along with this library; see the file COPYING.LIB.  If not, write to
+ the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ Boston, MA 02110-1301, USA.
+*******************************************************************************/
+
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "lilxml.h"
+
+static std::string print(XMLEle *ep, int level = 0)
+{
+    int length = sprlXMLEle(ep, level);
+    std::string result(length, '\0');
+    EXPECT_EQ(sprXMLEle(&result[0], ep, level), length);
+    return result;
+}
+
+TEST(CORE_LILXML, Test_PrintEscapesEntities)
+{
+    XMLEle *root = addXMLEle(nullptr, "defTextVector");
+    addXMLAtt(root, "device", "Telescope Simulator");
+    addXMLAtt(root, "label", "A & <B>");
+    XMLEle *text = addXMLEle(root, "defText");
+    addXMLAtt(text, "name", "QUOTE");
+    editXMLEle(text, "it's \"quoted\"");
+    addXMLEle(root, "empty");
+
+    ASSERT_EQ(print(root),
+              "<defTextVector device=\"Telescope Simulator\" label=\"A &amp; &lt;B&gt;\">\n"
+              "    <defText name=\"QUOTE\">\n"
+              "it&apos;s &quot;quoted&quot;\n"
+              "    </defText>\n"
+              "    <empty/>\n"
+              "</defTextVector>\n");
+
+    // Printed text parses back to the same values
+    char errmsg[1024];
+    std::string printed = print(root);
+    LilXML *lp = newLilXML();
+    XMLEle *parsed = nullptr;
+    for (size_t i = 0; i < printed.size() && parsed == nullptr; i++)
+        parsed = readXMLEle(lp, printed[i], errmsg);
+    delLilXML(lp);
+    ASSERT_NE(parsed, nullptr);
+    EXPECT_STREQ(findXMLAttValu(parsed, "label"), "A & <B>");
+    EXPECT_STREQ(pcdataXMLEle(findXMLEle(parsed, "defText")), "it's \"quoted\"");
+    EXPECT_EQ(print(parsed), printed);
+
+    delXMLEle(parsed);
+    delXMLEle(root);
+}
+
+TEST(CORE_LILXML, Test_CachedLengthFollowsEdits)
+{
+    XMLEle *root = addXMLEle(nullptr, "setNumberVector");
+    XMLAtt *state = addXMLAtt(root, "state", "Ok");
+    XMLEle *number = addXMLEle(root, "oneNumber");
+    editXMLEle(number, "1.5");
+
+    std::string before = print(root);
+    EXPECT_EQ(sprlXMLEle(root, 0), static_cast<int>(before.size()));
+
+    editXMLAtt(state, "Busy");
+    EXPECT_EQ(print(root).size(), before.size() + 2);
+
+    editXMLEle(number, "1.25 & more");
+    EXPECT_NE(print(root).find("1.25 &amp; more"), std::string::npos);
+
+    XMLEle *extra = addXMLEle(root, "oneNumber");
+    addXMLAtt(extra, "name", "X");
+    std::string added = print(root);
+    EXPECT_NE(added.find("<oneNumber name=\"X\"/>"), std::string::npos);
+
+    delXMLEle(extra);
+    rmXMLAtt(root, "state");
+    EXPECT_EQ(print(root), "<setNumberVector>\n    <oneNumber>\n1.25 &amp; more\n    </oneNumber>\n</setNumberVector>\n");
+
+    // A child printed on its own at another level keeps the parent length right
+    EXPECT_EQ(print(number, 0), "<oneNumber>\n1.25 &amp; more\n</oneNumber>\n");
+    EXPECT_EQ(sprlXMLEle(root, 0), static_cast<int>(print(root).size()));
+
+    delXMLEle(root);
+}
+
+TEST(CORE_LILXML, Test_SegmentsReferenceLargePcdata)
+{
+    XMLEle *root = addXMLEle(nullptr, "setBLOBVector");
+    addXMLAtt(root, "device", "CCD Simulator");
+    XMLEle *small = addXMLEle(root, "oneBLOB");
+    editXMLEle(small, "c2hvcnQ=");
+    XMLEle *large = addXMLEle(root, "oneBLOB");
+    std::string data(10000, 'A');
+    editXMLEle(large, data.c_str());
+    XMLEle *escaped = addXMLEle(root, "oneBLOB");
+    editXMLEle(escaped, (std::string(5000, 'B') + "&").c_str());
+
+    // Only large pcdata without entities is referenced in place
+    int nsegs = 0;
+    int textLength = sprslXMLEle(root, 0, 1024, &nsegs);
+    ASSERT_EQ(nsegs, 3);
+    EXPECT_EQ(textLength, sprlXMLEle(root, 0) - static_cast<int>(data.size()));
+
+    std::vector<char> text(textLength + 1);
+    std::vector<XMLSegment> segs(nsegs);
+    ASSERT_EQ(sprsXMLEle(text.data(), root, 0, 1024, segs.data()), 3);
+    EXPECT_EQ(segs[1].s, pcdataXMLEle(large));
+    EXPECT_EQ(segs[1].l, static_cast<int>(data.size()));
+
+    // The segments make up the same text as a plain print
+    std::string joined;
+    for (const XMLSegment &seg : segs)
+        joined.append(seg.s, seg.l);
+    EXPECT_EQ(joined, print(root));
+
+    // Nothing large enough, all in one segment
+    ASSERT_EQ(sprslXMLEle(root, 0, 100000, &nsegs), sprlXMLEle(root, 0));
+    ASSERT_EQ(nsegs, 1);
+
+    delXMLEle(root);
+}
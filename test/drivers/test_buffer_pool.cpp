@@ -0,0 +1,125 @@
+#include "indibufferpool.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+using INDI::BufferPool;
+
+namespace
+{
+
+bool isAligned(const void *buffer)
+{
+    return reinterpret_cast<uintptr_t>(buffer) % BufferPool::Alignment == 0;
+}
+
+}
+
+TEST(BufferPool, ReusesReleasedBuffers)
+{
+    BufferPool pool;
+
+    // Full frame, then a focus subframe, then the full frame again
+    void *full = pool.acquire(24 * 1024 * 1024);
+    ASSERT_NE(full, nullptr);
+    EXPECT_TRUE(isAligned(full));
+    EXPECT_GE(pool.capacity(full), 24U * 1024 * 1024);
+    EXPECT_TRUE(pool.release(full));
+
+    void *subframe = pool.acquire(100 * 100 * 2);
+    ASSERT_NE(subframe, nullptr);
+    EXPECT_NE(subframe, full);
+    EXPECT_TRUE(isAligned(subframe));
+    EXPECT_TRUE(pool.release(subframe));
+
+    void *again = pool.acquire(24 * 1024 * 1024 - 4096);
+    EXPECT_EQ(again, full);
+    EXPECT_TRUE(pool.release(again));
+
+    BufferPool::Statistics statistics = pool.statistics();
+    EXPECT_EQ(statistics.hits, 1U);
+    EXPECT_EQ(statistics.misses, 2U);
+    EXPECT_EQ(statistics.inUse, 0U);
+    EXPECT_GE(statistics.cached, 24U * 1024 * 1024);
+    EXPECT_EQ(statistics.peak, statistics.cached);
+
+    pool.trim();
+    EXPECT_EQ(pool.statistics().cached, 0U);
+    EXPECT_EQ(pool.statistics().hugeBuffers, 0U);
+}
+
+TEST(BufferPool, CacheLimit)
+{
+    BufferPool pool;
+    pool.setCacheLimit(8 * 1024 * 1024);
+
+    void *first = pool.acquire(6 * 1024 * 1024);
+    void *second = pool.acquire(6 * 1024 * 1024);
+    EXPECT_TRUE(pool.release(first));
+    EXPECT_TRUE(pool.release(second));
+
+    // The oldest buffer is freed to stay within the limit
+    EXPECT_LE(pool.statistics().cached, 8U * 1024 * 1024);
+    EXPECT_EQ(pool.acquire(6 * 1024 * 1024), second);
+}
+
+TEST(BufferPool, ForeignBuffers)
+{
+    BufferPool pool;
+    char *foreign = new char[16];
+
+    EXPECT_FALSE(pool.owns(foreign));
+    EXPECT_FALSE(pool.release(foreign));
+    EXPECT_EQ(pool.capacity(foreign), 0U);
+    delete [] foreign;
+}
+
+TEST(BufferPool, DetachedBuffers)
+{
+    BufferPool pool;
+    void *buffer = pool.acquire(1000);
+    ASSERT_NE(buffer, nullptr);
+
+    // Detached buffers are no longer tracked, nor handed out again
+    EXPECT_TRUE(pool.detach(buffer));
+    EXPECT_FALSE(pool.owns(buffer));
+    EXPECT_FALSE(pool.release(buffer));
+    EXPECT_FALSE(pool.detach(buffer));
+    EXPECT_EQ(pool.statistics().inUse, 0U);
+    EXPECT_EQ(pool.statistics().cached, 0U);
+
+    void *other = pool.acquire(1000);
+    EXPECT_NE(other, buffer);
+    EXPECT_TRUE(pool.release(other));
+    free(buffer);
+}
+
+TEST(BufferPool, ReallocateKeepsContent)
+{
+    BufferPool &pool = BufferPool::instance();
+
+    // Appending like a cfitsio memfile stays in place within the capacity
+    char *buffer = static_cast<char *>(BufferPool::reallocate(nullptr, 5760));
+    ASSERT_NE(buffer, nullptr);
+    memset(buffer, 'x', 5760);
+    size_t capacity = pool.capacity(buffer);
+    EXPECT_EQ(BufferPool::reallocate(buffer, capacity), buffer);
+
+    char *larger = static_cast<char *>(BufferPool::reallocate(buffer, capacity + 1));
+    ASSERT_NE(larger, nullptr);
+    EXPECT_GE(pool.capacity(larger), 2 * capacity);
+    EXPECT_EQ(larger[0], 'x');
+    EXPECT_EQ(larger[5759], 'x');
+    EXPECT_FALSE(pool.owns(buffer) && buffer != larger);
+    EXPECT_TRUE(pool.release(larger));
+
+    // Buffers from malloc are left to realloc
+    void *heap = malloc(16);
+    heap = BufferPool::reallocate(heap, 4096);
+    ASSERT_NE(heap, nullptr);
+    EXPECT_FALSE(pool.owns(heap));
+    free(heap);
+}
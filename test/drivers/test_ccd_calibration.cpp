@@ -0,0 +1,132 @@
+#include "indiccdcalibration.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+using INDI::CCDCalibration;
+
+namespace
+{
+
+CCDCalibration::Master makeMaster(int width, int height, float value)
+{
+    CCDCalibration::Master master;
+    master.width = width;
+    master.height = height;
+    master.data.assign(width * height, value);
+    return master;
+}
+
+CCDCalibration::Geometry makeGeometry(int width, int height)
+{
+    CCDCalibration::Geometry geometry;
+    geometry.width = width;
+    geometry.height = height;
+    return geometry;
+}
+
+}
+
+TEST(CCDCalibration, BiasDarkFlat)
+{
+    const int width = 64, height = 48;
+    CCDCalibration calibration;
+
+    calibration.setMaster(CCDCalibration::MASTER_BIAS, makeMaster(width, height, 100));
+
+    // 10s dark at -10C with 50 ADU of thermal signal
+    CCDCalibration::Master dark = makeMaster(width, height, 150);
+    dark.exposure = 10;
+    dark.temperature = -10;
+    calibration.setMaster(CCDCalibration::MASTER_DARK, dark);
+
+    // Left half of the sensor gets half the light of the right half
+    CCDCalibration::Master flat = makeMaster(width, height, 2000);
+    for (int y = 0; y < height; y++)
+        for (int x = 0; x < width / 2; x++)
+            flat.data[y * width + x] = 1000;
+    calibration.setMaster(CCDCalibration::MASTER_FLAT, flat);
+
+    // 20s light at -4C: twice the exposure and one doubling of the dark current
+    std::vector<uint16_t> frame(width * height);
+    for (int y = 0; y < height; y++)
+        for (int x = 0; x < width; x++)
+            frame[y * width + x] = 100 + 200 + (x < width / 2 ? 500 : 1000);
+
+    std::string error;
+    ASSERT_TRUE(calibration.calibrate(reinterpret_cast<uint8_t *>(frame.data()), 16, 1, makeGeometry(width, height), false,
+                                      20, -4, error)) << error;
+    EXPECT_EQ(calibration.steps(), "BDF");
+
+    // Flat field corrected to the mean level of the flat
+    for (uint16_t value : frame)
+        EXPECT_EQ(value, 750);
+}
+
+TEST(CCDCalibration, SubframeAndClipping)
+{
+    CCDCalibration calibration;
+
+    // Full frame bias with a gradient, the subframe uses its own part of it
+    CCDCalibration::Master bias = makeMaster(100, 80, 0);
+    for (int y = 0; y < 80; y++)
+        for (int x = 0; x < 100; x++)
+            bias.data[y * 100 + x] = x;
+    calibration.setMaster(CCDCalibration::MASTER_BIAS, bias);
+
+    CCDCalibration::Geometry geometry = makeGeometry(10, 10);
+    geometry.x = 20;
+    geometry.y = 30;
+
+    std::vector<uint8_t> frame(10 * 10, 25);
+    std::string error;
+    ASSERT_TRUE(calibration.calibrate(frame.data(), 8, 1, geometry, false, 1, NAN, error)) << error;
+    EXPECT_EQ(calibration.steps(), "B");
+    for (int y = 0; y < 10; y++)
+    {
+        EXPECT_EQ(frame[y * 10 + 0], 5);
+        EXPECT_EQ(frame[y * 10 + 4], 1);
+        // Negative values are clipped
+        EXPECT_EQ(frame[y * 10 + 9], 0);
+    }
+
+    // Masters of another binning or not covering the frame are rejected
+    geometry.binX = geometry.binY = 2;
+    EXPECT_FALSE(calibration.calibrate(frame.data(), 8, 1, geometry, false, 1, NAN, error));
+    geometry.binX = geometry.binY = 1;
+    geometry.x = 95;
+    EXPECT_FALSE(calibration.calibrate(frame.data(), 8, 1, geometry, false, 1, NAN, error));
+}
+
+TEST(CCDCalibration, HotPixels)
+{
+    const int width = 8, height = 8;
+    CCDCalibration calibration;
+
+    CCDCalibration::Master map = makeMaster(width, height, 0);
+    map.data[3 * width + 3] = 1;
+    map.data[3 * width + 4] = 1;
+    calibration.setMaster(CCDCalibration::MASTER_HOT_PIXELS, map);
+
+    // Mono frame: both adjacent hot pixels are replaced from their cold neighbours only
+    std::vector<uint16_t> frame(width * height, 1000);
+    frame[3 * width + 3] = 60000;
+    frame[3 * width + 4] = 50000;
+    std::string error;
+    ASSERT_TRUE(calibration.calibrate(reinterpret_cast<uint8_t *>(frame.data()), 16, 1, makeGeometry(width, height), false,
+                                      1, NAN, error)) << error;
+    EXPECT_EQ(frame[3 * width + 3], 1000);
+    EXPECT_EQ(frame[3 * width + 4], 1000);
+    EXPECT_EQ(calibration.steps(), "");
+
+    // Bayer frame: neighbours of the same color are two pixels away
+    for (int y = 0; y < height; y++)
+        for (int x = 0; x < width; x++)
+            frame[y * width + x] = (x % 2 == 1 && y % 2 == 1) ? 3000 : 1000;
+    frame[3 * width + 3] = 60000;
+    ASSERT_TRUE(calibration.calibrate(reinterpret_cast<uint8_t *>(frame.data()), 16, 1, makeGeometry(width, height), true,
+                                      1, NAN, error)) << error;
+    EXPECT_EQ(frame[3 * width + 3], 3000);
+}
@@ -0,0 +1,110 @@
+#include "indichannelizer.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+using INDI::Channelizer;
+
+namespace
+{
+
+// Complex tone at the given channel of a spectrum of the given size, as 16 bits interleaved I/Q
+std::vector<int16_t> makeTone(size_t samples, double channel, int channels)
+{
+    std::vector<int16_t> iq(2 * samples);
+    for (size_t i = 0; i < samples; i++)
+    {
+        double phase = 2 * M_PI * channel * i / channels;
+        iq[2 * i]     = static_cast<int16_t>(std::lround(16000 * std::cos(phase)));
+        iq[2 * i + 1] = static_cast<int16_t>(std::lround(16000 * std::sin(phase)));
+    }
+    return iq;
+}
+
+int peakChannel(const float *spectrum, int channels)
+{
+    return std::max_element(spectrum, spectrum + channels) - spectrum;
+}
+
+}
+
+TEST(Channelizer, TonePosition)
+{
+    const int channels = 64;
+    Channelizer channelizer;
+    ASSERT_TRUE(channelizer.configure(channels, 0, 0, Channelizer::WINDOW_HANN));
+
+    // Positive offsets land above the center channel, negative ones below
+    std::vector<int16_t> above = makeTone(channels * 8, 10, channels);
+    ASSERT_TRUE(channelizer.process(reinterpret_cast<const uint8_t *>(above.data()), above.size() * 2, 16));
+    const std::vector<float> &spectra = channelizer.finish();
+    ASSERT_EQ(channelizer.rows(), 1);
+    ASSERT_EQ(spectra.size(), static_cast<size_t>(channels));
+    EXPECT_EQ(peakChannel(spectra.data(), channels), channels / 2 + 10);
+    EXPECT_EQ(channelizer.segments(), 8U);
+
+    channelizer.reset();
+    std::vector<int16_t> below = makeTone(channels * 8, -5, channels);
+    channelizer.process(reinterpret_cast<const uint8_t *>(below.data()), below.size() * 2, 16);
+    EXPECT_EQ(peakChannel(channelizer.finish().data(), channels), channels / 2 - 5);
+}
+
+TEST(Channelizer, WelchOverlapAndAveraging)
+{
+    const int channels = 32;
+    Channelizer channelizer;
+    ASSERT_TRUE(channelizer.configure(channels, 0.5, 4, Channelizer::WINDOW_BLACKMAN));
+
+    // 50% overlap: 320 samples make 19 segments, i.e. 4 full rows of 4 and a last row of 3
+    std::vector<int16_t> tone = makeTone(320, 3, channels);
+    const uint8_t *data = reinterpret_cast<const uint8_t *>(tone.data());
+
+    // Feeding odd sized blocks gives the same spectra as one block
+    for (size_t offset = 0; offset < tone.size() * 2; offset += 52)
+        channelizer.process(data + offset, std::min<size_t>(52, tone.size() * 2 - offset), 16);
+    std::vector<float> blocks = channelizer.finish();
+    EXPECT_EQ(channelizer.segments(), 19U);
+    EXPECT_EQ(channelizer.samples(), 320U);
+    EXPECT_EQ(channelizer.rows(), 5);
+
+    channelizer.reset();
+    channelizer.process(data, tone.size() * 2, 16);
+    std::vector<float> single = channelizer.finish();
+    ASSERT_EQ(blocks.size(), single.size());
+    for (size_t i = 0; i < single.size(); i++)
+        EXPECT_FLOAT_EQ(blocks[i], single[i]);
+
+    // The tone has the same power in every row
+    for (int row = 0; row < channelizer.rows(); row++)
+    {
+        EXPECT_EQ(peakChannel(single.data() + row * channels, channels), channels / 2 + 3);
+        EXPECT_NEAR(single[row * channels + channels / 2 + 3], single[channels / 2 + 3], single[channels / 2 + 3] * 1e-3);
+    }
+}
+
+TEST(Channelizer, SampleFormats)
+{
+    const int channels = 16;
+    Channelizer channelizer;
+    ASSERT_TRUE(channelizer.configure(channels, 0, 0, Channelizer::WINDOW_RECTANGULAR));
+
+    // RTL-SDR offset binary: a constant 127.5 is silence, a constant 255 is a full scale DC signal
+    std::vector<uint8_t> dc(2 * channels, 255);
+    channelizer.process(dc.data(), dc.size(), 8);
+    const std::vector<float> &spectrum = channelizer.finish();
+    EXPECT_EQ(peakChannel(spectrum.data(), channels), channels / 2);
+    // Rectangular window: power of a unit I and Q signal is 2 * N^2, normalized by N
+    EXPECT_NEAR(spectrum[channels / 2], 2 * channels, 1e-3);
+
+    channelizer.reset();
+    std::vector<float> floats(2 * channels, 0.0f);
+    EXPECT_TRUE(channelizer.process(reinterpret_cast<const uint8_t *>(floats.data()), floats.size() * 4, -32));
+    EXPECT_FALSE(channelizer.process(dc.data(), dc.size(), 12));
+
+    EXPECT_FALSE(channelizer.configure(1, 0, 0, Channelizer::WINDOW_HANN));
+    EXPECT_FALSE(channelizer.configure(channels, 0.95, 0, Channelizer::WINDOW_HANN));
+}
@@ -0,0 +1,188 @@
+#include <gtest/gtest.h>
+
+#include "dsp.h"
+
+#include <cmath>
+#include <vector>
+
+namespace
+{
+
+const int Width = 320;
+const int Height = 240;
+
+struct Star
+{
+    double x;
+    double y;
+    double peak;
+};
+
+// Deterministic star field so the test does not depend on the libc random generator
+std::vector<Star> starField(int count)
+{
+    std::vector<Star> stars;
+    uint32_t seed = 12345;
+    auto next = [&seed]()
+    {
+        seed = seed * 1103515245 + 12345;
+        return ((seed >> 8) & 0xffff) / 65536.0;
+    };
+    for (int i = 0; i < count; i++)
+        stars.push_back({20 + next() * (Width - 40), 20 + next() * (Height - 40), 40 + next() * 160});
+    return stars;
+}
+
+// Gaussian stars on a noisy background, positions transformed by rotation around the center and offset
+dsp_stream_p render(const std::vector<Star> &stars, double radians, double dx, double dy)
+{
+    dsp_stream_p stream = dsp_stream_new();
+    dsp_stream_add_dim(stream, Width);
+    dsp_stream_add_dim(stream, Height);
+    dsp_stream_alloc_buffer(stream, stream->len);
+    uint32_t seed = 777;
+    for (int i = 0; i < stream->len; i++)
+    {
+        seed = seed * 1103515245 + 12345;
+        stream->buf[i] = 10 + ((seed >> 16) & 0xff) / 128.0;
+    }
+    double cx = Width / 2.0, cy = Height / 2.0;
+    for (auto &star : stars)
+    {
+        double x = cx + cos(radians) * (star.x - cx) - sin(radians) * (star.y - cy) + dx;
+        double y = cy + sin(radians) * (star.x - cx) + cos(radians) * (star.y - cy) + dy;
+        for (int py = static_cast<int>(y) - 6; py <= static_cast<int>(y) + 6; py++)
+            for (int px = static_cast<int>(x) - 6; px <= static_cast<int>(x) + 6; px++)
+                if (px >= 0 && px < Width && py >= 0 && py < Height)
+                    stream->buf[py * Width + px] += star.peak * exp(-((px - x) * (px - x) + (py - y) * (py - y)) / (2 * 1.5 * 1.5));
+    }
+    return stream;
+}
+
+dsp_stream_p ramp()
+{
+    dsp_stream_p stream = dsp_stream_new();
+    dsp_stream_add_dim(stream, 64);
+    dsp_stream_add_dim(stream, 48);
+    dsp_stream_add_dim(stream, 2);
+    dsp_stream_alloc_buffer(stream, stream->len);
+    for (int i = 0; i < stream->len; i++)
+        stream->buf[i] = (i % 64) * 2 + ((i / 64) % 48) * 3 + (i / (64 * 48)) * 1000;
+    return stream;
+}
+
+void release(dsp_stream_p stream)
+{
+    dsp_stream_free_buffer(stream);
+    dsp_stream_free(stream);
+}
+
+}
+
+TEST(DspAlign, WarpIdentityKeepsPixels)
+{
+    for (int interpolation : {DSP_INTERPOLATION_NEAREST, DSP_INTERPOLATION_BILINEAR, DSP_INTERPOLATION_LANCZOS})
+    {
+        dsp_stream_p stream = ramp();
+        dsp_stream_p original = dsp_stream_copy(stream);
+        double matrix[6] = {1, 0, 0, 0, 1, 0};
+        dsp_stream_warp(stream, matrix, interpolation);
+        for (int i = 0; i < stream->len; i++)
+            ASSERT_NEAR(stream->buf[i], original->buf[i], 1E-9) << "interpolation " << interpolation << " pixel " << i;
+        release(stream);
+        release(original);
+    }
+}
+
+TEST(DspAlign, WarpTranslatesEveryPlane)
+{
+    dsp_max_threads(4);
+    for (int interpolation : {DSP_INTERPOLATION_BILINEAR, DSP_INTERPOLATION_LANCZOS})
+    {
+        dsp_stream_p stream = ramp();
+        double matrix[6] = {1, 0, 3.5, 0, 1, -2};
+        dsp_stream_warp(stream, matrix, interpolation);
+        for (int z = 0; z < 2; z++)
+            for (int y = 0; y < 48; y++)
+                for (int x = 0; x < 64; x++)
+                {
+                    double expected = (x + 3.5 <= 63 && y >= 2) ? (x + 3.5) * 2 + (y - 2) * 3 + z * 1000 : 0;
+                    ASSERT_NEAR(stream->buf[(z * 48 + y) * 64 + x], expected, 1E-6) << x << "," << y << "," << z;
+                }
+        release(stream);
+    }
+    dsp_max_threads(1);
+}
+
+TEST(DspAlign, RegistrationRecoversRotationAndOffset)
+{
+    auto stars = starField(40);
+    dsp_stream_p ref = render(stars, 0, 0, 0);
+    dsp_stream_p frame = render(stars, 0.03, 6.4, -3.2);
+    ASSERT_GE(dsp_align_find_stars(ref, 5, 6, 20), 15);
+    ASSERT_GE(dsp_align_find_stars(frame, 5, 6, 20), 15);
+    dsp_stream_calc_triangles(ref);
+    dsp_stream_calc_triangles(frame);
+    EXPECT_EQ(ref->triangles_count, 1140);
+
+    int mask = dsp_align_get_offset(ref, frame, 2, 0.5);
+    ASSERT_FALSE(mask & DSP_ALIGN_NO_MATCH);
+    EXPECT_TRUE(mask & DSP_ALIGN_TRANSLATED);
+    EXPECT_TRUE(mask & DSP_ALIGN_ROTATED);
+    EXPECT_FALSE(mask & DSP_ALIGN_SCALED);
+    EXPECT_NEAR(frame->align_info.radians[0], 0.03, 1E-3);
+    EXPECT_NEAR(frame->align_info.factor[0], 1.0, 1E-3);
+    EXPECT_NEAR(frame->align_info.offset[0], 6.4, 0.1);
+    EXPECT_NEAR(frame->align_info.offset[1], -3.2, 0.1);
+    EXPECT_GE(frame->align_info.score, 0.5);
+
+    release(ref);
+    release(frame);
+}
+
+TEST(DspAlign, RegistrationRejectsUnrelatedFrames)
+{
+    dsp_stream_p ref = render(starField(40), 0, 0, 0);
+    std::vector<Star> other = starField(80);
+    other.erase(other.begin(), other.begin() + 40);
+    dsp_stream_p frame = render(other, 0, 0, 0);
+    dsp_align_find_stars(ref, 5, 6, 20);
+    dsp_align_find_stars(frame, 5, 6, 20);
+    EXPECT_TRUE(dsp_align_get_offset(ref, frame, 2, 0.5) & DSP_ALIGN_NO_MATCH);
+    release(ref);
+    release(frame);
+}
+
+TEST(DspAlign, StackAveragesAlignedFrames)
+{
+    dsp_max_threads(4);
+    auto stars = starField(40);
+    dsp_stack_p stack = dsp_stack_new(DSP_INTERPOLATION_LANCZOS, 5, 6, 2, 0.5);
+    dsp_stream_p ref = render(stars, 0, 0, 0);
+    EXPECT_EQ(dsp_stack_add(stack, ref), 0);
+    for (int i = 1; i < 4; i++)
+    {
+        dsp_stream_p frame = render(stars, 0.01 * i, 2.0 * i, -1.5 * i);
+        EXPECT_FALSE(dsp_stack_add(stack, frame) & DSP_ALIGN_NO_MATCH);
+        release(frame);
+    }
+    EXPECT_EQ(stack->frames, 4);
+    EXPECT_EQ(stack->rejected, 0);
+
+    dsp_stream_p mean = dsp_stack_get(stack);
+    ASSERT_NE(mean, nullptr);
+    // Compare the star peaks of the reference to the stacked ones
+    for (auto &star : stars)
+    {
+        int index = static_cast<int>(round(star.y)) * Width + static_cast<int>(round(star.x));
+        EXPECT_NEAR(mean->buf[index], ref->buf[index], ref->buf[index] * 0.1) << star.x << "," << star.y;
+    }
+    EXPECT_EQ(stack->coverage[Width * Height / 2 + Width / 2], 4);
+
+    dsp_stack_reset(stack);
+    EXPECT_EQ(dsp_stack_get(stack), nullptr);
+    release(mean);
+    release(ref);
+    dsp_stack_free(stack);
+    dsp_max_threads(1);
+}
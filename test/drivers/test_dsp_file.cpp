@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+
+#include "dsp.h"
+
+#include <cstdio>
+#include <string>
+
+namespace
+{
+
+// Not a multiple of the 4096 pixel staging block
+const int Width = 100;
+const int Height = 83;
+
+dsp_stream_p newPlane(int seed, double max)
+{
+    dsp_stream_p stream = dsp_stream_new();
+    dsp_stream_add_dim(stream, Width);
+    dsp_stream_add_dim(stream, Height);
+    dsp_stream_alloc_buffer(stream, stream->len);
+    for (int i = 0; i < stream->len; i++)
+        stream->buf[i] = (i * 7919 + seed) % static_cast<int>(max + 1);
+    // Full range, the writers stretch [min, max] to the output range
+    stream->buf[0] = 0;
+    stream->buf[stream->len - 1] = max;
+    return stream;
+}
+
+void freeStreams(dsp_stream_p *stream, int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        dsp_stream_free_buffer(stream[i]);
+        dsp_stream_free(stream[i]);
+    }
+    free(stream);
+}
+
+std::string tempFile(const char *name)
+{
+    return ::testing::TempDir() + name;
+}
+
+void expectRoundTrip(int bpp)
+{
+    std::string filename = tempFile("test_dsp_file.fits");
+    dsp_stream_p plane = newPlane(0, dsp_t_max);
+
+    dsp_file_write_fits(filename.c_str(), bpp, plane);
+
+    int channels = 0;
+    dsp_stream_p *read = dsp_file_read_fits(filename.c_str(), &channels, 0);
+    ASSERT_NE(read, nullptr);
+    ASSERT_EQ(channels, 1);
+    ASSERT_EQ(read[0]->len, plane->len);
+    EXPECT_EQ(read[0]->sizes[0], Width);
+    EXPECT_EQ(read[0]->sizes[1], Height);
+    for (int i = 0; i < plane->len; i++)
+        ASSERT_EQ(read[0]->buf[i], plane->buf[i]) << "pixel " << i << " bpp " << bpp;
+
+    freeStreams(read, channels + 1);
+    dsp_stream_free_buffer(plane);
+    dsp_stream_free(plane);
+    std::remove(filename.c_str());
+}
+
+}
+
+TEST(DspFile, PlaneRoundTrip)
+{
+    for (int bpp : {8, 16, 32, -32, -64})
+        expectRoundTrip(bpp);
+}
+
+TEST(DspFile, CompositeRoundTrip)
+{
+    const int components = 3;
+    // The composite writer stretches every plane to half the range of the pixel type
+    const double max = (1 << 16) / 2 - 1;
+    std::string filename = tempFile("test_dsp_file_composite.fits");
+
+    dsp_stream_p *planes = static_cast<dsp_stream_p*>(malloc(sizeof(dsp_stream_p) * (components + 1)));
+    for (int c = 0; c <= components; c++)
+        planes[c] = newPlane(c * 101, max);
+
+    dsp_file_write_fits_composite(filename.c_str(), components, 16, planes);
+
+    int channels = 0;
+    dsp_stream_p *read = dsp_file_read_fits(filename.c_str(), &channels, 0);
+    ASSERT_NE(read, nullptr);
+    ASSERT_EQ(channels, components);
+    for (int c = 0; c < components; c++)
+    {
+        ASSERT_EQ(read[c]->len, planes[c]->len);
+        for (int i = 0; i < planes[c]->len; i++)
+            ASSERT_EQ(read[c]->buf[i], planes[c]->buf[i]) << "component " << c << " pixel " << i;
+    }
+
+    // Last stream is the mean of the components
+    for (int i = 0; i < read[components]->len; i++)
+    {
+        double mean = 0;
+        for (int c = 0; c < components; c++)
+            mean += planes[c]->buf[i];
+        ASSERT_DOUBLE_EQ(read[components]->buf[i], mean / components) << "pixel " << i;
+    }
+
+    freeStreams(read, channels + 1);
+    freeStreams(planes, components + 1);
+    std::remove(filename.c_str());
+}
@@ -0,0 +1,198 @@
+#include <gtest/gtest.h>
+
+#include "dsp.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+namespace
+{
+
+struct Coverage
+{
+    std::vector<std::atomic<int>> hits;
+    std::atomic<int> badThread {0};
+    int threads {0};
+};
+
+void countItems(void *arg, int thread, int start, int end)
+{
+    Coverage *coverage = static_cast<Coverage*>(arg);
+    if (thread < 0 || thread >= coverage->threads)
+        coverage->badThread++;
+    for (int i = start; i < end; i++)
+        coverage->hits[i]++;
+}
+
+void nestedItems(void *arg, int thread, int start, int end)
+{
+    Coverage *coverage = static_cast<Coverage*>(arg);
+    for (int i = start; i < end; i++)
+    {
+        Coverage inner;
+        inner.hits = std::vector<std::atomic<int>>(16);
+        inner.threads = coverage->threads;
+        dsp_parallel_for(16, 1, countItems, &inner);
+        int total = 0;
+        for (auto &hit : inner.hits)
+            total += hit;
+        coverage->hits[i] += total == 16 ? 1 : 100;
+    }
+    (void)thread;
+}
+
+dsp_stream_p newFrame(int width, int height)
+{
+    dsp_stream_p stream = dsp_stream_new();
+    dsp_stream_add_dim(stream, width);
+    dsp_stream_add_dim(stream, height);
+    dsp_stream_alloc_buffer(stream, stream->len);
+    for (int i = 0; i < stream->len; i++)
+        stream->buf[i] = (i * 7919) % 251;
+    return stream;
+}
+
+// Reference implementation of the thread per call scheme the pool replaces
+struct SpawnArgs
+{
+    int cur_th;
+    dsp_stream_p stream;
+    double sum;
+};
+
+void *spawnSum(void *arg)
+{
+    SpawnArgs *args = static_cast<SpawnArgs*>(arg);
+    int start = args->cur_th * args->stream->len / dsp_max_threads(0);
+    int end = (args->cur_th + 1) * args->stream->len / dsp_max_threads(0);
+    args->sum = 0;
+    for (int i = start; i < end; i++)
+        args->sum += args->stream->buf[i];
+    return nullptr;
+}
+
+double spawnPerCall(dsp_stream_p stream)
+{
+    std::vector<pthread_t> th(dsp_max_threads(0));
+    std::vector<SpawnArgs> args(dsp_max_threads(0));
+    for (size_t t = 0; t < th.size(); t++)
+    {
+        args[t] = {static_cast<int>(t), stream, 0};
+        pthread_create(&th[t], nullptr, spawnSum, &args[t]);
+    }
+    double sum = 0;
+    for (size_t t = 0; t < th.size(); t++)
+    {
+        pthread_join(th[t], nullptr);
+        sum += args[t].sum;
+    }
+    return sum;
+}
+
+struct PoolSum
+{
+    dsp_stream_p stream;
+    double sum[64];
+};
+
+void poolSum(void *arg, int thread, int start, int end)
+{
+    PoolSum *args = static_cast<PoolSum*>(arg);
+    double sum = 0;
+    for (int i = start; i < end; i++)
+        sum += args->stream->buf[i];
+    args->sum[thread] += sum;
+}
+
+double pooled(dsp_stream_p stream)
+{
+    PoolSum args {};
+    args.stream = stream;
+    dsp_parallel_for(stream->len, 0, poolSum, &args);
+    double sum = 0;
+    for (unsigned long t = 0; t < dsp_max_threads(0); t++)
+        sum += args.sum[t];
+    return sum;
+}
+
+template <typename F>
+double microseconds(int iterations, F f)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++)
+        f();
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / iterations;
+}
+
+}
+
+TEST(DspThreads, ParallelForCoversEveryItemOnce)
+{
+    dsp_max_threads(4);
+    for (int count : {1, 3, 4, 17, 10007})
+    {
+        Coverage coverage;
+        coverage.hits = std::vector<std::atomic<int>>(count);
+        coverage.threads = 4;
+        dsp_parallel_for(count, 3, countItems, &coverage);
+        for (int i = 0; i < count; i++)
+            ASSERT_EQ(coverage.hits[i], 1) << "item " << i << " of " << count;
+        ASSERT_EQ(coverage.badThread, 0);
+    }
+    dsp_max_threads(1);
+}
+
+TEST(DspThreads, NestedLoopsRunInline)
+{
+    dsp_max_threads(4);
+    Coverage coverage;
+    coverage.hits = std::vector<std::atomic<int>>(64);
+    coverage.threads = 4;
+    dsp_parallel_for(64, 1, nestedItems, &coverage);
+    for (auto &hit : coverage.hits)
+        ASSERT_EQ(hit, 1);
+    dsp_max_threads(1);
+}
+
+TEST(DspThreads, MedianMatchesSingleThread)
+{
+    dsp_stream_p serial = newFrame(61, 47);
+    dsp_stream_p threaded = newFrame(61, 47);
+
+    dsp_max_threads(1);
+    dsp_buffer_median(serial, 3, 1);
+    dsp_max_threads(4);
+    dsp_buffer_median(threaded, 3, 1);
+    dsp_max_threads(1);
+
+    // Border pixels sample outside the frame and are not deterministic
+    for (int y = 1; y < 46; y++)
+        for (int x = 1; x < 60; x++)
+            ASSERT_EQ(serial->buf[y * 61 + x], threaded->buf[y * 61 + x]) << "pixel " << x << "," << y;
+
+    dsp_stream_free_buffer(serial);
+    dsp_stream_free(serial);
+    dsp_stream_free_buffer(threaded);
+    dsp_stream_free(threaded);
+}
+
+// Run with --gtest_also_run_disabled_tests to compare the pool against a thread per call on small and large frames
+TEST(DspThreads, DISABLED_Benchmark)
+{
+    dsp_max_threads(4);
+    for (int size : {64, 256, 1024, 4096})
+    {
+        dsp_stream_p stream = newFrame(size, size);
+        int iterations = std::max(4, 4000000 / stream->len);
+        ASSERT_DOUBLE_EQ(spawnPerCall(stream), pooled(stream));
+        double spawn = microseconds(iterations, [&]() { spawnPerCall(stream); });
+        double pool = microseconds(iterations, [&]() { pooled(stream); });
+        printf("%4dx%-4d  thread per call %10.1f us  pool %10.1f us  speedup %.1fx\n", size, size, spawn, pool, spawn / pool);
+        dsp_stream_free_buffer(stream);
+        dsp_stream_free(stream);
+    }
+    dsp_max_threads(1);
+}
@@ -0,0 +1,93 @@
+#include "indidevapi.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include <sys/time.h>
+
+namespace
+{
+
+double clockSeconds()
+{
+    struct timeval now { 0, 0 };
+    IEGetClockTime(&now);
+    return now.tv_sec + now.tv_usec / 1e6;
+}
+
+void setFlag(void *p)
+{
+    *static_cast<int *>(p) = 1;
+}
+
+}
+
+TEST(EventClock, SteppingJumpsToTimers)
+{
+    IESetClockStepping(1);
+    ASSERT_TRUE(IEGetClockStepping());
+
+    double start = clockSeconds();
+
+    // One hour of timers
+    int done = 0;
+    IEAddTimer(3600 * 1000, setFlag, &done);
+    EXPECT_EQ(IEDeferLoop(0, &done), 0);
+    EXPECT_EQ(done, 1);
+
+    EXPECT_NEAR(clockSeconds() - start, 3600.0, 0.001);
+
+    // Sleeping moves the clock forward without waiting
+    start = clockSeconds();
+    IEClockSleep(1500);
+    EXPECT_NEAR(clockSeconds() - start, 1.5, 0.001);
+
+    IESetClockStepping(0);
+}
+
+TEST(EventClock, SteppedTimersKeepTheirOrder)
+{
+    IESetClockStepping(1);
+
+    static std::vector<int> fired;
+    static int ids[] = {1, 2, 3};
+    fired.clear();
+
+    auto record = [](void *p)
+    {
+        fired.push_back(*static_cast<int *>(p));
+    };
+    IEAddTimer(1500, record, &ids[2]);
+    IEAddTimer(500, record, &ids[0]);
+    IEAddTimer(1000, record, &ids[1]);
+
+    int done = 0;
+    IEAddTimer(2000, setFlag, &done);
+    IEDeferLoop(0, &done);
+
+    EXPECT_EQ(fired, std::vector<int>({1, 2, 3}));
+
+    IESetClockStepping(0);
+}
+
+TEST(EventClock, ScaledTimers)
+{
+    IESetClockScale(100);
+    EXPECT_EQ(IEGetClockScale(), 100);
+
+    double start = clockSeconds();
+
+    int done = 0;
+    IEAddTimer(5000, setFlag, &done);
+    IEDeferLoop(0, &done);
+
+    // 5 seconds of the clock, about 50 ms of wall time
+    EXPECT_EQ(done, 1);
+    EXPECT_GE(clockSeconds() - start, 5.0);
+
+    // The clock keeps its time when slowed down again
+    double before = clockSeconds();
+    IESetClockScale(1);
+    EXPECT_NEAR(clockSeconds(), before, 0.01);
+}
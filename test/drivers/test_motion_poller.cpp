@@ -0,0 +1,189 @@
+#include "indimotionpoller.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+using INDI::MotionPoller;
+
+namespace
+{
+
+// Focuser model: starts moving after a latency, then at a constant speed until it reaches its target
+class SimulatedFocuser
+{
+    public:
+        void move(double target, uint64_t now)
+        {
+            from = position(now);
+            to = target;
+            start = now;
+        }
+
+        double position(uint64_t now) const
+        {
+            if (now <= start + latency)
+                return from;
+            double travelled = speed * (now - start - latency);
+            return (to > from) ? std::min(to, from + travelled) : std::max(to, from - travelled);
+        }
+
+        // Time at which the focuser reaches its target
+        uint64_t arrival() const
+        {
+            return start + latency + static_cast<uint64_t>(std::ceil(std::fabs(to - from) / speed));
+        }
+
+        double from {50000};
+        double to {50000};
+        uint64_t start {0};
+        uint64_t latency {200};
+        // Steps per millisecond
+        double speed {1.6};
+};
+
+enum Strategy
+{
+    FIXED_POLLING,
+    ADAPTIVE_POLLING,
+    EVENT_DRIVEN
+};
+
+// Autofocus run: an exposure of the given length after each move, the run time is the sum of exposures and move times
+// as seen by the driver, i.e. until it notices the move is complete.
+uint64_t autofocus(Strategy strategy, uint32_t period, uint32_t *polls)
+{
+    const uint64_t exposure = 2500;
+    SimulatedFocuser focuser;
+    MotionPoller poller;
+    poller.setPeriods(100, period);
+
+    // Outward past focus, then inward through the V curve
+    double targets[10] = { 57500 };
+    for (int i = 1; i < 10; i++)
+        targets[i] = targets[i - 1] - 1500;
+
+    uint64_t now = 0;
+    // The driver timer runs freely, its phase is unrelated to the start of the moves
+    uint64_t nextPoll = 370;
+    *polls = 0;
+
+    for (double target : targets)
+    {
+        focuser.move(target, now);
+
+        uint64_t done = 0;
+        switch (strategy)
+        {
+            case FIXED_POLLING:
+                while (nextPoll < now)
+                    nextPoll += period;
+                for (;; nextPoll += period)
+                {
+                    (*polls)++;
+                    if (focuser.position(nextPoll) == target)
+                        break;
+                }
+                done = nextPoll;
+                break;
+
+            case ADAPTIVE_POLLING:
+                // FocuserInterface reschedules the driver timer when the move starts
+                poller.start(focuser.position(now), target, now);
+                for (nextPoll = now + poller.nextDelay(now);; nextPoll += poller.nextDelay(nextPoll))
+                {
+                    (*polls)++;
+                    double position = focuser.position(nextPoll);
+                    if (position == target)
+                        break;
+                    poller.update(position, nextPoll);
+                }
+                poller.finish();
+                done = nextPoll;
+                break;
+
+            case EVENT_DRIVEN:
+                done = focuser.arrival();
+                break;
+        }
+
+        now = done + exposure;
+    }
+
+    return now;
+}
+
+}
+
+TEST(MotionPoller, Periods)
+{
+    MotionPoller poller;
+    poller.setPeriods(100, 1000);
+
+    // Idle
+    EXPECT_EQ(poller.nextDelay(0), 1000U);
+
+    // Fast until the speed is known
+    poller.start(1000, 3000, 0);
+    EXPECT_EQ(poller.nextDelay(0), 100U);
+    poller.update(1000, 100);
+    EXPECT_EQ(poller.nextDelay(100), 100U);
+
+    // 1 step per ms, 1800 steps to go: capped at the idle period, then polled at the expected arrival
+    poller.update(1200, 300);
+    EXPECT_EQ(poller.nextDelay(300), 1000U);
+    poller.update(2200, 1300);
+    EXPECT_EQ(poller.nextDelay(1300), 800U);
+    EXPECT_EQ(poller.nextDelay(1900), 200U);
+
+    // Late: polled fast
+    EXPECT_EQ(poller.nextDelay(2500), 100U);
+    EXPECT_EQ(poller.samples(), 3U);
+
+    poller.finish();
+    EXPECT_FALSE(poller.isMoving());
+    EXPECT_EQ(poller.nextDelay(2500), 1000U);
+
+    // A polling period shorter than the fast period wins
+    poller.setPeriods(100, 50);
+    poller.start(0, 10, 0);
+    EXPECT_EQ(poller.nextDelay(0), 50U);
+}
+
+TEST(MotionPoller, EventDriven)
+{
+    MotionPoller poller;
+    poller.setPeriods(100, 1000);
+    poller.setEventDriven(true);
+
+    // Polling stays a watchdog while the device reports completion on its own
+    poller.start(0, 5000, 0);
+    EXPECT_TRUE(poller.isMoving());
+    EXPECT_EQ(poller.nextDelay(0), 1000U);
+}
+
+TEST(MotionPoller, AutofocusRunTime)
+{
+    uint32_t fixedPolls, adaptivePolls, eventPolls;
+    const uint64_t fixed    = autofocus(FIXED_POLLING, 1000, &fixedPolls);
+    const uint64_t adaptive = autofocus(ADAPTIVE_POLLING, 1000, &adaptivePolls);
+    const uint64_t event    = autofocus(EVENT_DRIVEN, 1000, &eventPolls);
+
+    RecordProperty("FixedPollingMs", std::to_string(fixed));
+    RecordProperty("AdaptivePollingMs", std::to_string(adaptive));
+    RecordProperty("EventDrivenMs", std::to_string(event));
+
+    EXPECT_LE(event, adaptive);
+    EXPECT_LT(adaptive, fixed);
+
+    // Each move is noticed within a fast period of its end, fixed polling notices it half a period late on average
+    EXPECT_LE(adaptive - event, 10 * 100U);
+    EXPECT_GT(fixed - event, 10 * 250U);
+
+    // Polling at the expected arrival costs a handful of polls per move, not one per fast period
+    uint32_t fastPolls;
+    autofocus(FIXED_POLLING, 100, &fastPolls);
+    EXPECT_LT(adaptivePolls, fastPolls / 2);
+}
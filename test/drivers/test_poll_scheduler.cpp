@@ -0,0 +1,145 @@
+#include "indipollscheduler.h"
+
+#include <gtest/gtest.h>
+
+using INDI::PollScheduler;
+
+// Serial mount model counting round trips, like the LX200 :GR#/:GD#/:Gm#/:GL# commands
+class SimulatedSerialMount
+{
+    public:
+        bool readCoordinates()
+        {
+            transactions += 2;
+            return connected;
+        }
+        bool readPierSide()
+        {
+            transactions++;
+            return connected;
+        }
+        bool readTime()
+        {
+            transactions++;
+            return connected;
+        }
+
+        uint32_t transactions {0};
+        bool connected {true};
+};
+
+class PollSchedulerTest : public ::testing::Test
+{
+    protected:
+        void SetUp() override
+        {
+            scheduler.setBasePeriod(PollScheduler::MOTION_SLEWING, 250);
+            scheduler.setBasePeriod(PollScheduler::MOTION_TRACKING, 1000);
+            scheduler.setBasePeriod(PollScheduler::MOTION_IDLE, 2000);
+            scheduler.setBasePeriod(PollScheduler::MOTION_PARKED, 10000);
+
+            scheduler.addQuantity("COORD", [this]()
+            {
+                return mount.readCoordinates();
+            });
+            scheduler.addQuantity("PIER_SIDE", [this]()
+            {
+                return mount.readPierSide();
+            }, 5);
+            scheduler.addQuantity("TIME", [this]()
+            {
+                return mount.readTime();
+            }, 60, 30000);
+        }
+
+        // Drive the scheduler like Telescope::TimerHit() does for the given duration
+        void run(uint64_t duration)
+        {
+            uint64_t end = now + duration;
+            while (now < end)
+            {
+                scheduler.poll(now);
+                now += std::max<uint32_t>(scheduler.nextDelay(now), 1);
+            }
+        }
+
+        SimulatedSerialMount mount;
+        PollScheduler scheduler;
+        uint64_t now {1000};
+};
+
+TEST_F(PollSchedulerTest, ReadsEverythingOnFirstPoll)
+{
+    EXPECT_EQ(scheduler.nextDelay(now), 0u);
+    EXPECT_TRUE(scheduler.poll(now));
+    EXPECT_EQ(scheduler.readCount("COORD"), 1u);
+    EXPECT_EQ(scheduler.readCount("PIER_SIDE"), 1u);
+    EXPECT_EQ(scheduler.readCount("TIME"), 1u);
+    EXPECT_EQ(scheduler.nextDelay(now), 2000u);
+}
+
+TEST_F(PollSchedulerTest, RatesFollowMotionState)
+{
+    scheduler.setMotionState(PollScheduler::MOTION_SLEWING);
+    run(60000);
+    uint32_t slewing = mount.transactions;
+    EXPECT_EQ(scheduler.readCount("COORD"), 240u);
+    EXPECT_EQ(scheduler.readCount("PIER_SIDE"), 48u);
+
+    mount.transactions = 0;
+    scheduler.setMotionState(PollScheduler::MOTION_PARKED);
+    run(60000);
+    EXPECT_LT(mount.transactions * 20, slewing);
+}
+
+TEST_F(PollSchedulerTest, StalenessBudgetCapsSlowStates)
+{
+    scheduler.setMotionState(PollScheduler::MOTION_PARKED);
+    run(90000);
+    // 60 x 10 s parked period would be 10 minutes, the 30 s budget wins.
+    EXPECT_EQ(scheduler.readCount("TIME"), 3u);
+}
+
+TEST_F(PollSchedulerTest, RefreshDeduplicatesReads)
+{
+    scheduler.poll(now);
+    mount.transactions = 0;
+
+    EXPECT_TRUE(scheduler.refresh("PIER_SIDE", now + 100, 500));
+    EXPECT_TRUE(scheduler.refresh("PIER_SIDE", now + 200, 500));
+    EXPECT_EQ(mount.transactions, 0u);
+
+    EXPECT_TRUE(scheduler.refresh("PIER_SIDE", now + 600, 500));
+    EXPECT_EQ(mount.transactions, 1u);
+
+    EXPECT_FALSE(scheduler.refresh("UNKNOWN", now, 0));
+}
+
+TEST_F(PollSchedulerTest, InvalidateForcesRead)
+{
+    scheduler.poll(now);
+    scheduler.invalidate("PIER_SIDE");
+    EXPECT_EQ(scheduler.nextDelay(now + 10), 0u);
+    scheduler.poll(now + 10);
+    EXPECT_EQ(scheduler.readCount("PIER_SIDE"), 2u);
+    EXPECT_EQ(scheduler.readCount("COORD"), 1u);
+}
+
+TEST_F(PollSchedulerTest, BoostPollsAtSlewingRate)
+{
+    scheduler.setMotionState(PollScheduler::MOTION_PARKED);
+    scheduler.poll(now);
+    scheduler.boost(now + 1000);
+    EXPECT_EQ(scheduler.nextDelay(now), 250u);
+    run(1000);
+    EXPECT_EQ(scheduler.readCount("COORD"), 4u);
+    EXPECT_EQ(scheduler.nextDelay(now), 9750u);
+}
+
+TEST_F(PollSchedulerTest, FailedReadIsNotRetriedImmediately)
+{
+    mount.connected = false;
+    EXPECT_FALSE(scheduler.poll(now));
+    EXPECT_EQ(scheduler.nextDelay(now), 2000u);
+    EXPECT_FALSE(scheduler.refresh("COORD", now + 1, 1000));
+}
@@ -0,0 +1,111 @@
+#include "previewcontroller.h"
+
+#include <gtest/gtest.h>
+
+using INDI::PreviewController;
+
+namespace
+{
+
+// Offers frames at the given rate for the given duration, the size of a frame follows the operating point
+void stream(PreviewController &controller, double &now, double seconds, double fps, double uploadTime = 0.01)
+{
+    const double end = now + seconds;
+    for (; now < end; now += 1 / fps)
+    {
+        if (controller.skipFrame())
+            continue;
+
+        const PreviewController::OperatingPoint &point = controller.operatingPoint();
+        size_t bytes = 2000 * point.quality / (point.scale * point.scale);
+        controller.update(bytes, uploadTime, now);
+    }
+}
+
+}
+
+TEST(PreviewController, BitrateTarget)
+{
+    PreviewController controller;
+    controller.setMode(PreviewController::MODE_BITRATE);
+
+    // 10 FPS of 170 kB frames at quality 85, for a budget of 200 kB/s
+    controller.setTarget(200000, 0.2);
+    double now = 0;
+    stream(controller, now, 60, 10);
+
+    // Quality goes down first, then the frames are downscaled
+    EXPECT_EQ(controller.operatingPoint().quality, 30);
+    EXPECT_EQ(controller.operatingPoint().scale, 2);
+    EXPECT_EQ(controller.operatingPoint().skip, 0);
+    EXPECT_LE(controller.bitrate(), 200000);
+
+    // A tighter budget also skips frames once the frames cannot get any smaller
+    controller.setTarget(20000, 0.2);
+    stream(controller, now, 60, 10);
+    EXPECT_EQ(controller.operatingPoint().scale, 4);
+    EXPECT_GT(controller.operatingPoint().skip, 0);
+    EXPECT_LE(controller.bitrate(), 20000);
+
+    // A generous budget brings the preview back to its best
+    controller.setTarget(10000000, 0.2);
+    stream(controller, now, 120, 10);
+    EXPECT_EQ(controller.operatingPoint().quality, 85);
+    EXPECT_EQ(controller.operatingPoint().scale, 1);
+    EXPECT_EQ(controller.operatingPoint().skip, 0);
+}
+
+TEST(PreviewController, LatencyAndDrops)
+{
+    PreviewController controller;
+    controller.setMode(PreviewController::MODE_LATENCY);
+    controller.setTarget(1000000, 0.2);
+
+    // Uploads well within the target latency
+    double now = 0;
+    stream(controller, now, 10, 10, 0.05);
+    EXPECT_EQ(controller.operatingPoint().quality, 85);
+
+    // Frames dropped behind the upload step down even though the latency is fine
+    controller.dropped();
+    stream(controller, now, 1.05, 10, 0.05);
+    EXPECT_EQ(controller.operatingPoint().quality, 75);
+    EXPECT_EQ(controller.droppedFrames(), 1U);
+
+    // Slow uploads step down
+    stream(controller, now, 3, 10, 0.5);
+    EXPECT_LT(controller.operatingPoint().quality, 75);
+    EXPECT_NEAR(controller.latency(), 0.5, 1e-9);
+}
+
+TEST(PreviewController, LimitsAndFixedMode)
+{
+    PreviewController controller;
+
+    // Encoders without quality or scale setting only skip frames
+    PreviewController::Limits limits;
+    limits.minQuality = limits.maxQuality = 85;
+    limits.maxScale = 1;
+    limits.maxSkip = 3;
+    controller.setLimits(limits);
+    controller.setMode(PreviewController::MODE_BITRATE);
+    controller.setTarget(1000, 0.2);
+
+    double now = 0;
+    stream(controller, now, 30, 10);
+    EXPECT_EQ(controller.operatingPoint().quality, 85);
+    EXPECT_EQ(controller.operatingPoint().scale, 1);
+    EXPECT_EQ(controller.operatingPoint().skip, 3);
+
+    // One frame out of four is uploaded
+    int uploaded = 0;
+    for (int i = 0; i < 40; i++)
+        uploaded += controller.skipFrame() ? 0 : 1;
+    EXPECT_EQ(uploaded, 10);
+
+    // Fixed mode keeps the best operating point whatever the load
+    controller.setMode(PreviewController::MODE_FIXED);
+    stream(controller, now, 30, 10);
+    EXPECT_EQ(controller.operatingPoint().skip, 0);
+    EXPECT_GT(controller.bitrate(), 1000);
+}
@@ -0,0 +1,176 @@
+#include "indipulsescheduler.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "indilogger.h"
+#include "telescope_simulator.h"
+
+using INDI::PulseScheduler;
+using Clock = std::chrono::steady_clock;
+
+namespace
+{
+
+// Poll dispatch() like the event loop would when the completion pipe becomes readable
+int dispatchUntil(PulseScheduler &scheduler, int expected, std::chrono::milliseconds timeout)
+{
+    int dispatched = 0;
+    auto deadline = Clock::now() + timeout;
+    while (dispatched < expected && Clock::now() < deadline)
+    {
+        dispatched += scheduler.dispatch();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return dispatched;
+}
+
+double elapsedMs(Clock::time_point start, Clock::time_point end)
+{
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+}
+
+TEST(PulseScheduler, ConcurrentAxesStopOnTime)
+{
+    std::vector<INDI_EQ_AXIS> completed;
+    PulseScheduler scheduler([&completed](INDI_EQ_AXIS axis)
+    {
+        completed.push_back(axis);
+    });
+
+    Clock::time_point start = Clock::now(), stopRA, stopDE;
+    scheduler.start(AXIS_DE, 120, [&stopDE]()
+    {
+        stopDE = Clock::now();
+    });
+    scheduler.start(AXIS_RA, 60, [&stopRA]()
+    {
+        stopRA = Clock::now();
+    });
+    EXPECT_TRUE(scheduler.isActive(AXIS_RA));
+    EXPECT_TRUE(scheduler.isActive(AXIS_DE));
+
+    ASSERT_EQ(dispatchUntil(scheduler, 2, std::chrono::milliseconds(2000)), 2);
+    ASSERT_EQ(completed.size(), 2U);
+    EXPECT_EQ(completed[0], AXIS_RA);
+    EXPECT_EQ(completed[1], AXIS_DE);
+    EXPECT_FALSE(scheduler.isActive(AXIS_RA));
+    EXPECT_FALSE(scheduler.isActive(AXIS_DE));
+
+    // Both pulses overlap, each one ends at or after its own deadline
+    EXPECT_GE(elapsedMs(start, stopRA), 60);
+    EXPECT_GE(elapsedMs(start, stopDE), 120);
+    EXPECT_LT(stopRA, stopDE);
+
+    PulseScheduler::Statistics statistics = scheduler.statistics();
+    EXPECT_EQ(statistics.pulses, 2U);
+    EXPECT_GE(statistics.mean, 0);
+    EXPECT_GE(statistics.max, statistics.mean);
+    EXPECT_GE(statistics.rms, statistics.mean);
+
+    scheduler.resetStatistics();
+    EXPECT_EQ(scheduler.statistics().pulses, 0U);
+}
+
+TEST(PulseScheduler, LatenessIncludesStop)
+{
+    PulseScheduler scheduler(nullptr);
+
+    // A stop blocked behind the device, its time is part of the lateness
+    scheduler.start(AXIS_RA, 10, []()
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    });
+    ASSERT_EQ(dispatchUntil(scheduler, 1, std::chrono::milliseconds(2000)), 1);
+    EXPECT_GE(scheduler.statistics().max, 30);
+}
+
+TEST(PulseScheduler, RestartAndAbort)
+{
+    std::atomic<int> stops {0};
+    int completions = 0;
+    PulseScheduler scheduler([&completions](INDI_EQ_AXIS)
+    {
+        completions++;
+    });
+
+    // A new pulse on the same axis replaces the running one
+    scheduler.start(AXIS_RA, 500, [&stops]()
+    {
+        stops += 100;
+    });
+    scheduler.start(AXIS_RA, 20, [&stops]()
+    {
+        stops++;
+    });
+    EXPECT_EQ(dispatchUntil(scheduler, 1, std::chrono::milliseconds(1000)), 1);
+    EXPECT_EQ(stops, 1);
+
+    // Aborted pulses neither stop nor complete
+    scheduler.start(AXIS_DE, 20, [&stops]()
+    {
+        stops++;
+    });
+    scheduler.abort(AXIS_DE);
+    EXPECT_FALSE(scheduler.isActive(AXIS_DE));
+    EXPECT_EQ(dispatchUntil(scheduler, 1, std::chrono::milliseconds(100)), 0);
+    EXPECT_EQ(stops, 1);
+    EXPECT_EQ(completions, 1);
+    EXPECT_EQ(scheduler.statistics().pulses, 1U);
+}
+
+class MockScopeSim : public ScopeSim
+{
+    public:
+        MockScopeSim()
+        {
+            initProperties();
+        }
+
+        void guide(const char *property, const char *element, double ms)
+        {
+            double values[] = { ms };
+            char *names[] = { const_cast<char *>(element) };
+            ISNewNumber(getDeviceName(), property, values, names, 1);
+        }
+
+        void testConcurrentPulses()
+        {
+            guide("TELESCOPE_TIMED_GUIDE_NS", "TIMED_GUIDE_N", 80);
+            guide("TELESCOPE_TIMED_GUIDE_WE", "TIMED_GUIDE_W", 40);
+            EXPECT_EQ(GuideNSNP.s, IPS_BUSY);
+            EXPECT_EQ(GuideWENP.s, IPS_BUSY);
+            ASSERT_NE(m_PulseScheduler, nullptr);
+
+            ASSERT_EQ(dispatchUntil(*m_PulseScheduler, 2, std::chrono::milliseconds(2000)), 2);
+            EXPECT_EQ(GuideNSNP.s, IPS_IDLE);
+            EXPECT_EQ(GuideWENP.s, IPS_IDLE);
+            EXPECT_EQ(GuideNSN[DIRECTION_NORTH].value, 0);
+            EXPECT_EQ(GuideWEN[DIRECTION_WEST].value, 0);
+
+            EXPECT_EQ(GuidePulseErrorN[GUIDE_PULSES].value, 2);
+            EXPECT_GE(GuidePulseErrorN[GUIDE_MEAN_ERROR].value, 0);
+            EXPECT_GE(GuidePulseErrorN[GUIDE_MAX_ERROR].value, GuidePulseErrorN[GUIDE_MEAN_ERROR].value);
+        }
+};
+
+TEST(PulseScheduler, TelescopeSimulatorGuiding)
+{
+    MockScopeSim scope;
+    scope.testConcurrentPulses();
+}
+
+int main(int argc, char **argv)
+{
+    INDI::Logger::getInstance().configure("", INDI::Logger::file_off,
+                                          INDI::Logger::DBG_ERROR, INDI::Logger::DBG_ERROR);
+
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
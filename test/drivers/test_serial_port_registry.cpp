@@ -0,0 +1,121 @@
+#include "connectionplugins/serialportregistry.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+using Connection::SerialPortRegistry;
+
+namespace
+{
+
+std::string temporaryDirectory()
+{
+    char pattern[] = "/tmp/indi_ports_XXXXXX";
+    return std::string(mkdtemp(pattern));
+}
+
+}
+
+TEST(SerialPortRegistry, ClaimAndRelease)
+{
+    std::string directory = temporaryDirectory();
+    SerialPortRegistry registry(directory);
+    std::string port = directory + "/ttyUSB0";
+    fclose(fopen(port.c_str(), "w"));
+
+    EXPECT_TRUE(registry.owner(port).empty());
+    EXPECT_TRUE(registry.claim(port, "Mount"));
+    EXPECT_TRUE(registry.claim(port, "Mount"));
+    EXPECT_EQ(registry.owner(port), "Mount");
+
+    // Another device of the same driver, or a link to the same port, is kept out
+    std::string link = directory + "/mount";
+    ASSERT_EQ(symlink(port.c_str(), link.c_str()), 0);
+    EXPECT_FALSE(registry.claim(port, "Focuser"));
+    EXPECT_FALSE(registry.claim(link, "Focuser", 200));
+
+    // And so is another driver, which sees the owner
+    pid_t child = fork();
+    if (child == 0)
+    {
+        SerialPortRegistry other(directory);
+        bool ok = !other.claim(link, "Focuser") && other.owner(port) == "Mount";
+        _exit(ok ? 0 : 1);
+    }
+    int status = -1;
+    waitpid(child, &status, 0);
+    EXPECT_EQ(status, 0);
+
+    registry.release(link);
+    EXPECT_TRUE(registry.owner(port).empty());
+    EXPECT_TRUE(registry.claim(port, "Focuser"));
+    registry.release(port);
+}
+
+TEST(SerialPortRegistry, ProbingAndConnected)
+{
+    std::string directory = temporaryDirectory();
+    SerialPortRegistry registry(directory);
+    std::string port = directory + "/ttyUSB0";
+    fclose(fopen(port.c_str(), "w"));
+
+    // Other drivers see whether the claim is a probe in progress or a connected device
+    auto connectedInOtherDriver = [&directory, &port]()
+    {
+        pid_t child = fork();
+        if (child == 0)
+        {
+            SerialPortRegistry other(directory);
+            _exit(other.isConnected(port) ? 0 : 1);
+        }
+        int status = -1;
+        waitpid(child, &status, 0);
+        return status == 0;
+    };
+
+    EXPECT_FALSE(registry.isConnected(port));
+    ASSERT_TRUE(registry.claim(port, "Mount"));
+    EXPECT_FALSE(registry.isConnected(port));
+    EXPECT_FALSE(connectedInOtherDriver());
+
+    registry.setConnected(port);
+    EXPECT_TRUE(registry.isConnected(port));
+    EXPECT_TRUE(connectedInOtherDriver());
+    EXPECT_FALSE(registry.claim(port, "Focuser", 60000));
+
+    registry.release(port);
+    EXPECT_FALSE(registry.isConnected(port));
+    EXPECT_FALSE(connectedInOtherDriver());
+}
+
+TEST(SerialPortRegistry, RemembersPorts)
+{
+    std::string directory = temporaryDirectory();
+    SerialPortRegistry registry(directory);
+    std::string mount = directory + "/ttyUSB0";
+    std::string focuser = directory + "/ttyUSB1";
+    fclose(fopen(mount.c_str(), "w"));
+    fclose(fopen(focuser.c_str(), "w"));
+
+    EXPECT_TRUE(registry.lookup("Mount").empty());
+
+    registry.remember(mount, "Mount");
+    registry.remember(focuser, "Focuser");
+    EXPECT_EQ(registry.lookup("Mount"), mount);
+    EXPECT_EQ(registry.lookup("Focuser"), focuser);
+
+    // Devices swapped ports, and the cache is shared with other instances
+    registry.remember(focuser, "Mount");
+    SerialPortRegistry other(directory);
+    EXPECT_EQ(other.lookup("Mount"), focuser);
+
+    // Ports that went away are not returned
+    unlink(focuser.c_str());
+    EXPECT_TRUE(other.lookup("Mount").empty());
+}
@@ -5,6 +5,7 @@
 #include "config.h"
 #endif
 
+#include <chrono>
 #include <cstdlib>
 #include <cstring>
 
@@ -153,6 +154,51 @@ TEST(VectorTest, rotateZ)
     EXPECT_NEAR(v.secondary().Degrees(), 45, 0.00001);
 }
 
+// Axis tests
+
+TEST(AxisTest, SlewOnSteppedClock)
+{
+    // Polls run back to back on a stepped clock, the slew follows the clock and not the wall time
+    IESetClockStepping(1);
+
+    Axis axis("Test");
+    axis.setDegrees(0);
+    axis.Tracking(false);
+    axis.mcRate = 0;
+    axis.update();
+
+    struct timeval start { 0, 0 }, end { 0, 0 };
+    IEGetClockTime(&start);
+    auto wallStart = std::chrono::steady_clock::now();
+
+    axis.StartSlew(Angle(60.0));
+    int timer = IEAddPeriodicTimer(1000, [](void *p)
+    {
+        static_cast<Axis *>(p)->update();
+    }, &axis);
+
+    int slewing = 1;
+    int done = IEAddPeriodicTimer(1000, [](void *p)
+    {
+        *static_cast<int *>(p) = 0;
+    }, &slewing);
+    while (axis.isSlewing)
+    {
+        slewing = 1;
+        IEDeferLoop0(0, &slewing);
+    }
+    IERmTimer(timer);
+    IERmTimer(done);
+    IEGetClockTime(&end);
+
+    EXPECT_NEAR(axis.position.Degrees(), 60.0, 0.00001);
+    // 9 polls at the goto rate of 6 deg/s, then 4 at the center rate and the final one
+    EXPECT_EQ(end.tv_sec - start.tv_sec, 14);
+    EXPECT_LT(std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count(), 1.0);
+
+    IESetClockStepping(0);
+}
+
 // Alignment tests
 // the tuple contains:
 // Test Ha, Ra, primary, azimuth angle
@@ -8,6 +8,7 @@
  * watch for messages until get initial values of each operand
  * evaluate expression, repeat if -w each time an op arrives until true
  * exit val==0
+ * with -l, repeat all but the connection for each expression read from stdin
  */
 
 #define _GNU_SOURCE // needed for fdopen
@@ -45,7 +46,9 @@ static void initProps(FILE *fp);
 static int pstatestr(char *state);
 static time_t timestampINDI(char *ts);
 static int devcmp(char *op1, char *op2);
+static int propcmp(char *op1, char *op2);
 static int runEval(FILE *fp);
+static int runBatch(FILE *fp);
 static int setOp(XMLEle *root);
 static XMLEle *nxtEle(FILE *fp);
 static int readServerChar(FILE *fp);
@@ -64,6 +67,7 @@ static int verbose;                   /* more tracing */
 static int eflag;                     /* print each updated expression value*/
 static int fflag;                     /* print final expression value */
 static int iflag;                     /* read expresion from stdin */
+static int lflag;                     /* evaluate each line of stdin as an expression */
 static int oflag;                     /* print operands as they change */
 static int wflag;                     /* wait for expression to be true */
 static int bflag;                     /* beep when true */
@@ -118,6 +122,9 @@ int main(int ac, char *av[])
                 case 'i': /* read expression from stdin */
                     iflag++;
                     break;
+                case 'l': /* evaluate each line of stdin as an expression */
+                    lflag++;
+                    break;
                 case 'o': /* print operands as they change */
                     oflag++;
                     break;
@@ -159,8 +166,13 @@ int main(int ac, char *av[])
 
     /* now there are ac args starting with av[0] */
 
-    /* compile expression from av[0] or stdin */
-    if (ac == 0)
+    /* compile expression from av[0] or stdin, batch expressions are compiled as they are read */
+    if (lflag)
+    {
+        if (ac != 0)
+            usage();
+    }
+    else if (ac == 0)
         compileINDI(NULL);
     else if (ac == 1)
         compileINDI(av[0]);
@@ -193,6 +205,9 @@ int main(int ac, char *av[])
     /* set up to catch an io timeout function */
     signal(SIGALRM, onAlarm);
 
+    if (lflag)
+        return (runBatch(fp));
+
     /* send getProperties */
     getProps(fp);
 
@@ -216,6 +231,7 @@ static void usage()
     fprintf(stderr, "   -f   : print final expression value\n");
     fprintf(stderr, "   -h h : alternate host, default is %s\n", host_def);
     fprintf(stderr, "   -i   : read expression from stdin\n");
+    fprintf(stderr, "   -l   : evaluate each line of stdin as an expression, over one connection\n");
     fprintf(stderr, "   -o   : print operands as they change\n");
     fprintf(stderr, "   -p p : alternate port, default is %d\n", INDIPORT);
     fprintf(stderr, "   -t t : max secs to wait, 0 is forever, default is %d\n", TIMEOUT);
@@ -238,7 +254,10 @@ static void usage()
     fprintf(stderr, "     evalINDI '\"Security.Security._STATE\"==1'\n");
     fprintf(stderr, "   To wait for RA and Dec to be near zero and watch their values as they change:\n");
     fprintf(stderr, "     evalINDI -t 0 -wo 'abs(\"Mount.EqJ2K.RA\")<.01 && abs(\"Mount.EqJ2K.Dec\")<.01'\n");
+    fprintf(stderr, "   To wait for a slew to finish, then for the focuser to stop moving:\n");
+    fprintf(stderr, "     printf '\"Mount.EQUATORIAL_EOD_COORD._STATE\"==1\\n\"Focuser.ABS_FOCUS_POSITION._STATE\"==1\\n' | evalINDI -t 0 -wl\n");
     fprintf(stderr, "Exit 0 if expression evaluates to non-0, 1 if 0, else 2\n");
+    fprintf(stderr, "With -l, exit 0 if every expression evaluates to non-0, 1 if any is 0, else 2\n");
 
     exit(1);
 }
@@ -323,19 +342,46 @@ static void getProps(FILE *fp)
     /* get each operand used in the expression */
     nops = getAllOperands(&ops);
 
-    /* send getProperties for each unique device referenced */
+    /* send getProperties for each unique device.property referenced */
     for (i = 0; i < nops; i++)
     {
+        char *dot = strchr(ops[i], '.');
+        char *pdot;
+
+        /* compileExpr() only accepts device.name.element, skip anything else */
+        if (!dot)
+        {
+            fprintf(stderr, "Skipping malformed operand %s\n", ops[i]);
+            continue;
+        }
+
         for (j = 0; j < i; j++)
-            if (devcmp(ops[i], ops[j]) == 0)
+            if (propcmp(ops[i], ops[j]) == 0)
                 break;
         if (j < i)
             continue;
+
+        pdot = strchr(dot + 1, '.');
+        if (!pdot)
+        {
+            /* no property to narrow by, ask for the whole device */
+            for (j = 0; j < i; j++)
+                if (devcmp(ops[i], ops[j]) == 0)
+                    break;
+            if (j < i)
+                continue;
+            if (verbose)
+                fprintf(stderr, "sending getProperties for %.*s\n", (int)(dot - ops[i]), ops[i]);
+            fprintf(fp, "<getProperties version='%g' device='%.*s'/>\n", INDIV, (int)(dot - ops[i]), ops[i]);
+            continue;
+        }
+
         if (verbose)
-            fprintf(stderr, "sending getProperties for %.*s\n", (int)(strchr(ops[i], '.') - ops[i]), ops[i]);
-        fprintf(fp, "<getProperties version='%g' device='%.*s'/>\n", INDIV, (int)(strchr(ops[i], '.') - ops[i]),
-                ops[i]);
+            fprintf(stderr, "sending getProperties for %.*s\n", (int)(pdot - ops[i]), ops[i]);
+        fprintf(fp, "<getProperties version='%g' device='%.*s' name='%.*s'/>\n", INDIV, (int)(dot - ops[i]), ops[i],
+                (int)(pdot - dot - 1), dot + 1);
     }
+    fflush(fp);
 }
 
 /* wait for defXXX or setXXX for each property in the expression.
@@ -489,6 +535,32 @@ static int runEval(FILE *fp)
     return (v == 0);
 }
 
+/* compile, fetch and evaluate each non-blank, non-comment line of stdin in turn.
+ * return 0 if all evaluated to non-0, else 1.
+ * exit(2) if trouble, as runEval().
+ */
+static int runBatch(FILE *fp)
+{
+    char line[1024];
+    int rc = 0;
+
+    while (fgets(line, sizeof(line), stdin))
+    {
+        char *exp = line + strspn(line, " \t");
+        exp[strcspn(exp, "\r\n")] = '\0';
+        if (exp[0] == '\0' || exp[0] == '#')
+            continue;
+
+        compileINDI(exp);
+        getProps(fp);
+        initProps(fp);
+        if (runEval(fp))
+            rc = 1;
+    }
+
+    return (rc);
+}
+
 /* return 0|1|2|3 depending on whether state is Idle|Ok|Busy|<other>.
  */
 static int pstatestr(char *state)
@@ -528,6 +600,19 @@ static int devcmp(char *op1, char *op2)
     return (n1 != n2 || strncmp(op1, op2, n1));
 }
 
+/* return 0 if the device.property portion of the two given property specs match, else 1
+ */
+static int propcmp(char *op1, char *op2)
+{
+    char *d1 = strchr(op1, '.');
+    char *d2 = strchr(op2, '.');
+    char *p1 = d1 ? strchr(d1 + 1, '.') : NULL;
+    char *p2 = d2 ? strchr(d2 + 1, '.') : NULL;
+    int n1   = p1 ? p1 - op1 : (int)strlen(op1);
+    int n2   = p2 ? p2 - op2 : (int)strlen(op2);
+    return (n1 != n2 || strncmp(op1, op2, n1));
+}
+
 /* monitor server and return the next complete XML message.
  * exit(2) if time out.
  * N.B. caller must call delXMLEle()
@@ -3,6 +3,8 @@
  * All types but BLOBs are handled from their defXXX messages. Receipt of a
  *   defBLOB sends enableBLOB then uses setBLOBVector for the value. BLOBs
  *   are stored in a file dev.nam.elem.format. only .z compression is handled.
+ * With -b, further d.p.e queries are read from stdin, one per line, so many
+ *   queries share one connection and one round of getProperties.
  * exit status: 0 at least some found, 1 some not found, 2 real trouble.
  */
 
@@ -65,9 +67,11 @@ static int nsrchs;
 
 static void usage(void);
 static void crackDPE(char *spec);
+static void readBatch(void);
 static void addSearchDef(char *dev, char *prop, char *ele);
 static void openINDIServer(void);
 static void getprops(void);
+static char *propFilter(int i);
 static void listenINDI(void);
 static int finished(void);
 static void onAlarm(int dummy);
@@ -94,6 +98,7 @@ static int directfd = -1;             /* direct filedes to server, if >= 0 */
 static FILE *svrwfp;                  /* FILE * to talk to server */
 static FILE *svrrfp;                  /* FILE * to read from server */
 static int wflag;                     /* show wo properties too */
+static int bflag;                     /* read more queries from stdin */
 
 int main(int ac, char *av[])
 {
@@ -111,6 +116,9 @@ int main(int ac, char *av[])
                 case '1': /* just value */
                     justvalue++;
                     break;
+                case 'b': /* batch queries from stdin */
+                    bflag++;
+                    break;
                 case 'd':
                     if (ac < 2)
                     {
@@ -175,12 +183,19 @@ int main(int ac, char *av[])
     }
 
     /* now ac args starting with av[0] */
-    if (ac == 0)
+    if (ac == 0 && !bflag)
         av[ac++] = "*.*.*"; /* default is get everything */
 
     /* crack each d.p.e */
     while (ac--)
         crackDPE(*av++);
+    if (bflag)
+        readBatch();
+    if (nsrchs == 0)
+    {
+        fprintf(stderr, "No queries\n");
+        usage();
+    }
     onematch = nsrchs == 1 && !srchs[0].wc;
 
     /* open connection */
@@ -232,6 +247,7 @@ static void usage()
     fprintf(stderr, "  or just value if -1 and exactly one query without wildcards.\n");
     fprintf(stderr, "Options:\n");
     fprintf(stderr, "  -1    : print just value if expecting exactly one response\n");
+    fprintf(stderr, "  -b    : also read device.property.element queries from stdin, one per line\n");
     fprintf(stderr, "  -d f  : use file descriptor f already open to server\n");
     fprintf(stderr, "  -h h  : alternate host, default is %s\n", host_def);
     fprintf(stderr, "  -m    : keep monitoring for more updates\n");
@@ -263,6 +279,21 @@ static void crackDPE(char *spec)
     addSearchDef(d, p, e);
 }
 
+/* crack each non-blank, non-comment line of stdin as another d.p.e */
+static void readBatch()
+{
+    char line[1024];
+
+    while (fgets(line, sizeof(line), stdin))
+    {
+        char *spec = line + strspn(line, " \t");
+        spec[strcspn(spec, "\r\n")] = '\0';
+        if (spec[0] == '\0' || spec[0] == '#')
+            continue;
+        crackDPE(spec);
+    }
+}
+
 /* grow srchs[] with the new search */
 static void addSearchDef(char *dev, char *prop, char *ele)
 {
@@ -315,33 +346,60 @@ static void openINDIServer(void)
     svrrfp = fdopen(sockfd, "r");
 }
 
-/* issue getProperties to svrwfp, possibly constrained to one device */
+/* return the property name srchs[i] can be narrowed to in getProperties,
+ * or NULL if its whole device is needed.
+ */
+static char *propFilter(int i)
+{
+    for (int j = 0; j < nsrchs; j++)
+        if (!strcmp(srchs[i].d, srchs[j].d) && *srchs[j].p == WILDCARD)
+            return (NULL);
+    return (srchs[i].p);
+}
+
+/* issue getProperties to svrwfp, constrained to just the devices and
+ * properties we are looking for unless a device is wild.
+ */
 static void getprops()
 {
-    char *onedev = NULL;
-    int i;
+    int i, j;
 
-    /* find if only need one device */
+    /* any wild device needs everything */
     for (i = 0; i < nsrchs; i++)
     {
-        char *d = srchs[i].d;
-        if (*d == WILDCARD || (onedev && strcmp(d, onedev)))
+        if (*srchs[i].d == WILDCARD)
         {
-            onedev = NULL;
-            break;
+            fprintf(svrwfp, "<getProperties version='%g'/>\n", INDIV);
+            fflush(svrwfp);
+            if (verbose)
+                fprintf(stderr, "Queried properties from *\n");
+            return;
         }
-        else
-            onedev = d;
     }
 
-    if (onedev)
-        fprintf(svrwfp, "<getProperties version='%g' device='%s'/>\n", INDIV, onedev);
-    else
-        fprintf(svrwfp, "<getProperties version='%g'/>\n", INDIV);
-    fflush(svrwfp);
+    /* else one getProperties for each unique device or device.property */
+    for (i = 0; i < nsrchs; i++)
+    {
+        char *p = propFilter(i);
 
-    if (verbose)
-        fprintf(stderr, "Queried properties from %s\n", onedev ? onedev : "*");
+        for (j = 0; j < i; j++)
+        {
+            char *pj = propFilter(j);
+            if (!strcmp(srchs[i].d, srchs[j].d) && (p == pj || (p && pj && !strcmp(p, pj))))
+                break;
+        }
+        if (j < i)
+            continue;
+
+        if (p)
+            fprintf(svrwfp, "<getProperties version='%g' device='%s' name='%s'/>\n", INDIV, srchs[i].d, p);
+        else
+            fprintf(svrwfp, "<getProperties version='%g' device='%s'/>\n", INDIV, srchs[i].d);
+
+        if (verbose)
+            fprintf(stderr, "Queried properties from %s.%s\n", srchs[i].d, p ? p : "*");
+    }
+    fflush(svrwfp);
 }
 
 /* listen for INDI traffic on svrrfp.
@@ -1,4 +1,6 @@
 /* connect to an INDI server and set one or more device.property.element.
+ * With -b, further specs are read from stdin, one per line, so many settings
+ *   share one connection.
  */
 
 #define _GNU_SOURCE // needed for fdopen
@@ -48,6 +50,7 @@ static int directfd = -1;     /* direct filedes to server, if >= 0 */
 #define TIMEOUT 2             /* default timeout, secs */
 static int timeout = TIMEOUT; /* working timeout, secs */
 static LilXML *lillp;         /* XML parser context */
+static int bflag;             /* read more specs from stdin */
 
 typedef struct
 {
@@ -69,6 +72,10 @@ static int nsets;
 
 static void usage(void);
 static int crackSpec(int *acp, char **avp[]);
+static INDIDef *crackType(char *type);
+static void addSpec(INDIDef *dp, char *spec);
+static int readBatch(void);
+static void getProps(FILE *wfp);
 static void openINDIServer(FILE **rfpp, FILE **wfpp);
 static void listenINDI(FILE *rfp, FILE *wfp);
 static int finished(void);
@@ -98,6 +105,10 @@ int main(int ac, char *av[])
         {
             switch (*s)
             {
+                case 'b': /* batch specs from stdin */
+                    bflag++;
+                    break;
+
                 case 'd':
                     if (ac < 2)
                     {
@@ -167,16 +178,23 @@ int main(int ac, char *av[])
     }
 
     /* now ac args starting at av[0] */
-    if (ac < 1)
+    if (ac < 1 && !bflag)
         usage();
 
     /* crack each property, add to sets[]  */
     allspeced = 1;
-    do
+    while (ac > 0)
     {
         if (!crackSpec(&ac, &av))
             allspeced = 0;
-    } while (ac > 0);
+    }
+    if (bflag && !readBatch())
+        allspeced = 0;
+    if (nsets == 0)
+    {
+        fprintf(stderr, "Missing spec\n");
+        usage();
+    }
 
     /* open connection */
     if (directfd >= 0)
@@ -210,10 +228,7 @@ int main(int ac, char *av[])
     else
     {
         /* issue getProperties */
-        if (verbose)
-            fprintf(stderr, "Querying for properties\n");
-        fprintf(wfp, "<getProperties version='%g'/>\n", INDIV);
-        fflush(wfp);
+        getProps(wfp);
 
         /* listen for properties, set when see any we recognize */
         listenINDI(rfp, wfp);
@@ -228,6 +243,7 @@ static void usage()
     fprintf(stderr, "%s\n", GIT_TAG_STRING);
     fprintf(stderr, "Usage: %s [options] {[type] spec} ...\n", me);
     fprintf(stderr, "Options:\n");
+    fprintf(stderr, "  -b    : also read [type] spec from stdin, one per line\n");
     fprintf(stderr, "  -d f  : use file descriptor f already open to server\n");
     fprintf(stderr, "  -h h  : alternate host, default is %s\n", host_def);
     fprintf(stderr, "  -p p  : alternate port, default is %d\n", INDIPORT);
@@ -256,28 +272,13 @@ static void usage()
  */
 static int crackSpec(int *acp, char **avp[])
 {
-    char d[128], p[128], ev[2048];
     char *spec  = *avp[0];
     INDIDef *dp = NULL;
 
     /* check if first arg is type indicator */
     if ((*acp > 0) && (spec[0] == '-'))
     {
-        switch (spec[1])
-        {
-            case 'x':
-                dp = &defs[0];
-                break;
-            case 'n':
-                dp = &defs[1];
-                break;
-            case 's':
-                dp = &defs[2];
-                break;
-            default:
-                fprintf(stderr, "Bad property type: %s\n", spec);
-                usage();
-        }
+        dp = crackType(spec);
         (*acp)--;
         (*avp)++;
         spec = *avp[0];
@@ -288,7 +289,73 @@ static int crackSpec(int *acp, char **avp[])
         usage();
     }
 
-    /* then scan arg for property spec */
+    addSpec(dp, spec);
+
+    /* update caller's pointers */
+    (*acp)--;
+    (*avp)++;
+
+    /* return 1 if saw a spec */
+    return (dp ? 1 : 0);
+}
+
+/* return the defs[] entry for a -x/-n/-s type flag, else exit */
+static INDIDef *crackType(char *type)
+{
+    switch (type[1])
+    {
+        case 'x':
+            return (&defs[0]);
+        case 'n':
+            return (&defs[1]);
+        case 's':
+            return (&defs[2]);
+        default:
+            fprintf(stderr, "Bad property type: %s\n", type);
+            usage();
+    }
+
+    return (NULL);
+}
+
+/* crack each non-blank, non-comment line of stdin as [type] spec.
+ * return 1 if every line had a type
+ */
+static int readBatch()
+{
+    char line[2048];
+    int allspeced = 1;
+
+    while (fgets(line, sizeof(line), stdin))
+    {
+        char *spec  = line + strspn(line, " \t");
+        INDIDef *dp = NULL;
+
+        spec[strcspn(spec, "\r\n")] = '\0';
+        if (spec[0] == '\0' || spec[0] == '#')
+            continue;
+
+        if (spec[0] == '-')
+        {
+            dp = crackType(spec);
+            spec += 2;
+            spec += strspn(spec, " \t");
+        }
+        else
+            allspeced = 0;
+
+        addSpec(dp, spec);
+    }
+
+    return (allspeced);
+}
+
+/* scan spec for a property assignment and add it to sets[] with type dp, else exit */
+static void addSpec(INDIDef *dp, char *spec)
+{
+    char d[128], p[128], ev[2048];
+
+    /* scan arg for property spec */
     //if (sscanf(spec, "%[^.].%[^.].%s", d, p, ev) != 3)
     if (sscanf(spec, "%[^.].%[^.].%[^\n]", d, p, ev) != 3)
     {
@@ -304,13 +371,6 @@ static int crackSpec(int *acp, char **avp[])
     sets[nsets].ev  = NULL;
     sets[nsets].nev = 0;
     scanEV(&sets[nsets++], ev);
-
-    /* update caller's pointers */
-    (*acp)--;
-    (*avp)++;
-
-    /* return 1 if saw a spec */
-    return (dp ? 1 : 0);
 }
 
 /* open a read and write connection to host and port or die.
@@ -353,6 +413,25 @@ static void openINDIServer(FILE **rfpp, FILE **wfpp)
     *wfpp = fdopen(sockfd, "w");
 }
 
+/* ask only for the definitions of the properties we are going to set */
+static void getProps(FILE *wfp)
+{
+    int i, j;
+
+    for (i = 0; i < nsets; i++)
+    {
+        for (j = 0; j < i; j++)
+            if (!strcmp(sets[i].d, sets[j].d) && !strcmp(sets[i].p, sets[j].p))
+                break;
+        if (j < i)
+            continue;
+        if (verbose)
+            fprintf(stderr, "Querying for %s.%s\n", sets[i].d, sets[i].p);
+        fprintf(wfp, "<getProperties version='%g' device='%s' name='%s'/>\n", INDIV, sets[i].d, sets[i].p);
+    }
+    fflush(wfp);
+}
+
 /* listen for property reports, send new sets if match */
 static void listenINDI(FILE *rfp, FILE *wfp)
 {